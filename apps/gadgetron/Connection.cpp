@@ -33,6 +33,7 @@ namespace Gadgetron::Server::Connection {
             const Gadgetron::Core::StreamContext::Args& args,
             std::unique_ptr<std::iostream> stream
     ) {
+        // The child starts with every library and config the server has loaded, e.g. through prewarming.
         auto pid = fork();
         if (pid == 0) {
             handle_connection(std::move(stream), paths, args);
@@ -14,6 +14,22 @@
 using namespace boost::filesystem;
 using namespace Gadgetron::Server;
 
+namespace {
+
+    Gadgetron::Connection::SocketOptions socket_options(const boost::program_options::variables_map &args) {
+        using Gadgetron::Connection::SocketOptions;
+
+        auto mode = args["socket_ingest"].as<std::string>();
+        if (mode != "default" && mode != "throughput")
+            throw std::runtime_error("Unknown socket ingest mode '" + mode + "'; expected 'default' or 'throughput'");
+
+        auto options = mode == "throughput" ? SocketOptions::ingest() : SocketOptions{};
+        if (args["socket_receive_buffer"].as<int>() > 0)
+            options.receive_buffer_size = args["socket_receive_buffer"].as<int>();
+        return options;
+    }
+}
+
 
 Server::Server(
         const boost::program_options::variables_map &args
@@ -35,12 +51,20 @@ void Server::serve() {
 
     acceptor.set_option(boost::asio::socket_base::reuse_address(true));
 
+    auto options = socket_options(args);
+    GINFO_STREAM("Socket ingest: " << args["socket_ingest"].as<std::string>() << " mode, "
+                                   << options.buffer_size << " byte stream buffers");
+
+    // Accepted sockets inherit the receive buffer size, which needs to be set before the handshake to take effect.
+    if (options.receive_buffer_size > 0)
+        acceptor.set_option(boost::asio::socket_base::receive_buffer_size(options.receive_buffer_size));
+
     while(true) {
         auto socket = std::make_unique<boost::asio::ip::tcp::socket>(executor);
         acceptor.accept(*socket);
 
         GINFO_STREAM("Accepted connection from: " << socket->remote_endpoint().address());
 
-        Connection::handle(paths, args, Gadgetron::Connection::stream_from_socket(std::move(socket)));
+        Connection::handle(paths, args, Gadgetron::Connection::stream_from_socket(std::move(socket), options));
     }
 }
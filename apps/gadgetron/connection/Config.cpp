@@ -4,7 +4,10 @@
 #include <map>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 
 #include <boost/range/algorithm/transform.hpp>
 #include <boost/range/algorithm/count_if.hpp>
@@ -161,6 +164,10 @@ namespace {
         static pugi::xml_node add_node(const Config::Stream &stream, pugi::xml_node &node) {
             auto stream_node = node.append_child("stream");
             stream_node.append_attribute("key").set_value(stream.key.c_str());
+            if (stream.scheduler.shared) {
+                stream_node.append_attribute("scheduler").set_value("shared");
+                stream_node.append_attribute("threads").set_value((long long unsigned int)stream.scheduler.threads);
+            }
             for (auto n : stream.nodes) {
                 visit([&stream_node](auto &typed_node) { add_node(typed_node, stream_node); }, n);
             }
@@ -170,6 +177,8 @@ namespace {
         static pugi::xml_node add_node(const Config::ParallelProcess& parallelProcess, pugi::xml_node & node){
             auto parallel_node = node.append_child("parallelprocess");
             parallel_node.append_attribute("workers").set_value((long long unsigned int)parallelProcess.workers);
+            parallel_node.append_attribute("max_in_flight").set_value((long long unsigned int)parallelProcess.max_in_flight);
+            parallel_node.append_attribute("delivery").set_value(parallelProcess.ordered ? "ordered" : "unordered");
             add_node(parallelProcess.stream, parallel_node);
             return parallel_node;
         }
@@ -184,6 +193,10 @@ namespace {
 
         static pugi::xml_node add_node(const Config::PureDistributed& distributed, pugi::xml_node& node){
             auto puredistributed_node = node.append_child("puredistributed");
+            puredistributed_node.append_attribute("max_in_flight").set_value((long long unsigned int)distributed.max_in_flight);
+            puredistributed_node.append_attribute("delivery").set_value(distributed.ordered ? "ordered" : "unordered");
+            puredistributed_node.append_attribute("scheduling").set_value(distributed.scheduling.c_str());
+            puredistributed_node.append_attribute("sticky_key").set_value(distributed.sticky_key.c_str());
             add_readers(distributed.readers,puredistributed_node);
             add_writers(distributed.writers,puredistributed_node);
             add_node(distributed.stream,puredistributed_node);
@@ -523,7 +536,16 @@ namespace {
             for (auto &node : stream_node.children()) {
                 nodes.push_back(node_parsers.at(node.name())(node));
             }
-            return Config::Stream{stream_node.attribute("key").value(), nodes};
+            return Config::Stream{stream_node.attribute("key").value(), nodes, parse_scheduler(stream_node)};
+        }
+
+        static Config::Scheduler parse_scheduler(const pugi::xml_node &stream_node) {
+            std::string scheduler = stream_node.attribute("scheduler").value();
+            if (scheduler.empty() || scheduler == "threads") return Config::Scheduler{};
+            if (scheduler != "shared")
+                throw ConfigNodeError("Unknown scheduler '" + scheduler + "'; expected 'threads' or 'shared'", stream_node);
+
+            return Config::Scheduler{true, stream_node.attribute("threads").as_ullong(0)};
         }
 
         Config::PureStream parse_purestream(const pugi::xml_node &purestream_node){
@@ -536,7 +558,18 @@ namespace {
         Config::ParallelProcess parse_parallelprocess(const pugi::xml_node& parallelprocess_node)
         {
             size_t workers = std::stoul(parallelprocess_node.attribute("workers").value());
-            return Config::ParallelProcess{workers,parse_purestream(parallelprocess_node.child("purestream"))};
+            auto config = Config::ParallelProcess{workers,parse_purestream(parallelprocess_node.child("purestream"))};
+            config.max_in_flight = parallelprocess_node.attribute("max_in_flight").as_ullong(0);
+            config.ordered = parse_delivery(parallelprocess_node);
+            return config;
+        }
+
+        static bool parse_delivery(const pugi::xml_node &node) {
+            std::string delivery = node.attribute("delivery").value();
+            if (delivery.empty() || delivery == "ordered") return true;
+            if (delivery != "unordered")
+                throw ConfigNodeError("Unknown delivery '" + delivery + "'; expected 'ordered' or 'unordered'", node);
+            return false;
         }
 
         Config::PureDistributed parse_puredistributed(const pugi::xml_node& puredistributedprocess_node){
@@ -544,7 +577,20 @@ namespace {
             auto purestream = parse_purestream(puredistributedprocess_node.child("purestream"));
             auto readers = parse_readers(puredistributedprocess_node.child("readers"));
             auto writers = parse_writers(puredistributedprocess_node.child("writers"));
-            return {readers,writers,purestream};
+
+            Config::PureDistributed config{readers,writers,purestream};
+            config.max_in_flight = puredistributedprocess_node.attribute("max_in_flight").as_ullong(config.max_in_flight);
+            if (config.max_in_flight == 0)
+                throw ConfigNodeError("Attribute 'max_in_flight' must be at least 1", puredistributedprocess_node);
+
+            config.ordered = parse_delivery(puredistributedprocess_node);
+
+            config.scheduling = puredistributedprocess_node.attribute("scheduling").as_string(config.scheduling.c_str());
+            if (!std::set<std::string>{"least_loaded", "latency", "power_of_two", "sticky"}.count(config.scheduling))
+                throw ConfigNodeError("Unknown scheduling '" + config.scheduling + "'; expected 'least_loaded', 'latency', 'power_of_two' or 'sticky'", puredistributedprocess_node);
+            config.sticky_key = puredistributedprocess_node.attribute("sticky_key").as_string(config.sticky_key.c_str());
+
+            return config;
         }
 
         static optional<std::string> parse_target(std::string s) {
@@ -616,6 +662,26 @@ namespace Gadgetron::Server::Connection {
         return std::get<1>(*parser)(doc);
     }
 
+    Config parse_config_cached(const std::string &text) {
+        static constexpr size_t max_cached_configs = 64;
+        static std::mutex mutex;
+        static std::unordered_map<std::string, Config> configs;
+
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            auto cached = configs.find(text);
+            if (cached != configs.end()) return cached->second;
+        }
+
+        std::stringstream stream(text);
+        auto config = parse_config(stream);
+
+        std::lock_guard<std::mutex> guard(mutex);
+        if (configs.size() >= max_cached_configs) configs.clear();
+        configs.emplace(text, config);
+        return config;
+    }
+
     std::string serialize_config(const Config &config) {
         pugi::xml_document doc{};
         auto config_node = doc.append_child("configuration");
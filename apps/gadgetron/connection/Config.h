@@ -32,9 +32,20 @@ namespace Gadgetron::Server::Connection {
             std::string dll, classname;
         };
 
+        /**
+         * How the nodes of a stream are run. By default every node gets a thread of its own. With a shared
+         * scheduler, nodes which process one message at a time run as tasks on a process wide pool of at most
+         * 'threads' workers (0 meaning one per core), shared between all connections using the same cap.
+         */
+        struct Scheduler {
+            bool shared = false;
+            size_t threads = 0;
+        };
+
         struct Stream {
             std::string key;
             std::vector<Node> nodes;
+            Scheduler scheduler = {};
         };
 
         struct PureStream{
@@ -85,11 +96,17 @@ namespace Gadgetron::Server::Connection {
             std::vector<Reader> readers;
             std::vector<Writer> writers;
             PureStream stream;
+            size_t max_in_flight = 2;
+            bool ordered = true;
+            std::string scheduling = "least_loaded";
+            std::string sticky_key = "slice";
         };
 
         struct ParallelProcess {
             size_t workers = 0;
             PureStream stream;
+            size_t max_in_flight = 0; // Items being processed or awaiting output; 0 is twice the workers.
+            bool ordered = true;
         };
 
         struct Distributor : Gadget { using Gadget::Gadget;};
@@ -107,6 +124,12 @@ namespace Gadgetron::Server::Connection {
     };
 
     Config parse_config(std::istream &stream);
+
+    /**
+     * As parse_config, but reuses the result of an earlier parse of the same text. The cache is process wide; it
+     * is shared by connections handled on threads, and inherited by connections forked from a prewarmed server.
+     */
+    Config parse_config_cached(const std::string &text);
     std::string serialize_config(const Config& config);
     std::string serialize_config(const Config::External& external_config);
 }
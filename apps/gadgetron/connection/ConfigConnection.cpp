@@ -2,7 +2,9 @@
 #include "ConfigConnection.h"
 
 #include <map>
+#include <chrono>
 #include <iostream>
+#include <iterator>
 
 #include "gadgetron_config.h"
 
@@ -34,8 +36,12 @@ namespace {
         explicit ConfigHandler(std::function<void(Config)> callback)
         : callback(std::move(callback)) {}
 
-        void handle_callback(std::istream &config_stream) {
-            callback(parse_config(config_stream));
+        void handle_callback(const std::string &config_text) {
+            auto start = std::chrono::steady_clock::now();
+            auto config = parse_config_cached(config_text);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            GDEBUG_STREAM("Config ready in " << elapsed.count() << " ms");
+            callback(std::move(config));
         }
 
     private:
@@ -55,7 +61,8 @@ namespace {
             GDEBUG_STREAM("Reading config file: " << filename);
 
             std::ifstream config_stream(filename.string());
-            handle_callback(config_stream);
+            if (!config_stream) throw std::runtime_error("Unable to open config file: " + filename.string());
+            handle_callback(std::string(std::istreambuf_iterator<char>(config_stream), {}));
         }
 
     private:
@@ -68,8 +75,7 @@ namespace {
         : ConfigHandler(callback) {}
 
         void handle(std::istream &stream, Gadgetron::Core::OutputChannel& ) override {
-            std::stringstream config_stream(read_string_from_stream<uint32_t>(stream));
-            handle_callback(config_stream);
+            handle_callback(read_string_from_stream<uint32_t>(stream));
         }
     };
 
@@ -4,6 +4,23 @@
 #include "ConfigConnection.h"
 #include "Writers.h"
 
+#include "Telemetry.h"
+#include "hoMemoryPool.h"
+#include "hoNDFFT.h"
+#include "trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <boost/filesystem.hpp>
+
+#if _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
 namespace {
 
     using namespace Gadgetron::Core;
@@ -44,6 +61,30 @@ namespace {
         stream.write(reinterpret_cast<char *>(&close), sizeof(close));
     }
 
+    std::shared_ptr<Gadgetron::Trace::Session> trace_session(const StreamContext::Args &args) {
+        if (!args.count("trace_folder") || args["trace_folder"].as<std::string>().empty()) return nullptr;
+
+        static std::atomic<size_t> connections{0};
+        auto folder = boost::filesystem::path(args["trace_folder"].as<std::string>());
+        boost::filesystem::create_directories(folder);
+
+        // Connections are usually handled in forked processes, which all start from the same counter, so the
+        // process id keeps their names apart; the file is created exclusively, so no trace can replace another.
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        auto prefix = "gadgetron-trace-" + std::to_string(seconds) + "-" + std::to_string(getpid()) + "-";
+
+        for (int attempt = 0; attempt < 100; attempt++) {
+            auto filename = (folder / (prefix + std::to_string(++connections) + ".json")).string();
+            if (auto file = std::fopen(filename.c_str(), "wx")) {
+                std::fclose(file);
+                return std::make_shared<Gadgetron::Trace::Session>(filename);
+            }
+            if (!boost::filesystem::exists(filename)) break;
+        }
+        throw std::runtime_error("Unable to create a trace file in " + folder.string());
+    }
+
 }
 
 
@@ -58,6 +99,28 @@ namespace Gadgetron::Server::Connection {
         stream->exceptions(std::istream::failbit | std::istream::badbit | std::istream::eofbit);
         ErrorSender sender;
 
+        // Threads started through the ErrorHandler inherit the arena, so everything the connection caches goes with it.
+        bool use_arena = args.count("memory_pool") && args["memory_pool"].as<std::string>() == "connection";
+        auto arena = use_arena ? std::make_shared<hoMemoryPool::Arena>() : nullptr;
+        hoMemoryPool::ArenaScope arena_scope(arena);
+
+        // Likewise the trace session; the trace is written once the last thread of the connection lets go of it.
+        std::shared_ptr<Trace::Session> trace;
+        try {
+            trace = trace_session(args);
+        } catch (const std::exception &e) {
+            GWARN_STREAM("Unable to trace connection: " << e.what());
+        }
+        Trace::SessionScope trace_scope(trace);
+        Trace::name_thread("Connection Main Thread");
+
+        // The registry is per process, so the reporter is started here rather than in the server; with the server
+        // forking a process per connection, a reporter started before the fork would only ever see an empty registry.
+        auto telemetry_interval = args.count("telemetry_interval") ? args["telemetry_interval"].as<unsigned int>() : 0;
+        if (telemetry_interval) {
+            Gadgetron::Core::Telemetry::report_periodically(std::chrono::seconds(telemetry_interval));
+        }
+
         ErrorHandler error_handler(sender,"Connection Main Thread");
 
         error_handler.handle([&]() {
@@ -73,6 +136,17 @@ namespace Gadgetron::Server::Connection {
         }
         catch (...) {}
 
+        auto fft_plans = FFT::plan_cache_statistics();
+        GDEBUG_STREAM("FFT plan cache: " << fft_plans.hits << " hits, " << fft_plans.misses << " misses, "
+                                         << fft_plans.plans << " plans");
+
+        if (hoMemoryPool::enabled()) {
+            auto pool = arena ? arena->statistics() : hoMemoryPool::statistics();
+            GDEBUG_STREAM("Memory pool: " << pool.allocations << " allocations, " << pool.reused << " reused, "
+                                          << (pool.peak_bytes >> 20) << " MiB peak, "
+                                          << (pool.cached_bytes >> 20) << " MiB cached");
+        }
+
         GINFO_STREAM("Connection state: [FINISHED]");
     }
 
@@ -9,6 +9,8 @@
 #include "Writer.h"
 #include "Channel.h"
 #include "Context.h"
+#include "hoMemoryPool.h"
+#include "trace.h"
 
 namespace Gadgetron::Server::Connection {
 
@@ -69,10 +71,15 @@ namespace Gadgetron::Server::Connection {
         template<class F, class... ARGS>
         std::thread run(F fn, ARGS &&... args) {
             return std::thread(
-                    []( auto handler, auto fn, auto &&... iargs) {
+                    []( auto handler, auto arena, auto trace, auto fn, auto &&... iargs) {
+                        hoMemoryPool::ArenaScope arena_scope(std::move(arena));
+                        Trace::SessionScope trace_scope(std::move(trace));
+                        Trace::name_thread(handler.location);
                         handler.handle(fn, std::forward<ARGS>(iargs)...);
                     },
                     *this,
+                    hoMemoryPool::current_arena(),
+                    Trace::current_session(),
                     std::forward<F>(fn),
                     std::forward<ARGS>(args)...
             );
@@ -6,10 +6,12 @@
 
 #include "io/primitives.h"
 #include "Response.h"
+#include "Telemetry.h"
 
 namespace {
 
     using namespace Gadgetron::Server;
+    using namespace Gadgetron::Core;
 
     std::string gadgetron_info() {
         std::stringstream stream;
@@ -54,6 +56,8 @@ namespace {
         answers["gadgetron::cuda::runtime"]      = Info::CUDA::cuda_runtime_version;
         answers["gadgetron::cuda::memory"]       = cuda_memory;
         answers["gadgetron::cuda::capabilities"] = cuda_capabilities;
+        answers["gadgetron::telemetry"]          = []() { return Telemetry::Registry::instance().json(); };
+        answers["gadgetron::telemetry::summary"] = []() { return Telemetry::Registry::instance().summary(); };
     }
 }
 
@@ -1,21 +1,26 @@
 #include "Loader.h"
 
 #include <memory>
+#include <mutex>
 
 #include "stream/Stream.h"
 
 namespace {
     using namespace Gadgetron::Core;
+    using namespace Gadgetron::Server::Connection;
 
     using reader_factory = std::unique_ptr<Reader>();
     using writer_factory = std::unique_ptr<Writer>();
-}
 
-namespace Gadgetron::Server::Connection {
+    // Libraries are opened once per process, and kept open; reopening them is a large part of setting up a stream.
+    boost::dll::shared_library shared_library(const std::string &shared_library_name) {
+        static std::mutex mutex;
+        static std::map<std::string, boost::dll::shared_library> libraries;
 
-    Loader::Loader(const StreamContext &context) : context(context) {}
+        std::lock_guard<std::mutex> guard(mutex);
+        auto cached = libraries.find(shared_library_name);
+        if (cached != libraries.end()) return cached->second;
 
-    boost::dll::shared_library Loader::load_library(const std::string &shared_library_name) {
         auto lib = boost::dll::shared_library(
                 shared_library_name,
                 boost::dll::load_mode::append_decorations |
@@ -23,10 +28,98 @@ namespace Gadgetron::Server::Connection {
                 boost::dll::load_mode::search_system_folders
         );
 
+        libraries.emplace(shared_library_name, lib);
+        return lib;
+    }
+
+    template<class CONFIG>
+    void preload_all(const std::vector<CONFIG> &configs) {
+        for (auto &config : configs) shared_library(config.dll);
+    }
+
+    void preload(const Config::Gadget &gadget) { shared_library(gadget.dll); }
+
+    void preload(const Config::Stream &stream);
+
+    void preload(const Config::PureStream &stream) {
+        preload_all(stream.gadgets);
+    }
+
+    void preload(const Config::External &external) {
+        preload_all(external.readers);
+        preload_all(external.writers);
+    }
+
+    void preload(const Config::Parallel &parallel) {
+        preload(parallel.branch);
+        preload(parallel.merge);
+        for (auto &stream : parallel.streams) preload(stream);
+    }
+
+    void preload(const Config::Distributed &distributed) {
+        preload_all(distributed.readers);
+        preload_all(distributed.writers);
+        preload(distributed.distributor);
+        preload(distributed.stream);
+    }
+
+    void preload(const Config::ParallelProcess &parallel_process) {
+        preload(parallel_process.stream);
+    }
+
+    void preload(const Config::PureDistributed &pure_distributed) {
+        preload_all(pure_distributed.readers);
+        preload_all(pure_distributed.writers);
+        preload(pure_distributed.stream);
+    }
+
+    void preload(const Config::Stream &stream) {
+        for (auto &node : stream.nodes) Gadgetron::Core::visit([](auto &n) { preload(n); }, node);
+    }
+}
+
+namespace Gadgetron::Server::Connection {
+
+    Loader::Loader(const StreamContext &context) : context(context) {}
+
+    boost::dll::shared_library Loader::load_library(const std::string &shared_library_name) {
+        auto lib = shared_library(shared_library_name);
         libraries.push_back(lib);
         return lib;
     }
 
+    void Loader::preload(const Config &config) {
+        preload_all(default_readers());
+        preload_all(default_writers());
+        preload_all(config.readers);
+        preload_all(config.writers);
+        ::preload(config.stream);
+    }
+
+    const std::vector<Config::Reader> &Loader::default_readers() {
+        static const std::vector<Config::Reader> readers{
+                Config::Reader { "gadgetron_core_readers", "AcquisitionReader", Core::none },
+                Config::Reader { "gadgetron_core_readers", "WaveformReader", Core::none },
+                Config::Reader { "gadgetron_core_readers", "ImageReader", Core::none },
+                Config::Reader { "gadgetron_core_readers", "BufferReader", Core::none },
+                Config::Reader { "gadgetron_core_readers", "IsmrmrdImageArrayReader", Core::none },
+                Config::Reader { "gadgetron_core_readers", "AcquisitionBucketReader", Core::none }
+        };
+        return readers;
+    }
+
+    const std::vector<Config::Writer> &Loader::default_writers() {
+        static const std::vector<Config::Writer> writers{
+                Config::Writer { "gadgetron_mricore", "GadgetIsmrmrdAcquisitionMessageWriter" },
+                Config::Writer { "gadgetron_mricore", "GadgetIsmrmrdWaveformMessageWriter" },
+                Config::Writer { "gadgetron_core_writers", "ImageWriter" },
+                Config::Writer { "gadgetron_core_writers", "BufferWriter" },
+                Config::Writer { "gadgetron_core_writers", "IsmrmrdImageArrayWriter" },
+                Config::Writer { "gadgetron_core_writers", "AcquisitionBucketWriter" }
+        };
+        return writers;
+    }
+
     std::unique_ptr<Reader> Loader::load(const Config::Reader &conf) {
         auto factory = load_factory<reader_factory>("reader_factory_export_", conf.classname, conf.dll);
         return factory();
@@ -51,17 +51,7 @@ namespace Gadgetron::Server::Connection {
 
         template<class CONFIG>
         std::map<uint16_t, std::unique_ptr<Reader>> load_default_and_additional_readers(CONFIG config) {
-
-            static const std::vector<Config::Reader> default_readers{
-                    Config::Reader { "gadgetron_core_readers", "AcquisitionReader", Core::none },
-                    Config::Reader { "gadgetron_core_readers", "WaveformReader", Core::none },
-                    Config::Reader { "gadgetron_core_readers", "ImageReader", Core::none },
-                    Config::Reader { "gadgetron_core_readers", "BufferReader", Core::none },
-                    Config::Reader { "gadgetron_core_readers", "IsmrmrdImageArrayReader", Core::none },
-                    Config::Reader { "gadgetron_core_readers", "AcquisitionBucketReader", Core::none }
-            };
-
-            auto configs = default_readers;
+            auto configs = default_readers();
             configs.insert(configs.end(), config.readers.begin(), config.readers.end());
             return load_readers(configs);
         }
@@ -73,22 +63,22 @@ namespace Gadgetron::Server::Connection {
 
         template<class CONFIG>
         std::vector<std::unique_ptr<Writer>> load_default_and_additional_writers(CONFIG config) {
-
-            static const std::vector<Config::Writer> default_writers{
-                    Config::Writer { "gadgetron_mricore", "GadgetIsmrmrdAcquisitionMessageWriter" },
-                    Config::Writer { "gadgetron_mricore", "GadgetIsmrmrdWaveformMessageWriter" },
-                    Config::Writer { "gadgetron_core_writers", "ImageWriter" },
-                    Config::Writer { "gadgetron_core_writers", "BufferWriter" },
-                    Config::Writer { "gadgetron_core_writers", "IsmrmrdImageArrayWriter" },
-                    Config::Writer { "gadgetron_core_writers", "AcquisitionBucketWriter" }
-            };
-
-            auto configs = default_writers;
+            auto configs = default_writers();
             configs.insert(configs.begin(), config.writers.begin(), config.writers.end());
             return load_writers(configs);
         }
 
+        /**
+         * Loads every library the config refers to, so connections using it find them loaded. Libraries are
+         * cached for the lifetime of the process; a server which preloads before forking hands them to every
+         * connection it forks.
+         */
+        static void preload(const Config &config);
+
     private:
+        static const std::vector<Config::Reader> &default_readers();
+        static const std::vector<Config::Writer> &default_writers();
+
         boost::dll::shared_library load_library(const std::string &shared_library_name);
 
         const Core::StreamContext context;
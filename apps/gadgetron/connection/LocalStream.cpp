@@ -0,0 +1,401 @@
+#include "LocalStream.h"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Gadgetron::Connection;
+using local_socket = boost::asio::local::stream_protocol::socket;
+
+#if defined(__linux__)
+namespace {
+
+    constexpr uint64_t magic = 0x314C41434F4C5447; // "GTLOCAL1"
+
+    enum FrameKind : uint64_t { inline_frame = 0, shared_frame = 1 };
+
+    struct Frame {
+        uint64_t kind, length;
+    };
+
+    struct Hello {
+        uint64_t magic, capacity;
+    };
+
+    struct Control {
+        std::atomic<uint64_t> consumed;
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "The ring's control block must be lock free.");
+
+    std::system_error last_error(const std::string& what) {
+        return std::system_error(errno, std::generic_category(), what);
+    }
+
+    class Ring {
+    public:
+        Ring(int fd, size_t capacity) : fd(fd), capacity(capacity) {
+            mapping = mmap(nullptr, ring_data_offset + capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) {
+                auto error = last_error("Failed to map shared memory ring");
+                ::close(fd);
+                throw error;
+            }
+            control = static_cast<Control*>(mapping);
+            data    = static_cast<char*>(mapping) + ring_data_offset;
+        }
+
+        ~Ring() {
+            munmap(mapping, ring_data_offset + capacity);
+            ::close(fd);
+        }
+
+        static std::unique_ptr<Ring> create(size_t capacity) {
+            capacity = (capacity + ring_data_offset - 1) / ring_data_offset * ring_data_offset;
+
+            int fd = memfd_create("gadgetron-local-stream", MFD_CLOEXEC);
+            if (fd < 0) throw last_error("Failed to create shared memory ring");
+            if (ftruncate(fd, ring_data_offset + capacity) != 0) {
+                auto error = last_error("Failed to size shared memory ring");
+                ::close(fd);
+                throw error;
+            }
+            // A fresh memfd is zero filled, so nothing has been consumed.
+            return std::make_unique<Ring>(fd, capacity);
+        }
+
+        const int fd;
+        const size_t capacity;
+        Control* control;
+        char* data;
+
+    private:
+        void* mapping;
+    };
+
+    void send_hello(int socket, const Ring* ring) {
+        Hello hello{ magic, ring ? ring->capacity : 0 };
+        iovec iov{ &hello, sizeof(hello) };
+
+        msghdr message{};
+        message.msg_iov    = &iov;
+        message.msg_iovlen = 1;
+
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        if (ring) {
+            message.msg_control    = control;
+            message.msg_controllen = sizeof(control);
+
+            auto header        = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type  = SCM_RIGHTS;
+            header->cmsg_len   = CMSG_LEN(sizeof(int));
+            std::memcpy(CMSG_DATA(header), &ring->fd, sizeof(int));
+        }
+
+        if (sendmsg(socket, &message, MSG_NOSIGNAL) != ssize_t(sizeof(hello)))
+            throw last_error("Failed to send local stream hello");
+    }
+
+    std::unique_ptr<Ring> receive_hello(int socket) {
+        Hello hello{};
+        iovec iov{ &hello, sizeof(hello) };
+
+        msghdr message{};
+        message.msg_iov    = &iov;
+        message.msg_iovlen = 1;
+
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        message.msg_control    = control;
+        message.msg_controllen = sizeof(control);
+
+        auto received = recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+        if (received <= 0) throw last_error("Failed to receive local stream hello");
+
+        int fd = -1;
+        for (auto header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS)
+                std::memcpy(&fd, CMSG_DATA(header), sizeof(int));
+        }
+
+        auto close_and_throw = [&](const std::string& what) {
+            if (fd >= 0) ::close(fd);
+            throw std::runtime_error(what);
+        };
+
+        for (auto bytes = reinterpret_cast<char*>(&hello); received < ssize_t(sizeof(hello));) {
+            auto r = ::recv(socket, bytes + received, sizeof(hello) - received, 0);
+            if (r <= 0) close_and_throw("Local stream peer disconnected during hello");
+            received += r;
+        }
+
+        if (hello.magic != magic) close_and_throw("Local stream peer sent an invalid hello");
+        if (hello.capacity == 0) {
+            if (fd >= 0) ::close(fd);
+            return nullptr;
+        }
+        if (fd < 0) close_and_throw("Local stream peer announced a ring, but did not send it");
+
+        struct stat status {};
+        if (fstat(fd, &status) != 0 || size_t(status.st_size) < ring_data_offset + hello.capacity)
+            close_and_throw("Local stream peer sent a ring smaller than announced");
+
+        return std::make_unique<Ring>(fd, hello.capacity);
+    }
+
+    class LocalStreamBuf : public std::streambuf {
+    public:
+        LocalStreamBuf(std::unique_ptr<local_socket> socket, const LocalStreamOptions& options);
+
+    protected:
+        std::streamsize xsputn(const char_type* data, std::streamsize length) override;
+
+        int sync() override;
+        int underflow() override;
+        int overflow(int ch = traits_type::eof()) override;
+
+    private:
+        void send(size_t shared_length);
+        void wait_for_ring(size_t length);
+        void fill();
+        void read_raw(char* data, size_t length);
+
+        std::unique_ptr<local_socket> socket;
+        std::unique_ptr<Ring> outbound, inbound;
+        const size_t shared_write_size;
+
+        std::vector<char> input_buffer;
+        std::vector<char> output_buffer;
+        char *raw_begin, *raw_end;
+
+        uint64_t frame_kind    = inline_frame;
+        size_t frame_remaining = 0;
+        size_t exposed         = 0;
+
+        uint64_t produced = 0, consumed = 0;
+    };
+
+    LocalStreamBuf::LocalStreamBuf(std::unique_ptr<local_socket> socket, const LocalStreamOptions& options)
+        : socket(std::move(socket)), shared_write_size(std::max<size_t>(options.shared_write_size, 1)),
+          input_buffer(std::max<size_t>(options.buffer_size, sizeof(Frame))),
+          output_buffer(std::max<size_t>(options.buffer_size, 1)) {
+
+        if (options.ring_size) outbound = Ring::create(options.ring_size);
+
+        send_hello(this->socket->native_handle(), outbound.get());
+        inbound = receive_hello(this->socket->native_handle());
+
+        raw_begin = raw_end = input_buffer.data();
+        this->setg(raw_begin, raw_begin, raw_begin);
+        this->setp(output_buffer.data(), output_buffer.data() + output_buffer.size());
+    }
+
+    void LocalStreamBuf::fill() {
+        raw_begin = input_buffer.data();
+        raw_end   = raw_begin + socket->read_some(boost::asio::buffer(input_buffer));
+    }
+
+    void LocalStreamBuf::read_raw(char* data, size_t length) {
+        while (length) {
+            if (raw_begin == raw_end) fill();
+            auto available = std::min<size_t>(length, raw_end - raw_begin);
+            std::memcpy(data, raw_begin, available);
+            raw_begin += available;
+            data += available;
+            length -= available;
+        }
+    }
+
+    /*
+     * The get area is either a run of inline bytes in the input buffer, or a run of the peer's ring. Ring bytes are
+     * handed back to the peer once the get area has been consumed, which is when the next underflow happens.
+     */
+    int LocalStreamBuf::underflow() {
+        if (exposed) {
+            consumed += exposed;
+            inbound->control->consumed.store(consumed, std::memory_order_release);
+            exposed = 0;
+        }
+
+        while (frame_remaining == 0) {
+            Frame frame{};
+            read_raw(reinterpret_cast<char*>(&frame), sizeof(frame));
+            if (frame.kind != inline_frame && frame.kind != shared_frame)
+                throw std::runtime_error("Local stream peer sent an invalid frame");
+            if (frame.kind == shared_frame && !inbound)
+                throw std::runtime_error("Local stream peer sent a shared frame, but has no ring");
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            frame_kind      = frame.kind;
+            frame_remaining = frame.length;
+        }
+
+        if (frame_kind == inline_frame) {
+            if (raw_begin == raw_end) fill();
+            auto length = std::min<size_t>(frame_remaining, raw_end - raw_begin);
+            this->setg(raw_begin, raw_begin, raw_begin + length);
+            raw_begin += length;
+            frame_remaining -= length;
+        } else {
+            auto offset = consumed % inbound->capacity;
+            auto length = std::min<size_t>(frame_remaining, inbound->capacity - offset);
+            auto begin  = inbound->data + offset;
+            this->setg(begin, begin, begin + length);
+            exposed = length;
+            frame_remaining -= length;
+        }
+
+        return traits_type::to_int_type(*this->gptr());
+    }
+
+    /*
+     * Sends the buffered bytes as an inline frame, followed by a frame announcing shared_length bytes in the ring,
+     * in a single write.
+     */
+    void LocalStreamBuf::send(size_t shared_length) {
+        auto buffered = size_t(this->pptr() - this->pbase());
+        Frame inline_header{ inline_frame, buffered };
+        Frame shared_header{ shared_frame, shared_length };
+
+        std::array<boost::asio::const_buffer, 3> buffers;
+        size_t count = 0;
+        if (buffered) {
+            buffers[count++] = boost::asio::buffer(&inline_header, sizeof(inline_header));
+            buffers[count++] = boost::asio::buffer(this->pbase(), buffered);
+        }
+        if (shared_length) buffers[count++] = boost::asio::buffer(&shared_header, sizeof(shared_header));
+        if (!count) return;
+
+        boost::asio::write(*socket, std::vector<boost::asio::const_buffer>(buffers.begin(), buffers.begin() + count));
+        this->setp(output_buffer.data(), output_buffer.data() + output_buffer.size());
+    }
+
+    int LocalStreamBuf::sync() {
+        send(0);
+        return 0;
+    }
+
+    int LocalStreamBuf::overflow(int ch) {
+        send(0);
+        if (ch != traits_type::eof()) {
+            *this->pptr() = traits_type::to_char_type(ch);
+            this->pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    /*
+     * Waits for the peer to consume enough of the ring. A full ring means the peer is behind, like a full socket
+     * buffer would; but unlike a socket write, the wait needs to notice if the peer goes away.
+     */
+    void LocalStreamBuf::wait_for_ring(size_t length) {
+        auto available = [&]() {
+            return outbound->capacity - (produced - outbound->control->consumed.load(std::memory_order_acquire));
+        };
+
+        for (size_t round = 0; available() < length; round++) {
+            if (round < 128) {
+                std::this_thread::yield();
+                continue;
+            }
+            pollfd descriptor{ socket->native_handle(), POLLRDHUP, 0 };
+            if (::poll(&descriptor, 1, 1) > 0 && (descriptor.revents & (POLLRDHUP | POLLHUP | POLLERR)))
+                throw std::runtime_error("Local stream peer disconnected");
+        }
+    }
+
+    std::streamsize LocalStreamBuf::xsputn(const char_type* data, std::streamsize length) {
+        if (!outbound || size_t(length) < shared_write_size) return std::streambuf::xsputn(data, length);
+
+        for (auto remaining = size_t(length); remaining;) {
+            auto chunk = std::min<size_t>(remaining, outbound->capacity / 2);
+            wait_for_ring(chunk);
+
+            auto offset = produced % outbound->capacity;
+            auto first  = std::min<size_t>(chunk, outbound->capacity - offset);
+            std::memcpy(outbound->data + offset, data, first);
+            std::memcpy(outbound->data, data + first, chunk - first);
+            produced += chunk;
+
+            std::atomic_thread_fence(std::memory_order_release);
+            send(chunk);
+
+            data += chunk;
+            remaining -= chunk;
+        }
+        return length;
+    }
+
+    class LocalStream : public std::iostream {
+    public:
+        LocalStream(std::unique_ptr<local_socket> socket, const LocalStreamOptions& options,
+            std::shared_ptr<boost::asio::io_service> io_service = nullptr)
+            : std::iostream(new LocalStreamBuf(std::move(socket), options)), io_service(std::move(io_service)) {
+            buffer = std::unique_ptr<LocalStreamBuf>(static_cast<LocalStreamBuf*>(this->rdbuf()));
+        }
+
+    private:
+        std::shared_ptr<boost::asio::io_service> io_service;
+        std::unique_ptr<LocalStreamBuf> buffer;
+    };
+}
+
+bool Gadgetron::Connection::local_streams_supported() noexcept {
+    return true;
+}
+
+bool Gadgetron::Connection::local_peer_is_same_user(const local_socket& socket) noexcept {
+    ucred credentials{};
+    socklen_t length = sizeof(credentials);
+    auto fd = const_cast<local_socket&>(socket).native_handle();
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) return false;
+    return credentials.uid == geteuid();
+}
+
+std::unique_ptr<std::iostream> Gadgetron::Connection::stream_from_local_socket(
+    std::unique_ptr<local_socket> socket, const LocalStreamOptions& options) {
+    return std::make_unique<LocalStream>(std::move(socket), options);
+}
+
+std::unique_ptr<std::iostream> Gadgetron::Connection::local_stream(
+    const std::string& path, const LocalStreamOptions& options) {
+    auto io_service = std::make_shared<boost::asio::io_service>();
+    auto socket     = std::make_unique<local_socket>(*io_service);
+    socket->connect(boost::asio::local::stream_protocol::endpoint(path));
+    return std::make_unique<LocalStream>(std::move(socket), options, io_service);
+}
+
+#else
+
+bool Gadgetron::Connection::local_streams_supported() noexcept {
+    return false;
+}
+
+bool Gadgetron::Connection::local_peer_is_same_user(const local_socket&) noexcept {
+    return false;
+}
+
+std::unique_ptr<std::iostream> Gadgetron::Connection::stream_from_local_socket(
+    std::unique_ptr<local_socket>, const LocalStreamOptions&) {
+    throw std::runtime_error("Local streams are not supported on this platform");
+}
+
+std::unique_ptr<std::iostream> Gadgetron::Connection::local_stream(const std::string&, const LocalStreamOptions&) {
+    throw std::runtime_error("Local streams are not supported on this platform");
+}
+
+#endif
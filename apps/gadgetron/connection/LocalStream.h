@@ -0,0 +1,50 @@
+#pragma once
+#include <boost/asio/local/stream_protocol.hpp>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace Gadgetron::Connection {
+
+    /**
+     * Streams between processes on the same host. Bytes go over a Unix domain socket, except large writes (array
+     * payloads), which are copied into a shared memory ring and only announced on the socket. That replaces two
+     * copies through kernel socket buffers, and many small socket writes, with one copy into the ring and one out.
+     *
+     * The protocol, for peers in other languages: each side starts by sending a hello
+     *
+     *      uint64 magic ("GTLOCAL1"), uint64 ring capacity
+     *
+     * with the file descriptor of its ring (a memfd) attached via SCM_RIGHTS, unless the capacity is 0. A side
+     * that sent capacity 0 sends everything inline. After the hello, the socket carries frames
+     *
+     *      uint64 kind, uint64 length
+     *
+     * Kind 0 (inline) is followed by length bytes of the stream on the socket. Kind 1 (shared) means the next
+     * length bytes of the stream are in the sender's ring, starting at the position the receiver has reached.
+     * The ring file starts with a 64 byte control block, whose first field is the uint64 number of bytes the
+     * receiver has consumed, written by the receiver; the ring's data starts at ring_data_offset. Positions wrap
+     * modulo the capacity, and the sender never has more than the capacity outstanding.
+     *
+     * Writes are buffered until flushed, or until a large write goes through the ring. Only available on Linux.
+     */
+    struct LocalStreamOptions {
+        /// Capacity in bytes of this side's ring. 0 sends everything on the socket.
+        size_t ring_size = 32u << 20;
+        /// Writes of at least this many bytes go through the ring.
+        size_t shared_write_size = 64u << 10;
+        /// Size in bytes of the userspace buffer in each direction.
+        size_t buffer_size = 64u << 10;
+    };
+
+    constexpr size_t ring_data_offset = 4096;
+
+    bool local_streams_supported() noexcept;
+
+    /// Whether the process at the other end of a connected socket runs as the same user as this one (SO_PEERCRED).
+    bool local_peer_is_same_user(const boost::asio::local::stream_protocol::socket& socket) noexcept;
+
+    std::unique_ptr<std::iostream> stream_from_local_socket(
+        std::unique_ptr<boost::asio::local::stream_protocol::socket> socket, const LocalStreamOptions& options = {});
+    std::unique_ptr<std::iostream> local_stream(const std::string& path, const LocalStreamOptions& options = {});
+}
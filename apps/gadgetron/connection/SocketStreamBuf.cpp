@@ -7,23 +7,32 @@
 #include "Types.h"
 
 #include <boost/asio.hpp>
+
+#include <algorithm>
+
 namespace {
     using boost::asio::ip::tcp;
+    using Gadgetron::Connection::SocketOptions;
 
     std::unique_ptr<tcp::socket> connect_socket(
-        const std::string& host, const std::string& service, boost::asio::io_service& context) {
+        const std::string& host, const std::string& service, boost::asio::io_service& context,
+        const SocketOptions& options) {
         tcp::resolver resolver{ context };
         auto endpoint = *resolver.resolve(tcp::resolver::query(host, service));
         auto socket   = std::make_unique<tcp::socket>(context);
+        // Kernel buffer sizes need to be in place before connecting to affect the TCP window.
+        socket->open(endpoint.endpoint().protocol());
+        Gadgetron::Connection::apply_socket_options(*socket, options);
         socket->connect(endpoint);
         return std::move(socket);
     }
 
     class SocketStreamBuf : public std::streambuf {
     public:
-        explicit SocketStreamBuf(std::unique_ptr<boost::asio::ip::tcp::socket> socket, size_t buffer_size = 1024);
+        explicit SocketStreamBuf(std::unique_ptr<boost::asio::ip::tcp::socket> socket, const SocketOptions& options = {});
 
     protected:
+        std::streamsize xsgetn(char_type* data, std::streamsize length) override;
         std::streamsize xsputn(const char_type* data, std::streamsize length) override;
 
         int sync() override;
@@ -34,6 +43,7 @@ namespace {
         std::unique_ptr<boost::asio::ip::tcp::socket> socket;
         std::vector<char> input_buffer;
         std::vector<char> output_buffer;
+        const std::streamsize direct_read_size;
 
         /* Other members */
     };
@@ -48,6 +58,22 @@ namespace {
         this->setg(this->eback(), this->eback(), this->eback() + elements_read);
         return traits_type::to_int_type(*this->gptr());
     }
+    /*
+     * Large reads (such as acquisition payloads) are served from whatever is already buffered, and the remainder is
+     * read straight from the socket into the destination, rather than being staged through the input buffer.
+     */
+    std::streamsize SocketStreamBuf::xsgetn(char_type* data, std::streamsize length) {
+        auto buffered = std::min<std::streamsize>(length, this->egptr() - this->gptr());
+        std::copy_n(this->gptr(), buffered, data);
+        this->gbump(static_cast<int>(buffered));
+
+        auto remaining = length - buffered;
+        if (remaining == 0) return length;
+        if (remaining < direct_read_size) return buffered + std::streambuf::xsgetn(data + buffered, remaining);
+
+        return buffered + boost::asio::read(*socket, boost::asio::buffer(data + buffered, remaining));
+    }
+
     int SocketStreamBuf::overflow(int ch) {
         if (this->pptr() != this->pbase()) {
             boost::asio::write(*socket, boost::asio::buffer(this->pbase(), std::distance(this->pbase(), this->pptr())));
@@ -64,8 +90,10 @@ namespace {
         this->overflow();
         return boost::asio::write(*socket, boost::asio::buffer(data, length));
     }
-    SocketStreamBuf::SocketStreamBuf(std::unique_ptr<boost::asio::ip::tcp::socket> socket, size_t buffer_size)
-        : socket(std::move(socket)), input_buffer(buffer_size), output_buffer(buffer_size) {
+    SocketStreamBuf::SocketStreamBuf(std::unique_ptr<boost::asio::ip::tcp::socket> socket, const SocketOptions& options)
+        : socket(std::move(socket)), input_buffer(options.buffer_size), output_buffer(options.buffer_size),
+          direct_read_size(std::max<size_t>(options.direct_read_size, 1)) {
+        auto buffer_size = options.buffer_size;
         this->setg(input_buffer.data(), input_buffer.data() + buffer_size, input_buffer.data() + buffer_size);
         this->setp(output_buffer.data(), output_buffer.data() + buffer_size);
     }
@@ -73,14 +101,14 @@ namespace {
     using namespace Gadgetron::Connection;
     class SocketStream : public std::iostream {
     public:
-        explicit SocketStream(std::unique_ptr<boost::asio::ip::tcp::socket> socket)
-            : std::iostream(new SocketStreamBuf(std::move(socket))) {
+        explicit SocketStream(std::unique_ptr<boost::asio::ip::tcp::socket> socket, const SocketOptions& options = {})
+            : std::iostream(new SocketStreamBuf(std::move(socket), options)) {
             buffer = std::unique_ptr<SocketStreamBuf>(static_cast<SocketStreamBuf*>(this->rdbuf()));
         }
 
-        SocketStream(const std::string& host, const std::string& service,
+        SocketStream(const std::string& host, const std::string& service, const SocketOptions& options,
             std::shared_ptr<boost::asio::io_service> io_service = std::make_shared<boost::asio::io_service>())
-            : SocketStream(connect_socket(host, service, *io_service)) {
+            : SocketStream(connect_socket(host, service, *io_service, options), options) {
             this->io_service = io_service;
         }
 
@@ -93,12 +121,33 @@ namespace {
 }
 
 
+Gadgetron::Connection::SocketOptions Gadgetron::Connection::SocketOptions::ingest() {
+    SocketOptions options;
+    options.buffer_size         = 1u << 20;
+    options.direct_read_size    = 64u << 10;
+    options.receive_buffer_size = 8 << 20;
+    options.send_buffer_size    = 8 << 20;
+    options.no_delay            = true;
+    return options;
+}
+
+void Gadgetron::Connection::apply_socket_options(boost::asio::ip::tcp::socket& socket, const SocketOptions& options) {
+    // The kernel may clamp buffer sizes (net.core.rmem_max), so failing to get the requested size is not an error.
+    if (options.receive_buffer_size > 0)
+        socket.set_option(boost::asio::socket_base::receive_buffer_size(options.receive_buffer_size));
+    if (options.send_buffer_size > 0)
+        socket.set_option(boost::asio::socket_base::send_buffer_size(options.send_buffer_size));
+    if (options.no_delay)
+        socket.set_option(tcp::no_delay(true));
+}
+
 std::unique_ptr<std::iostream> Gadgetron::Connection::stream_from_socket(
-    std::unique_ptr<boost::asio::ip::tcp::socket> socket) {
-    return std::make_unique<SocketStream>(std::move(socket));
+    std::unique_ptr<boost::asio::ip::tcp::socket> socket, const SocketOptions& options) {
+    apply_socket_options(*socket, options);
+    return std::make_unique<SocketStream>(std::move(socket), options);
 }
 
 std::unique_ptr<std::iostream> Gadgetron::Connection::remote_stream(
-    const std::string& host, const std::string& service) {
-    return std::make_unique<SocketStream>(host, service);
+    const std::string& host, const std::string& service, const SocketOptions& options) {
+    return std::make_unique<SocketStream>(host, service, options);
 }
@@ -1,10 +1,32 @@
-
 #pragma once
 #include <boost/asio/ip/tcp.hpp>
 #include <iostream>
 
 namespace Gadgetron::Connection {
 
-    std::unique_ptr<std::iostream> stream_from_socket(std::unique_ptr<boost::asio::ip::tcp::socket> socket);
-    std::unique_ptr<std::iostream> remote_stream(const std::string & host, const std::string& service);
-}
\ No newline at end of file
+    /**
+     * Tuning of the sockets and stream buffers backing a connection. The defaults keep small userspace buffers and
+     * the system's socket settings.
+     */
+    struct SocketOptions {
+        /// Size in bytes of the userspace buffer in each direction.
+        size_t buffer_size = 1024;
+        /// Reads of at least this many bytes bypass the input buffer and land directly in the caller's storage.
+        size_t direct_read_size = 1024;
+        /// Kernel receive and send buffer sizes (SO_RCVBUF, SO_SNDBUF) in bytes. 0 keeps the system default.
+        int receive_buffer_size = 0;
+        int send_buffer_size = 0;
+        /// Disables Nagle's algorithm (TCP_NODELAY).
+        bool no_delay = false;
+
+        /// Options for connections receiving raw data at scanner rates: MB-sized buffers, fewer system calls.
+        static SocketOptions ingest();
+    };
+
+    void apply_socket_options(boost::asio::ip::tcp::socket& socket, const SocketOptions& options);
+
+    std::unique_ptr<std::iostream> stream_from_socket(std::unique_ptr<boost::asio::ip::tcp::socket> socket,
+                                                      const SocketOptions& options = {});
+    std::unique_ptr<std::iostream> remote_stream(const std::string & host, const std::string& service,
+                                                 const SocketOptions& options = {});
+}
@@ -1,4 +1,5 @@
 
+#include <chrono>
 #include <memory>
 
 #include "StreamConnection.h"
@@ -74,6 +75,7 @@ namespace Gadgetron::Server::Connection::StreamConnection {
     ) {
         GINFO_STREAM("Connection state: [STREAM]");
 
+        auto setup_start = std::chrono::steady_clock::now();
         Loader loader{context};
 
         auto ichannel = make_channel<MessageChannel>();
@@ -83,6 +85,9 @@ namespace Gadgetron::Server::Connection::StreamConnection {
         auto readers = loader.load_readers(config);
         auto writers = loader.load_writers(config);
 
+        std::chrono::duration<double, std::milli> setup_time = std::chrono::steady_clock::now() - setup_start;
+        GINFO_STREAM("Stream setup took " << setup_time.count() << " ms");
+
         std::thread input_thread = start_input_thread(
                 stream,
                 std::move(ichannel.output),
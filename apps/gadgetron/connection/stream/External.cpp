@@ -1,6 +1,7 @@
 #include "External.h"
 
 #include "connection/Config.h"
+#include "connection/LocalStream.h"
 #include "connection/SocketStreamBuf.h"
 #include "connection/stream/common/Closer.h"
 #include "connection/stream/common/ExternalChannel.h"
@@ -8,8 +9,8 @@
 #include "external/Python.h"
 #include "external/Matlab.h"
 
-#include <boost/asio/use_future.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
 #include "system_info.h"
 
 using namespace Gadgetron::Core;
@@ -17,14 +18,38 @@ using namespace Gadgetron::Server::Connection;
 using namespace Gadgetron::Server::Connection::Stream;
 
 using tcp = boost::asio::ip::tcp;
+using local = boost::asio::local::stream_protocol;
 
 namespace {
 
-    const std::map<std::string, std::function<boost::process::child(const Config::Execute &, unsigned short, const Context &)>> modules{
+    using Module = boost::process::child(const Config::Execute &, unsigned short, boost::process::environment, const Context &);
+
+    const std::map<std::string, std::function<Module>> modules{
             {"python", start_python_module},
             {"matlab", start_matlab_module}
     };
 
+    // Modules that support the local transport connect to this socket instead of the TCP port. The transport is
+    // experimental: it is only offered with the external_local_transport option, and no module shipped with the
+    // Gadgetron implements it yet (the protocol is described in LocalStream.h).
+    const std::string local_socket_variable = "GADGETRON_EXTERNAL_LOCAL_SOCKET";
+
+    std::shared_ptr<local::acceptor> open_local_acceptor(boost::asio::io_service &io_service) {
+        if (!Gadgetron::Connection::local_streams_supported()) return nullptr;
+
+        auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gadgetron-%%%%-%%%%-%%%%.sock");
+        try {
+            auto acceptor = std::make_shared<local::acceptor>(io_service, local::endpoint(path.string()));
+            // Only our own user may connect; peers are checked again when they do.
+            boost::filesystem::permissions(path, boost::filesystem::owner_read | boost::filesystem::owner_write);
+            return acceptor;
+        }
+        catch (const std::exception &e) {
+            GDEBUG_STREAM("Local transport for external modules unavailable; using TCP only: " << e.what());
+            return nullptr;
+        }
+    }
+
     void process_input(GenericInputChannel input, std::shared_ptr<ExternalChannel> external) {
         auto closer = make_closer(external);
         for (auto message : input) {
@@ -43,10 +68,14 @@ namespace Gadgetron::Server::Connection::Stream {
 
     void External::monitor_child(
             std::shared_ptr<boost::process::child> child,
-            std::shared_ptr<tcp::acceptor> acceptor
+            std::shared_ptr<tcp::acceptor> acceptor,
+            std::shared_ptr<local::acceptor> local_acceptor
     ) {
         child->wait();
-        io_service.dispatch([=]() { acceptor->close(); });
+        io_service.dispatch([=]() {
+            acceptor->close();
+            if (local_acceptor) local_acceptor->close();
+        });
     }
 
     std::shared_ptr<ExternalChannel> External::open_connection(Config::Connect connect, const Context &context) {
@@ -62,30 +91,70 @@ namespace Gadgetron::Server::Connection::Stream {
 
         tcp::endpoint endpoint(Info::tcp_protocol(), 0);
         auto acceptor = std::make_shared<tcp::acceptor>(io_service, endpoint);
+        auto local_acceptor = local_transport ? open_local_acceptor(io_service) : nullptr;
+        auto local_path = local_acceptor ? local_acceptor->local_endpoint().path() : std::string();
 
         auto port = acceptor->local_endpoint().port();
         boost::algorithm::to_lower(execute.type);
 
+        boost::process::environment environment = boost::this_process::environment();
+        if (local_acceptor) environment[local_socket_variable] = local_path;
+
         GINFO_STREAM("Waiting for external module '" << execute.name << "' on port: " << port);
 
-        auto child = std::make_shared<boost::process::child>(modules.at(execute.type)(execute, port, context));
+        auto child = std::make_shared<boost::process::child>(modules.at(execute.type)(execute, port, environment, context));
 
         monitors.child = std::async(
                 std::launch::async,
-                [=](auto child, auto acceptor) { monitor_child(std::move(child), std::move(acceptor)); },
+                [=](auto child, auto acceptor, auto local_acceptor) {
+                    monitor_child(std::move(child), std::move(acceptor), std::move(local_acceptor));
+                },
                 child,
-                acceptor
+                acceptor,
+                local_acceptor
         );
 
+        // The module connects on whichever transport it supports; the first connection wins.
+        std::unique_ptr<std::iostream> stream;
+        std::string transport;
+
         auto socket = std::make_unique<tcp::socket>(io_service);
-        auto future_socket = acceptor->async_accept(*socket, boost::asio::use_future);
+        acceptor->async_accept(*socket, [&](const boost::system::error_code &error) {
+            if (error || stream) return;
+            if (local_acceptor) local_acceptor->close();
+            stream = Gadgetron::Connection::stream_from_socket(std::move(socket));
+            transport = "port: " + std::to_string(port);
+        });
+
+        // Connections on the local socket from processes of other users are turned away, and do not end the wait.
+        std::unique_ptr<local::socket> local_socket;
+        std::function<void()> accept_local = [&]() {
+            local_socket = std::make_unique<local::socket>(io_service);
+            local_acceptor->async_accept(*local_socket, [&](const boost::system::error_code &error) {
+                if (error || stream) return;
+                if (!Gadgetron::Connection::local_peer_is_same_user(*local_socket)) {
+                    GWARN_STREAM("Rejected a connection on the local socket of external module '" << execute.name
+                                 << "' from a process of another user");
+                    return accept_local();
+                }
+                acceptor->close();
+                stream = Gadgetron::Connection::stream_from_local_socket(std::move(local_socket));
+                transport = "local socket (shared memory)";
+            });
+        };
+        if (local_acceptor) accept_local();
 
         io_service.run();
-        future_socket.get();
 
-        GINFO_STREAM("Connected to external module '" << execute.name << "' on port: " << port);
+        if (local_acceptor) {
+            boost::system::error_code ignored;
+            boost::filesystem::remove(local_path, ignored);
+        }
+
+        if (!stream) throw std::runtime_error("External module '" + execute.name + "' exited before connecting.");
+
+        GINFO_STREAM("Connected to external module '" << execute.name << "' on " << transport);
 
-        auto stream = Gadgetron::Connection::stream_from_socket(std::move(socket));
         auto external_channel = std::make_shared<ExternalChannel>(
                 std::move(stream),
                 serialization,
@@ -116,7 +185,9 @@ namespace Gadgetron::Server::Connection::Stream {
         configuration(std::make_shared<Configuration>(
                 context,
                 config
-        )) {
+        )),
+        local_transport(context.args.count("external_local_transport") &&
+                        context.args.at("external_local_transport").as<bool>()) {
         channel = std::async(
                 std::launch::async,
                 [=](auto config, auto context) { return open_external_channel(config, context); },
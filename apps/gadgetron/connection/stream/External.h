@@ -40,11 +40,16 @@ namespace Gadgetron::Server::Connection::Stream {
         std::shared_ptr<ExternalChannel> open_connection(Config::Connect, const Core::Context &);
         std::shared_ptr<ExternalChannel> open_external_channel(const Config::External &, const Core::Context &);
 
-        void monitor_child(std::shared_ptr<boost::process::child>, std::shared_ptr<boost::asio::ip::tcp::acceptor>);
+        void monitor_child(
+                std::shared_ptr<boost::process::child>,
+                std::shared_ptr<boost::asio::ip::tcp::acceptor>,
+                std::shared_ptr<boost::asio::local::stream_protocol::acceptor>
+        );
 
         std::future<std::shared_ptr<ExternalChannel>> channel;
         std::shared_ptr<Serialization> serialization;
         std::shared_ptr<Configuration> configuration;
+        const bool local_transport;
 
         boost::asio::io_service io_service;
 
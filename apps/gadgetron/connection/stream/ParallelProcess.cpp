@@ -1,60 +1,89 @@
 #include "ParallelProcess.h"
 
+#include "ParallelWindow.h"
 #include "ThreadPool.h"
+#include "hoMemoryPool.h"
+#include "trace.h"
 
 using namespace Gadgetron::Core;
 
 namespace Gadgetron::Server::Connection::Stream {
 
-    void ParallelProcess::process_input(GenericInputChannel input, Queue &queue) {
-
-        ThreadPool pool(workers ? workers : std::thread::hardware_concurrency());
-
-        for (auto message : input) {
-            queue.push(
-                pool.async(
-                        [&](auto message) { return pureStream.process_function(std::move(message)); },
-                        std::move(message)
-                )
-            );
+    void ParallelProcess::process_input(GenericInputChannel input, std::shared_ptr<ParallelWindow> window) {
+
+        auto &pool = default_thread_pool();
+        auto arena = hoMemoryPool::current_arena();
+        auto trace = Gadgetron::Trace::current_session();
+
+        try {
+            for (auto message : input) {
+                auto bytes = message.bytes();
+                auto sequence = window->admit(bytes);
+
+                pool.submit(detail::Task([=, message = std::make_shared<Message>(std::move(message))]() {
+                    hoMemoryPool::ArenaScope arena_scope(arena);
+                    Gadgetron::Trace::SessionScope trace_scope(trace);
+                    try {
+                        window->complete(sequence, bytes, pureStream.process_function(std::move(*message)), nullptr);
+                    }
+                    catch (...) {
+                        window->complete(sequence, bytes, none, std::current_exception());
+                    }
+                }));
+            }
+        }
+        catch (...) {
+            window->close();
+            throw;
         }
 
-        pool.join(); queue.close();
+        window->close();
     }
 
-    void ParallelProcess::process_output(OutputChannel output, Queue &queue) {
-        while(true) output.push_message(queue.pop().get());
+    void ParallelProcess::process_output(OutputChannel output, std::shared_ptr<ParallelWindow> window) {
+        try {
+            while(true) output.push_message(window->pop());
+        }
+        catch (...) {
+            window->abandon();
+            throw;
+        }
     }
 
     void ParallelProcess::process(GenericInputChannel input,
             OutputChannel output,
             ErrorHandler& error_handler
     ) {
-        Queue queue;
+        auto running = workers ? workers : default_thread_pool().size();
+        auto window = std::make_shared<ParallelWindow>(max_in_flight ? max_in_flight : 2 * running, running, ordered);
 
         auto input_thread = error_handler.run(
-                [&](auto input) { this->process_input(std::move(input), queue); },
+                [&](auto input) { this->process_input(std::move(input), window); },
                 std::move(input)
         );
 
         auto output_thread = error_handler.run(
-                [&](auto output) { this->process_output(std::move(output), queue); },
+                [&](auto output) { this->process_output(std::move(output), window); },
                 std::move(output)
         );
 
         input_thread.join(); output_thread.join();
+        window->drain();
+
+        GINFO_STREAM("ParallelProcess: " << window->summary());
     }
 
     ParallelProcess::ParallelProcess(
             const Config::ParallelProcess& conf,
             const Context& context,
             Loader& loader
-    ) : pureStream{ conf.stream, context, loader }, workers{ conf.workers } {}
+    ) : pureStream{ conf.stream, context, loader },
+        workers{ conf.workers },
+        max_in_flight{ conf.max_in_flight },
+        ordered{ conf.ordered } {}
 
     const std::string& ParallelProcess::name() {
         const static std::string n = "ParallelProcess";
         return n;
     }
 }
-
-
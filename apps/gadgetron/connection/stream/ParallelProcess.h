@@ -2,9 +2,17 @@
 
 #include "PureStream.h"
 #include "connection/stream/Processable.h"
-#include <future>
 
 namespace Gadgetron::Server::Connection::Stream {
+
+    class ParallelWindow;
+
+    /**
+     * Runs a PureStream on the server-wide thread pool, on up to 'workers' items at a time. At most max_in_flight
+     * items are held between input and output; input is not taken from the channel beyond that, so a slow stream
+     * holds back its producer instead of buffering everything it sends. Output is in input order, unless ordered
+     * is false, in which case each result is passed on as soon as it is done.
+     */
     class ParallelProcess : public Processable {
 
     public:
@@ -12,13 +20,12 @@ namespace Gadgetron::Server::Connection::Stream {
         void process(Core::GenericInputChannel input, Core::OutputChannel output, ErrorHandler& error_handler) override;
         const std::string& name() override;
     private:
-
-        using Queue = Core::MPMCChannel<std::future<Core::Message>>;
-
-        void process_input(Core::GenericInputChannel input, Queue &queue);
-        void process_output(Core::OutputChannel output, Queue &queue);
+        void process_input(Core::GenericInputChannel input, std::shared_ptr<ParallelWindow> window);
+        void process_output(Core::OutputChannel output, std::shared_ptr<ParallelWindow> window);
 
         const size_t workers;
+        const size_t max_in_flight;
+        const bool ordered;
         const PureStream pureStream;
     };
 }
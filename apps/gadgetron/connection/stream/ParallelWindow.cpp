@@ -0,0 +1,94 @@
+#include "ParallelWindow.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace Gadgetron::Core;
+
+namespace Gadgetron::Server::Connection::Stream {
+
+    ParallelWindow::ParallelWindow(size_t max_in_flight, size_t max_running, bool ordered)
+        : max_in_flight(max_in_flight), max_running(max_running), ordered(ordered) {}
+
+    size_t ParallelWindow::admit(size_t bytes) {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&]() { return abandoned || (in_flight < max_in_flight && running < max_running); });
+        if (abandoned) throw ChannelClosed();
+
+        in_flight++; running++;
+        held(bytes);
+        peak_in_flight_ = std::max(peak_in_flight_, in_flight);
+        return next_sequence++;
+    }
+
+    void ParallelWindow::complete(size_t sequence, size_t input_bytes, optional<Message> message,
+                                  std::exception_ptr error) {
+        std::lock_guard<std::mutex> guard(m);
+        auto bytes = message ? message->bytes() : 0;
+        running--;
+        released(input_bytes);
+        held(bytes);
+        results.emplace(sequence, Result{std::move(message), std::move(error), bytes});
+        cv.notify_all();
+    }
+
+    Message ParallelWindow::pop() {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&]() { return deliverable() || (closed && in_flight == 0); });
+        if (!deliverable()) throw ChannelClosed();
+
+        auto result = std::move(results.begin()->second);
+        next_delivery = results.begin()->first + 1;
+        results.erase(results.begin());
+        in_flight--;
+        released(result.bytes);
+        cv.notify_all();
+        lock.unlock();
+
+        if (result.error) std::rethrow_exception(result.error);
+        return std::move(*result.message);
+    }
+
+    void ParallelWindow::close() {
+        std::lock_guard<std::mutex> guard(m);
+        closed = true;
+        cv.notify_all();
+    }
+
+    void ParallelWindow::abandon() {
+        std::lock_guard<std::mutex> guard(m);
+        abandoned = true;
+        cv.notify_all();
+    }
+
+    void ParallelWindow::drain() {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&]() { return running == 0; });
+    }
+
+    size_t ParallelWindow::peak_in_flight() {
+        std::lock_guard<std::mutex> guard(m);
+        return peak_in_flight_;
+    }
+
+    std::string ParallelWindow::summary() {
+        std::lock_guard<std::mutex> guard(m);
+        std::stringstream stream;
+        stream << next_sequence << " items, peak of " << peak_in_flight_ << " in flight (limit " << max_in_flight
+               << ") holding " << peak_bytes / (1024.0 * 1024.0) << " MiB";
+        return stream.str();
+    }
+
+    bool ParallelWindow::deliverable() const {
+        return !results.empty() && (!ordered || results.begin()->first == next_delivery);
+    }
+
+    void ParallelWindow::held(size_t bytes) {
+        held_bytes += bytes;
+        peak_bytes = std::max(peak_bytes, held_bytes);
+    }
+
+    void ParallelWindow::released(size_t bytes) {
+        held_bytes -= bytes;
+    }
+}
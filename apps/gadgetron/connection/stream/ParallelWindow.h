@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "Channel.h"
+#include "Message.h"
+
+namespace Gadgetron::Server::Connection::Stream {
+
+    /**
+     * The items of a ParallelProcess between input and output. An item is admitted when it is taken from the input,
+     * runs until its result is complete, and leaves the window when the result is popped for output.
+     *
+     * At most max_in_flight items are in the window, and at most max_running of them run at once. Results are
+     * popped in admission order if ordered is set, and as soon as they are complete otherwise.
+     */
+    class ParallelWindow {
+    public:
+        ParallelWindow(size_t max_in_flight, size_t max_running, bool ordered);
+
+        /// Blocks until there is room for another item. Returns the item's sequence number.
+        size_t admit(size_t bytes);
+
+        void complete(size_t sequence, size_t input_bytes, Core::optional<Core::Message> message,
+                      std::exception_ptr error);
+
+        /// Next result; throws ChannelClosed once the input is closed and every result has been popped.
+        Core::Message pop();
+
+        /// No more items will be admitted.
+        void close();
+
+        /// Nothing more will be popped; stops admitting items.
+        void abandon();
+
+        /// Waits for the running items to complete.
+        void drain();
+
+        size_t peak_in_flight();
+
+        std::string summary();
+
+    private:
+        struct Result {
+            Core::optional<Core::Message> message;
+            std::exception_ptr error;
+            size_t bytes;
+        };
+
+        bool deliverable() const;
+        void held(size_t bytes);
+        void released(size_t bytes);
+
+        const size_t max_in_flight, max_running;
+        const bool ordered;
+
+        std::mutex m;
+        std::condition_variable cv;
+        std::map<size_t, Result> results;
+        size_t next_sequence = 0, next_delivery = 0;
+        size_t in_flight = 0, running = 0;
+        size_t held_bytes = 0, peak_bytes = 0, peak_in_flight_ = 0;
+        bool closed = false, abandoned = false;
+    };
+}
@@ -18,7 +18,7 @@ namespace {
             std::shared_ptr<Serialization> serialization,
             std::shared_ptr<Configuration> configuration
     ) {
-        return std::make_unique<Worker>(std::move(address), std::move(serialization), std::move(configuration));
+        return std::make_unique<RemoteWorker>(std::move(address), std::move(serialization), std::move(configuration));
     }
 
     std::list<std::future<std::unique_ptr<Worker>>> begin_connecting_to_peers(
@@ -50,19 +50,17 @@ namespace {
 namespace Gadgetron::Server::Connection::Stream {
 
 
-    void PureDistributed::process_outbound(GenericInputChannel input, Queue &jobs) {
-        auto workers = Pool(finish_connecting_to_peers(std::move(pending_workers)));
-
+    void PureDistributed::process_outbound(GenericInputChannel input, Pool &pool) {
         for (auto message : input) {
-            jobs.push(workers.push(std::move(message)));
+            pool.push(std::move(message));
         }
 
-        jobs.close();
+        pool.close();
     }
 
-    void PureDistributed::process_inbound(OutputChannel output, Queue &jobs) {
+    void PureDistributed::process_inbound(OutputChannel output, Pool &pool) {
         while (true) {
-            output.push_message(jobs.pop().get());
+            output.push_message(pool.pop());
         }
     }
 
@@ -70,15 +68,19 @@ namespace Gadgetron::Server::Connection::Stream {
             OutputChannel output,
             ErrorHandler& error_handler
     ) {
-        auto queue = Queue();
+        Pool pool(
+                finish_connecting_to_peers(std::move(pending_workers)),
+                settings,
+                make_scheduling_policy(scheduling, sticky_key)
+        );
 
         auto outbound = error_handler.run(
-                [&](auto input) { process_outbound(std::move(input), queue); },
+                [&](auto input) { process_outbound(std::move(input), pool); },
                 std::move(input)
         );
 
         auto inbound = error_handler.run(
-                [&](auto output) { process_inbound(std::move(output), queue); },
+                [&](auto output) { process_inbound(std::move(output), pool); },
                 std::move(output)
         );
 
@@ -89,7 +91,10 @@ namespace Gadgetron::Server::Connection::Stream {
             const Config::PureDistributed& config,
             const Core::StreamContext& context,
             Loader& loader
-    ) : serialization(std::make_shared<Serialization>(
+    ) : settings{config.max_in_flight, config.ordered},
+        scheduling(config.scheduling),
+        sticky_key(config.sticky_key),
+        serialization(std::make_shared<Serialization>(
                 loader.load_readers(config),
                 loader.load_writers(config)
         )),
@@ -3,6 +3,7 @@
 #include <map>
 #include <list>
 #include <thread>
+#include <future>
 
 #include "Processable.h"
 #include "Reader.h"
@@ -37,11 +38,11 @@ namespace Gadgetron::Server::Connection::Stream {
         const std::string& name() override;
 
     private:
-        using Job = std::future<Core::Message>;
-        using Queue = Core::MPMCChannel<Job>;
+        void process_outbound(Core::GenericInputChannel, Pool &);
+        void process_inbound(Core::OutputChannel, Pool &);
 
-        void process_outbound(Core::GenericInputChannel, Queue &);
-        void process_inbound(Core::OutputChannel, Queue &);
+        const Pool::Settings settings;
+        const std::string scheduling, sticky_key;
 
         std::shared_ptr<Serialization> serialization;
         std::shared_ptr<Configuration> configuration;
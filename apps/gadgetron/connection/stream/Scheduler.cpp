@@ -0,0 +1,358 @@
+#include "Scheduler.h"
+
+#include "Telemetry.h"
+#include "ThreadPool.h"
+#include "log.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif // USE_OMP
+
+namespace {
+    using namespace Gadgetron::Core;
+    using namespace Gadgetron::Server::Connection;
+    using namespace Gadgetron::Server::Connection::Stream;
+
+    std::chrono::nanoseconds thread_cpu_time() {
+#if defined(_WIN32)
+        FILETIME creation, exit, kernel, user;
+        GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+        auto ticks = [](const FILETIME &time) { return (uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+        return std::chrono::nanoseconds((ticks(kernel) + ticks(user)) * 100);
+#else
+        timespec time{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+#endif
+    }
+
+    /**
+     * Restores the OpenMP thread count of the calling thread when it goes out of scope. Some gadgets limit it for
+     * the thread they run on; on the shared scheduler, that thread goes on to run other nodes.
+     */
+    class OmpThreadsScope {
+    public:
+#ifdef USE_OMP
+        OmpThreadsScope() : threads(omp_get_max_threads()) {}
+        ~OmpThreadsScope() { omp_set_num_threads(threads); }
+
+    private:
+        const int threads;
+#endif // USE_OMP
+    };
+
+    class ScheduledNode;
+
+    /**
+     * Shared between a channel and the node consuming from it. Pushing to or closing the channel wakes up the
+     * consumer, if it runs on the shared scheduler.
+     */
+    struct ReadySignal {
+        std::atomic<bool> closed{false};
+        std::weak_ptr<ScheduledNode> consumer;
+
+        void notify();
+    };
+
+    class NotifyingChannel : public MessageChannel {
+    public:
+        explicit NotifyingChannel(std::shared_ptr<ReadySignal> signal) : signal(std::move(signal)) {}
+
+    protected:
+        void push_message(Message message) override {
+            MessageChannel::push_message(std::move(message));
+            signal->notify();
+        }
+
+        void close() override {
+            MessageChannel::close();
+            signal->closed = true;
+            signal->notify();
+        }
+
+    private:
+        std::shared_ptr<ReadySignal> signal;
+    };
+
+    class Latch {
+    public:
+        explicit Latch(size_t count) : count(count) {}
+
+        void count_down() {
+            std::lock_guard<std::mutex> guard(m);
+            if (--count == 0) cv.notify_all();
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&]() { return count == 0; });
+        }
+
+    private:
+        size_t count;
+        std::mutex m;
+        std::condition_variable cv;
+    };
+
+    /**
+     * Runs a MessageDrivenNode as a series of tasks on a ThreadPool. A task is submitted when the first signal
+     * arrives; while it runs, further signals are counted rather than submitted, and the task keeps draining the
+     * input until it has accounted for all of them. At most one task per node is ever in flight, so the node sees
+     * its messages in order and one at a time.
+     */
+    class ScheduledNode : public std::enable_shared_from_this<ScheduledNode> {
+    public:
+        ScheduledNode(
+                std::shared_ptr<NodeProcessable> processable,
+                GenericInputChannel input,
+                OutputChannel output,
+                std::shared_ptr<ReadySignal> signal,
+                ThreadPool &pool,
+                const ErrorHandler &error_handler,
+                std::shared_ptr<Latch> latch
+        ) : processable(std::move(processable)),
+            node(*this->processable->message_driven()),
+            input(std::move(input)),
+            output(std::move(output)),
+            signal(std::move(signal)),
+            pool(pool),
+            error_handler(error_handler, this->processable->name()),
+            latch(std::move(latch)),
+            trace(Gadgetron::Trace::current_session()) {}
+
+        void notify() {
+            if (pending.fetch_add(1) == 0)
+                pool.submit(detail::Task([self = shared_from_this()]() { self->run(); }));
+        }
+
+    private:
+        void run() {
+            auto timer = processable->time_cpu();
+            OmpThreadsScope omp_threads;
+            Gadgetron::Trace::SessionScope trace_scope(trace);
+            auto signals = pending.load();
+            do {
+                if (!finished) step();
+            } while ((signals = pending.fetch_sub(signals) - signals) != 0);
+        }
+
+        void step() {
+            bool done = true;
+            error_handler.handle([&]() { done = process_available(); });
+            if (done) complete();
+        }
+
+        bool process_available() {
+            if (!started) {
+                node.start(*output);
+                started = true;
+            }
+
+            // Read before draining; once the channel is closed, nothing can be pushed after what we drain here.
+            bool closed = signal->closed;
+            while (auto message = input->try_pop()) {
+                node.process_message(std::move(*message), *output);
+            }
+
+            if (!closed) return false;
+            node.finish(*output);
+            return true;
+        }
+
+        void complete() {
+            finished = true;
+            input.reset();
+            output.reset();
+            latch->count_down();
+        }
+
+        const std::shared_ptr<NodeProcessable> processable;
+        MessageDrivenNode &node;
+        optional<GenericInputChannel> input;
+        optional<OutputChannel> output;
+        const std::shared_ptr<ReadySignal> signal;
+        ThreadPool &pool;
+        ErrorHandler error_handler;
+        const std::shared_ptr<Latch> latch;
+        const std::shared_ptr<Gadgetron::Trace::Session> trace;
+
+        std::atomic<size_t> pending{0};
+        bool started = false;
+        bool finished = false;
+    };
+
+    void ReadySignal::notify() {
+        if (auto node = consumer.lock()) node->notify();
+    }
+
+    ThreadPool &scheduler_pool(size_t threads) {
+        if (threads == 0) return default_thread_pool();
+
+        static std::mutex m;
+        static std::map<size_t, std::unique_ptr<ThreadPool>> pools;
+
+        std::lock_guard<std::mutex> guard(m);
+        auto &pool = pools[threads];
+        if (!pool) pool = std::make_unique<ThreadPool>(threads);
+        return *pool;
+    }
+
+    void report_cpu_time(
+            const std::string &key,
+            const std::vector<std::shared_ptr<Processable>> &nodes,
+            const std::vector<bool> &scheduled
+    ) {
+        std::stringstream report;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            auto node = std::dynamic_pointer_cast<NodeProcessable>(nodes[i]);
+            if (!node) continue;
+            report << " [" << node->name() << ": "
+                   << std::chrono::duration<double, std::milli>(node->cpu_time()).count() << " ms"
+                   << (scheduled[i] ? ", scheduled" : "") << "]";
+        }
+        GDEBUG_STREAM("CPU time per node in stream '" << key << "':" << report.str());
+    }
+
+    void report_telemetry(
+            const std::vector<std::pair<std::string, std::shared_ptr<Telemetry::NodeStatistics>>> &nodes,
+            const std::vector<std::pair<std::string, std::shared_ptr<Telemetry::ChannelStatistics>>> &channels
+    ) {
+        std::stringstream report;
+        for (auto &[name, node] : nodes) report << "\n  " << Telemetry::summary(name, *node);
+        for (auto &[name, channel] : channels) report << "\n  " << Telemetry::summary(name, *channel);
+        GDEBUG_STREAM("Telemetry:" << report.str());
+    }
+
+    std::atomic<size_t> stream_instances{0};
+}
+
+namespace Gadgetron::Server::Connection::Stream {
+
+    CpuTimer::CpuTimer(std::atomic<int64_t> &total) : total(total), start(thread_cpu_time()) {}
+
+    CpuTimer::~CpuTimer() {
+        total += (thread_cpu_time() - start).count();
+    }
+
+    NodeProcessable::NodeProcessable(std::unique_ptr<Node> node, std::string name)
+        : node(std::move(node)), name_(std::move(name)) {}
+
+    void NodeProcessable::process(GenericInputChannel input, OutputChannel output, ErrorHandler &) {
+        CpuTimer timer{cpu_nanoseconds};
+        node->process(input, output);
+    }
+
+    const std::string &NodeProcessable::name() {
+        return name_;
+    }
+
+    MessageDrivenNode *NodeProcessable::message_driven() {
+        return dynamic_cast<MessageDrivenNode *>(node.get());
+    }
+
+    CpuTimer NodeProcessable::time_cpu() {
+        return CpuTimer{cpu_nanoseconds};
+    }
+
+    std::chrono::nanoseconds NodeProcessable::cpu_time() const {
+        return std::chrono::nanoseconds(cpu_nanoseconds.load());
+    }
+
+    void process_chain(
+            const std::string &key,
+            const std::vector<std::shared_ptr<Processable>> &nodes,
+            const Config::Scheduler &scheduler,
+            GenericInputChannel input,
+            OutputChannel output,
+            ErrorHandler &error_handler
+    ) {
+        // With the shared scheduler, the channels between nodes tell their consumer when there is work to do.
+        std::vector<std::shared_ptr<ReadySignal>> signals(nodes.size());
+
+        std::vector<GenericInputChannel> input_channels{};
+        input_channels.emplace_back(std::move(input));
+        std::vector<OutputChannel> output_channels{};
+
+        for (auto i = 1; i < nodes.size(); i++) {
+            if (scheduler.shared) signals[i] = std::make_shared<ReadySignal>();
+            auto channel = signals[i] ? make_channel<NotifyingChannel>(signals[i]) : make_channel<MessageChannel>();
+            input_channels.emplace_back(std::move(channel.input));
+            output_channels.emplace_back(std::move(channel.output));
+        }
+
+        output_channels.emplace_back(std::move(output));
+
+        // Every node is measured on its channels, and every channel between two nodes is counted.
+        auto instance = key + "#" + std::to_string(++stream_instances);
+        std::vector<std::pair<std::string, std::shared_ptr<Telemetry::NodeStatistics>>> node_statistics;
+        std::vector<std::pair<std::string, std::shared_ptr<Telemetry::ChannelStatistics>>> channel_statistics;
+        for (auto i = 0; i < nodes.size(); i++) {
+            node_statistics.emplace_back(instance + "/" + nodes[i]->name(), std::make_shared<Telemetry::NodeStatistics>());
+            node_statistics.back().second->name = nodes[i]->name();
+            Telemetry::Registry::instance().add(node_statistics.back().first, node_statistics.back().second);
+            if (i == 0) continue;
+            channel_statistics.emplace_back(instance + "/" + nodes[i - 1]->name() + " -> " + nodes[i]->name(),
+                                            std::make_shared<Telemetry::ChannelStatistics>());
+            Telemetry::Registry::instance().add(channel_statistics.back().first, channel_statistics.back().second);
+        }
+        for (auto i = 0; i < nodes.size(); i++) {
+            auto node = node_statistics[i].second;
+            input_channels[i].instrument(i > 0 ? channel_statistics[i - 1].second : nullptr, node);
+            output_channels[i].instrument(i + 1 < nodes.size() ? channel_statistics[i].second : nullptr, node);
+        }
+
+        ErrorHandler nested_handler{error_handler, key};
+
+        // Nodes which do not handle messages one at a time, or which read from the stream input, keep a thread.
+        std::vector<bool> scheduled(nodes.size());
+        for (auto i = 0; i < nodes.size(); i++) {
+            auto node = std::dynamic_pointer_cast<NodeProcessable>(nodes[i]);
+            scheduled[i] = signals[i] && node && node->message_driven();
+        }
+
+        auto latch = std::make_shared<Latch>(std::count(scheduled.begin(), scheduled.end(), true));
+        std::vector<std::shared_ptr<ScheduledNode>> scheduled_nodes;
+        for (auto i = 0; i < nodes.size(); i++) {
+            if (!scheduled[i]) continue;
+            scheduled_nodes.push_back(std::make_shared<ScheduledNode>(
+                    std::dynamic_pointer_cast<NodeProcessable>(nodes[i]),
+                    std::move(input_channels[i]),
+                    std::move(output_channels[i]),
+                    signals[i],
+                    scheduler_pool(scheduler.threads),
+                    nested_handler,
+                    latch
+            ));
+            signals[i]->consumer = scheduled_nodes.back();
+        }
+
+        std::vector<std::thread> threads;
+        for (auto i = 0; i < nodes.size(); i++) {
+            if (scheduled[i]) continue;
+            threads.emplace_back(Processable::process_async(nodes[i],std::move(input_channels[i]),std::move(output_channels[i]),nested_handler));
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        latch->wait();
+
+        report_cpu_time(key, nodes, scheduled);
+        report_telemetry(node_statistics, channel_statistics);
+    }
+}
+
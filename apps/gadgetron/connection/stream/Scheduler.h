@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "connection/Config.h"
+#include "connection/stream/Processable.h"
+
+#include "Channel.h"
+#include "Node.h"
+
+namespace Gadgetron::Server::Connection::Stream {
+
+    /// Adds the CPU time spent by the calling thread, until the timer goes out of scope, to a total.
+    class CpuTimer {
+    public:
+        explicit CpuTimer(std::atomic<int64_t> &total);
+        ~CpuTimer();
+
+    private:
+        std::atomic<int64_t> &total;
+        const std::chrono::nanoseconds start;
+    };
+
+    /// A Node in a stream, along with the CPU time spent in it.
+    class NodeProcessable : public Processable {
+    public:
+        NodeProcessable(std::unique_ptr<Core::Node> node, std::string name);
+
+        void process(Core::GenericInputChannel input, Core::OutputChannel output, ErrorHandler &) override;
+
+        const std::string &name() override;
+
+        /// The node, if it can be driven one message at a time.
+        Core::MessageDrivenNode *message_driven();
+
+        /// Measures the CPU time spent by the calling thread until the timer goes out of scope.
+        CpuTimer time_cpu();
+
+        std::chrono::nanoseconds cpu_time() const;
+
+    private:
+        std::unique_ptr<Core::Node> node;
+        const std::string name_;
+        std::atomic<int64_t> cpu_nanoseconds{0};
+    };
+
+    /**
+     * Runs a chain of nodes, each reading what the one before it writes, from input to output, and returns once
+     * all of them have finished.
+     *
+     * With the shared scheduler, message driven NodeProcessables other than the first run as tasks on a shared
+     * ThreadPool rather than on threads of their own. Every other node keeps a thread.
+     */
+    void process_chain(
+            const std::string &key,
+            const std::vector<std::shared_ptr<Processable>> &nodes,
+            const Config::Scheduler &scheduler,
+            Core::GenericInputChannel input,
+            Core::OutputChannel output,
+            ErrorHandler &error_handler
+    );
+}
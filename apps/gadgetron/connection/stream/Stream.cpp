@@ -6,9 +6,11 @@
 #include "connection/stream/Distributed.h"
 #include "connection/stream/ParallelProcess.h"
 #include "connection/stream/PureDistributed.h"
+#include "connection/stream/Scheduler.h"
 #include "connection/Loader.h"
 
 #include "Node.h"
+#include "log.h"
 
 namespace {
     using namespace Gadgetron::Core;
@@ -28,26 +30,6 @@ namespace {
         return visit([](auto& ac){return print_action(ac);},action);
     }
 
-    class NodeProcessable : public Processable {
-    public:
-        NodeProcessable(std::unique_ptr<Node> node, std::string name) : node(std::move(node)), name_(std::move(name)) {}
-
-        void process(GenericInputChannel input,
-                OutputChannel output,
-                ErrorHandler &
-        ) override {
-             node->process(input, output);
-        }
-
-        const std::string& name() override {
-            return name_;
-        }
-
-    private:
-        std::unique_ptr<Node> node;
-        const std::string name_;
-    };
-
     std::shared_ptr<Processable> load_node(const Config::Gadget &conf, const StreamContext &context, Loader &loader) {
         GDEBUG("Loading Gadget %s of class %s from %s\n", conf.name.c_str(), conf.classname.c_str(), conf.dll.c_str());
         auto factory = loader.load_factory<Loader::generic_factory<Node>>("gadget_factory_export_", conf.classname,
@@ -83,7 +65,8 @@ namespace {
 
 namespace Gadgetron::Server::Connection::Stream {
 
-    Stream::Stream(const Config::Stream &config, const Core::StreamContext &context, Loader &loader) : key(config.key) {
+    Stream::Stream(const Config::Stream &config, const Core::StreamContext &context, Loader &loader)
+        : key(config.key), scheduler(config.scheduler) {
         for (auto &node_config : config.nodes) {
             nodes.emplace_back(
                     Core::visit([&](auto n) { return load_node(n, context, loader); }, node_config)
@@ -96,29 +79,7 @@ namespace Gadgetron::Server::Connection::Stream {
             ErrorHandler &error_handler
     ) {
         if (empty()) return;
-
-        std::vector<GenericInputChannel> input_channels{};
-        input_channels.emplace_back(std::move(input));
-        std::vector<OutputChannel> output_channels{};
-
-        for (auto i = 0; i < nodes.size()-1; i++) {
-            auto channel = make_channel<MessageChannel>();
-            input_channels.emplace_back(std::move(channel.input));
-            output_channels.emplace_back(std::move(channel.output));
-        }
-
-        output_channels.emplace_back(std::move(output));
-
-        ErrorHandler nested_handler{error_handler, key};
-
-        std::vector<std::thread> threads(nodes.size());
-        for (auto i = 0; i < nodes.size(); i++) {
-            threads[i] = Processable::process_async(nodes[i],std::move(input_channels[i]),std::move(output_channels[i]),nested_handler);
-        }
-
-        for (auto &thread : threads) {
-            thread.join();
-        }
+        process_chain(key, nodes, scheduler, std::move(input), std::move(output), error_handler);
     }
 
     bool Stream::empty() const { return nodes.empty(); }
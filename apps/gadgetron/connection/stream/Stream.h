@@ -32,6 +32,7 @@ namespace Gadgetron::Server::Connection::Stream {
 
     private:
         std::vector<std::shared_ptr<Processable>> nodes;
+        const Config::Scheduler scheduler;
     };
 }
 
@@ -31,6 +31,7 @@ namespace Gadgetron::Server::Connection::Stream {
     void Configuration::send(std::iostream &stream) const {
         send_config(stream, config);
         send_header(stream, context.header);
+        stream.flush();
     }
 
     Configuration::Configuration(
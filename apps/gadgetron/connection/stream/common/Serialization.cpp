@@ -27,6 +27,7 @@ namespace Gadgetron::Server::Connection::Stream {
             throw std::runtime_error("Could not find appropriate writer for message.");
 
         (*writer)->write(stream, std::move(message));
+        stream.flush();
     }
 
     Core::Message Serialization::read(
@@ -58,5 +59,6 @@ namespace Gadgetron::Server::Connection::Stream {
 
     void Serialization::close(std::iostream &stream) const {
         IO::write(stream, CLOSE);
+        stream.flush();
     }
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "LocalWorker.h"
+
+using namespace Gadgetron::Core;
+
+namespace Gadgetron::Server::Connection::Stream {
+
+    LocalWorker::LocalWorker(Function function, std::string name)
+        : function(std::move(function)), name(std::move(name)) {
+        thread = std::thread([this]() { process_jobs(); });
+    }
+
+    LocalWorker::~LocalWorker() {
+        jobs.close();
+        thread.join();
+    }
+
+    void LocalWorker::push(Message message, Response on_response, Failure on_failure) {
+        try {
+            jobs.push(Job{std::move(message), std::move(on_response), std::move(on_failure)});
+        }
+        catch (const ChannelClosed &) {
+            throw std::runtime_error("Cannot push message to closed/failed worker.");
+        }
+    }
+
+    void LocalWorker::close() {
+        jobs.close();
+    }
+
+    std::string LocalWorker::describe() const {
+        return name;
+    }
+
+    void LocalWorker::process_jobs() {
+        try {
+            while (true) {
+                auto job = jobs.pop();
+                try {
+                    job.respond(function(std::move(job.message)));
+                }
+                catch (...) {
+                    job.fail(std::current_exception());
+                }
+            }
+        }
+        catch (const ChannelClosed &) {}
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <thread>
+#include <functional>
+
+#include "MPMCChannel.h"
+#include "Message.h"
+
+#include "Worker.h"
+
+namespace Gadgetron::Server::Connection::Stream {
+
+    /**
+     * Worker applying a function to each message on a thread of its own, in the order the messages are pushed.
+     * Stands in for a remote worker, so the Pool can be exercised and benchmarked on a single machine.
+     */
+    class LocalWorker : public Worker {
+    public:
+        using Function = std::function<Core::Message(Core::Message)>;
+
+        explicit LocalWorker(Function function, std::string name = "local");
+        ~LocalWorker() override;
+
+        void push(Core::Message message, Response on_response, Failure on_failure) override;
+        void close() override;
+        std::string describe() const override;
+
+    private:
+        struct Job {
+            Core::Message message;
+            Response respond;
+            Failure fail;
+        };
+
+        const Function function;
+        const std::string name;
+
+        Core::MPMCChannel<Job> jobs;
+        std::thread thread;
+
+        void process_jobs();
+    };
+}
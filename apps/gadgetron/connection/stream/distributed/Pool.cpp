@@ -1,10 +1,10 @@
-
 #include "Pool.h"
 
-#include "connection/stream/common/Discovery.h"
+#include <algorithm>
+
+#include <boost/asio/post.hpp>
 
 #include "log.h"
-#include "io/iostream_operators.h"
 
 using namespace Gadgetron::Core;
 using namespace Gadgetron::Server::Connection::Stream;
@@ -12,52 +12,218 @@ using namespace Gadgetron;
 
 namespace {
 
-    bool compare_load(const std::unique_ptr<Worker> &a, const std::unique_ptr<Worker> &b) {
-        return a->current_load() < b->current_load();
+    size_t default_window(size_t workers, size_t max_in_flight) {
+        return std::max<size_t>(1, 4 * workers * max_in_flight);
+    }
+}
+
+namespace Gadgetron::Server::Connection::Stream {
+
+    Pool::Pool(
+            std::list<std::unique_ptr<Worker>> workers,
+            Settings settings,
+            std::unique_ptr<SchedulingPolicy> policy
+    ) : settings(settings),
+        window(settings.window ? settings.window : default_window(workers.size(), settings.max_in_flight)),
+        policy(std::move(policy)),
+        work(boost::asio::make_work_guard(io)) {
+
+        for (auto &worker : workers) this->workers.push_back(WorkerState{std::move(worker)});
+
+        dispatcher = std::thread([this]() {
+            try {
+                io.run();
+            }
+            catch (...) {
+                abort(std::current_exception());
+            }
+        });
     }
 
-    std::unique_ptr<Worker> &select_best_worker(std::list<std::unique_ptr<Worker>> &workers) {
-        return *std::min_element(workers.begin(), workers.end(), compare_load);
+    Pool::~Pool() {
+        io.stop();
+        dispatcher.join();
+        for (auto &state : workers) state.worker->close();
     }
 
-    Message send_to_best_worker(
-            Message message,
-            std::shared_ptr<std::list<std::unique_ptr<Worker>>> workers,
-            size_t retries
-    ) {
+    void Pool::push(Message message) {
+        size_t sequence;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            space.wait(lock, [&]() { return outstanding < window || error; });
+            if (error) std::rethrow_exception(error);
+            outstanding++;
+            sequence = next_sequence++;
+        }
 
-        if (!retries) throw std::runtime_error("Multiple workers failed processing job; aborting.");
+        // Handlers are copied by older versions of asio; the message is moved through a shared pointer.
+        auto job = std::make_shared<Job>(Job{sequence, std::move(message), settings.retries, {}});
+        boost::asio::post(io, [this, job]() {
+            backlog.push_back(std::move(*job));
+            dispatch();
+        });
+    }
 
-        auto &worker = select_best_worker(*workers);
+    void Pool::close() {
+        boost::asio::post(io, [this]() {
+            closing = true;
+            finish_if_done();
+        });
+    }
 
+    Message Pool::pop() {
         try {
-            auto response = worker->push(message.clone());
-            GDEBUG_STREAM("Pushed message; waiting for response from worker " << worker->address);
-            auto response_message = response.get();
-            GDEBUG_STREAM("Response gotten from worker " << worker->address);
-            return std::move(response_message);
+            auto response = responses.pop();
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                outstanding--;
+            }
+            space.notify_one();
+            return response;
         }
-        catch (const std::exception &e) {
-            GWARN_STREAM("Worker " << worker->address << " failed processing job. The job will be retried. [" << e.what() << "]");
-            return send_to_best_worker(std::move(message), std::move(workers), retries - 1);
+        catch (const ChannelClosed &) {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (error) std::rethrow_exception(error);
+            throw;
         }
     }
-}
 
-namespace Gadgetron::Server::Connection::Stream {
+    void Pool::dispatch() {
+        if (aborted || backlog.empty()) return;
 
-    Pool::Pool(
-            std::list<std::unique_ptr<Worker>> workers
-    ) : workers(std::make_shared<std::list<std::unique_ptr<Worker>>>(std::move(workers))) {}
-
-    std::future<Message> Pool::push(Message message) {
-        return std::async(
-                std::launch::async,
-                send_to_best_worker,
-                std::move(message),
-                workers,
-                3
+        std::vector<WorkerLoad> loads;
+        for (auto &state : workers) loads.push_back(load(state));
+
+        auto alive = [&]() { return std::any_of(loads.begin(), loads.end(), [](auto &l) { return l.alive; }); };
+        auto available = [&]() { return std::any_of(loads.begin(), loads.end(), [](auto &l) { return l.available(); }); };
+
+        if (!alive()) return abort(std::make_exception_ptr(
+                std::runtime_error("No workers available to process job; aborting.")
+        ));
+
+        for (auto job = backlog.begin(); job != backlog.end() && available();) {
+            auto worker = policy->select(job->message, loads);
+            if (!worker) { ++job; continue; }
+
+            auto selected = std::move(*job); job = backlog.erase(job);
+            send(*worker, std::move(selected));
+            loads[*worker] = load(workers[*worker]);
+        }
+    }
+
+    WorkerLoad Pool::load(const WorkerState &state) const {
+        return WorkerLoad{
+                state.in_flight,
+                !state.failed,
+                state.in_flight >= settings.max_in_flight,
+                state.service_time
+        };
+    }
+
+    void Pool::send(size_t worker, Job job) {
+        auto &state = workers[worker];
+        auto sequence = job.sequence;
+        auto message = job.message.clone();
+
+        job.sent = Clock::now();
+        state.in_flight++;
+        in_flight.emplace(sequence, std::move(job));
+
+        auto on_response = [this, worker, sequence](Message response) {
+            auto shared = std::make_shared<Message>(std::move(response));
+            boost::asio::post(io, [this, worker, sequence, shared]() {
+                completed(worker, sequence, std::move(*shared));
+            });
+        };
+
+        auto on_failure = [this, worker, sequence](std::exception_ptr e) {
+            boost::asio::post(io, [this, worker, sequence, e]() { failed(worker, sequence, e); });
+        };
+
+        try {
+            state.worker->push(std::move(message), on_response, on_failure);
+        }
+        catch (...) {
+            on_failure(std::current_exception());
+        }
+    }
+
+    void Pool::completed(size_t worker, size_t sequence, Message response) {
+        auto &state = workers[worker];
+        state.in_flight--;
+
+        auto job = in_flight.find(sequence);
+        if (aborted || job == in_flight.end()) return;
+
+        // Workers take their jobs one after another; a job started when it was sent, or when the previous finished.
+        // The latest job weighs in with a quarter in the worker's moving average.
+        auto now = Clock::now();
+        auto service = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                now - std::max(job->second.sent, state.last_completed)
         );
+        state.service_time = state.service_time.count() ? state.service_time + (service - state.service_time) / 4 : service;
+        state.last_completed = now;
+        in_flight.erase(job);
+
+        if (settings.ordered) {
+            reorder_buffer.emplace(sequence, std::move(response));
+            while (!reorder_buffer.empty() && reorder_buffer.begin()->first == next_delivery) {
+                deliver(std::move(reorder_buffer.begin()->second));
+                reorder_buffer.erase(reorder_buffer.begin());
+                next_delivery++;
+            }
+        }
+        else {
+            deliver(std::move(response));
+        }
+
+        dispatch();
+        finish_if_done();
     }
-}
 
+    void Pool::failed(size_t worker, size_t sequence, std::exception_ptr e) {
+        auto &state = workers[worker];
+        state.in_flight--;
+
+        if (!state.failed) {
+            try { std::rethrow_exception(e); }
+            catch (const std::exception &error) {
+                GWARN_STREAM("Worker " << state.worker->describe() << " failed processing job. The job will be retried. [" << error.what() << "]");
+            }
+            catch (...) {}
+            state.failed = true;
+            state.worker->close();
+        }
+
+        auto job = in_flight.find(sequence);
+        if (aborted || job == in_flight.end()) return;
+
+        if (job->second.attempts <= 1) return abort(std::make_exception_ptr(
+                std::runtime_error("Multiple workers failed processing job; aborting.")
+        ));
+
+        job->second.attempts--;
+        backlog.push_front(std::move(job->second));
+        in_flight.erase(job);
+
+        dispatch();
+    }
+
+    void Pool::deliver(Message response) {
+        responses.push(std::move(response));
+    }
+
+    void Pool::finish_if_done() {
+        if (closing && backlog.empty() && in_flight.empty() && reorder_buffer.empty()) responses.close();
+    }
+
+    void Pool::abort(std::exception_ptr e) {
+        aborted = true;
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (!error) error = std::move(e);
+        }
+        space.notify_all();
+        responses.close();
+    }
+}
@@ -1,26 +1,112 @@
 #pragma once
 
+#include <map>
+#include <list>
+#include <chrono>
 #include <mutex>
+#include <thread>
 #include <vector>
 #include <memory>
-#include <future>
-#include <algorithm>
+#include <condition_variable>
 
-#include "connection/stream/common/External.h"
-
-#include "Worker.h"
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/executor_work_guard.hpp>
 
+#include "MPMCChannel.h"
 #include "Message.h"
 
+#include "Worker.h"
+#include "SchedulingPolicy.h"
+
 
 namespace Gadgetron::Server::Connection::Stream {
 
+    /**
+     * Spreads jobs over a set of workers. Dispatching is event driven: a single io_context thread hands jobs to
+     * workers as they report back, keeping at most max_in_flight unanswered jobs on each worker. The scheduling
+     * policy picks the worker for each job; it may hold a job back, in which case later jobs are dispatched around
+     * it. No thread waits on an individual job. A job whose worker fails is retried on the remaining workers.
+     *
+     * Responses are delivered through pop(); in the order the jobs were pushed if ordered is set, as soon as they
+     * arrive otherwise. Ordered delivery parks early responses in a reorder buffer without holding back dispatch,
+     * so a slow job delays its successors' delivery, but not their processing.
+     *
+     * At most window jobs are held between push and pop; push blocks beyond that.
+     */
     class Pool {
     public:
-        explicit Pool(std::list<std::unique_ptr<Worker>> workers);
-        std::future<Core::Message> push(Core::Message message);
+        struct Settings {
+            size_t max_in_flight = 2;
+            bool ordered = true;
+            size_t retries = 3;
+            size_t window = 0; // Defaults to four times the number of jobs the workers can have in flight.
+        };
+
+        Pool(
+                std::list<std::unique_ptr<Worker>> workers,
+                Settings settings,
+                std::unique_ptr<SchedulingPolicy> policy = std::make_unique<LeastLoaded>()
+        );
+        ~Pool();
+
+        void push(Core::Message message);
+
+        /// No more jobs will be pushed; pop throws ChannelClosed once every response has been delivered.
+        void close();
+
+        /// Next response. Rethrows the error that aborted the pool, if any.
+        Core::Message pop();
 
     private:
-        std::shared_ptr<std::list<std::unique_ptr<Worker>>> workers;
+        using Clock = std::chrono::steady_clock;
+
+        struct Job {
+            size_t sequence;
+            Core::Message message;
+            size_t attempts;
+            Clock::time_point sent;
+        };
+
+        struct WorkerState {
+            std::unique_ptr<Worker> worker;
+            size_t in_flight = 0;
+            bool failed = false;
+            std::chrono::nanoseconds service_time{0};
+            Clock::time_point last_completed;
+        };
+
+        const Settings settings;
+        const size_t window;
+        const std::unique_ptr<SchedulingPolicy> policy;
+
+        boost::asio::io_context io;
+        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work;
+        std::thread dispatcher;
+
+        // Owned by the dispatcher thread.
+        std::vector<WorkerState> workers;
+        std::list<Job> backlog;
+        std::map<size_t, Job> in_flight;
+        std::map<size_t, Core::Message> reorder_buffer;
+        size_t next_delivery = 0;
+        bool closing = false;
+        bool aborted = false;
+
+        void dispatch();
+        WorkerLoad load(const WorkerState &state) const;
+        void send(size_t worker, Job job);
+        void completed(size_t worker, size_t sequence, Core::Message response);
+        void failed(size_t worker, size_t sequence, std::exception_ptr e);
+        void deliver(Core::Message response);
+        void finish_if_done();
+        void abort(std::exception_ptr e);
+
+        // Shared between the dispatcher, pushing and popping threads.
+        Core::MPMCChannel<Core::Message> responses;
+        std::mutex mutex;
+        std::condition_variable space;
+        size_t outstanding = 0;
+        size_t next_sequence = 0;
+        std::exception_ptr error;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,136 @@
+#include "SchedulingPolicy.h"
+
+#include <unordered_map>
+
+#include "mri_core_data.h"
+
+using namespace Gadgetron::Core;
+
+namespace {
+
+    using Counters = ISMRMRD::EncodingCounters;
+    const std::unordered_map<std::string, std::function<uint16_t(const Counters &)>> counter_keys = {
+            {"kspace_encode_step_1", [](const Counters &idx) { return idx.kspace_encode_step_1; }},
+            {"kspace_encode_step_2", [](const Counters &idx) { return idx.kspace_encode_step_2; }},
+            {"average",              [](const Counters &idx) { return idx.average; }},
+            {"slice",                [](const Counters &idx) { return idx.slice; }},
+            {"contrast",             [](const Counters &idx) { return idx.contrast; }},
+            {"phase",                [](const Counters &idx) { return idx.phase; }},
+            {"repetition",           [](const Counters &idx) { return idx.repetition; }},
+            {"set",                  [](const Counters &idx) { return idx.set; }},
+            {"segment",              [](const Counters &idx) { return idx.segment; }},
+            {"user_0",               [](const Counters &idx) { return idx.user[0]; }},
+            {"user_1",               [](const Counters &idx) { return idx.user[1]; }},
+            {"user_2",               [](const Counters &idx) { return idx.user[2]; }},
+            {"user_3",               [](const Counters &idx) { return idx.user[3]; }},
+            {"user_4",               [](const Counters &idx) { return idx.user[4]; }},
+            {"user_5",               [](const Counters &idx) { return idx.user[5]; }},
+            {"user_6",               [](const Counters &idx) { return idx.user[6]; }},
+            {"user_7",               [](const Counters &idx) { return idx.user[7]; }}
+    };
+
+    using ImageHeader = ISMRMRD::ImageHeader;
+    const std::unordered_map<std::string, std::function<uint16_t(const ImageHeader &)>> image_keys = {
+            {"average",    [](const ImageHeader &header) { return header.average; }},
+            {"slice",      [](const ImageHeader &header) { return header.slice; }},
+            {"contrast",   [](const ImageHeader &header) { return header.contrast; }},
+            {"phase",      [](const ImageHeader &header) { return header.phase; }},
+            {"repetition", [](const ImageHeader &header) { return header.repetition; }},
+            {"set",        [](const ImageHeader &header) { return header.set; }}
+    };
+
+    template<class T>
+    const T *first_part(const Message &message) {
+        if (message.messages().empty()) return nullptr;
+        auto chunk = dynamic_cast<const TypedMessageChunk<T> *>(message.messages().front().get());
+        return chunk ? &chunk->data() : nullptr;
+    }
+
+    optional<size_t> earliest_completion(const std::vector<Gadgetron::Server::Connection::Stream::WorkerLoad> &workers) {
+        optional<size_t> best;
+        for (size_t i = 0; i < workers.size(); i++) {
+            if (!workers[i].available()) continue;
+            if (!best || workers[i].expected_completion() < workers[*best].expected_completion()) best = i;
+        }
+        return best;
+    }
+}
+
+namespace Gadgetron::Server::Connection::Stream {
+
+    optional<size_t> LeastLoaded::select(const Message &, const std::vector<WorkerLoad> &workers) {
+        optional<size_t> best;
+        for (size_t i = 0; i < workers.size(); i++) {
+            if (!workers[i].available()) continue;
+            if (!best || workers[i].in_flight < workers[*best].in_flight) best = i;
+        }
+        return best;
+    }
+
+    optional<size_t> LatencyAware::select(const Message &, const std::vector<WorkerLoad> &workers) {
+        return earliest_completion(workers);
+    }
+
+    PowerOfTwoChoices::PowerOfTwoChoices() : random(std::random_device()()) {}
+
+    optional<size_t> PowerOfTwoChoices::select(const Message &, const std::vector<WorkerLoad> &workers) {
+        std::vector<size_t> available;
+        for (size_t i = 0; i < workers.size(); i++) if (workers[i].available()) available.push_back(i);
+        if (available.empty()) return none;
+        if (available.size() == 1) return available.front();
+
+        std::uniform_int_distribution<size_t> pick(0, available.size() - 1);
+        auto first = pick(random), second = pick(random);
+        while (second == first) second = pick(random);
+
+        auto a = available[first], b = available[second];
+        return workers[b].expected_completion() < workers[a].expected_completion() ? b : a;
+    }
+
+    Sticky::Sticky(Key key, std::unique_ptr<SchedulingPolicy> fallback)
+        : key(std::move(key)), fallback(std::move(fallback)) {}
+
+    optional<size_t> Sticky::select(const Message &job, const std::vector<WorkerLoad> &workers) {
+        auto index = key(job);
+        if (!index) return fallback->select(job, workers);
+
+        auto assignment = assignments.find(*index);
+        if (assignment != assignments.end() && workers[assignment->second].alive) {
+            if (workers[assignment->second].full) return none;
+            return assignment->second;
+        }
+
+        auto worker = fallback->select(job, workers);
+        if (worker) assignments[*index] = *worker;
+        return worker;
+    }
+
+    Sticky::Key header_key(const std::string &name) {
+        if (!counter_keys.count(name))
+            throw std::runtime_error("Unknown sticky key '" + name + "'; expected an encoding counter, e.g. 'slice'");
+
+        auto counter = counter_keys.at(name);
+        auto image = image_keys.count(name) ? image_keys.at(name) : std::function<uint16_t(const ImageHeader &)>();
+
+        return [=](const Message &message) -> optional<uint16_t> {
+            if (auto header = first_part<ISMRMRD::AcquisitionHeader>(message)) return counter(header->idx);
+            if (auto header = first_part<ImageHeader>(message)) {
+                if (image) return image(*header);
+                return none;
+            }
+            if (auto data = first_part<IsmrmrdReconData>(message)) {
+                if (data->rbit_.empty() || data->rbit_.front().data_.headers_.empty()) return none;
+                return counter(data->rbit_.front().data_.headers_[0].idx);
+            }
+            return none;
+        };
+    }
+
+    std::unique_ptr<SchedulingPolicy> make_scheduling_policy(const std::string &name, const std::string &sticky_key) {
+        if (name == "least_loaded") return std::make_unique<LeastLoaded>();
+        if (name == "latency") return std::make_unique<LatencyAware>();
+        if (name == "power_of_two") return std::make_unique<PowerOfTwoChoices>();
+        if (name == "sticky") return std::make_unique<Sticky>(header_key(sticky_key), std::make_unique<LatencyAware>());
+        throw std::runtime_error("Unknown scheduling policy '" + name + "'");
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <map>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include <functional>
+
+#include "Message.h"
+#include "Types.h"
+
+namespace Gadgetron::Server::Connection::Stream {
+
+    /// What the Pool knows about a worker when a job is to be sent somewhere.
+    struct WorkerLoad {
+        size_t in_flight;
+        bool alive;
+        bool full;      // At the pool's in-flight limit; the worker can't take another job right now.
+
+        // Moving average of the time the worker spends on a job; zero until the worker has completed one.
+        std::chrono::nanoseconds service_time;
+
+        bool available() const { return alive && !full; }
+
+        /// Expected time until a job sent to the worker now would complete.
+        std::chrono::nanoseconds expected_completion() const { return service_time * (in_flight + 1); }
+    };
+
+    /**
+     * Decides which worker a job is sent to. Policies are only ever called from the Pool's dispatcher thread.
+     */
+    class SchedulingPolicy {
+    public:
+        virtual ~SchedulingPolicy() = default;
+
+        /// An available worker, or none to hold the job back until a worker reports back.
+        virtual Core::optional<size_t> select(const Core::Message &job, const std::vector<WorkerLoad> &workers) = 0;
+    };
+
+    /// The worker with the fewest jobs in flight.
+    class LeastLoaded : public SchedulingPolicy {
+    public:
+        Core::optional<size_t> select(const Core::Message &, const std::vector<WorkerLoad> &workers) override;
+    };
+
+    /// The worker expected to complete the job first. Workers without a measured service time are tried first.
+    class LatencyAware : public SchedulingPolicy {
+    public:
+        Core::optional<size_t> select(const Core::Message &, const std::vector<WorkerLoad> &workers) override;
+    };
+
+    /// The better of two available workers chosen at random, by expected completion time.
+    class PowerOfTwoChoices : public SchedulingPolicy {
+    public:
+        PowerOfTwoChoices();
+        Core::optional<size_t> select(const Core::Message &, const std::vector<WorkerLoad> &workers) override;
+
+    private:
+        std::mt19937 random;
+    };
+
+    /**
+     * Jobs with the same key go to the same worker, so state a worker has built for a key (e.g. GRAPPA weights
+     * for a slice) is reused. The first job with a key is placed by the fallback policy, as are jobs without a
+     * key, and jobs whose worker has failed. A job whose worker is busy is held back, without holding back jobs
+     * for other keys.
+     */
+    class Sticky : public SchedulingPolicy {
+    public:
+        using Key = std::function<Core::optional<uint16_t>(const Core::Message &)>;
+
+        Sticky(Key key, std::unique_ptr<SchedulingPolicy> fallback);
+        Core::optional<size_t> select(const Core::Message &job, const std::vector<WorkerLoad> &workers) override;
+
+    private:
+        const Key key;
+        const std::unique_ptr<SchedulingPolicy> fallback;
+        std::map<uint16_t, size_t> assignments;
+    };
+
+    /// The named header index (e.g. "slice") of the acquisitions, images or buffers in a message, if any.
+    Sticky::Key header_key(const std::string &name);
+
+    std::unique_ptr<SchedulingPolicy> make_scheduling_policy(const std::string &name, const std::string &sticky_key);
+}
@@ -1,8 +1,6 @@
-
 #include "Worker.h"
 
-#include <chrono>
-#include <future>
+#include <sstream>
 
 #include "connection/stream/common/External.h"
 #include "connection/stream/common/ExternalChannel.h"
@@ -11,82 +9,47 @@
 using namespace Gadgetron::Core;
 using namespace Gadgetron::Server::Connection::Stream;
 
-namespace {
-
-    template<class T>
-    std::chrono::milliseconds time_since(std::chrono::time_point<T> instance) {
-        return std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - instance
-        );
-    }
-}
-
 namespace Gadgetron::Server::Connection::Stream {
 
-    struct Worker::Job {
-        std::chrono::time_point<std::chrono::steady_clock> start;
-        std::promise<Core::Message> response;
+    struct RemoteWorker::Job {
+        Response respond;
+        Failure fail;
     };
 
     struct Module {
-        Worker& worker;
-        explicit Module(Worker &worker) : worker(worker) {}
+        RemoteWorker& worker;
+        explicit Module(RemoteWorker &worker) : worker(worker) {}
         virtual ~Module() = default;
     };
 
-    struct Worker::PushModule : public Module {
+    struct RemoteWorker::PushModule : public Module {
         using Module::Module;
 
-        virtual std::future<Message> push(Message message) {
+        virtual void push(Message message, Response on_response, Failure on_failure) {
             GDEBUG_STREAM("Pushing message to remote worker " << worker.address);
 
-            Job job {
-                    std::chrono::steady_clock::now(),
-                    std::promise<Message>()
-            };
-
-            auto future = job.response.get_future();
             worker.channel->push_message(std::move(message));
-            worker.jobs.push_back(std::move(job));
-            return future;
-        };
-    };
-
-    struct Worker::LoadModule : public Module {
-        using Module::Module;
-
-        virtual long long current_load() {
-            auto current_job_duration_estimate = std::max(
-                    worker.timing.latest.count(),
-                    time_since(worker.jobs.front().start).count()
-            );
-
-            return current_job_duration_estimate * worker.jobs.size();
+            worker.jobs.push_back(Job{std::move(on_response), std::move(on_failure)});
         };
     };
 
-    struct Worker::ClosedPushModule : public Worker::PushModule {
-        using Worker::PushModule::PushModule;
-        std::future<Message> push(Message message) override {
+    struct RemoteWorker::ClosedPushModule : public RemoteWorker::PushModule {
+        using RemoteWorker::PushModule::PushModule;
+        void push(Message, Response, Failure) override {
             throw std::runtime_error("Cannot push message to closed/failed worker.");
         }
     };
-
-    struct Worker::ClosedLoadModule : public Worker::LoadModule {
-        using Worker::LoadModule::LoadModule;
-        long long current_load() override { return std::numeric_limits<long long>::max(); }
-    };
 }
 
 
 namespace Gadgetron::Server::Connection::Stream {
 
-    Worker::~Worker() {
+    RemoteWorker::~RemoteWorker() {
         channel->close();
         inbound_thread.join();
     }
 
-    Worker::Worker(
+    RemoteWorker::RemoteWorker(
             Address address,
             std::shared_ptr<Serialization> serialization,
             std::shared_ptr<Configuration> configuration
@@ -99,60 +62,63 @@ namespace Gadgetron::Server::Connection::Stream {
                 std::move(configuration)
         );
 
-        load_module = std::make_unique<LoadModule>(*this);
         push_module = std::make_unique<PushModule>(*this);
 
         inbound_thread = std::thread([=]() { handle_inbound_messages(); });
     }
 
-    long long Worker::current_load() const {
+    void RemoteWorker::push(Message message, Response on_response, Failure on_failure) {
         std::lock_guard<std::mutex> guard(mutex);
-        return load_module->current_load();
+        push_module->push(std::move(message), std::move(on_response), std::move(on_failure));
     }
 
-    std::future<Message> Worker::push(Message message) {
+    void RemoteWorker::close() {
         std::lock_guard<std::mutex> guard(mutex);
-        return push_module->push(std::move(message));
+        channel->close();
     }
 
-    void Worker::close() {
-        std::lock_guard<std::mutex> guard(mutex);
-        channel->close();
+    std::string RemoteWorker::describe() const {
+        std::stringstream stream;
+        stream << address;
+        return stream.str();
     }
 
-    void Worker::handle_inbound_messages() {
+    void RemoteWorker::handle_inbound_messages() {
+        std::exception_ptr failure;
         try {
             while(true) process_inbound_message(channel->pop());
         }
-        catch (const ChannelClosed &) {}
+        catch (const ChannelClosed &) {
+            failure = std::make_exception_ptr(std::runtime_error("Worker closed the connection with jobs pending."));
+        }
         catch (const std::exception &e) {
             GWARN_STREAM("Worker " << address << " failed: " << e.what());
-            fail_pending_messages(std::current_exception());
+            failure = std::current_exception();
         }
         switch_to_closed_modules();
+        fail_pending_messages(failure);
     }
 
-    void Worker::process_inbound_message(Core::Message message) {
+    void RemoteWorker::process_inbound_message(Core::Message message) {
         GDEBUG_STREAM("Received message from remote worker " << address);
 
-        std::lock_guard<std::mutex> guard(mutex);
-
+        std::unique_lock<std::mutex> lock(mutex);
         auto job = std::move(jobs.front()); jobs.pop_front();
-        timing.latest = time_since(job.start);
-        job.response.set_value(std::move(message));
+        lock.unlock();
+
+        job.respond(std::move(message));
     }
 
-    void Worker::fail_pending_messages(const std::exception_ptr &e) {
-        std::lock_guard<std::mutex> guard(mutex);
+    void RemoteWorker::fail_pending_messages(const std::exception_ptr &e) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto pending = std::move(jobs); jobs.clear();
+        lock.unlock();
 
-        for (auto &job : jobs) {
-            job.response.set_exception(e);
-        }
+        for (auto &job : pending) job.fail(e);
     }
 
-    void Worker::switch_to_closed_modules() {
+    void RemoteWorker::switch_to_closed_modules() {
         std::lock_guard<std::mutex> guard(mutex);
-        load_module = std::make_unique<ClosedLoadModule>(*this);
         push_module = std::make_unique<ClosedPushModule>(*this);
     }
 }
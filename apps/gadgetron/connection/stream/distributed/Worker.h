@@ -1,8 +1,7 @@
 #pragma once
 
-#include <chrono>
 #include <memory>
-#include <future>
+#include <functional>
 
 #include "connection/Core.h"
 #include "connection/stream/common/Serialization.h"
@@ -15,37 +14,49 @@
 
 namespace Gadgetron::Server::Connection::Stream {
 
+    /**
+     * Processes messages on behalf of a Pool. Pushing a message never waits for the job to finish; the outcome
+     * is reported through one of the callbacks, which may be invoked from any thread.
+     */
     class Worker {
+    public:
+        using Response = std::function<void(Core::Message)>;
+        using Failure = std::function<void(std::exception_ptr)>;
+
+        virtual ~Worker() = default;
+
+        /// Throws if the worker is closed or has failed.
+        virtual void push(Core::Message message, Response on_response, Failure on_failure) = 0;
+        virtual void close() = 0;
+        virtual std::string describe() const = 0;
+    };
+
+    class RemoteWorker : public Worker {
     public:
         const Address address;
 
-        ~Worker();
-        Worker(
+        ~RemoteWorker() override;
+        RemoteWorker(
                 Address address,
                 std::shared_ptr<Serialization> serialization,
                 std::shared_ptr<Configuration> configuration
         );
 
-        std::future<Core::Message> push(Core::Message message);
-        long long current_load() const;
-        void close();
+        void push(Core::Message message, Response on_response, Failure on_failure) override;
+        void close() override;
+        std::string describe() const override;
 
     private:
         mutable std::mutex mutex;
 
         std::thread inbound_thread;
 
-        struct Timing {
-            std::chrono::milliseconds latest = std::chrono::seconds(5);
-        } timing;
-
         struct Job;
         std::list<Job> jobs;
         std::unique_ptr<ExternalChannel> channel;
 
-        struct PushModule; struct LoadModule; struct ClosedPushModule; struct ClosedLoadModule;
+        struct PushModule; struct ClosedPushModule;
         std::unique_ptr<PushModule> push_module;
-        std::unique_ptr<LoadModule> load_module;
         void switch_to_closed_modules();
 
         void handle_inbound_messages();
@@ -9,13 +9,20 @@
 
 namespace Gadgetron::Server::Connection::Stream {
 
-    boost::process::child start_matlab_module(const Config::Execute &execute, unsigned short port, const Gadgetron::Core::Context &context) {
+    boost::process::child start_matlab_module(
+            const Config::Execute &execute,
+            unsigned short port,
+            boost::process::environment environment,
+            const Gadgetron::Core::Context &context
+    ) {
+
+        environment["GADGETRON_EXTERNAL_PORT"] = std::to_string(port);
+        environment["GADGETRON_EXTERNAL_MODULE"] = execute.name;
 
         boost::process::child module(
                 boost::process::search_path("matlab"),
                 boost::process::args={"-batch", "gadgetron.external.main"},
-                boost::process::env["GADGETRON_EXTERNAL_PORT"] = std::to_string(port),
-                boost::process::env["GADGETRON_EXTERNAL_MODULE"] = execute.name
+                environment
         );
 
         GINFO_STREAM("Started external MATLAB module (pid: " << module.id() << ").");
@@ -7,6 +7,11 @@
 #include "Context.h"
 
 namespace Gadgetron::Server::Connection::Stream {
-    boost::process::child start_matlab_module(const Config::Execute &, unsigned short port, const Gadgetron::Core::Context &);
+    boost::process::child start_matlab_module(
+            const Config::Execute &,
+            unsigned short port,
+            boost::process::environment environment,
+            const Gadgetron::Core::Context &
+    );
     bool matlab_available() noexcept;
 }
\ No newline at end of file
@@ -10,7 +10,12 @@
 
 namespace Gadgetron::Server::Connection::Stream {
 
-    boost::process::child start_python_module(const Config::Execute &execute, unsigned short port, const Gadgetron::Core::Context &context) {
+    boost::process::child start_python_module(
+            const Config::Execute &execute,
+            unsigned short port,
+            boost::process::environment environment,
+            const Gadgetron::Core::Context &context
+    ) {
 
         auto python_path = (context.paths.gadgetron_home / "share" / "gadgetron" / "python").string();
 
@@ -22,10 +27,12 @@ namespace Gadgetron::Server::Connection::Stream {
 
         if(execute.target) args.push_back(execute.target.value());
 
+        environment["PYTHONPATH"] += python_path;
+
         boost::process::child module(
                 boost::process::search_path("python3"),
                 boost::process::args=args,
-                boost::process::env["PYTHONPATH"]+={python_path}
+                environment
         );
 
         GINFO_STREAM("Started external Python module (pid: " << module.id() << ").");
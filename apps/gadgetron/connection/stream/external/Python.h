@@ -7,7 +7,12 @@
 #include "Context.h"
 
 namespace Gadgetron::Server::Connection::Stream {
-    boost::process::child start_python_module(const Config::Execute &, unsigned short port, const Gadgetron::Core::Context &);
+    boost::process::child start_python_module(
+            const Config::Execute &,
+            unsigned short port,
+            boost::process::environment environment,
+            const Gadgetron::Core::Context &
+    );
     bool python_available() noexcept;
 }
 
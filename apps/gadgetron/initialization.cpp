@@ -1,6 +1,19 @@
 
 #include "initialization.h"
 
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+#include "gadgetron_config.h"
+#include "connection/Config.h"
+#include "connection/Loader.h"
+
+#include "hoMemoryPool.h"
+#include "hoNDFFT.h"
+#include "log.h"
+
 #ifdef FORCE_LIMIT_OPENBLAS_NUM_THREADS
 #include <cblas.h>
 #endif
@@ -19,4 +32,75 @@ namespace Gadgetron::Server {
 #endif
 
     }
+
+    void configure_fft_libraries(const boost::program_options::variables_map& args) {
+
+        auto planning = args["fft_planning"].as<std::string>();
+        if (planning == "measure") {
+            FFT::set_planning_mode(FFT::PlanningMode::Measure);
+        } else if (planning != "estimate") {
+            throw std::runtime_error("Unknown FFT planning mode: " + planning);
+        }
+
+        /*
+         * Wisdom is most useful with measured plans, but importing it is cheap and lets estimated plans pick up
+         * anything a previous measuring run has learned.
+         */
+        auto wisdom_folder = args["home"].as<boost::filesystem::path>() / "share" / "gadgetron" / "fftw";
+        try {
+            boost::filesystem::create_directories(wisdom_folder);
+            FFT::use_wisdom_folder(wisdom_folder.string());
+        } catch (const boost::filesystem::filesystem_error& error) {
+            GWARN_STREAM("FFTW wisdom disabled; " << error.what());
+        }
+    }
+
+    void configure_memory_pool(const boost::program_options::variables_map& args) {
+
+        auto mode = args["memory_pool"].as<std::string>();
+        if (mode != "off" && mode != "on" && mode != "connection") {
+            throw std::runtime_error("Unknown memory pool mode: " + mode);
+        }
+
+        hoMemoryPool::enable(mode != "off");
+        hoMemoryPool::set_cache_limit(args["memory_pool_cache"].as<size_t>() << 20);
+    }
+
+    void prewarm(const boost::program_options::variables_map& args) {
+
+        auto names = args["prewarm"].as<std::vector<std::string>>();
+        if (names.empty()) return;
+
+        auto start = std::chrono::steady_clock::now();
+        auto config_folder = args["home"].as<boost::filesystem::path>() / GADGETRON_CONFIG_PATH;
+
+        std::vector<boost::filesystem::path> files;
+        if (names.size() == 1 && names.front() == "all") {
+            for (auto& entry : boost::filesystem::directory_iterator(config_folder)) {
+                if (entry.path().extension() == ".xml") files.push_back(entry.path());
+            }
+        } else {
+            for (auto& name : names) files.push_back(config_folder / name);
+        }
+
+        /*
+         * Only libraries and configs are prepared here; nothing is computed. Connections are forked from this
+         * process, and a child does not get working copies of the threads (e.g. OpenMP's) its parent has started.
+         */
+        size_t prepared = 0;
+        for (auto& file : files) {
+            try {
+                std::ifstream stream(file.string());
+                if (!stream) throw std::runtime_error("Unable to open file");
+                auto config = Connection::parse_config_cached(std::string(std::istreambuf_iterator<char>(stream), {}));
+                Connection::Loader::preload(config);
+                prepared++;
+            } catch (const std::exception& e) {
+                GWARN_STREAM("Unable to prewarm config " << file << ": " << e.what());
+            }
+        }
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        GINFO_STREAM("Prewarmed " << prepared << " of " << files.size() << " configs in " << elapsed.count() << " ms");
+    }
 }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <boost/program_options/variables_map.hpp>
+
 namespace Gadgetron::Server {
     void configure_blas_libraries();
+    void configure_fft_libraries(const boost::program_options::variables_map& args);
+    void configure_memory_pool(const boost::program_options::variables_map& args);
+    void prewarm(const boost::program_options::variables_map& args);
 
 
 }
\ No newline at end of file
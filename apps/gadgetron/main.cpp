@@ -31,7 +31,42 @@ int main(int argc, char *argv[]) {
              "Set the Gadgetron home directory.")
             ("port,p",
              value<unsigned short>()->default_value(9002),
-             "Listen for incoming connections on this port.");
+             "Listen for incoming connections on this port.")
+            ("fft_planning",
+             value<std::string>()->default_value("estimate"),
+             "FFTW planning rigor, 'estimate' or 'measure'. Plans are cached per array shape either way.")
+            ("socket_ingest",
+             value<std::string>()->default_value("default"),
+             "Socket ingest mode for client connections, 'default' or 'throughput'. Throughput mode uses MB-sized "
+             "buffers and reads large payloads directly into array storage.")
+            ("socket_receive_buffer",
+             value<int>()->default_value(0),
+             "Kernel receive buffer size (SO_RCVBUF) in bytes for client connections. 0 uses the ingest mode's setting.")
+            ("memory_pool",
+             value<std::string>()->default_value("off"),
+             "Recycle array storage through a size-class pool: 'off', 'on', or 'connection' to also release the "
+             "memory cached by a connection when it ends.")
+            ("memory_pool_cache",
+             value<size_t>()->default_value(1024),
+             "Upper bound in MiB on the memory the pool keeps cached for reuse.")
+            ("telemetry_interval",
+             value<unsigned int>()->default_value(0),
+             "Seconds between summaries of per node and per channel activity in the log. 0 disables them; the "
+             "counters can still be queried with 'gadgetron::telemetry'.")
+            ("external_local_transport",
+             value<bool>()->default_value(false),
+             "Experimental: also offer external modules started by the Gadgetron a Unix socket with shared memory "
+             "buffers, passed in GADGETRON_EXTERNAL_LOCAL_SOCKET. Modules that do not support it connect over TCP "
+             "as before.")
+            ("trace_folder",
+             value<std::string>()->default_value(""),
+             "Folder in which to write a Chrome trace (chrome://tracing) of each connection, with a span for every "
+             "message handled by every node and for the timed reconstruction steps. Empty disables tracing.")
+            ("prewarm",
+             value<std::vector<std::string>>()->multitoken()->default_value({}, ""),
+             "Config files (in the config folder) to prepare before accepting connections, or 'all'. Their "
+             "libraries are loaded and the configs parsed once, in the server, and connections start with both "
+             "in place.");
 
     variables_map args;
     store(parse_command_line(argc, argv, desc), args);
@@ -52,6 +87,9 @@ int main(int argc, char *argv[]) {
 
     try {
         configure_blas_libraries();
+        configure_fft_libraries(args);
+        configure_memory_pool(args);
+        prewarm(args);
 
         // Ensure working directory exists.
         create_directories(args["dir"].as<path>());
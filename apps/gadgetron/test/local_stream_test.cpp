@@ -0,0 +1,125 @@
+#include "../connection/LocalStream.h"
+#include <boost/asio.hpp>
+#include <gtest/gtest.h>
+#include <future>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace ba = boost::asio;
+using local = boost::asio::local::stream_protocol;
+using namespace Gadgetron;
+
+class LocalStreamTest : public ::testing::Test {
+public:
+    void connect(const Connection::LocalStreamOptions& options_a, const Connection::LocalStreamOptions& options_b) {
+        auto socket_a = std::make_unique<local::socket>(ios);
+        auto socket_b = std::make_unique<local::socket>(ios);
+        ba::local::connect_pair(*socket_a, *socket_b);
+
+        // Both sides exchange hellos, so they need to be set up concurrently.
+        auto future_b = std::async(std::launch::async, [&]() {
+            return Connection::stream_from_local_socket(std::move(socket_b), options_b);
+        });
+        a = Connection::stream_from_local_socket(std::move(socket_a), options_a);
+        b = future_b.get();
+    }
+
+    static std::vector<char> random_data(size_t size) {
+        std::mt19937_64 engine;
+        std::uniform_int_distribution<int> distribution(0, 255);
+        auto data = std::vector<char>(size);
+        for (auto& d : data) d = char(distribution(engine));
+        return data;
+    }
+
+    ba::io_service ios{};
+    std::unique_ptr<std::iostream> a, b;
+};
+
+static void mixed_transfer(std::iostream& from, std::iostream& to) {
+    auto sizes = std::vector<size_t>{ 2, 340, 1u << 16, 2, 340, 3u << 20, 7, 1u << 17, 1, 5u << 20, 8 };
+    auto data  = LocalStreamTest::random_data(std::accumulate(sizes.begin(), sizes.end(), size_t(0)));
+
+    auto thread = std::thread([&]() {
+        size_t offset = 0;
+        for (auto size : sizes) {
+            from.write(data.data() + offset, size);
+            offset += size;
+        }
+        from.flush();
+    });
+
+    auto received = std::vector<char>(data.size());
+    size_t offset = 0;
+    for (auto size : sizes) {
+        to.read(received.data() + offset, size);
+        offset += size;
+    }
+    thread.join();
+
+    ASSERT_TRUE(to.good());
+    ASSERT_EQ(data, received);
+}
+
+TEST_F(LocalStreamTest, mixed_transfer) {
+    connect({}, {});
+    mixed_transfer(*a, *b);
+    mixed_transfer(*b, *a);
+}
+
+TEST_F(LocalStreamTest, payload_larger_than_ring) {
+    Connection::LocalStreamOptions small_ring;
+    small_ring.ring_size = 64u << 10;
+    small_ring.shared_write_size = 1u << 10;
+    connect(small_ring, small_ring);
+
+    mixed_transfer(*a, *b);
+}
+
+TEST_F(LocalStreamTest, peer_without_ring) {
+    Connection::LocalStreamOptions no_ring;
+    no_ring.ring_size = 0;
+    connect({}, no_ring);
+
+    mixed_transfer(*a, *b);
+    mixed_transfer(*b, *a);
+}
+
+TEST_F(LocalStreamTest, small_writes_wait_for_flush) {
+    connect({}, {});
+
+    const std::string name = "Albatros";
+    *a << name << std::flush;
+
+    std::vector<char> received(name.size());
+    b->read(received.data(), received.size());
+    ASSERT_EQ(name, std::string(received.begin(), received.end()));
+}
+
+TEST_F(LocalStreamTest, full_ring_notices_disconnect) {
+    Connection::LocalStreamOptions small_ring;
+    small_ring.ring_size = 64u << 10;
+    small_ring.shared_write_size = 1u << 10;
+    connect(small_ring, {});
+
+    auto data = random_data(1u << 20);
+    auto writer = std::async(std::launch::async, [&]() { a->write(data.data(), data.size()); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    b.reset();
+
+    ASSERT_EQ(writer.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    ASSERT_TRUE(a->bad());
+}
+
+TEST(LocalPeerTest, same_user) {
+    ba::io_service ios;
+    local::socket socket_a(ios), socket_b(ios);
+    ba::local::connect_pair(socket_a, socket_b);
+    EXPECT_TRUE(Connection::local_peer_is_same_user(socket_a));
+
+    local::socket unconnected(ios);
+    unconnected.open();
+    EXPECT_FALSE(Connection::local_peer_is_same_user(unconnected));
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include "connection/stream/ParallelWindow.h"
+
+#include <algorithm>
+#include <future>
+#include <random>
+#include <thread>
+
+using namespace Gadgetron::Core;
+using namespace Gadgetron::Server::Connection::Stream;
+using namespace std::chrono_literals;
+
+namespace {
+
+    template <class T> bool blocked(std::future<T> &future) {
+        return future.wait_for(50ms) == std::future_status::timeout;
+    }
+
+    /// Runs items through a window, with workers that take a random time each so that they finish out of order.
+    std::vector<int> run_items(ParallelWindow &window, int items) {
+        std::vector<std::thread> workers;
+        std::thread input([&]() {
+            for (int i = 0; i < items; i++) {
+                auto sequence = window.admit(0);
+                workers.emplace_back([&window, sequence, i]() {
+                    std::mt19937 random(i);
+                    std::this_thread::sleep_for(std::chrono::microseconds(random() % 2000));
+                    window.complete(sequence, 0, Message(i), nullptr);
+                });
+            }
+            window.close();
+        });
+
+        std::vector<int> received;
+        try {
+            while (true) received.push_back(force_unpack<int>(window.pop()));
+        } catch (const ChannelClosed &) {}
+
+        input.join();
+        for (auto &worker : workers) worker.join();
+        return received;
+    }
+}
+
+TEST(ParallelWindowTest, deliversInInputOrderWhenWorkersFinishOutOfOrder) {
+    ParallelWindow window(4, 4, true);
+    auto received = run_items(window, 200);
+
+    ASSERT_EQ(received.size(), 200u);
+    for (int i = 0; i < 200; i++) EXPECT_EQ(received[i], i);
+    EXPECT_LE(window.peak_in_flight(), 4u);
+}
+
+TEST(ParallelWindowTest, unorderedDeliversEveryResult) {
+    ParallelWindow window(4, 4, false);
+    auto received = run_items(window, 200);
+
+    std::sort(received.begin(), received.end());
+    ASSERT_EQ(received.size(), 200u);
+    for (int i = 0; i < 200; i++) EXPECT_EQ(received[i], i);
+    EXPECT_LE(window.peak_in_flight(), 4u);
+}
+
+TEST(ParallelWindowTest, completedItemsCountUntilPopped) {
+    ParallelWindow window(2, 2, true);
+    auto first = window.admit(0);
+    auto second = window.admit(0);
+
+    auto third = std::async(std::launch::async, [&]() { return window.admit(0); });
+    EXPECT_TRUE(blocked(third));
+
+    // The second item finishes first; it is neither delivered nor does it make room before the first
+    window.complete(second, 0, Message(1), nullptr);
+    auto popped = std::async(std::launch::async, [&]() { return force_unpack<int>(window.pop()); });
+    EXPECT_TRUE(blocked(popped));
+    EXPECT_TRUE(blocked(third));
+
+    window.complete(first, 0, Message(0), nullptr);
+    EXPECT_EQ(popped.get(), 0);
+    EXPECT_EQ(third.get(), 2u);
+
+    EXPECT_EQ(force_unpack<int>(window.pop()), 1);
+    window.complete(2, 0, Message(2), nullptr);
+    window.close();
+    EXPECT_EQ(force_unpack<int>(window.pop()), 2);
+    EXPECT_THROW(window.pop(), ChannelClosed);
+    EXPECT_EQ(window.peak_in_flight(), 2u);
+}
+
+TEST(ParallelWindowTest, limitsRunningItems) {
+    ParallelWindow window(4, 1, true);
+    auto first = window.admit(0);
+
+    auto second = std::async(std::launch::async, [&]() { return window.admit(0); });
+    EXPECT_TRUE(blocked(second));
+
+    // A completed item no longer runs, so the next one is admitted before the first is popped
+    window.complete(first, 0, Message(0), nullptr);
+    EXPECT_EQ(second.get(), 1u);
+}
+
+TEST(ParallelWindowTest, abandonReleasesBlockedInput) {
+    ParallelWindow window(1, 1, true);
+    window.admit(0);
+
+    auto second = std::async(std::launch::async, [&]() { return window.admit(0); });
+    EXPECT_TRUE(blocked(second));
+
+    window.abandon();
+    EXPECT_THROW(second.get(), ChannelClosed);
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include "connection/stream/distributed/LocalWorker.h"
+#include "connection/stream/distributed/Pool.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <set>
+#include <thread>
+
+using namespace Gadgetron::Core;
+using namespace Gadgetron::Server::Connection::Stream;
+using namespace std::chrono_literals;
+
+namespace {
+
+    std::unique_ptr<Worker> delaying_worker(std::chrono::milliseconds delay) {
+        return std::make_unique<LocalWorker>([=](Message message) {
+            std::this_thread::sleep_for(delay);
+            return message;
+        });
+    }
+
+    template<class F>
+    std::vector<Message> run(Pool &pool, int jobs, F make_message) {
+        auto producer = std::thread([&]() {
+            for (int i = 0; i < jobs; i++) pool.push(make_message(i));
+            pool.close();
+        });
+
+        std::vector<Message> received;
+        try {
+            while (true) received.push_back(pool.pop());
+        } catch (const ChannelClosed &) {}
+
+        producer.join();
+        return received;
+    }
+
+    std::vector<int> run(Pool &pool, int jobs) {
+        std::vector<int> received;
+        for (auto &message : run(pool, jobs, [](int i) { return Message(i); }))
+            received.push_back(force_unpack<int>(std::move(message)));
+        return received;
+    }
+}
+
+TEST(PoolTest, orderedDeliveryWithStraggler) {
+    std::list<std::unique_ptr<Worker>> workers;
+    workers.push_back(delaying_worker(20ms));
+    workers.push_back(delaying_worker(0ms));
+
+    Pool pool(std::move(workers), Pool::Settings{2, true});
+    auto received = run(pool, 50);
+
+    ASSERT_EQ(received.size(), 50u);
+    for (int i = 0; i < 50; i++) EXPECT_EQ(received[i], i);
+}
+
+TEST(PoolTest, unorderedDeliveryDoesNotWaitForStraggler) {
+    std::list<std::unique_ptr<Worker>> workers;
+    workers.push_back(delaying_worker(200ms));
+    workers.push_back(delaying_worker(0ms));
+
+    Pool pool(std::move(workers), Pool::Settings{1, false});
+    auto received = run(pool, 20);
+
+    ASSERT_EQ(received.size(), 20u);
+    EXPECT_NE(received.front(), 0);
+    std::sort(received.begin(), received.end());
+    for (int i = 0; i < 20; i++) EXPECT_EQ(received[i], i);
+}
+
+TEST(PoolTest, failedJobsAreRetriedOnOtherWorkers) {
+    std::list<std::unique_ptr<Worker>> workers;
+    workers.push_back(std::make_unique<LocalWorker>([](Message) -> Message {
+        throw std::runtime_error("Worker is broken.");
+    }));
+    workers.push_back(delaying_worker(1ms));
+
+    Pool pool(std::move(workers), Pool::Settings{2, true});
+    auto received = run(pool, 20);
+
+    ASSERT_EQ(received.size(), 20u);
+    for (int i = 0; i < 20; i++) EXPECT_EQ(received[i], i);
+}
+
+TEST(PoolTest, abortsWhenAllWorkersFail) {
+    std::list<std::unique_ptr<Worker>> workers;
+    workers.push_back(std::make_unique<LocalWorker>([](Message) -> Message {
+        throw std::runtime_error("Worker is broken.");
+    }));
+
+    Pool pool(std::move(workers), Pool::Settings{});
+    pool.push(Message(1));
+    pool.close();
+
+    EXPECT_THROW(pool.pop(), std::runtime_error);
+}
+
+namespace {
+
+    Message acquisition(uint16_t slice) {
+        ISMRMRD::AcquisitionHeader header{};
+        header.idx.slice = slice;
+        return Message(header);
+    }
+
+    std::unique_ptr<Worker> counting_worker(std::chrono::milliseconds delay, std::vector<uint16_t> &slices) {
+        return std::make_unique<LocalWorker>([=, &slices](Message message) {
+            slices.push_back(unpack_view<ISMRMRD::AcquisitionHeader>(message).idx.slice);
+            std::this_thread::sleep_for(delay);
+            return message;
+        });
+    }
+}
+
+TEST(PoolTest, stickySchedulingKeepsSlicesOnOneWorker) {
+    std::array<std::vector<uint16_t>, 3> slices;
+    std::list<std::unique_ptr<Worker>> workers;
+    for (auto &seen : slices) workers.push_back(counting_worker(1ms, seen));
+
+    Pool pool(std::move(workers), Pool::Settings{2, true}, make_scheduling_policy("sticky", "slice"));
+    EXPECT_EQ(run(pool, 60, [](int i) { return acquisition(i % 6); }).size(), 60u);
+
+    std::set<uint16_t> all;
+    for (auto &seen : slices) {
+        std::set<uint16_t> unique(seen.begin(), seen.end());
+        for (auto slice : unique) EXPECT_TRUE(all.insert(slice).second) << "Slice " << slice << " on several workers";
+    }
+    EXPECT_EQ(all.size(), 6u);
+}
+
+namespace {
+
+    /**
+     * Dispatches jobs to a scheduling policy as the Pool does, against a simulated clock rather than real workers.
+     * Each worker handles one job at a time, taking its service time for each, and holds at most max_in_flight;
+     * its service time is known to the policy once it has completed a job. Time only passes while no worker can
+     * take the next job. Returns the number of jobs sent to each worker.
+     */
+    std::vector<size_t> simulate(SchedulingPolicy &policy, const std::vector<std::chrono::milliseconds> &service_times,
+                                 size_t max_in_flight, int jobs) {
+        struct SimulatedWorker {
+            std::chrono::milliseconds service_time;
+            std::deque<std::chrono::milliseconds> completions;
+            size_t completed = 0;
+        };
+
+        std::vector<SimulatedWorker> workers;
+        for (auto service_time : service_times) workers.push_back(SimulatedWorker{service_time});
+        std::vector<size_t> dispatched(workers.size(), 0);
+        auto now = 0ms;
+
+        for (int job = 0; job < jobs;) {
+            std::vector<WorkerLoad> loads;
+            for (auto &worker : workers) {
+                auto in_flight = worker.completions.size();
+                std::chrono::nanoseconds measured = worker.completed ? worker.service_time : 0ms;
+                loads.push_back(WorkerLoad{in_flight, true, in_flight >= max_in_flight, measured});
+            }
+
+            if (auto selected = policy.select(Message(job), loads)) {
+                auto &worker = workers[*selected];
+                auto start = worker.completions.empty() ? now : worker.completions.back();
+                worker.completions.push_back(start + worker.service_time);
+                dispatched[*selected]++;
+                job++;
+                continue;
+            }
+
+            auto next = std::chrono::milliseconds::max();
+            for (auto &worker : workers)
+                if (!worker.completions.empty()) next = std::min(next, worker.completions.front());
+            now = next;
+            for (auto &worker : workers) {
+                while (!worker.completions.empty() && worker.completions.front() <= now) {
+                    worker.completions.pop_front();
+                    worker.completed++;
+                }
+            }
+        }
+        return dispatched;
+    }
+}
+
+TEST(PoolTest, latencyAwareSchedulingFavoursFastWorkers) {
+    LatencyAware policy;
+    auto dispatched = simulate(policy, {20ms, 1ms}, 4, 100);
+
+    // Once their service times are known, the slow worker only gets a job while the fast one is full
+    EXPECT_EQ(dispatched[0] + dispatched[1], 100u);
+    EXPECT_LT(dispatched[0], dispatched[1] / 4);
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include "connection/stream/Scheduler.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif // USE_OMP
+
+using namespace Gadgetron::Core;
+using namespace Gadgetron::Server::Connection;
+using namespace Gadgetron::Server::Connection::Stream;
+using namespace std::chrono_literals;
+
+namespace {
+
+    struct Events {
+        std::mutex m;
+        std::vector<std::string> log;
+
+        void add(const std::string &event) {
+            std::lock_guard<std::mutex> guard(m);
+            log.push_back(event);
+        }
+
+        size_t index(const std::string &event) {
+            return std::find(log.begin(), log.end(), event) - log.begin();
+        }
+    };
+
+    class Reporter : public ErrorReporter {
+    public:
+        void operator()(const std::string &location, const std::string &message) override {
+            std::lock_guard<std::mutex> guard(m);
+            errors.push_back(location + ": " + message);
+        }
+
+        std::mutex m;
+        std::vector<std::string> errors;
+    };
+
+    /// Passes on ints, recording what it sees, and checking that it is never called concurrently.
+    class RecordingNode : public Node, public MessageDrivenNode {
+    public:
+        RecordingNode(std::string name, Events &events) : name(std::move(name)), events(events) {}
+
+        void process(GenericInputChannel &in, OutputChannel &out) override {
+            start(out);
+            for (auto message : in) process_message(std::move(message), out);
+            finish(out);
+        }
+
+        void start(OutputChannel &) override {
+            events.add(name + ":start");
+        }
+
+        void process_message(Message message, OutputChannel &out) override {
+            EXPECT_EQ(in_flight.fetch_add(1), 0) << name << " was called concurrently";
+            auto value = force_unpack<int>(std::move(message));
+            received.push_back(value);
+            on_message();
+            std::this_thread::sleep_for(std::chrono::microseconds(value % 3 * 50));
+            in_flight--;
+            out.push(value);
+        }
+
+        void finish(OutputChannel &) override {
+            events.add(name + ":finish");
+        }
+
+        std::function<void()> on_message = []() {};
+        std::vector<int> received;
+
+    private:
+        const std::string name;
+        Events &events;
+        std::atomic<int> in_flight{0};
+    };
+
+    std::vector<int> run_chain(std::vector<std::shared_ptr<Processable>> nodes, Config::Scheduler scheduler,
+                               int messages, Reporter &reporter) {
+        auto input = make_channel<MessageChannel>();
+        auto output = make_channel<MessageChannel>();
+
+        std::thread producer([&, in = std::move(input.output)]() mutable {
+            for (int i = 0; i < messages; i++) in.push(i);
+        });
+
+        std::vector<int> received;
+        std::thread consumer([&, out = std::move(output.input)]() mutable {
+            for (auto message : out) received.push_back(force_unpack<int>(std::move(message)));
+        });
+
+        ErrorHandler error_handler(reporter, "test");
+        process_chain("test", nodes, scheduler, std::move(input.input), std::move(output.output), error_handler);
+
+        producer.join();
+        consumer.join();
+        return received;
+    }
+
+    class SchedulerTest : public ::testing::TestWithParam<bool> {
+    protected:
+        Config::Scheduler scheduler() const {
+            return Config::Scheduler{GetParam(), 2};
+        }
+    };
+}
+
+TEST_P(SchedulerTest, nodesSeeMessagesInOrderAndFinishInChainOrder) {
+    Events events;
+    std::vector<RecordingNode *> recorders;
+    std::vector<std::shared_ptr<Processable>> nodes;
+    for (auto name : {"first", "a", "b", "c"}) {
+        auto node = std::make_unique<RecordingNode>(name, events);
+        recorders.push_back(node.get());
+        nodes.push_back(std::make_shared<NodeProcessable>(std::move(node), name));
+    }
+
+    Reporter reporter;
+    auto received = run_chain(nodes, scheduler(), 200, reporter);
+    EXPECT_TRUE(reporter.errors.empty());
+
+    ASSERT_EQ(received.size(), 200u);
+    for (int i = 0; i < 200; i++) EXPECT_EQ(received[i], i);
+    for (auto recorder : recorders) EXPECT_EQ(recorder->received, received);
+
+    // Every node starts before and finishes after its own messages, and only once the node before it has finished.
+    for (auto name : {"first", "a", "b", "c"}) {
+        EXPECT_EQ(std::count(events.log.begin(), events.log.end(), name + std::string(":start")), 1);
+        EXPECT_EQ(std::count(events.log.begin(), events.log.end(), name + std::string(":finish")), 1);
+    }
+    EXPECT_LT(events.index("first:finish"), events.index("a:finish"));
+    EXPECT_LT(events.index("a:finish"), events.index("b:finish"));
+    EXPECT_LT(events.index("b:finish"), events.index("c:finish"));
+}
+
+TEST_P(SchedulerTest, finishesWithoutMessages) {
+    Events events;
+    std::vector<std::shared_ptr<Processable>> nodes;
+    for (auto name : {"first", "a", "b"})
+        nodes.push_back(std::make_shared<NodeProcessable>(std::make_unique<RecordingNode>(name, events), name));
+
+    Reporter reporter;
+    EXPECT_TRUE(run_chain(nodes, scheduler(), 0, reporter).empty());
+    EXPECT_LT(events.index("a:finish"), events.index("b:finish"));
+    EXPECT_LT(events.index("b:finish"), events.log.size());
+}
+
+INSTANTIATE_TEST_SUITE_P(Scheduler, SchedulerTest, ::testing::Values(false, true));
+
+#ifdef USE_OMP
+TEST(SchedulerTest, nodesDoNotChangeTheThreadCountOfOtherNodes) {
+    Events events;
+    auto first = std::make_unique<RecordingNode>("first", events);
+    auto limiting = std::make_unique<RecordingNode>("limiting", events);
+    auto observing = std::make_unique<RecordingNode>("observing", events);
+
+    // Both scheduled nodes share the only worker of the pool
+    int default_threads = 0;
+    std::vector<int> observed;
+    limiting->on_message = [&]() { omp_set_num_threads(default_threads + 4); };
+    observing->on_message = [&]() { observed.push_back(omp_get_max_threads()); };
+
+    std::vector<std::shared_ptr<Processable>> nodes{
+            std::make_shared<NodeProcessable>(std::move(first), "first"),
+            std::make_shared<NodeProcessable>(std::move(limiting), "limiting"),
+            std::make_shared<NodeProcessable>(std::move(observing), "observing")};
+
+    std::thread([&]() { default_threads = omp_get_max_threads(); }).join();
+
+    Reporter reporter;
+    run_chain(nodes, Config::Scheduler{true, 1}, 50, reporter);
+
+    ASSERT_EQ(observed.size(), 50u);
+    for (auto threads : observed) EXPECT_EQ(threads, default_threads);
+}
+#endif // USE_OMP
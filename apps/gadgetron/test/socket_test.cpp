@@ -4,6 +4,7 @@
 #include "../connection/SocketStreamBuf.h"
 #include <boost/asio.hpp>
 #include <gtest/gtest.h>
+#include <numeric>
 #include <random>
 
 namespace ba = boost::asio;
@@ -14,7 +15,7 @@ using namespace Gadgetron;
 class SocketTest : public ::testing::Test {
 
 public:
-    SocketTest() : ::testing::Test() {
+    explicit SocketTest(const Connection::SocketOptions& options = {}) : ::testing::Test() {
         auto endpoint = tcp::endpoint(tcp::v6(), 0);
         acceptor = std::make_unique<tcp::acceptor>(tcp::acceptor(ios, endpoint));
 
@@ -25,7 +26,7 @@ public:
             return socket;
         });
 
-        socketstream = Connection::remote_stream("localhost", std::to_string(port));
+        socketstream = Connection::remote_stream("localhost", std::to_string(port), options);
 
         server_socket = std::make_unique<tcp::socket>(socketF.get());
     }
@@ -38,6 +39,11 @@ public:
 
 };
 
+class IngestSocketTest : public SocketTest {
+public:
+    IngestSocketTest() : SocketTest(Connection::SocketOptions::ingest()) {}
+};
+
 TEST_F(SocketTest, read_test) {
 
     auto data = std::vector<char>(19,42);
@@ -102,3 +108,44 @@ TEST_F(SocketTest, nulltest) {
     thread.join();
 }
 
+
+static void mixed_reads(tcp::socket& server_socket, std::iostream& socketstream) {
+    auto sizes = std::vector<size_t>{ 2, 340, 1u << 16, 2, 340, 3u << 20, 7, 1u << 17, 1 };
+
+    std::mt19937_64 engine;
+    std::uniform_int_distribution<int> distribution(0, 255);
+    auto data = std::vector<char>(std::accumulate(sizes.begin(), sizes.end(), size_t(0)));
+    for (auto& d : data) d = char(distribution(engine));
+
+    auto thread = std::thread([&]() { ba::write(server_socket, ba::buffer(data.data(), data.size())); });
+
+    auto received = std::vector<char>(data.size());
+    size_t offset = 0;
+    for (auto size : sizes) {
+        socketstream.read(received.data() + offset, size);
+        offset += size;
+    }
+    thread.join();
+
+    ASSERT_EQ(data, received);
+}
+
+TEST_F(SocketTest, mixed_read_test) {
+    mixed_reads(*server_socket, *socketstream);
+}
+
+TEST_F(IngestSocketTest, mixed_read_test) {
+    mixed_reads(*server_socket, *socketstream);
+}
+
+TEST_F(IngestSocketTest, write_test) {
+    auto data = std::vector<char>(1u << 22, 42);
+
+    auto thread = std::thread([&]() { socketstream->write(data.data(), data.size()); });
+
+    auto data2 = std::vector<char>(data.size());
+    ba::read(*server_socket, ba::buffer(data2.data(), data2.size()));
+
+    ASSERT_EQ(data, data2);
+    thread.join();
+}
@@ -29,12 +29,74 @@ namespace Gadgetron::Core {
        channel.close();
     }
 
+    BoundedMessageChannel::BoundedMessageChannel(size_t capacity, size_t spin_count)
+        : channel(capacity, spin_count) {}
+
+    Message BoundedMessageChannel::pop() {
+        return channel.pop();
+    }
+
+    optional<Message> BoundedMessageChannel::try_pop() {
+        return channel.try_pop();
+    }
+
+    void BoundedMessageChannel::push_message(Message message) {
+        channel.push(std::move(message));
+    }
+
+    void BoundedMessageChannel::close() {
+        channel.close();
+    }
+
+    SPSCMessageChannel::SPSCMessageChannel(size_t capacity, size_t spin_count)
+        : channel(capacity, spin_count) {}
+
+    Message SPSCMessageChannel::pop() {
+        return channel.pop();
+    }
+
+    optional<Message> SPSCMessageChannel::try_pop() {
+        return channel.try_pop();
+    }
+
+    void SPSCMessageChannel::push_message(Message message) {
+        channel.push(std::move(message));
+    }
+
+    void SPSCMessageChannel::close() {
+        channel.close();
+    }
+
     Message GenericInputChannel::pop() {
-        return channel->pop();
+        if (!probe) return channel->pop();
+
+        auto asked = probe->idle();
+        try {
+            auto message = channel->pop();
+            probe->received(asked, true);
+            return message;
+        } catch (...) {
+            probe->closed(asked);
+            throw;
+        }
     }
 
     optional<Message> GenericInputChannel::try_pop() {
-        return channel->try_pop();
+        if (!probe) return channel->try_pop();
+
+        auto asked = probe->idle();
+        auto message = channel->try_pop();
+        if (message) probe->received(asked, false);
+        return message;
+    }
+
+    void GenericInputChannel::instrument(std::shared_ptr<Telemetry::ChannelStatistics> channel_statistics,
+                                         std::shared_ptr<Telemetry::NodeStatistics> consumer) {
+        if (probe) {
+            if (!channel_statistics) channel_statistics = probe->channel;
+            if (!consumer) consumer = probe->node;
+        }
+        probe = std::make_shared<Telemetry::InputProbe>(std::move(channel_statistics), std::move(consumer));
     }
 
     GenericInputChannel::GenericInputChannel(std::shared_ptr<Channel> channel) : channel{channel},
@@ -42,7 +104,27 @@ namespace Gadgetron::Core {
     }
 
     void OutputChannel::push_message(Gadgetron::Core::Message message) {
-        channel->push_message(std::move(message));
+        if (!probe) return channel->push_message(std::move(message));
+
+        // Counted before the push, so that the consumer never sees a negative depth.
+        probe->pushing(message.bytes());
+        auto started = Telemetry::Clock::now();
+        try {
+            channel->push_message(std::move(message));
+        } catch (...) {
+            probe->failed();
+            throw;
+        }
+        probe->pushed(started);
+    }
+
+    void OutputChannel::instrument(std::shared_ptr<Telemetry::ChannelStatistics> channel_statistics,
+                                   std::shared_ptr<Telemetry::NodeStatistics> producer) {
+        if (probe) {
+            if (!channel_statistics) channel_statistics = probe->channel;
+            if (!producer) producer = probe->node;
+        }
+        probe = std::make_shared<Telemetry::OutputProbe>(std::move(channel_statistics), std::move(producer));
     }
 
     OutputChannel::OutputChannel(std::shared_ptr<Channel> channel) : channel{channel},
@@ -7,6 +7,8 @@
 
 #include "MPMCChannel.h"
 #include "Message.h"
+#include "RingBuffer.h"
+#include "Telemetry.h"
 #include "Types.h"
 
 #include "ChannelIterator.h"
@@ -54,6 +56,13 @@ namespace Gadgetron { namespace Core {
 
         ChannelIterator<OutputChannel> begin();
 
+        /**
+         * Records the messages pushed through this end in channel, and the time spent blocked pushing them in
+         * producer. Either may be null, in which case statistics previously attached to this end are kept.
+         */
+        void instrument(std::shared_ptr<Telemetry::ChannelStatistics> channel,
+            std::shared_ptr<Telemetry::NodeStatistics> producer);
+
     private:
         OutputChannel(const OutputChannel&) = default;
 
@@ -65,6 +74,7 @@ namespace Gadgetron { namespace Core {
 
         std::shared_ptr<Channel> channel;
         std::shared_ptr<Channel::Closer> closer;
+        std::shared_ptr<Telemetry::OutputProbe> probe;
     };
 } }
 
@@ -89,6 +99,13 @@ namespace Gadgetron { namespace Core {
         /// Nonblocking method returning a message if one is available, or None otherwise
         optional<Message> try_pop();
 
+        /**
+         * Records the messages taken from this end in channel, and how long consumer waits for and works on each of
+         * them. Either may be null, in which case statistics previously attached to this end are kept.
+         */
+        void instrument(std::shared_ptr<Telemetry::ChannelStatistics> channel,
+            std::shared_ptr<Telemetry::NodeStatistics> consumer);
+
     private:
         GenericInputChannel(const GenericInputChannel&) = default;
 
@@ -100,6 +117,7 @@ namespace Gadgetron { namespace Core {
 
         std::shared_ptr<Channel::Closer> closer;
         std::shared_ptr<Channel> channel;
+        std::shared_ptr<Telemetry::InputProbe> probe;
     };
 
     template <class CHANNEL> class ChannelIterator;
@@ -122,6 +140,48 @@ namespace Gadgetron { namespace Core {
         MPMCChannel<Message> channel;
     };
 
+    /**
+     * A MessageChannel with a fixed capacity. Producers are blocked while the channel is full, which puts
+     * backpressure on upstream nodes rather than letting a slow consumer grow memory without bounds.
+     */
+    class BoundedMessageChannel : public Channel {
+    public:
+        explicit BoundedMessageChannel(size_t capacity = MPMCRingBuffer<Message>::default_capacity,
+            size_t spin_count = MPMCRingBuffer<Message>::default_spin_count);
+
+    protected:
+        Message pop() override;
+
+        optional<Message> try_pop() override;
+
+        void close() override;
+
+        void push_message(Message) override;
+
+        MPMCRingBuffer<Message> channel;
+    };
+
+    /**
+     * A bounded channel for exactly one producing and one consuming thread, e.g. between two nodes in a Stream.
+     * Do not split either end of this channel.
+     */
+    class SPSCMessageChannel : public Channel {
+    public:
+        explicit SPSCMessageChannel(size_t capacity = SPSCRingBuffer<Message>::default_capacity,
+            size_t spin_count = SPSCRingBuffer<Message>::default_spin_count);
+
+    protected:
+        Message pop() override;
+
+        optional<Message> try_pop() override;
+
+        void close() override;
+
+        void push_message(Message) override;
+
+        SPSCRingBuffer<Message> channel;
+    };
+
     /***
      * Creates a ChannelPair
      * @tparam ChannelType Type of Channel, typically MessageChannel
@@ -155,6 +215,16 @@ namespace Gadgetron { namespace Core {
             return force_unpack<TYPELIST...>(std::move(message));
         }
 
+        /// As pop, but leaves the message packed.
+        Message pop_message() {
+            Message message = in.pop();
+            while (!convertible_to<TYPELIST...>(message)) {
+                bypass.push_message(std::move(message));
+                message = in.pop();
+            }
+            return message;
+        }
+
         optional<decltype(force_unpack<TYPELIST...>(Message{}))> try_pop() {
 
             optional<Message> message = in.try_pop();
@@ -38,4 +38,16 @@ namespace Gadgetron {
         }
         gadget->close();
     }
+
+    void LegacyGadgetNode::start(Core::OutputChannel& out) {
+        gadget->next(std::make_shared<ChannelAdaptor>(out));
+    }
+
+    void LegacyGadgetNode::process_message(Core::Message message, Core::OutputChannel& out) {
+        gadget->process(message.to_container_message());
+    }
+
+    void LegacyGadgetNode::finish(Core::OutputChannel& out) {
+        gadget->close();
+    }
 }  // namespace Gadgetron
@@ -609,7 +609,7 @@ namespace Gadgetron {
     };
 
 
-    class LegacyGadgetNode : public Core::Node {
+    class LegacyGadgetNode : public Core::Node, public Core::MessageDrivenNode {
     public:
         LegacyGadgetNode(
                 std::unique_ptr<Gadget> gadget_ptr,
@@ -620,6 +620,10 @@ namespace Gadgetron {
         void process(Core::GenericInputChannel& in,
                      Core::OutputChannel& out) override;
 
+        void start(Core::OutputChannel& out) override;
+        void process_message(Core::Message message, Core::OutputChannel& out) override;
+        void finish(Core::OutputChannel& out) override;
+
     private:
 
         std::unique_ptr<Gadget> gadget;
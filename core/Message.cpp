@@ -35,4 +35,10 @@ Gadgetron::Core::Message Gadgetron::Core::Message::clone(){
         cloned_messages.emplace_back(chunk->clone());
 
     return Message(std::move(cloned_messages));
-}
\ No newline at end of file
+}
+size_t Gadgetron::Core::Message::bytes() const {
+    size_t total = 0;
+    for (const auto& chunk : messages_)
+        total += chunk->bytes();
+    return total;
+}
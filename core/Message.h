@@ -22,6 +22,9 @@ namespace Gadgetron {
         public:
             virtual ~MessageChunk() = default;
             virtual std::unique_ptr<MessageChunk> clone() const = 0;
+
+            /// Approximate size in memory, including the storage of arrays.
+            virtual size_t bytes() const { return 0; }
         protected:
             virtual GadgetContainerMessageBase *to_container_message() = 0;
 
@@ -47,8 +50,13 @@ namespace Gadgetron {
 
             GadgetContainerMessageBase *to_container_message();
 
+            /// A message sharing the payload of this one. Parts are copied when, and if, either message is unpacked
+            /// while the other still holds them.
             Message clone();
 
+            /// Approximate size in memory of all parts of the message.
+            size_t bytes() const;
+
         private:
             std::vector<std::unique_ptr<MessageChunk>> messages_;
         };
@@ -72,13 +80,40 @@ namespace Gadgetron {
         template<class T>
         optional<T> unpack(Message &&message);
 
+        /**
+         * Unpacks a message without taking it apart or copying its arrays. The arrays in the result refer to the
+         * storage of the message: they must not be modified, and must not outlive the message.
+         */
+        template<class ...ARGS>
+        std::enable_if_t<(sizeof...(ARGS) > 1), std::tuple<ARGS...>>
+        unpack_view(const Message &message);
+
+        template<class T>
+        T unpack_view(const Message &message);
+
+        /**
+         * Unpacks a message that is only going to be read, such as one handed to a writer. Parts no other message
+         * shares are moved out, as by force_unpack; shared arrays are viewed as by unpack_view rather than copied.
+         * The message keeps the shared parts alive, so it must outlive the result, and is of no other use after.
+         */
+        template<class ...ARGS>
+        std::enable_if_t<(sizeof...(ARGS) > 1), std::tuple<ARGS...>>
+        unpack_for_reading(Message &message);
+
+        template<class T>
+        T unpack_for_reading(Message &message);
+
 
+        /**
+         * Holds one part of a message. The payload is reference counted; clones and copies of a chunk share it, and
+         * it is only copied when one of them asks for mutable access (or takes the payload) while it is shared.
+         */
         template<class T>
         class TypedMessageChunk : public MessageChunk {
         public:
 
             template<class... ARGS>
-            explicit TypedMessageChunk(ARGS &&... xs) : data(std::forward<ARGS>(xs)...) {}
+            explicit TypedMessageChunk(ARGS &&... xs) : payload(std::make_shared<T>(std::forward<ARGS>(xs)...)) {}
 
             TypedMessageChunk(TypedMessageChunk &&other) = default;
 
@@ -92,10 +127,25 @@ namespace Gadgetron {
 
             std::unique_ptr<MessageChunk> clone() const override;
 
+            size_t bytes() const override;
+
             ~TypedMessageChunk() override = default;
 
-            T data;
+            const T &data() const { return *payload; }
+
+            /// Access for modification; copies the payload first if it is shared.
+            T &mutable_data();
 
+            /// The payload; moved out if this chunk is its only owner, copied otherwise.
+            T take();
+
+            /// A copy of the payload, except for arrays, which refer to the storage of this chunk.
+            T view() const;
+
+            bool shared() const { return payload.use_count() > 1; }
+
+        private:
+            std::shared_ptr<T> payload;
         };
     }
 }
@@ -4,7 +4,9 @@
 #include <boost/optional.hpp>
 #include <boost/hana.hpp>
 
+#include <atomic>
 #include <iostream>
+#include <type_traits>
 #include <boost/core/demangle.hpp>
 #include "Types.h"
 
@@ -13,13 +15,61 @@ namespace Gadgetron::Core {
 
     template<class T>
     GadgetContainerMessageBase* TypedMessageChunk<T>::to_container_message() {
-        return new GadgetContainerMessage<T>(std::move(data));
+        return new GadgetContainerMessage<T>(take());
     }
 
 
     template<class T>
     std::unique_ptr<MessageChunk> TypedMessageChunk<T>::clone() const {
-        return std::make_unique<TypedMessageChunk<T>>(data);
+        return std::make_unique<TypedMessageChunk<T>>(*this);
+    }
+
+    namespace detail {
+        template<class T>
+        struct View {
+            static T of(const T &data) { return data; }
+        };
+
+        template<class T>
+        struct View<hoNDArray<T>> {
+            static hoNDArray<T> of(const hoNDArray<T> &data) {
+                if (data.empty()) return hoNDArray<T>();
+                return hoNDArray<T>(data.dimensions(), const_cast<T *>(data.data()), false);
+            }
+        };
+
+        template<class T, class = void>
+        struct PayloadBytes {
+            static size_t of(const T &) { return 0; }
+        };
+
+        template<class T>
+        struct PayloadBytes<T, std::void_t<decltype(std::declval<const T &>().get_number_of_bytes())>> {
+            static size_t of(const T &data) { return data.get_number_of_bytes(); }
+        };
+    }
+
+    template<class T>
+    size_t TypedMessageChunk<T>::bytes() const {
+        return sizeof(T) + detail::PayloadBytes<T>::of(*payload);
+    }
+
+    template<class T>
+    T &TypedMessageChunk<T>::mutable_data() {
+        if (payload.use_count() > 1) payload = std::make_shared<T>(*payload);
+        // Pairs with the release of the last other owner, whose reads must happen before our writes.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return *payload;
+    }
+
+    template<class T>
+    T TypedMessageChunk<T>::take() {
+        return std::move(mutable_data());
+    }
+
+    template<class T>
+    T TypedMessageChunk<T>::view() const {
+        return detail::View<T>::of(*payload);
     }
 
     namespace {
@@ -85,7 +135,25 @@ namespace Gadgetron::Core {
 
             namespace hana = boost::hana;
 
-            struct detail {
+            // How the payload of a chunk is taken out of the message.
+            struct Take {
+                template<class T>
+                static T get(TypedMessageChunk<T> &chunk) { return chunk.take(); }
+            };
+
+            struct View {
+                template<class T>
+                static T get(TypedMessageChunk<T> &chunk) { return chunk.view(); }
+            };
+
+            // For a message that is given up: only shared payloads are viewed, the rest are moved out.
+            struct TakeOrView {
+                template<class T>
+                static T get(TypedMessageChunk<T> &chunk) { return chunk.shared() ? chunk.view() : chunk.take(); }
+            };
+
+            template<class ACCESS>
+            struct converter {
                 template<class Iterator>
                 static bool convertible(Iterator it, const Iterator &it_end) {
                     return true;
@@ -109,7 +177,7 @@ namespace Gadgetron::Core {
 
                 template<class T, class... SARGS>
                 static hana::tuple<T, SARGS...> combine(T &&val1, hana::tuple<SARGS...> &&val2) {
-                    return hana::prepend(val2, std::forward<T>(val1));
+                    return hana::prepend(std::move(val2), std::forward<T>(val1));
                 }
 
 
@@ -146,21 +214,21 @@ namespace Gadgetron::Core {
 
                 template<class Iterator, class T>
                 static T convert(Iterator &it, const Iterator &it_end, const hana::basic_type<T>&) {
-                    return std::move(reinterpret_message<T>(**it).data);
+                    return ACCESS::get(reinterpret_message<T>(**it));
                 }
 
                 template<class Iterator, class T>
                 static optional <T> convert(Iterator &it, const Iterator &it_end, const hana::basic_type<optional < T>>
 
                 ) {
-                    if (convertible(it, it_end, hana::type_c<T>)) return reinterpret_message<T>(**it).data;
+                    if (convertible(it, it_end, hana::type_c<T>)) return ACCESS::get(reinterpret_message<T>(**it));
                     return optional<T>();
                 }
 
                 template<class Iterator, class T, class... TYPES>
                 static hana::tuple<T, TYPES...> convert(Iterator &it, const Iterator &it_end, const hana::basic_type<T>&,
                                                         const hana::basic_type<TYPES> &...xs) {
-                    auto &value = reinterpret_message<T>(**it).data;
+                    auto value = ACCESS::get(reinterpret_message<T>(**it));
                     return combine(std::move(value), convert(++it, it_end, xs...));
                 }
 
@@ -172,7 +240,7 @@ namespace Gadgetron::Core {
                 ) {
 
                     if (convertible(it, it_end, hana::basic_type<T>(), xs...)) {
-                        auto &val = reinterpret_message<T>(**it).data;
+                        auto val = ACCESS::get(reinterpret_message<T>(**it));
                         return combine(optional<T>(std::move(val)), convert(++it, it_end, xs...));
                     }
                     return combine(optional<T>(), convert(it, it_end, xs...));
@@ -214,7 +282,8 @@ namespace Gadgetron::Core {
                                       const hana::basic_type<TYPES> &... xs) {
 
                     auto result = convert(it, it_end, xs...);
-                    return hana::unpack(result, [](auto ...xs) {
+                    // Unpacked as an rvalue, so the parts are moved, rather than copied, into the result.
+                    return hana::unpack(std::move(result), [](auto &&...xs) {
                         return std::make_tuple(std::move(xs)...);
                     });
 
@@ -233,7 +302,15 @@ namespace Gadgetron::Core {
                     return messageTuple_to_tuple(messages.begin(), messages.end(), hana::basic_type<ARGS>()...);
 
                 }
+
+                template<class ...ARGS>
+                static auto message_view(const Message &message) {
+                    auto &messages = message.messages();
+                    return messageTuple_to_tuple(messages.begin(), messages.end(), hana::basic_type<ARGS>()...);
+                }
             };
+
+            using detail = converter<Take>;
         }
     }
 
@@ -257,6 +334,28 @@ namespace Gadgetron::Core {
         return gadgetron_message_detail::detail::message_to_tuple<T>(message);
     }
 
+    template<class ...ARGS>
+    std::enable_if_t<(sizeof...(ARGS) > 1), std::tuple<ARGS...>>
+    unpack_view(const Message &message) {
+        return gadgetron_message_detail::converter<gadgetron_message_detail::View>::message_view<ARGS...>(message);
+    }
+
+    template<class T>
+    T unpack_view(const Message &message) {
+        return gadgetron_message_detail::converter<gadgetron_message_detail::View>::message_view<T>(message);
+    }
+
+    template<class ...ARGS>
+    std::enable_if_t<(sizeof...(ARGS) > 1), std::tuple<ARGS...>>
+    unpack_for_reading(Message &message) {
+        return gadgetron_message_detail::converter<gadgetron_message_detail::TakeOrView>::message_view<ARGS...>(message);
+    }
+
+    template<class T>
+    T unpack_for_reading(Message &message) {
+        return gadgetron_message_detail::converter<gadgetron_message_detail::TakeOrView>::message_view<T>(message);
+    }
+
     template<class ...ARGS>
     std::enable_if_t<(sizeof...(ARGS) > 1), optional < std::tuple<ARGS...>>>
     unpack(Message &&message) {
@@ -22,6 +22,26 @@ namespace Gadgetron::Core {
         virtual void process(GenericInputChannel& in, OutputChannel& out) = 0;
     };
 
+    /**
+     * Optional interface for Nodes which handle their input one message at a time, without blocking on the
+     * InputChannel. A Stream running on the shared scheduler drives such Nodes as tasks whenever messages are
+     * available, rather than dedicating a thread to each of them. Calls are serialized, but may be made from
+     * different threads.
+     */
+    class MessageDrivenNode {
+    public:
+        virtual ~MessageDrivenNode() = default;
+
+        /// Called once, before the first message.
+        virtual void start(OutputChannel& out) {}
+
+        /// Called once for every message on the InputChannel.
+        virtual void process_message(Message message, OutputChannel& out) = 0;
+
+        /// Called once, after the InputChannel has been closed and drained.
+        virtual void finish(OutputChannel& out) {}
+    };
+
     class GenericChannelGadget : public Node, public PropertyMixin {
     public:
         GenericChannelGadget(const Context& context, const GadgetProperties& properties) : PropertyMixin(properties), header{context.header} {}
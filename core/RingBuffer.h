@@ -0,0 +1,381 @@
+#pragma once
+
+#include "MPMCChannel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace Gadgetron::Core {
+
+    namespace detail {
+
+        constexpr size_t cache_line_size = 64;
+
+        inline void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+            _mm_pause();
+#else
+            std::this_thread::yield();
+#endif
+        }
+
+        inline size_t round_up_to_power_of_two(size_t value) {
+            size_t result = 1;
+            while (result < value) result <<= 1;
+            return result;
+        }
+
+        /**
+         * Spin-then-park waiting. A waiter polls its predicate for a number of rounds before registering itself
+         * and sleeping on a condition variable. Notifiers only touch the mutex if a waiter is actually parked,
+         * so the uncontended push/pop path never locks.
+         */
+        class Parker {
+        public:
+            explicit Parker(size_t spin_count) : spin_count{ spin_count } {}
+
+            template <class PRED> void wait(PRED&& ready) {
+                for (size_t i = 0; i < spin_count; i++) {
+                    if (ready())
+                        return;
+                    if (i < spin_count / 2)
+                        cpu_relax();
+                    else
+                        std::this_thread::yield();
+                }
+
+                std::unique_lock<std::mutex> lock(m);
+                waiting.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                cv.wait(lock, ready);
+                waiting.fetch_sub(1);
+            }
+
+            void notify_one() {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (waiting.load(std::memory_order_relaxed) == 0)
+                    return;
+                { std::lock_guard<std::mutex> guard(m); }
+                cv.notify_one();
+            }
+
+            void notify_all() {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (waiting.load(std::memory_order_relaxed) == 0)
+                    return;
+                { std::lock_guard<std::mutex> guard(m); }
+                cv.notify_all();
+            }
+
+        private:
+            const size_t spin_count;
+            std::atomic<size_t> waiting{ 0 };
+            std::mutex m;
+            std::condition_variable cv;
+        };
+
+        /**
+         * Bounded multi-producer multi-consumer ring (Vyukov). Each cell carries a sequence number which tells
+         * producers and consumers whether it is free for the current lap.
+         */
+        template <class T> class MPMCRing {
+        public:
+            explicit MPMCRing(size_t requested_capacity)
+                : capacity_{ round_up_to_power_of_two(std::max<size_t>(requested_capacity, 2)) },
+                  mask{ capacity_ - 1 },
+                  cells{ new Cell[capacity_] } {
+                for (size_t i = 0; i < capacity_; i++)
+                    cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            ~MPMCRing() {
+                optional<T> discard;
+                while (try_pop(discard)) discard.reset();
+            }
+
+            bool try_push(T& value) {
+                Cell* cell;
+                size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+                while (true) {
+                    cell         = &cells[pos & mask];
+                    size_t seq   = cell->sequence.load(std::memory_order_acquire);
+                    auto diff    = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                    if (diff == 0) {
+                        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    } else if (diff < 0) {
+                        return false;
+                    } else {
+                        pos = enqueue_pos.load(std::memory_order_relaxed);
+                    }
+                }
+                new (&cell->storage) T(std::move(value));
+                cell->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            bool try_pop(optional<T>& result) {
+                Cell* cell;
+                size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+                while (true) {
+                    cell         = &cells[pos & mask];
+                    size_t seq   = cell->sequence.load(std::memory_order_acquire);
+                    auto diff    = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+                    if (diff == 0) {
+                        if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    } else if (diff < 0) {
+                        return false;
+                    } else {
+                        pos = dequeue_pos.load(std::memory_order_relaxed);
+                    }
+                }
+                T* element = std::launder(reinterpret_cast<T*>(&cell->storage));
+                result.emplace(std::move(*element));
+                element->~T();
+                cell->sequence.store(pos + mask + 1, std::memory_order_release);
+                return true;
+            }
+
+            size_t size() const {
+                auto head = dequeue_pos.load(std::memory_order_relaxed);
+                auto tail = enqueue_pos.load(std::memory_order_relaxed);
+                return tail > head ? tail - head : 0;
+            }
+
+            size_t capacity() const { return capacity_; }
+
+        private:
+            struct Cell {
+                std::atomic<size_t> sequence;
+                std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+            };
+
+            const size_t capacity_;
+            const size_t mask;
+            std::unique_ptr<Cell[]> cells;
+
+            alignas(cache_line_size) std::atomic<size_t> enqueue_pos{ 0 };
+            alignas(cache_line_size) std::atomic<size_t> dequeue_pos{ 0 };
+        };
+
+        /**
+         * Bounded single-producer single-consumer ring (Lamport), with each side caching the other side's index
+         * to avoid touching the shared cache line on every operation.
+         */
+        template <class T> class SPSCRing {
+        public:
+            explicit SPSCRing(size_t requested_capacity)
+                : capacity_{ round_up_to_power_of_two(std::max<size_t>(requested_capacity, 2)) },
+                  mask{ capacity_ - 1 },
+                  slots{ new Slot[capacity_] } {}
+
+            ~SPSCRing() {
+                optional<T> discard;
+                while (try_pop(discard)) discard.reset();
+            }
+
+            bool try_push(T& value) {
+                size_t pos = tail.load(std::memory_order_relaxed);
+                if (pos - cached_head == capacity_) {
+                    cached_head = head.load(std::memory_order_acquire);
+                    if (pos - cached_head == capacity_)
+                        return false;
+                }
+                new (&slots[pos & mask]) T(std::move(value));
+                tail.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            bool try_pop(optional<T>& result) {
+                size_t pos = head.load(std::memory_order_relaxed);
+                if (pos == cached_tail) {
+                    cached_tail = tail.load(std::memory_order_acquire);
+                    if (pos == cached_tail)
+                        return false;
+                }
+                T* element = std::launder(reinterpret_cast<T*>(&slots[pos & mask]));
+                result.emplace(std::move(*element));
+                element->~T();
+                head.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            size_t size() const {
+                auto h = head.load(std::memory_order_relaxed);
+                auto t = tail.load(std::memory_order_relaxed);
+                return t > h ? t - h : 0;
+            }
+
+            size_t capacity() const { return capacity_; }
+
+        private:
+            using Slot = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+            const size_t capacity_;
+            const size_t mask;
+            std::unique_ptr<Slot[]> slots;
+
+            alignas(cache_line_size) std::atomic<size_t> head{ 0 };
+            size_t cached_tail = 0;
+            alignas(cache_line_size) std::atomic<size_t> tail{ 0 };
+            size_t cached_head = 0;
+        };
+    }
+
+    /**
+     * A fixed capacity channel backed by a preallocated ring. Producers block (spin, then park) while the ring is
+     * full, consumers block while it is empty. Close semantics match MPMCChannel: pushing to a closed channel
+     * throws ChannelClosed, while consumers drain the remaining elements before seeing ChannelClosed.
+     * @tparam RING Non-blocking ring implementation, detail::MPMCRing or detail::SPSCRing
+     */
+    template <class T, class RING> class BoundedChannel {
+        static_assert(std::is_nothrow_move_constructible<T>::value,
+            "BoundedChannel requires elements which are nothrow move constructible");
+
+    public:
+        static constexpr size_t default_capacity    = 1024;
+        static constexpr size_t default_spin_count  = 512;
+
+        explicit BoundedChannel(size_t capacity = default_capacity, size_t spin_count = default_spin_count)
+            : ring{ capacity }, not_empty{ spin_count }, not_full{ spin_count } {}
+
+        BoundedChannel(const BoundedChannel&) = delete;
+        BoundedChannel& operator=(const BoundedChannel&) = delete;
+
+        /// Pushes an element, blocking while the channel is full.
+        void push(T);
+
+        /// Pushes an element if there is room. Returns false if the channel is full.
+        bool try_push(T&);
+
+        template <class... ARGS> void emplace(ARGS&&... args);
+
+        T pop();
+        optional<T> try_pop();
+
+        void close();
+
+        size_t size() const { return ring.size(); }
+        size_t capacity() const { return ring.capacity(); }
+
+    private:
+        class PushGuard;
+
+        bool drained();
+
+        RING ring;
+        std::atomic<bool> is_closed{ false };
+        std::atomic<size_t> pending_pushes{ 0 };
+        detail::Parker not_empty;
+        detail::Parker not_full;
+    };
+
+    /// Bounded, lock free multi-producer multi-consumer channel.
+    template <class T> using MPMCRingBuffer = BoundedChannel<T, detail::MPMCRing<T>>;
+
+    /// Bounded, lock free single-producer single-consumer channel. Only valid with exactly one thread on each end.
+    template <class T> using SPSCRingBuffer = BoundedChannel<T, detail::SPSCRing<T>>;
+
+    /** Implementation **/
+
+    /*
+     * Producers register themselves before checking is_closed, so a consumer that has observed a closed channel
+     * with no producers in flight knows that nothing more can arrive.
+     */
+    template <class T, class RING> class BoundedChannel<T, RING>::PushGuard {
+    public:
+        explicit PushGuard(BoundedChannel& channel) : channel{ channel } {
+            channel.pending_pushes.fetch_add(1);
+            if (channel.is_closed.load()) {
+                release();
+                throw ChannelClosed();
+            }
+        }
+
+        ~PushGuard() {
+            if (active) release();
+        }
+
+    private:
+        void release() {
+            active = false;
+            channel.pending_pushes.fetch_sub(1);
+            if (channel.is_closed.load())
+                channel.not_empty.notify_all();
+            else
+                channel.not_empty.notify_one();
+        }
+
+        BoundedChannel& channel;
+        bool active = true;
+    };
+
+    template <class T, class RING> bool BoundedChannel<T, RING>::drained() {
+        return is_closed.load() && pending_pushes.load() == 0;
+    }
+
+    template <class T, class RING> void BoundedChannel<T, RING>::push(T value) {
+        PushGuard guard(*this);
+        bool closed = false;
+        not_full.wait([&]() {
+            if (ring.try_push(value))
+                return true;
+            closed = is_closed.load();
+            return closed;
+        });
+        if (closed)
+            throw ChannelClosed();
+    }
+
+    template <class T, class RING> bool BoundedChannel<T, RING>::try_push(T& value) {
+        PushGuard guard(*this);
+        return ring.try_push(value);
+    }
+
+    template <class T, class RING>
+    template <class... ARGS>
+    void BoundedChannel<T, RING>::emplace(ARGS&&... args) {
+        push(T(std::forward<ARGS>(args)...));
+    }
+
+    template <class T, class RING> T BoundedChannel<T, RING>::pop() {
+        optional<T> result;
+        not_empty.wait([&]() {
+            if (ring.try_pop(result))
+                return true;
+            if (!drained())
+                return false;
+            ring.try_pop(result);
+            return true;
+        });
+        if (!result)
+            throw ChannelClosed();
+        not_full.notify_one();
+        return std::move(*result);
+    }
+
+    template <class T, class RING> optional<T> BoundedChannel<T, RING>::try_pop() {
+        optional<T> result;
+        if (ring.try_pop(result))
+            not_full.notify_one();
+        return result;
+    }
+
+    template <class T, class RING> void BoundedChannel<T, RING>::close() {
+        is_closed.store(true);
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+}
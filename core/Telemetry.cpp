@@ -0,0 +1,275 @@
+#include "Telemetry.h"
+
+#include "log.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace Gadgetron::Core::Telemetry {
+
+    namespace {
+
+        int64_t nanoseconds_since_epoch(Clock::time_point time) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        }
+
+        double milliseconds(std::chrono::nanoseconds duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+
+        void update_max(std::atomic<int64_t>& max, int64_t value) {
+            auto current = max.load();
+            while (value > current && !max.compare_exchange_weak(current, value)) {}
+        }
+
+        std::string escape(const std::string& name) {
+            std::string result;
+            for (auto c : name) {
+                if (c == '"' || c == '\\') result += '\\';
+                result += c;
+            }
+            return result;
+        }
+    }
+
+    void Histogram::record(std::chrono::nanoseconds duration) {
+        auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        size_t bucket = 0;
+        while (microseconds > 0 && bucket < buckets - 1) {
+            microseconds >>= 1;
+            bucket++;
+        }
+        counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t Histogram::count() const {
+        size_t total = 0;
+        for (auto& count : counts_) total += count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    std::chrono::microseconds Histogram::quantile(double q) const {
+        auto snapshot = counts();
+        size_t total = 0;
+        for (auto count : snapshot) total += count;
+        if (total == 0) return std::chrono::microseconds(0);
+
+        auto target = std::max<size_t>(1, size_t(std::ceil(q * total)));
+        size_t seen = 0;
+        for (size_t bucket = 0; bucket < buckets; bucket++) {
+            seen += snapshot[bucket];
+            if (seen >= target) return upper_bound(bucket);
+        }
+        return upper_bound(buckets - 1);
+    }
+
+    std::array<size_t, Histogram::buckets> Histogram::counts() const {
+        std::array<size_t, buckets> snapshot{};
+        for (size_t bucket = 0; bucket < buckets; bucket++)
+            snapshot[bucket] = counts_[bucket].load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    std::chrono::microseconds Histogram::upper_bound(size_t bucket) {
+        return std::chrono::microseconds(int64_t(1) << bucket);
+    }
+
+    void ChannelStatistics::pushed(size_t message_bytes) {
+        messages.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(message_bytes, std::memory_order_relaxed);
+        update_max(max_depth, depth.fetch_add(1) + 1);
+    }
+
+    void ChannelStatistics::popped() {
+        depth.fetch_sub(1);
+    }
+
+    std::chrono::nanoseconds NodeStatistics::busy() const {
+        return std::chrono::nanoseconds(std::max<int64_t>(0, service_ns.load() - output_wait_ns.load()));
+    }
+
+    std::chrono::nanoseconds NodeStatistics::input_wait() const {
+        return std::chrono::nanoseconds(input_wait_ns.load());
+    }
+
+    std::chrono::nanoseconds NodeStatistics::output_wait() const {
+        return std::chrono::nanoseconds(output_wait_ns.load());
+    }
+
+    InputProbe::InputProbe(std::shared_ptr<ChannelStatistics> channel, std::shared_ptr<NodeStatistics> node)
+        : channel(std::move(channel)), node(std::move(node)) {}
+
+    Clock::time_point InputProbe::idle() {
+        auto now = Clock::now();
+        auto since = in_hand.exchange(-1);
+        if (since >= 0 && node) {
+            auto service = std::chrono::nanoseconds(nanoseconds_since_epoch(now) - since);
+            node->service_ns += service.count();
+            node->latency.record(service);
+            if (Trace::active())
+                Trace::record(node->name, Clock::time_point(std::chrono::nanoseconds(since)), now);
+        }
+        return now;
+    }
+
+    void InputProbe::received(Clock::time_point asked, bool blocking) {
+        auto now = Clock::now();
+        if (channel) channel->popped();
+        if (node) {
+            node->messages.fetch_add(1, std::memory_order_relaxed);
+            if (blocking) node->input_wait_ns += (now - asked).count();
+        }
+        in_hand = nanoseconds_since_epoch(now);
+    }
+
+    void InputProbe::closed(Clock::time_point asked) {
+        if (node) node->input_wait_ns += (Clock::now() - asked).count();
+    }
+
+    OutputProbe::OutputProbe(std::shared_ptr<ChannelStatistics> channel, std::shared_ptr<NodeStatistics> node)
+        : channel(std::move(channel)), node(std::move(node)) {}
+
+    void OutputProbe::pushing(size_t bytes) {
+        if (channel) channel->pushed(bytes);
+    }
+
+    void OutputProbe::pushed(Clock::time_point started) {
+        if (node) node->output_wait_ns += (Clock::now() - started).count();
+    }
+
+    void OutputProbe::failed() {
+        if (channel) {
+            channel->messages--;
+            channel->depth--;
+        }
+    }
+
+    Registry& Registry::instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    void Registry::add(std::string name, std::weak_ptr<NodeStatistics> node) {
+        std::lock_guard<std::mutex> guard(m);
+        prune(nodes);
+        nodes.emplace_back(std::move(name), std::move(node));
+    }
+
+    void Registry::add(std::string name, std::weak_ptr<ChannelStatistics> channel) {
+        std::lock_guard<std::mutex> guard(m);
+        prune(channels);
+        channels.emplace_back(std::move(name), std::move(channel));
+    }
+
+    size_t Registry::size() {
+        std::lock_guard<std::mutex> guard(m);
+        return nodes.size() + channels.size();
+    }
+
+    template<class T>
+    void Registry::prune(Entries<T>& entries) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](auto& entry) { return entry.second.expired(); }),
+                      entries.end());
+    }
+
+    template<class T>
+    std::vector<std::pair<std::string, std::shared_ptr<T>>> Registry::live(Entries<T>& entries) {
+        std::vector<std::pair<std::string, std::shared_ptr<T>>> result;
+        auto expired = std::remove_if(entries.begin(), entries.end(), [&](auto& entry) {
+            auto statistics = entry.second.lock();
+            if (!statistics) return true;
+            result.emplace_back(entry.first, std::move(statistics));
+            return false;
+        });
+        entries.erase(expired, entries.end());
+        return result;
+    }
+
+    std::string Registry::summary() {
+        std::lock_guard<std::mutex> guard(m);
+        std::stringstream stream;
+        for (auto& [name, node] : live(nodes)) stream << Telemetry::summary(name, *node) << "\n";
+        for (auto& [name, channel] : live(channels)) stream << Telemetry::summary(name, *channel) << "\n";
+        return stream.str();
+    }
+
+    std::string Registry::json() {
+        std::lock_guard<std::mutex> guard(m);
+        std::stringstream stream;
+        stream << std::fixed << std::setprecision(3);
+
+        stream << "{\"nodes\":[";
+        bool first = true;
+        for (auto& [name, node] : live(nodes)) {
+            if (!first) stream << ",";
+            first = false;
+            stream << "{\"name\":\"" << escape(name) << "\""
+                   << ",\"messages\":" << node->messages.load()
+                   << ",\"busy_ms\":" << milliseconds(node->busy())
+                   << ",\"input_wait_ms\":" << milliseconds(node->input_wait())
+                   << ",\"output_wait_ms\":" << milliseconds(node->output_wait())
+                   << ",\"latency_us\":{\"p50\":" << node->latency.quantile(0.5).count()
+                   << ",\"p90\":" << node->latency.quantile(0.9).count()
+                   << ",\"p99\":" << node->latency.quantile(0.99).count()
+                   << ",\"bucket_upper_bounds\":[";
+            for (size_t bucket = 0; bucket < Histogram::buckets; bucket++)
+                stream << (bucket ? "," : "") << Histogram::upper_bound(bucket).count();
+            stream << "],\"counts\":[";
+            auto counts = node->latency.counts();
+            for (size_t bucket = 0; bucket < Histogram::buckets; bucket++)
+                stream << (bucket ? "," : "") << counts[bucket];
+            stream << "]}}";
+        }
+
+        stream << "],\"channels\":[";
+        first = true;
+        for (auto& [name, channel] : live(channels)) {
+            if (!first) stream << ",";
+            first = false;
+            stream << "{\"name\":\"" << escape(name) << "\""
+                   << ",\"messages\":" << channel->messages.load()
+                   << ",\"bytes\":" << channel->bytes.load()
+                   << ",\"depth\":" << channel->depth.load()
+                   << ",\"max_depth\":" << channel->max_depth.load() << "}";
+        }
+        stream << "]}";
+        return stream.str();
+    }
+
+    std::string summary(const std::string& name, const NodeStatistics& node) {
+        std::stringstream stream;
+        stream << std::fixed << std::setprecision(1);
+        stream << "node " << name << ": " << node.messages.load() << " messages, busy "
+               << milliseconds(node.busy()) << " ms, waiting for input " << milliseconds(node.input_wait())
+               << " ms, blocked on output " << milliseconds(node.output_wait()) << " ms, latency p50 <= "
+               << node.latency.quantile(0.5).count() << " us, p99 <= " << node.latency.quantile(0.99).count()
+               << " us";
+        return stream.str();
+    }
+
+    std::string summary(const std::string& name, const ChannelStatistics& channel) {
+        std::stringstream stream;
+        stream << std::fixed << std::setprecision(1);
+        stream << "channel " << name << ": " << channel.messages.load() << " messages, "
+               << channel.bytes.load() / (1024.0 * 1024.0) << " MiB, depth " << channel.depth.load()
+               << " (max " << channel.max_depth.load() << ")";
+        return stream.str();
+    }
+
+    void report_periodically(std::chrono::seconds interval) {
+        static std::once_flag started;
+        std::call_once(started, [interval]() {
+            std::thread([interval]() {
+                while (true) {
+                    std::this_thread::sleep_for(interval);
+                    auto report = Registry::instance().summary();
+                    if (!report.empty()) GINFO_STREAM("Pipeline telemetry:\n" << report);
+                }
+            }).detach();
+        });
+    }
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Gadgetron::Core::Telemetry {
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Histogram of durations in power of two buckets. Bucket 0 counts durations below one microsecond, bucket b
+     * durations in [2^(b-1), 2^b) microseconds, and the last bucket everything longer.
+     */
+    class Histogram {
+    public:
+        static constexpr size_t buckets = 28;
+
+        void record(std::chrono::nanoseconds duration);
+
+        size_t count() const;
+
+        /// Upper bound of the bucket holding the given quantile, e.g. 0.99 for the 99th percentile.
+        std::chrono::microseconds quantile(double q) const;
+
+        std::array<size_t, buckets> counts() const;
+
+        static std::chrono::microseconds upper_bound(size_t bucket);
+
+    private:
+        std::array<std::atomic<size_t>, buckets> counts_{};
+    };
+
+    /// Activity on a channel. Depth is the number of messages pushed but not yet popped.
+    struct ChannelStatistics {
+        std::atomic<size_t> messages{0};
+        std::atomic<size_t> bytes{0};
+        std::atomic<int64_t> depth{0};
+        std::atomic<int64_t> max_depth{0};
+
+        void pushed(size_t bytes);
+        void popped();
+    };
+
+    /**
+     * Activity of a node, as seen from its channels. A node is busy with a message from the moment it receives it
+     * until it asks for the next one, minus any time it spends blocked pushing output into a full channel.
+     * When tracing, each message handled becomes a span with the node's name.
+     */
+    struct NodeStatistics {
+        std::string name;
+        std::atomic<size_t> messages{0};
+        std::atomic<int64_t> service_ns{0};
+        std::atomic<int64_t> input_wait_ns{0};
+        std::atomic<int64_t> output_wait_ns{0};
+        Histogram latency;
+
+        std::chrono::nanoseconds busy() const;
+        std::chrono::nanoseconds input_wait() const;
+        std::chrono::nanoseconds output_wait() const;
+    };
+
+    /// Attached to the consuming end of a channel. See GenericInputChannel::instrument.
+    class InputProbe {
+    public:
+        InputProbe(std::shared_ptr<ChannelStatistics> channel, std::shared_ptr<NodeStatistics> node);
+
+        /// Called before asking the channel for a message. Completes the message in hand, if any.
+        Clock::time_point idle();
+
+        /// Called when a message was taken from the channel; blocking if the call could have waited for it.
+        void received(Clock::time_point asked, bool blocking);
+
+        /// Called when a blocking call returned without a message, i.e. the channel was closed.
+        void closed(Clock::time_point asked);
+
+        const std::shared_ptr<ChannelStatistics> channel;
+        const std::shared_ptr<NodeStatistics> node;
+
+    private:
+        std::atomic<int64_t> in_hand{-1};
+    };
+
+    /// Attached to the producing end of a channel. See OutputChannel::instrument.
+    class OutputProbe {
+    public:
+        OutputProbe(std::shared_ptr<ChannelStatistics> channel, std::shared_ptr<NodeStatistics> node);
+
+        void pushing(size_t bytes);
+        void pushed(Clock::time_point started);
+        void failed();
+
+        const std::shared_ptr<ChannelStatistics> channel;
+        const std::shared_ptr<NodeStatistics> node;
+    };
+
+    /**
+     * Process wide list of the statistics currently being collected. Entries are held weakly, and disappear when
+     * their owner (e.g. the Stream they belong to) lets go of them.
+     */
+    class Registry {
+    public:
+        static Registry& instance();
+
+        void add(std::string name, std::weak_ptr<NodeStatistics> node);
+        void add(std::string name, std::weak_ptr<ChannelStatistics> channel);
+
+        /// One line per node and channel; empty if nothing is registered.
+        std::string summary();
+
+        /// All nodes and channels as a JSON object, with the full latency histograms.
+        std::string json();
+
+        /// Number of entries held, expired or not. Expired entries are dropped as new ones are added.
+        size_t size();
+
+    private:
+        template<class T> using Entries = std::vector<std::pair<std::string, std::weak_ptr<T>>>;
+
+        template<class T> void prune(Entries<T>& entries);
+        template<class T> std::vector<std::pair<std::string, std::shared_ptr<T>>> live(Entries<T>& entries);
+
+        std::mutex m;
+        Entries<NodeStatistics> nodes;
+        Entries<ChannelStatistics> channels;
+    };
+
+    std::string summary(const std::string& name, const NodeStatistics& node);
+    std::string summary(const std::string& name, const ChannelStatistics& channel);
+
+    /**
+     * Logs the registry summary at the given interval, from a background thread. Only the first call in a process has
+     * effect. The registry only sees the streams of its own process, so when connections are handled in forked
+     * processes this must be called in each of them, after the fork.
+     */
+    void report_periodically(std::chrono::seconds interval);
+}
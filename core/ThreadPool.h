@@ -4,102 +4,437 @@
 
 #pragma once
 #include "MPMCChannel.h"
-#include <boost/hana.hpp>
+#include "RingBuffer.h"
+
+#include <algorithm>
+#include <deque>
+#include <exception>
 #include <future>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace Gadgetron::Core {
 
+    namespace detail {
 
-    class ThreadPool {
-    private:
-        class Work {
-        public:
-            virtual void execute() = 0;
-            virtual ~Work()        = default;
-        };
-
-        template <class F, class... ARGS> class Storage{
-        public:
-            explicit Storage(F&& f, ARGS&&... args)
-                : f{ std::forward<F>(f) }, args{ std::forward<ARGS>(args)... } {}
-        protected:
-            F f;
-            boost::hana::tuple<std::decay_t<ARGS>...> args;
+        /**
+         * Type erased, move-only unit of work. Small callables (such as the chunks of a parallel_for) are stored
+         * inline, so submitting them does not touch the heap.
+         */
+        class Task {
         public:
-            using R = decltype(boost::hana::unpack(std::move(args),f));
-        protected:
-            std::promise<R> promise;
+            Task() = default;
 
+            template <class F, class = std::enable_if_t<!std::is_same<std::decay_t<F>, Task>::value>>
+            explicit Task(F&& f) {
+                using Callable = std::decay_t<F>;
+                if constexpr (fits_inline<Callable>()) {
+                    new (&storage) Callable(std::forward<F>(f));
+                    vtable = &vtable_for<Callable>;
+                } else {
+                    new (&storage) HeapCallable<Callable>{ std::make_unique<Callable>(std::forward<F>(f)) };
+                    vtable = &vtable_for<HeapCallable<Callable>>;
+                }
+            }
 
-        public:
-            std::future<R> get_future() {
-                return promise.get_future();
+            Task(Task&& other) noexcept : vtable{ other.vtable } {
+                if (vtable) {
+                    vtable->move(&storage, &other.storage);
+                    other.reset();
+                }
             }
-        };
-        template<class F, bool IS_VOID, class... ARGS> class ConcreteWorkImpl{};
 
-        template<class F, class... ARGS> class ConcreteWorkImpl<F,false,ARGS...> : public Work, public Storage<F,ARGS...> {
-        public:
-            using Storage<F,ARGS...>::Storage;
-
-            void execute() override {
-                try {
-                    auto val = boost::hana::unpack(std::move(this->args),this->f);
-                    this->promise.set_value(std::move(val));
-                } catch (...){
-                    this->promise.set_exception(std::current_exception());
+            Task& operator=(Task&& other) noexcept {
+                if (this != &other) {
+                    reset();
+                    vtable = other.vtable;
+                    if (vtable) {
+                        vtable->move(&storage, &other.storage);
+                        other.reset();
+                    }
                 }
+                return *this;
             }
-        };
-        template<class F, class... ARGS> class ConcreteWorkImpl<F,true,ARGS...> : public Work, public Storage<F,ARGS...> {
-        public:
-            using Storage<F,ARGS...>::Storage;
-
-            void execute() override {
-                try {
-                    boost::hana::unpack(std::move(this->args),this->f);
-                    this->promise.set_value();
-                } catch (...){
-                    this->promise.set_exception(std::current_exception());
+
+            Task(const Task&) = delete;
+            Task& operator=(const Task&) = delete;
+
+            ~Task() { reset(); }
+
+            void operator()() { vtable->invoke(&storage); }
+
+            explicit operator bool() const { return vtable != nullptr; }
+
+        private:
+            static constexpr size_t inline_size = 6 * sizeof(void*);
+
+            template <class F> struct HeapCallable {
+                std::unique_ptr<F> f;
+                void operator()() { (*f)(); }
+            };
+
+            template <class F> static constexpr bool fits_inline() {
+                return sizeof(F) <= inline_size && alignof(F) <= alignof(std::max_align_t)
+                       && std::is_nothrow_move_constructible<F>::value;
+            }
+
+            struct VTable {
+                void (*invoke)(void*);
+                void (*move)(void* destination, void* source);
+                void (*destroy)(void*);
+            };
+
+            template <class F>
+            static constexpr VTable vtable_for = {
+                [](void* f) { (*static_cast<F*>(f))(); },
+                [](void* destination, void* source) { new (destination) F(std::move(*static_cast<F*>(source))); },
+                [](void* f) { static_cast<F*>(f)->~F(); }
+            };
+
+            void reset() {
+                if (vtable) {
+                    vtable->destroy(&storage);
+                    vtable = nullptr;
                 }
             }
-        };
 
-    template<class F, class... ARGS> class ConcreteWork : public ConcreteWorkImpl<F, std::is_same<typename Storage<F,ARGS...>::R,void>::value,ARGS...> {
-        public:
-            using ConcreteWorkImpl<F, std::is_same<typename Storage<F,ARGS...>::R,void>::value,ARGS...>::ConcreteWorkImpl;
+            std::aligned_storage_t<inline_size, alignof(std::max_align_t)> storage;
+            const VTable* vtable = nullptr;
         };
+    }
 
+    /**
+     * Work-stealing thread pool. Each worker owns a deque; work submitted from a worker goes to its own deque and
+     * is run LIFO, work submitted from outside the pool goes to a shared FIFO queue. Idle workers steal from the
+     * front of the other workers' deques before parking.
+     */
+    class ThreadPool {
     public:
-        explicit ThreadPool(unsigned int workers) {
-            for (auto i = 0u; i < workers; i++) {
-                threads.emplace_back([this]() {
-                    try {
-                        while (true)
-                            this->work_queue.pop()->execute();
-                    } catch (const ChannelClosed&) {
-                    }
-                });
+        explicit ThreadPool(unsigned int workers);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// Runs f(args...) on the pool. The returned future holds the result or the exception thrown by f.
+        template <class F, class... ARGS> auto async(F&& f, ARGS&&... args);
+
+        /// Finishes all submitted work and stops the workers. Subsequent submissions from outside the pool throw.
+        void join();
+
+        size_t size() const { return queues.size(); }
+
+        /// Runs a single queued task on the calling thread, if there is one. Used to help out while waiting.
+        bool run_pending_task();
+
+        void submit(detail::Task task);
+
+    private:
+        struct alignas(detail::cache_line_size) WorkQueue {
+            std::mutex m;
+            std::deque<detail::Task> tasks;
+        };
+
+        struct WorkerIdentity {
+            ThreadPool* pool = nullptr;
+            size_t index     = 0;
+        };
+
+        static WorkerIdentity& current_worker() {
+            static thread_local WorkerIdentity identity;
+            return identity;
+        }
+
+        void worker_loop(size_t index);
+        bool find_task(size_t index, detail::Task& task);
+        bool pop_local(size_t index, detail::Task& task);
+        bool pop_injected(detail::Task& task);
+        bool steal(size_t thief, detail::Task& task);
+
+        std::vector<std::unique_ptr<WorkQueue>> queues;
+        WorkQueue injection_queue;
+
+        std::atomic<long> pending{ 0 };
+        std::atomic<bool> stopping{ false };
+        detail::Parker idle{ 256 };
+
+        std::vector<std::thread> threads;
+    };
+
+    /// Process wide pool with one worker per core, for gadgets which would otherwise spin up their own threads.
+    inline ThreadPool& default_thread_pool() {
+        static ThreadPool pool{ std::max(1u, std::thread::hardware_concurrency()) };
+        return pool;
+    }
+
+    /**
+     * Calls f(begin, end) for consecutive chunks of [begin, end) on the pool. The calling thread takes part in
+     * the work, so calling this from inside a pool task does not deadlock.
+     * @param grain Number of indices per chunk. 0 picks roughly four chunks per worker.
+     */
+    template <class F> void parallel_for_chunks(ThreadPool& pool, size_t begin, size_t end, F&& f, size_t grain = 0);
+
+    /// Calls f(i) for every i in [begin, end) on the pool.
+    template <class F> void parallel_for(ThreadPool& pool, size_t begin, size_t end, F&& f, size_t grain = 0);
+
+    template <class F> void parallel_for(size_t begin, size_t end, F&& f, size_t grain = 0) {
+        parallel_for(default_thread_pool(), begin, end, std::forward<F>(f), grain);
+    }
+
+    /**
+     * Reduces f(i) over [begin, end) with reduce(T, T). Partial results are combined in index order, so the
+     * result does not depend on scheduling.
+     */
+    template <class T, class F, class R>
+    T parallel_reduce(ThreadPool& pool, size_t begin, size_t end, T identity, F&& f, R&& reduce, size_t grain = 0);
+
+    template <class T, class F, class R>
+    T parallel_reduce(size_t begin, size_t end, T identity, F&& f, R&& reduce, size_t grain = 0) {
+        return parallel_reduce(
+            default_thread_pool(), begin, end, std::move(identity), std::forward<F>(f), std::forward<R>(reduce), grain);
+    }
+
+    /** Implementation **/
+
+    inline ThreadPool::ThreadPool(unsigned int workers) {
+        workers = std::max(workers, 1u);
+        for (auto i = 0u; i < workers; i++)
+            queues.push_back(std::make_unique<WorkQueue>());
+        for (auto i = 0u; i < workers; i++)
+            threads.emplace_back([this, i]() { this->worker_loop(i); });
+    }
+
+    inline ThreadPool::~ThreadPool() {
+        if (!stopping)
+            join();
+    }
+
+    inline void ThreadPool::join() {
+        stopping = true;
+        idle.notify_all();
+        for (auto& thread : threads) {
+            if (thread.joinable())
+                thread.join();
+        }
+    }
+
+    inline void ThreadPool::submit(detail::Task task) {
+        auto& worker = current_worker();
+        pending.fetch_add(1);
+        if (worker.pool == this) {
+            auto& queue = *queues[worker.index];
+            std::lock_guard<std::mutex> guard(queue.m);
+            queue.tasks.push_back(std::move(task));
+        } else {
+            if (stopping) {
+                pending.fetch_sub(1);
+                throw ChannelClosed();
             }
+            std::lock_guard<std::mutex> guard(injection_queue.m);
+            injection_queue.tasks.push_back(std::move(task));
         }
+        idle.notify_one();
+    }
+
+    inline bool ThreadPool::pop_local(size_t index, detail::Task& task) {
+        auto& queue = *queues[index];
+        std::lock_guard<std::mutex> guard(queue.m);
+        if (queue.tasks.empty())
+            return false;
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    inline bool ThreadPool::pop_injected(detail::Task& task) {
+        std::lock_guard<std::mutex> guard(injection_queue.m);
+        if (injection_queue.tasks.empty())
+            return false;
+        task = std::move(injection_queue.tasks.front());
+        injection_queue.tasks.pop_front();
+        return true;
+    }
 
-        template <class F, class... ARGS> auto async(F&& f, ARGS&&... args) {
-            auto work = std::make_unique<ConcreteWork<F, ARGS...>>(std::forward<F>(f), std::forward<ARGS>(args)...);
-            auto future_result = work->get_future();
-            work_queue.push(std::move(work));
-            return std::move(future_result);
+    inline bool ThreadPool::steal(size_t thief, detail::Task& task) {
+        static thread_local std::minstd_rand random{ std::random_device{}() };
+        auto start = random() % queues.size();
+        for (size_t i = 0; i < queues.size(); i++) {
+            auto victim = (start + i) % queues.size();
+            if (victim == thief)
+                continue;
+            auto& queue = *queues[victim];
+            std::unique_lock<std::mutex> lock(queue.m, std::try_to_lock);
+            if (!lock || queue.tasks.empty())
+                continue;
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
         }
+        return false;
+    }
 
-        void join(){
-            work_queue.close();
-            for (auto& thread : threads){
-                thread.join();
+    inline bool ThreadPool::find_task(size_t index, detail::Task& task) {
+        if (pending.load(std::memory_order_relaxed) <= 0)
+            return false;
+        return pop_local(index, task) || pop_injected(task) || steal(index, task);
+    }
+
+    inline bool ThreadPool::run_pending_task() {
+        auto& worker = current_worker();
+        auto index   = worker.pool == this ? worker.index : queues.size();
+        detail::Task task;
+        bool found = index < queues.size() ? find_task(index, task) : (pop_injected(task) || steal(index, task));
+        if (!found)
+            return false;
+        pending.fetch_sub(1);
+        task();
+        return true;
+    }
+
+    inline void ThreadPool::worker_loop(size_t index) {
+        current_worker() = { this, index };
+        detail::Task task;
+        while (true) {
+            if (find_task(index, task)) {
+                pending.fetch_sub(1);
+                task();
+                task = detail::Task();
+                continue;
             }
+
+            bool stop = false;
+            idle.wait([&]() {
+                if (pending.load() > 0)
+                    return true;
+                stop = stopping.load();
+                return stop;
+            });
+            if (stop)
+                return;
         }
+    }
 
-    private:
-        MPMCChannel<std::unique_ptr<Work>> work_queue;
-        std::vector<std::thread> threads;
-    };
+    template <class F, class... ARGS> auto ThreadPool::async(F&& f, ARGS&&... args) {
+        using R = std::invoke_result_t<std::decay_t<F>&, std::decay_t<ARGS>&&...>;
+
+        std::promise<R> promise;
+        auto future_result = promise.get_future();
+
+        submit(detail::Task([promise = std::move(promise), f = std::forward<F>(f),
+                                args = std::make_tuple(std::forward<ARGS>(args)...)]() mutable {
+            try {
+                if constexpr (std::is_void<R>::value) {
+                    std::apply(f, std::move(args));
+                    promise.set_value();
+                } else {
+                    promise.set_value(std::apply(f, std::move(args)));
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        }));
+
+        return future_result;
+    }
+
+    namespace detail {
+        struct ChunkedLoop {
+            ChunkedLoop(size_t begin, size_t end, size_t grain)
+                : begin{ begin }, end{ end }, grain{ grain }, chunks{ (end - begin + grain - 1) / grain } {}
+
+            const size_t begin, end, grain, chunks;
+            std::atomic<size_t> next_chunk{ 0 };
+            std::atomic<size_t> completed{ 0 };
+
+            std::mutex m;
+            std::condition_variable done;
+            std::exception_ptr exception;
+
+            template <class F> void run(F& f) {
+                for (auto chunk = next_chunk++; chunk < chunks; chunk = next_chunk++) {
+                    auto chunk_begin = begin + chunk * grain;
+                    auto chunk_end   = std::min(end, chunk_begin + grain);
+                    try {
+                        f(chunk_begin, chunk_end);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> guard(m);
+                        if (!exception)
+                            exception = std::current_exception();
+                    }
+                    if (++completed == chunks) {
+                        std::lock_guard<std::mutex> guard(m);
+                        done.notify_all();
+                    }
+                }
+            }
+
+            void wait() {
+                std::unique_lock<std::mutex> lock(m);
+                done.wait(lock, [this]() { return completed.load() == chunks; });
+                if (exception)
+                    std::rethrow_exception(exception);
+            }
+        };
+    }
+
+    template <class F> void parallel_for_chunks(ThreadPool& pool, size_t begin, size_t end, F&& f, size_t grain) {
+        if (end <= begin)
+            return;
+        if (grain == 0)
+            grain = std::max<size_t>(1, (end - begin) / (4 * pool.size()));
+        if (end - begin <= grain) {
+            f(begin, end);
+            return;
+        }
+
+        auto loop    = std::make_shared<detail::ChunkedLoop>(begin, end, grain);
+        auto* body   = &f;
+        auto helpers = std::min(loop->chunks - 1, pool.size());
+
+        // Helpers which start after all chunks are taken return without touching the body, which is what makes
+        // capturing it by pointer safe once this function has returned.
+        for (size_t i = 0; i < helpers; i++)
+            pool.submit(detail::Task([loop, body]() { loop->run(*body); }));
+
+        loop->run(f);
+        loop->wait();
+    }
+
+    template <class F> void parallel_for(ThreadPool& pool, size_t begin, size_t end, F&& f, size_t grain) {
+        parallel_for_chunks(
+            pool, begin, end,
+            [&f](size_t chunk_begin, size_t chunk_end) {
+                for (auto i = chunk_begin; i < chunk_end; i++)
+                    f(i);
+            },
+            grain);
+    }
+
+    template <class T, class F, class R>
+    T parallel_reduce(ThreadPool& pool, size_t begin, size_t end, T identity, F&& f, R&& reduce, size_t grain) {
+        if (end <= begin)
+            return identity;
+        if (grain == 0)
+            grain = std::max<size_t>(1, (end - begin) / (4 * pool.size()));
+
+        auto chunks = (end - begin + grain - 1) / grain;
+        std::vector<T> partials(chunks, identity);
+
+        parallel_for_chunks(
+            pool, begin, end,
+            [&](size_t chunk_begin, size_t chunk_end) {
+                auto& partial = partials[(chunk_begin - begin) / grain];
+                for (auto i = chunk_begin; i < chunk_end; i++)
+                    partial = reduce(std::move(partial), f(i));
+            },
+            grain);
 
+        return std::accumulate(partials.begin(), partials.end(), std::move(identity),
+            [&](T a, T& b) { return reduce(std::move(a), std::move(b)); });
+    }
 }
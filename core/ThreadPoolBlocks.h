@@ -0,0 +1,39 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include "hoNDArray.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace Gadgetron::Core {
+
+    /**
+     * Calls f(block, index) for every block spanned by the first inner_dimensions dimensions of the array. For an
+     * [RO E1 CHA N] array and inner_dimensions = 2 this is once per 2D image. The block is a non-owning view.
+     */
+    template <class T, class F>
+    void parallel_for_each_block(ThreadPool& pool, hoNDArray<T>& array, size_t inner_dimensions, F&& f) {
+        auto dimensions = array.dimensions();
+        inner_dimensions = std::min(inner_dimensions, dimensions.size());
+
+        std::vector<size_t> block_dimensions(dimensions.begin(), dimensions.begin() + inner_dimensions);
+        if (block_dimensions.empty())
+            block_dimensions.push_back(1);
+
+        size_t block_size = std::accumulate(
+            block_dimensions.begin(), block_dimensions.end(), size_t(1), std::multiplies<size_t>());
+        size_t blocks = block_size ? array.get_number_of_elements() / block_size : 0;
+
+        parallel_for(pool, 0, blocks, [&](size_t index) {
+            hoNDArray<T> block(block_dimensions, array.get_data_ptr() + index * block_size);
+            f(block, index);
+        }, 1);
+    }
+
+    template <class T, class F> void parallel_for_each_block(hoNDArray<T>& array, size_t inner_dimensions, F&& f) {
+        parallel_for_each_block(default_thread_pool(), array, inner_dimensions, std::forward<F>(f));
+    }
+}
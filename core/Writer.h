@@ -64,7 +64,10 @@ namespace Gadgetron::Core {
     template<class ...ARGS>
     void Gadgetron::Core::TypedWriter<ARGS...>::write(std::ostream &stream,  Message message) {
 
-        std::tuple<ARGS...> arg_tuple = force_unpack<ARGS...>(std::move(message));
+        // The writer is the last owner of the message: its parts are moved out, except those it shares with other
+        // messages, which are only read, so arrays among them are viewed rather than copied. The message holds on
+        // to the shared parts until they have been serialized.
+        std::tuple<ARGS...> arg_tuple = unpack_for_reading<ARGS...>(message);
 
         gadgetron_writer_detail::index_apply<sizeof...(ARGS)>(
                 [&](auto... Is) { this->serialize(stream, std::move(std::get<Is>(arg_tuple))...); });
@@ -11,10 +11,17 @@ namespace Gadgetron::Core::Parallel {
 
     template<class... ARGS>
     void Fanout<ARGS...>::process(InputChannel<ARGS...> &input, std::map<std::string, OutputChannel> output) {
-        for (auto thing : input) {
+        // The branches share the payload of each message; a branch only copies what it unpacks while shared.
+        while (true) {
+            Message message;
+            try {
+                message = input.pop_message();
+            } catch (const ChannelClosed &) {
+                return;
+            }
+            // Failing to push to a branch propagates, rather than quietly leaving the other branches unfed.
             for (auto &pair : output) {
-                auto copy_of_thing = thing;
-                pair.second.push(std::move(copy_of_thing));
+                pair.second.push_message(message.clone());
             }
         }
     }
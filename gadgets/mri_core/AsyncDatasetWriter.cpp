@@ -0,0 +1,163 @@
+#include "AsyncDatasetWriter.h"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "log.h"
+
+namespace Gadgetron {
+
+    namespace {
+        class DatasetDestination : public AsyncDatasetWriter::Destination {
+        public:
+            explicit DatasetDestination(std::unique_ptr<ISMRMRD::Dataset> dataset) : dataset(std::move(dataset)) {}
+
+            void append(const ISMRMRD::Acquisition& acquisition) override { dataset->appendAcquisition(acquisition); }
+            void append(const ISMRMRD::Waveform& waveform) override { dataset->appendWaveform(waveform); }
+
+        private:
+            std::unique_ptr<ISMRMRD::Dataset> dataset;
+        };
+    }
+
+    AsyncDatasetWriter::AsyncDatasetWriter(std::unique_ptr<ISMRMRD::Dataset> dataset, Settings settings)
+        : AsyncDatasetWriter(std::make_unique<DatasetDestination>(std::move(dataset)), settings) {}
+
+    AsyncDatasetWriter::AsyncDatasetWriter(std::unique_ptr<Destination> destination, Settings settings)
+        : settings(settings), destination(std::move(destination)) {
+        if (settings.queue_size == 0 || settings.batch_size == 0)
+            throw std::invalid_argument("AsyncDatasetWriter: queue_size and batch_size must be at least 1");
+        recycled.reserve(settings.queue_size);
+        writer = std::thread([this]() { this->write_loop(); });
+    }
+
+    AsyncDatasetWriter::~AsyncDatasetWriter() {
+        try {
+            close();
+        } catch (const std::exception& e) {
+            GERROR_STREAM("AsyncDatasetWriter: error writing dataset: " << e.what());
+        } catch (...) {
+            GERROR_STREAM("AsyncDatasetWriter: error writing dataset");
+        }
+    }
+
+    std::unique_ptr<ISMRMRD::Acquisition> AsyncDatasetWriter::acquisition() {
+        {
+            std::lock_guard<std::mutex> guard(m);
+            if (!recycled.empty()) {
+                auto acquisition = std::move(recycled.back());
+                recycled.pop_back();
+                return acquisition;
+            }
+        }
+        return std::make_unique<ISMRMRD::Acquisition>();
+    }
+
+    void AsyncDatasetWriter::append(std::unique_ptr<ISMRMRD::Acquisition> acquisition) {
+        enqueue(Item{ std::move(acquisition), nullptr, std::chrono::steady_clock::now() });
+    }
+
+    void AsyncDatasetWriter::append(std::unique_ptr<ISMRMRD::Waveform> waveform) {
+        enqueue(Item{ nullptr, std::move(waveform), std::chrono::steady_clock::now() });
+    }
+
+    void AsyncDatasetWriter::enqueue(Item item) {
+        std::unique_lock<std::mutex> lock(m);
+
+        if (queue.size() >= settings.queue_size) {
+            auto start = std::chrono::steady_clock::now();
+            not_full.wait(lock, [&]() { return error || closed || queue.size() < settings.queue_size; });
+            stats.blocked += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        }
+
+        if (error) std::rethrow_exception(error);
+        if (closed) throw std::runtime_error("AsyncDatasetWriter: append after close");
+
+        queue.push_back(std::move(item));
+        if (queue.size() == 1 || queue.size() == settings.batch_size) not_empty.notify_one();
+    }
+
+    void AsyncDatasetWriter::write_loop() {
+        std::vector<Item> batch;
+        std::unique_lock<std::mutex> lock(m);
+
+        while (true) {
+            not_empty.wait(lock, [&]() { return closed || !queue.empty(); });
+            if (queue.empty()) return;
+
+            auto deadline = queue.front().queued + settings.flush_interval;
+            not_empty.wait_until(lock, deadline, [&]() { return closed || queue.size() >= settings.batch_size; });
+
+            batch.clear();
+            std::move(queue.begin(), queue.end(), std::back_inserter(batch));
+            queue.clear();
+            not_full.notify_all();
+            lock.unlock();
+
+            try {
+                write(batch);
+            } catch (...) {
+                lock.lock();
+                error = std::current_exception();
+                not_full.notify_all();
+                return;
+            }
+
+            lock.lock();
+            stats.batches++;
+            stats.largest_batch = std::max(stats.largest_batch, batch.size());
+            for (auto& item : batch) {
+                if (item.acquisition) {
+                    stats.acquisitions++;
+                    if (recycled.size() < settings.queue_size) recycled.push_back(std::move(item.acquisition));
+                } else {
+                    stats.waveforms++;
+                }
+            }
+        }
+    }
+
+    // One call per item, as ISMRMRD::Dataset has no call appending several at once.
+    void AsyncDatasetWriter::write(std::vector<Item>& batch) {
+        for (auto& item : batch) {
+            if (item.acquisition)
+                destination->append(*item.acquisition);
+            else
+                destination->append(*item.waveform);
+        }
+    }
+
+    void AsyncDatasetWriter::close() {
+        {
+            std::lock_guard<std::mutex> guard(m);
+            closed = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+
+        if (writer.joinable()) writer.join();
+
+        // Destroying the destination closes the file; until then, it is not guaranteed to be readable.
+        destination.reset();
+
+        std::lock_guard<std::mutex> guard(m);
+        if (error) std::rethrow_exception(std::exchange(error, nullptr));
+    }
+
+    AsyncDatasetWriter::Statistics AsyncDatasetWriter::statistics() {
+        std::lock_guard<std::mutex> guard(m);
+        return stats;
+    }
+
+    std::string AsyncDatasetWriter::summary() {
+        auto stats = statistics();
+        std::stringstream stream;
+        stream << stats.acquisitions << " acquisitions and " << stats.waveforms << " waveforms in " << stats.batches
+               << " batches (largest " << stats.largest_batch << "); appends waited "
+               << stats.blocked.count() / 1000.0 << " ms on a full queue";
+        return stream.str();
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "gadgetron_mricore_export.h"
+
+#include <ismrmrd/ismrmrd.h>
+#include <ismrmrd/dataset.h>
+#include <ismrmrd/waveform.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Gadgetron {
+
+    /**
+     * Appends acquisitions and waveforms to an ISMRMRD dataset from a background thread, so the pipeline only
+     * pays for copying the data into an acquisition, not for the HDF5 write.
+     *
+     * At most queue_size items wait to be written; append blocks while the queue is full. The writer waits until
+     * batch_size items are queued, or the oldest has waited flush_interval, and then writes everything that is
+     * queued in one go. Written acquisitions are handed back through acquisition(), so a steady stream of
+     * acquisitions of the same size does not allocate.
+     *
+     * close() writes everything queued and closes the file. It is called by the destructor, but call it
+     * explicitly to learn about write errors; they are also rethrown by the next append.
+     *
+     * Batching amortises the handoff between the threads, not the HDF5 writes: ISMRMRD::Dataset only appends one
+     * acquisition or waveform per call, extending the HDF5 dataset by one element each time. For the same reason
+     * the dump is not compressed; libismrmrd creates its HDF5 datasets with its own creation property lists, and
+     * offers no way to set a filter on them.
+     */
+    class EXPORTGADGETSMRICORE AsyncDatasetWriter {
+    public:
+        struct Settings {
+            size_t queue_size = 1024;
+            size_t batch_size = 64;
+            std::chrono::milliseconds flush_interval{ 1000 };
+        };
+
+        struct Statistics {
+            size_t acquisitions = 0;
+            size_t waveforms = 0;
+            size_t batches = 0;
+            size_t largest_batch = 0;
+            std::chrono::microseconds blocked{ 0 };
+        };
+
+        /// Where the items are appended, in order, from the writer thread. Destroying it completes the file.
+        class Destination {
+        public:
+            virtual ~Destination() = default;
+            virtual void append(const ISMRMRD::Acquisition& acquisition) = 0;
+            virtual void append(const ISMRMRD::Waveform& waveform) = 0;
+        };
+
+        AsyncDatasetWriter(std::unique_ptr<ISMRMRD::Dataset> dataset, Settings settings);
+        AsyncDatasetWriter(std::unique_ptr<Destination> destination, Settings settings);
+        ~AsyncDatasetWriter();
+
+        /// An acquisition to fill and append; reuses one that has already been written, if any.
+        std::unique_ptr<ISMRMRD::Acquisition> acquisition();
+
+        void append(std::unique_ptr<ISMRMRD::Acquisition> acquisition);
+        void append(std::unique_ptr<ISMRMRD::Waveform> waveform);
+
+        void close();
+
+        Statistics statistics();
+        std::string summary();
+
+    private:
+        struct Item {
+            std::unique_ptr<ISMRMRD::Acquisition> acquisition;
+            std::unique_ptr<ISMRMRD::Waveform> waveform;
+            std::chrono::steady_clock::time_point queued;
+        };
+
+        void enqueue(Item item);
+        void write_loop();
+        void write(std::vector<Item>& batch);
+
+        const Settings settings;
+        std::unique_ptr<Destination> destination;
+
+        std::mutex m;
+        std::condition_variable not_empty, not_full;
+        std::deque<Item> queue;
+        std::vector<std::unique_ptr<ISMRMRD::Acquisition>> recycled;
+        Statistics stats;
+        std::exception_ptr error;
+        bool closed = false;
+
+        std::thread writer;
+    };
+}
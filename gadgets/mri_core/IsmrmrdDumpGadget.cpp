@@ -224,7 +224,24 @@ namespace Gadgetron
             ismrmrd_filename = p.string();
             GDEBUG_STREAM("KSpace dump file name : " << ismrmrd_filename);
 
-            ismrmrd_dataset_ = boost::shared_ptr<ISMRMRD::Dataset>(new ISMRMRD::Dataset(ismrmrd_filename.c_str(), "dataset", true));
+            auto ismrmrd_dataset = std::make_unique<ISMRMRD::Dataset>(ismrmrd_filename.c_str(), "dataset", true);
+
+            try
+            {
+                ismrmrd_dataset->writeHeader(ismrmrd_xml_);
+            }
+            catch (...)
+            {
+                GDEBUG("Failed to write XML header to HDF file\n");
+                return GADGET_FAIL;
+            }
+
+            AsyncDatasetWriter::Settings settings;
+            settings.queue_size = dump_queue_size.value();
+            settings.batch_size = dump_batch_size.value();
+            settings.flush_interval = std::chrono::milliseconds(dump_flush_interval_ms.value());
+
+            ismrmrd_writer_ = std::make_unique<AsyncDatasetWriter>(std::move(ismrmrd_dataset), settings);
         }
         catch (...)
         {
@@ -241,15 +258,8 @@ namespace Gadgetron
         {
             if (this->save_ismrmrd_data_)
             {
-                this->create_ismrmrd_dataset();
-
-                try
+                if (this->create_ismrmrd_dataset() != GADGET_OK)
                 {
-                    ismrmrd_dataset_->writeHeader(ismrmrd_xml_);
-                }
-                catch (...)
-                {
-                    GDEBUG("Failed to write XML header to HDF file\n");
                     return GADGET_FAIL;
                 }
 
@@ -265,8 +275,8 @@ namespace Gadgetron
 
         if (this->save_ismrmrd_data_ && !this->save_xml_header_only.value())
         {
-            ISMRMRD::Acquisition ismrmrd_acq;
-            ismrmrd_acq.setHead(*m1->getObjectPtr());
+            auto ismrmrd_acq = ismrmrd_writer_->acquisition();
+            ismrmrd_acq->setHead(*m1->getObjectPtr());
 
             GadgetContainerMessage< hoNDArray< std::complex<float> > >* m2 = AsContainerMessage< hoNDArray< std::complex<float> > >(m1->cont());
             if (!m2)
@@ -275,12 +285,12 @@ namespace Gadgetron
                 return GADGET_FAIL;
             }
 
-            memcpy((void *)ismrmrd_acq.getDataPtr(), m2->getObjectPtr()->get_data_ptr(), sizeof(float)*m2->getObjectPtr()->get_number_of_elements() * 2);
+            memcpy((void *)ismrmrd_acq->getDataPtr(), m2->getObjectPtr()->get_data_ptr(), sizeof(float)*m2->getObjectPtr()->get_number_of_elements() * 2);
 
             if (m2->cont())
             {
                 //Write trajectory
-                if (ismrmrd_acq.trajectory_dimensions() == 0)
+                if (ismrmrd_acq->trajectory_dimensions() == 0)
                 {
                     GDEBUG("Malformed dataset. Trajectory attached but trajectory dimensions == 0\n");
                     return GADGET_FAIL;
@@ -294,12 +304,12 @@ namespace Gadgetron
                     return GADGET_FAIL;
                 }
 
-                memcpy((void *)ismrmrd_acq.getTrajPtr(), m3->getObjectPtr()->get_data_ptr(),
+                memcpy((void *)ismrmrd_acq->getTrajPtr(), m3->getObjectPtr()->get_data_ptr(),
                     sizeof(float)*m3->getObjectPtr()->get_number_of_elements());
             }
             else
             {
-                if (ismrmrd_acq.trajectory_dimensions() != 0)
+                if (ismrmrd_acq->trajectory_dimensions() != 0)
                 {
                     GDEBUG("Malformed dataset. Trajectory dimensions not zero but no trajectory attached\n");
                     return GADGET_FAIL;
@@ -309,7 +319,7 @@ namespace Gadgetron
             {
                 try
                 {
-                    ismrmrd_dataset_->appendAcquisition(ismrmrd_acq);
+                    ismrmrd_writer_->append(std::move(ismrmrd_acq));
                 }
                 catch (...)
                 {
@@ -336,15 +346,8 @@ namespace Gadgetron
         {
             if (this->save_ismrmrd_data_)
             {
-                this->create_ismrmrd_dataset();
-
-                try
-                {
-                    ismrmrd_dataset_->writeHeader(ismrmrd_xml_);
-                }
-                catch (...)
+                if (this->create_ismrmrd_dataset() != GADGET_OK)
                 {
-                    GDEBUG("Failed to write XML header to HDF file\n");
                     return GADGET_FAIL;
                 }
 
@@ -370,19 +373,20 @@ namespace Gadgetron
                 return GADGET_FAIL;
             }
 
+            // the waveform data is passed on, so the writer gets a copy
             ismrmrd_wav.data = m2->getObjectPtr()->begin();
+            auto ismrmrd_wav_copy = std::make_unique<ISMRMRD::Waveform>(ismrmrd_wav);
+            ismrmrd_wav.data = NULL;
 
             try
             {
-                ismrmrd_dataset_->appendWaveform(ismrmrd_wav);
+                ismrmrd_writer_->append(std::move(ismrmrd_wav_copy));
             }
             catch (...)
             {
                 GDEBUG("Error appending ISMRMRD Waveform\n");
                 return GADGET_FAIL;
             }
-
-            ismrmrd_wav.data = NULL;
         }
 
         // TODO: remove this check
@@ -403,5 +407,28 @@ namespace Gadgetron
         return 0;
     }
 
+    int IsmrmrdDumpGadget::close(unsigned long flags)
+    {
+        if (ismrmrd_writer_)
+        {
+            // write out what is still queued and close the file, so it is complete once the connection is done
+            try
+            {
+                ismrmrd_writer_->close();
+                GDEBUG_STREAM("IsmrmrdDumpGadget, wrote " << ismrmrd_writer_->summary());
+            }
+            catch (const std::exception& e)
+            {
+                GERROR_STREAM("IsmrmrdDumpGadget, error writing dump file : " << e.what());
+                ismrmrd_writer_.reset();
+                return GADGET_FAIL;
+            }
+
+            ismrmrd_writer_.reset();
+        }
+
+        return BaseClass::close(flags);
+    }
+
     GADGET_FACTORY_DECLARE(IsmrmrdDumpGadget)
 }
@@ -4,6 +4,7 @@
 #include "Gadget.h"
 #include "hoNDArray.h"
 #include "gadgetron_mricore_export.h"
+#include "AsyncDatasetWriter.h"
 
 #include <ismrmrd/ismrmrd.h>
 #include <ismrmrd/dataset.h>
@@ -11,6 +12,7 @@
 #include <ismrmrd/waveform.h>
 
 #include <complex>
+#include <memory>
 
 namespace Gadgetron {
 
@@ -51,9 +53,15 @@ namespace Gadgetron {
         // TODO: remove this option
         GADGET_PROPERTY(pass_waveform_downstream, bool, "If true, waveform data is passed downstream", false);
 
+        // data is written to file on a background thread; these control how far it may fall behind
+        GADGET_PROPERTY(dump_queue_size, size_t, "Maximum number of acquisitions and waveforms waiting to be written; the pipeline waits when it is reached", 1024);
+        GADGET_PROPERTY(dump_batch_size, size_t, "Number of waiting acquisitions and waveforms that triggers a write", 64);
+        GADGET_PROPERTY(dump_flush_interval_ms, size_t, "Longest time in ms an acquisition or waveform waits before it is written", 1000);
+
         int process_config(ACE_Message_Block* mb) override;
         int process(GadgetContainerMessage<ISMRMRD::AcquisitionHeader>* m1) override ;
         int process(GadgetContainerMessage<ISMRMRD::WaveformHeader>* m1) override ;
+        int close(unsigned long flags) override;
 
     private:
 
@@ -61,7 +69,7 @@ namespace Gadgetron {
         bool save_ismrmrd_data_;
         ISMRMRD::IsmrmrdHeader ismrmrd_header_;
         std::string ismrmrd_xml_;
-        boost::shared_ptr<ISMRMRD::Dataset>  ismrmrd_dataset_;
+        std::unique_ptr<AsyncDatasetWriter> ismrmrd_writer_;
 
         int create_ismrmrd_dataset();
     };
@@ -1,15 +1,28 @@
 #ifndef NHLBICOMPRESSION_H
 #define NHLBICOMPRESSION_H
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <exception>
 #include <fstream>
 #include <iostream>
 #include <cmath>
+#include <stdexcept>
 #include <string>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define NHLBI_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define NHLBI_AVX2_TARGET
+#endif
+#endif
+
 #pragma pack(push, 1)
 struct CompressionHeader
 {
@@ -19,6 +32,202 @@ struct CompressionHeader
 };
 #pragma pack(pop)
 
+/*
+ * Bulk packing and unpacking of the NHLBI bit stream. Sample i occupies bits [i*bits, (i+1)*bits) of a little
+ * endian bit stream, stored as a two's complement integer of round(value*scale).
+ *
+ * The portable routines move whole 32 bit words through a 64 bit accumulator. The AVX2 routines quantize eight
+ * samples at a time, and unpack eight samples at a time with gathers; they are selected at runtime when the
+ * processor supports them. The unpacking routines read up to NHLBI::padding bytes past the end of the stream.
+ */
+namespace NHLBI
+{
+    constexpr size_t padding = 16;
+
+    inline uint32_t value_mask(unsigned int bits)
+    {
+        return static_cast<uint32_t>((uint64_t(1) << bits) - 1);
+    }
+
+    inline int32_t sign_extend(uint32_t value, unsigned int bits)
+    {
+        return static_cast<int32_t>(value << (32 - bits)) >> (32 - bits);
+    }
+
+    template <typename T> void pack_portable(const T* values, size_t count, T scale, unsigned int bits, uint8_t* out)
+    {
+        const uint32_t mask = value_mask(bits);
+        uint64_t accumulator = 0;
+        unsigned int filled = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            auto compact = static_cast<uint32_t>(static_cast<int64_t>(std::round(values[i]*scale))) & mask;
+            accumulator |= uint64_t(compact) << filled;
+            filled += bits;
+            if (filled >= 32) {
+                auto word = static_cast<uint32_t>(accumulator);
+                memcpy(out, &word, sizeof(word));
+                out += sizeof(word);
+                accumulator >>= 32;
+                filled -= 32;
+            }
+        }
+
+        for (; filled > 0; filled = filled > 8 ? filled - 8 : 0) {
+            *out++ = static_cast<uint8_t>(accumulator);
+            accumulator >>= 8;
+        }
+    }
+
+    template <typename T> void unpack_portable(const uint8_t* in, size_t count, T scale, unsigned int bits, T* out)
+    {
+        const uint32_t mask = value_mask(bits);
+        uint64_t accumulator = 0;
+        unsigned int available = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            if (available < bits) {
+                uint32_t word;
+                memcpy(&word, in, sizeof(word));
+                in += sizeof(word);
+                accumulator |= uint64_t(word) << available;
+                available += 32;
+            }
+            auto compact = static_cast<uint32_t>(accumulator) & mask;
+            accumulator >>= bits;
+            available -= bits;
+            out[i] = sign_extend(compact, bits) / scale;
+        }
+    }
+
+#if defined(NHLBI_AVX2_TARGET)
+
+    inline bool avx2_supported()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return true;
+#endif
+    }
+
+    NHLBI_AVX2_TARGET inline void pack_avx2(const float* values, size_t count, float scale, unsigned int bits, uint8_t* out)
+    {
+        const __m256 scales = _mm256_set1_ps(scale);
+        const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256i mask = _mm256_set1_epi32(static_cast<int>(value_mask(bits)));
+
+        uint64_t accumulator = 0;
+        unsigned int filled = 0;
+        alignas(32) uint32_t compact[8];
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            // std::round rounds halfway cases away from zero, which none of the AVX rounding modes do.
+            __m256 x = _mm256_mul_ps(_mm256_loadu_ps(values + i), scales);
+            __m256 truncated = _mm256_round_ps(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            __m256 fraction = _mm256_andnot_ps(sign_mask, _mm256_sub_ps(x, truncated));
+            __m256 step = _mm256_and_ps(_mm256_cmp_ps(fraction, half, _CMP_GE_OQ), one);
+            __m256 rounded = _mm256_add_ps(truncated, _mm256_or_ps(step, _mm256_and_ps(x, sign_mask)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(compact),
+                               _mm256_and_si256(_mm256_cvtps_epi32(rounded), mask));
+
+            for (auto value : compact) {
+                accumulator |= uint64_t(value) << filled;
+                filled += bits;
+                if (filled >= 32) {
+                    auto word = static_cast<uint32_t>(accumulator);
+                    memcpy(out, &word, sizeof(word));
+                    out += sizeof(word);
+                    accumulator >>= 32;
+                    filled -= 32;
+                }
+            }
+        }
+
+        // Eight samples always end on a byte boundary, so the tail can be packed independently.
+        for (; filled > 0; filled -= 8) {
+            *out++ = static_cast<uint8_t>(accumulator);
+            accumulator >>= 8;
+        }
+        pack_portable(values + i, count - i, scale, bits, out);
+    }
+
+    NHLBI_AVX2_TARGET inline void unpack_avx2(const uint8_t* in, size_t count, float scale, unsigned int bits, float* out)
+    {
+        alignas(32) int32_t offsets[8];
+        alignas(32) int32_t shifts[8];
+        for (unsigned int j = 0; j < 8; j++) {
+            offsets[j] = static_cast<int32_t>((j*bits)/8);
+            shifts[j] = static_cast<int32_t>((j*bits)%8);
+        }
+
+        const __m256 scales = _mm256_set1_ps(scale);
+        const __m128i unused_bits = _mm_cvtsi32_si128(static_cast<int>(32 - bits));
+        const __m256i offset = _mm256_load_si256(reinterpret_cast<const __m256i*>(offsets));
+        const __m256i shift = _mm256_load_si256(reinterpret_cast<const __m256i*>(shifts));
+        const __m256i low_words = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+        // A sample starts at most 7 bits into its first byte, so up to 25 bits fit in a 32 bit load.
+        const bool wide = bits > 25;
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8, in += bits) {
+            __m256i words;
+            if (!wide) {
+                words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(in), offset, 1);
+                words = _mm256_srlv_epi32(words, shift);
+            } else {
+                auto base = reinterpret_cast<const long long*>(in);
+                __m256i low = _mm256_i32gather_epi64(base, _mm256_castsi256_si128(offset), 1);
+                __m256i high = _mm256_i32gather_epi64(base, _mm256_extracti128_si256(offset, 1), 1);
+                low = _mm256_srlv_epi64(low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(shift)));
+                high = _mm256_srlv_epi64(high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(shift, 1)));
+                low = _mm256_permutevar8x32_epi32(low, low_words);
+                high = _mm256_permutevar8x32_epi32(high, low_words);
+                words = _mm256_permute2x128_si256(low, high, 0x20);
+            }
+
+            words = _mm256_sra_epi32(_mm256_sll_epi32(words, unused_bits), unused_bits);
+            _mm256_storeu_ps(out + i, _mm256_div_ps(_mm256_cvtepi32_ps(words), scales));
+        }
+
+        unpack_portable(in, count - i, scale, bits, out + i);
+    }
+
+#else
+
+    inline bool avx2_supported()
+    {
+        return false;
+    }
+
+#endif
+
+    template <typename T> void pack(const T* values, size_t count, T scale, unsigned int bits, uint8_t* out)
+    {
+#if defined(NHLBI_AVX2_TARGET)
+        if constexpr (std::is_same_v<T, float>) {
+            if (avx2_supported()) return pack_avx2(values, count, scale, bits, out);
+        }
+#endif
+        pack_portable(values, count, scale, bits, out);
+    }
+
+    template <typename T> void unpack(const uint8_t* in, size_t count, T scale, unsigned int bits, T* out)
+    {
+#if defined(NHLBI_AVX2_TARGET)
+        if constexpr (std::is_same_v<T, float>) {
+            if (avx2_supported()) return unpack_avx2(in, count, scale, bits, out);
+        }
+#endif
+        unpack_portable(in, count, scale, bits, out);
+    }
+}
+
 template <typename T> class CompressedBuffer
 {
 
@@ -31,11 +240,16 @@ public:
         max_val_ = 0.0;
         scale_ = 0.0;
     }
-    
+
     CompressedBuffer(std::vector<T>& d, T tolerance = -1.0, uint8_t precision_bits = 32)
+        : CompressedBuffer(d.data(), d.size(), tolerance, precision_bits)
+    {
+    }
+
+    CompressedBuffer(const T* d, size_t elements, T tolerance = -1.0, uint8_t precision_bits = 32)
     {
         auto comp_func = [](T a, T b) { return std::abs(a) < std::abs(b); };
-        max_val_ = *std::max_element(d.begin(), d.end(), comp_func);
+        max_val_ = elements ? *std::max_element(d, d + elements, comp_func) : T(0);
 
         if (tolerance > 0) {
             tolerance_ = tolerance;
@@ -47,20 +261,22 @@ public:
                 max_int = max_int>>1;
             }
             bits_++; //Signed
+            check_precision(bits_);
         } else {
             bits_ = precision_bits;
-            uint64_t max_int = (1<<(bits_-1))-1;
+            check_precision(bits_);
+            uint64_t max_int = (uint64_t(1)<<(bits_-1))-1;
             scale_ = (max_int-1)/max_val_;
+            //Above 24 bits the scale is rounded to single precision, which may push the largest sample out of range
+            while (static_cast<uint64_t>(std::abs(std::round(max_val_*scale_))) > max_int) {
+                scale_ = std::nextafter(scale_, T(0));
+            }
             tolerance_ = 0.5/scale_;
         }
 
-        elements_ = d.size();
-        size_t bytes_needed = static_cast<size_t>(std::ceil((bits_*elements_)/8.0f));
-        comp_.resize(bytes_needed, 0);
-
-        for (size_t i = 0; i < d.size(); i++) {
-            setValue(i,d[i]);
-        }
+        elements_ = elements;
+        allocate();
+        NHLBI::pack(d, elements_, scale_, static_cast<unsigned int>(bits_), comp_.data());
     }
 
     float operator[](size_t idx)
@@ -80,18 +296,28 @@ public:
 
     T getCompressionRatio()
     {
-        return (1.0*elements_*sizeof(T))/comp_.size();
+        return (1.0*elements_*sizeof(T))/serialized_bytes(bits_, elements_);
+    }
+
+    /**
+     * Decompresses all samples into out, which must have room for size() values. Produces the same values as
+     * operator[].
+     */
+    void decompress(T* out) const
+    {
+        NHLBI::unpack(comp_.data(), elements_, scale_, static_cast<unsigned int>(bits_), out);
     }
 
     std::vector<uint8_t> serialize()
     {
-        std::vector<uint8_t> out(comp_.size()+sizeof(CompressionHeader),0);
+        auto bytes = serialized_bytes(bits_, elements_);
+        std::vector<uint8_t> out(bytes+sizeof(CompressionHeader),0);
         CompressionHeader h;
         h.elements_ = this->elements_;
         h.scale_ = this->scale_;
         h.bits_ = static_cast<uint8_t>(this->bits_);
         memcpy(&out[0],&h, sizeof(CompressionHeader));
-        memcpy(&out[sizeof(CompressionHeader)], &comp_[0], comp_.size());
+        memcpy(&out[sizeof(CompressionHeader)], comp_.data(), std::min(bytes, comp_.size()));
         return out;
     }
 
@@ -103,8 +329,9 @@ public:
 
         CompressionHeader h;
         memcpy(&h, &buffer[0], sizeof(CompressionHeader));
-        
-        size_t bytes_needed = static_cast<size_t>(std::ceil((h.bits_*h.elements_)/8.0f));
+        check_precision(h.bits_);
+
+        size_t bytes_needed = serialized_bytes(h.bits_, h.elements_);
         if (bytes_needed != (buffer.size()-sizeof(CompressionHeader))) {
             throw std::runtime_error("Incorrect number of bytes in buffer");
         }
@@ -113,9 +340,9 @@ public:
         this->elements_ = h.elements_;
         this->scale_ = h.scale_;
         this->tolerance_ = 0.5/h.scale_;
-        this->comp_.resize(bytes_needed,0);
+        allocate();
 
-        memcpy(&comp_[0], &buffer[sizeof(CompressionHeader)], bytes_needed);
+        memcpy(comp_.data(), &buffer[sizeof(CompressionHeader)], std::min(bytes_needed, comp_.size()));
     }
 
 private:
@@ -126,70 +353,43 @@ private:
     T scale_;
     std::vector<uint8_t> comp_;
 
-    void setValue(size_t idx, T v)
+    //Number of bytes on the wire. Computed in single precision, as it always has been, so that both ends agree.
+    static size_t serialized_bytes(size_t bits, size_t elements)
     {
-        size_t sb = (idx*bits_)/8;
-
-        uint64_t* bptr = reinterpret_cast<uint64_t*>(&comp_[sb]);
-        
-        size_t upshift = idx*bits_-sb*8;
+        return static_cast<size_t>(std::ceil((bits*elements)/8.0f));
+    }
 
-        //Create mask with ones corresponding to current bits
-        const uint64_t bitmask = ((1<<bits_)-1)<<upshift;
+    static void check_precision(size_t bits)
+    {
+        if (bits < 1 || bits > 32) {
+            throw std::runtime_error("NHLBI compression supports 1 to 32 bits per sample, not " + std::to_string(bits));
+        }
+    }
 
-        //Convert number to compact integeter representation
-        int64_t int_val = static_cast<int64_t>(std::round(v*scale_));
-        uint64_t compact_val = compact_int(int_val);
-        *bptr = ((*bptr) & (~bitmask)) | (compact_val << upshift);         
+    //The exact size of the bit stream, plus room for the word sized reads and writes of the bulk routines.
+    void allocate()
+    {
+        comp_.assign((bits_*elements_ + 7)/8 + NHLBI::padding, 0);
     }
 
     float getValue(size_t idx)
     {
         size_t sb = (idx*bits_)/8;
-        uint64_t* bptr = reinterpret_cast<uint64_t*>(&comp_[sb]);
-        
-        size_t upshift = idx*bits_-sb*8;
+        uint64_t bptr;
+        memcpy(&bptr, &comp_[sb], sizeof(bptr));
 
-        //Create mask with ones corresponding to current bits
-        const uint64_t bitmask = ((1<<bits_)-1)<<upshift;
+        size_t upshift = idx*bits_-sb*8;
 
         //Mask other bits and shift back down
-        uint64_t compact_val =  (*bptr & bitmask)>>upshift;
+        uint32_t compact_val = static_cast<uint32_t>(bptr >> upshift) & NHLBI::value_mask(bits_);
 
         //Convert back to binary
-        int64_t int_val = uncompact_int(compact_val);
-        
+        int64_t int_val = NHLBI::sign_extend(compact_val, bits_);
+
         //Scale back and return
         return int_val / scale_;
     }
-
-    uint64_t compact_int(int64_t bin)
-    {
-
-        uint64_t abs_val = static_cast<uint64_t>(std::abs(bin));
-        
-        if (bin < 0) {
-            const uint64_t bitmask = ((1<<bits_)-1);
-            abs_val ^= bitmask;
-            abs_val += 1;
-        }
-        return abs_val;
-    }
-
-    int64_t uncompact_int(uint64_t cbin)
-    {
-        if (cbin & (1<<(bits_-1))) {
-            const uint64_t bitmask = ((1<<bits_)-1);
-            int64_t out = static_cast<int64_t>((cbin ^ bitmask)+1);
-            out = -out;
-            return out;
-        }
-
-        return static_cast<int64_t>(cbin);
-    }
 };
 
 
 #endif //NHLBICOMPRESSION
-
-
@@ -1,4 +1,5 @@
 #include "NoiseAdjustGadget.h"
+#include "NoisePrewhitenerCache.h"
 #include "hoArmadillo.h"
 #include "hoMatrix.h"
 #include "hoNDArray_elemwise.h"
@@ -6,6 +7,8 @@
 #include "hoNDArray_reductions.h"
 #include "io/primitives.h"
 #include "log.h"
+#include "mri_core_noise_prewhitening.h"
+#include "mri_core_utility.h"
 #include <boost/iterator/counting_iterator.hpp>
 #ifdef USE_OMP
 #include "omp.h"
@@ -14,6 +17,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <chrono>
 #include <typeinfo>
 using namespace std::string_literals;
 namespace bf = boost::filesystem;
@@ -276,6 +280,11 @@ namespace Gadgetron {
         omp_set_num_threads(1);
 #endif // USE_OMP
 
+        scale_only_channels = current_ismrmrd_header.acquisitionSystemInformation
+                                  ? find_scale_only_channels(scale_only_channels_by_name,
+                                      current_ismrmrd_header.acquisitionSystemInformation->coilLabel)
+                                  : std::vector<size_t>{};
+
         // find the measurementID of this scan
 
         noisehandler = load_or_gather();
@@ -304,6 +313,18 @@ namespace Gadgetron {
             noise_dependency_folder, noise_dependency_prefix);
         GDEBUG("Stored noise dependency is %s\n", noise_dependency_file.c_str());
 
+        NoisePrewhitenerCache::Key cache_key{ noise_dependency_file.string(), {}, scale_only_channels };
+        if (current_ismrmrd_header.acquisitionSystemInformation)
+            for (const auto& coil : current_ismrmrd_header.acquisitionSystemInformation->coilLabel)
+                cache_key.coil_names.push_back(coil.coilName);
+
+        auto& cache = NoisePrewhitenerCache::instance();
+        if (auto cached = cache.find(cache_key)) {
+            GDEBUG("Stored noise prewhitener is cached : %s\n", noise_dependency_file.c_str());
+            return LoadedNoise{ std::move(cached->prewhitening_matrix), cached->noise_dwell_time_us };
+        }
+
+        auto file_version     = NoisePrewhitenerCache::version(noise_dependency_file.string());
         auto noise_covariance = loadNoiseCovariance(noise_dependency_file);
         // try to load the precomputed noise prewhitener
         if (!noise_covariance) {
@@ -343,7 +364,12 @@ namespace Gadgetron {
                         }
                     }
                 }
-                return LoadedNoise{noise_covariance->noise_covariance_matrix,noise_covariance->noise_dwell_time_us};
+                auto prewhitening_matrix = computeNoisePrewhitener(
+                    mask_channels(std::move(noise_covariance->noise_covariance_matrix), scale_only_channels));
+                if (file_version)
+                    cache.insert(cache_key, *file_version,
+                        NoisePrewhitenerCache::Entry{ prewhitening_matrix, noise_covariance->noise_dwell_time_us });
+                return LoadedNoise{ std::move(prewhitening_matrix), noise_covariance->noise_dwell_time_us };
 
             } else if (current_ismrmrd_header.acquisitionSystemInformation) {
                 GERROR("Noise ismrmrd header does not have acquisition system information but current header "
@@ -395,9 +421,12 @@ namespace Gadgetron {
 
         normalize_covariance(ng);
 
+        auto noise_dependency_file
+            = generateNoiseDependencyFilePath(measurement_id, noise_dependency_folder, noise_dependency_prefix);
         saveNoiseCovariance(
             NoiseCovariance{ this->current_ismrmrd_header, ng.noise_dwell_time_us, ng.tmp_covariance },
-            generateNoiseDependencyFilePath(measurement_id, noise_dependency_folder, noise_dependency_prefix));
+            noise_dependency_file);
+        NoisePrewhitenerCache::instance().invalidate(noise_dependency_file.string());
     }
 
     template <> void NoiseAdjustGadget::save_noisedata(NoiseHandler& nh) const {
@@ -417,9 +446,8 @@ namespace Gadgetron {
 
         auto& data = std::get<hoNDArray<std::complex<float>>>(acq);
         if (data.get_size(1) == pw.prewhitening_matrix.get_size(0)) {
-            auto dataM = as_arma_matrix(data);
-            auto pwm = as_arma_matrix(pw.prewhitening_matrix);
-            dataM *= pwm;
+            hoNDArray<std::complex<float>> buf;
+            apply_channel_matrix({ &data }, pw.prewhitening_matrix, pw.upper_triangular, buf);
         } else if (!this->pass_nonconformant_data) {
             throw std::runtime_error("Input data has different number of channels from noise data");
         }
@@ -442,18 +470,19 @@ namespace Gadgetron {
         auto prewhitening_matrix = computeNoisePrewhitener(masked_covariance);
         prewhitening_matrix
             *= calculate_scale_factor(head.sample_time_us, ng.noise_dwell_time_us, receiver_noise_bandwidth);
-        return handle_acquisition(Prewhitener{ prewhitening_matrix }, acq);
+        auto upper_triangular = is_upper_triangular(prewhitening_matrix);
+        return handle_acquisition(Prewhitener{ std::move(prewhitening_matrix), upper_triangular }, acq);
     }
 
     template <>
     NoiseAdjustGadget::NoiseHandler NoiseAdjustGadget::handle_acquisition(
         LoadedNoise ln, Core::Acquisition& acq) const {
         auto& head               = std::get<ISMRMRD::AcquisitionHeader>(acq);
-        auto masked_covariance   = mask_channels(std::move(ln.covariance), scale_only_channels);
-        auto prewhitening_matrix = computeNoisePrewhitener(masked_covariance);
+        auto prewhitening_matrix = std::move(ln.prewhitening_matrix);
         prewhitening_matrix
             *= calculate_scale_factor(head.sample_time_us, ln.noise_dwell_time_us, receiver_noise_bandwidth);
-        return handle_acquisition(Prewhitener{ prewhitening_matrix }, acq);
+        auto upper_triangular = is_upper_triangular(prewhitening_matrix);
+        return handle_acquisition(Prewhitener{ std::move(prewhitening_matrix), upper_triangular }, acq);
     }
 
     template <>
@@ -466,24 +495,77 @@ namespace Gadgetron {
 
     void NoiseAdjustGadget::process(Core::InputChannel<Core::Acquisition>& input, Core::OutputChannel& output) {
 
-        scale_only_channels = current_ismrmrd_header.acquisitionSystemInformation
-                                  ? find_scale_only_channels(scale_only_channels_by_name,
-                                      current_ismrmrd_header.acquisitionSystemInformation->coilLabel)
-                                  : std::vector<size_t>{};
-
         auto filepath
             = generateNoiseDependencyFilePath(measurement_id, noise_dependency_folder, noise_dependency_prefix);
 
-        for (auto acq : input) {
+        // Once the prewhitener is known, acquisitions are collected and prewhitened together. A batch is passed on
+        // when it is full, when it is too old, or as soon as no further acquisitions are waiting on the input, so
+        // batching never waits for data that has not arrived yet.
+        std::vector<Core::Acquisition> batch;
+        hoNDArray<std::complex<float>> buf;
+        auto batch_start = std::chrono::steady_clock::now();
+        auto max_latency = std::chrono::duration<float, std::milli>(prewhitening_max_latency_ms);
+
+        auto flush = [&]() {
+            if (batch.empty())
+                return;
+            std::vector<hoNDArray<std::complex<float>>*> data;
+            for (auto& acq : batch)
+                data.push_back(&std::get<hoNDArray<std::complex<float>>>(acq));
+            auto& prewhitener = std::get<Prewhitener>(noisehandler);
+            apply_channel_matrix(data, prewhitener.prewhitening_matrix, prewhitener.upper_triangular, buf);
+            for (auto& acq : batch)
+                output.push(std::move(acq));
+            batch.clear();
+        };
+
+        while (true) {
+            Core::optional<Core::Acquisition> next;
+            try {
+                next = batch.empty() ? Core::optional<Core::Acquisition>(input.pop()) : input.try_pop();
+            } catch (const Core::ChannelClosed&) {
+                break;
+            }
+            if (!next) {
+                flush();
+                continue;
+            }
+
+            auto& acq = *next;
             if (is_noise(acq)) {
                 add_noise(noisehandler, acq);
                 continue;
             }
+
+            auto prewhitener = std::get_if<Prewhitener>(&noisehandler);
+            if (prewhitener
+                && std::get<hoNDArray<std::complex<float>>>(acq).get_size(1)
+                       == prewhitener->prewhitening_matrix.get_size(0)) {
+                if (batch.empty()) {
+                    batch_start = std::chrono::steady_clock::now();
+                    // Room for a full batch and its product, so that batches cut short by the latency limit or by
+                    // an idle input do not leave buf to grow one step at a time.
+                    auto full_batch = 2 * prewhitening_batch_size
+                        * std::get<hoNDArray<std::complex<float>>>(acq).get_number_of_elements();
+                    if (prewhitening_batch_size > 1 && buf.get_number_of_elements() < full_batch)
+                        buf.create(full_batch);
+                }
+                batch.push_back(std::move(acq));
+                if (batch.size() >= prewhitening_batch_size
+                    || (max_latency.count() > 0 && std::chrono::steady_clock::now() - batch_start >= max_latency))
+                    flush();
+                continue;
+            }
+
+            flush();
             noisehandler = handle_acquisition(std::move(noisehandler), acq);
             output.push(std::move(acq));
         }
+        flush();
 
         this->save_noisedata(noisehandler);
+
+        GDEBUG_STREAM("Noise prewhitener cache: " << NoisePrewhitenerCache::instance().summary());
     }
 
     GADGETRON_GADGET_EXPORT(NoiseAdjustGadget)
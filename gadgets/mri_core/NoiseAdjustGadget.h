@@ -28,10 +28,12 @@ namespace Gadgetron {
 
         struct Prewhitener {
             hoNDArray<std::complex<float>> prewhitening_matrix;
+            bool upper_triangular; // checked once, not for every acquisition it is applied to
         };
 
+        // prewhitener computed from a stored noise covariance, not yet scaled for the dwell time of the data
         struct LoadedNoise {
-            hoNDArray<std::complex<float>> covariance;
+            hoNDArray<std::complex<float>> prewhitening_matrix;
             float noise_dwell_time_us;
         };
 
@@ -55,6 +57,10 @@ namespace Gadgetron {
             scale_only_channels_by_name, std::string, "List of named channels that should only be scaled", "");
         NODE_PROPERTY(noise_dependency_folder, boost::filesystem::path, "Path to the working directory",
             boost::filesystem::temp_directory_path() / "gadgetron");
+        NODE_PROPERTY(prewhitening_batch_size, size_t,
+            "Number of acquisitions prewhitened together with one matrix product", 1);
+        NODE_PROPERTY(prewhitening_max_latency_ms, float,
+            "Longest an acquisition is held back while its batch fills; 0 for no limit", 0.0);
 
         const float receiver_noise_bandwidth;
 
@@ -0,0 +1,288 @@
+#include "NoisePrewhitenerCache.h"
+#include "io/primitives.h"
+#include "log.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+
+namespace Gadgetron {
+
+    namespace {
+        // FNV-1a, which, unlike std::hash, is the same for every build that reads the stored entries
+        constexpr uint64_t fnv_offset_basis = 14695981039346656037ull;
+
+        void fnv1a(uint64_t& hash, const char* data, size_t size) {
+            for (size_t i = 0; i < size; i++) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ull;
+            }
+        }
+
+        uint64_t fingerprint(const NoisePrewhitenerCache::Key& key) {
+            uint64_t hash = fnv_offset_basis;
+            auto add      = [&](const std::string& s) { fnv1a(hash, s.c_str(), s.size() + 1); };
+            for (const auto& name : key.coil_names)
+                add(name);
+            add("|");
+            for (auto channel : key.scale_only_channels)
+                add(std::to_string(channel));
+            return hash;
+        }
+
+        const std::string stored_entry_marker = "GADGETRON_NOISE_PREWHITENER_2";
+    }
+
+    NoisePrewhitenerCache::NoisePrewhitenerCache(bool persistent) : persistent(persistent) {}
+
+    bool NoisePrewhitenerCache::Key::operator<(const Key& other) const {
+        return std::tie(noise_dependency_file, coil_names, scale_only_channels)
+               < std::tie(other.noise_dependency_file, other.coil_names, other.scale_only_channels);
+    }
+
+    bool NoisePrewhitenerCache::Version::operator==(const Version& other) const {
+        return size == other.size && hash == other.hash;
+    }
+
+    NoisePrewhitenerCache& NoisePrewhitenerCache::instance() {
+        static NoisePrewhitenerCache cache(true);
+        return cache;
+    }
+
+    std::optional<NoisePrewhitenerCache::Version> NoisePrewhitenerCache::version(
+        const std::string& noise_dependency_file) {
+        std::ifstream file(noise_dependency_file, std::ios::in | std::ios::binary);
+        if (!file.good())
+            return std::nullopt;
+
+        Version version{ 0, fnv_offset_basis };
+        std::vector<char> buffer(64 * 1024);
+        while (file) {
+            file.read(buffer.data(), buffer.size());
+            fnv1a(version.hash, buffer.data(), size_t(file.gcount()));
+            version.size += uintmax_t(file.gcount());
+        }
+        if (file.bad())
+            return std::nullopt;
+        return version;
+    }
+
+    std::string NoisePrewhitenerCache::stored_entry_file(const Key& key) {
+        std::stringstream name;
+        name << key.noise_dependency_file << ".prewhitener-" << std::hex << std::setw(16) << std::setfill('0')
+             << fingerprint(key);
+        return name.str();
+    }
+
+    std::optional<NoisePrewhitenerCache::Entry> NoisePrewhitenerCache::find(const Key& key) {
+        auto current = version(key.noise_dependency_file);
+
+        {
+            std::lock_guard<std::mutex> guard(m);
+            auto it = index.find(key);
+            if (it != index.end()) {
+                if (current && it->second->version == *current) {
+                    items.splice(items.begin(), items, it->second);
+                    stats.hits++;
+                    return it->second->entry;
+                }
+
+                items.erase(it->second);
+                index.erase(it);
+                stats.stale++;
+            }
+        }
+
+        // Not in memory, e.g. because it was computed by another connection
+        if (persistent && current) {
+            if (auto stored = load(key, *current)) {
+                std::lock_guard<std::mutex> guard(m);
+                stats.hits++;
+                stats.stored_hits++;
+                emplace(key, *current, *stored);
+                return stored;
+            }
+        }
+
+        std::lock_guard<std::mutex> guard(m);
+        stats.misses++;
+        return std::nullopt;
+    }
+
+    void NoisePrewhitenerCache::insert(const Key& key, const Version& version, Entry entry) {
+        if (persistent)
+            store(key, version, entry);
+
+        std::lock_guard<std::mutex> guard(m);
+        emplace(key, version, std::move(entry));
+    }
+
+    void NoisePrewhitenerCache::emplace(const Key& key, const Version& version, Entry entry) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            items.erase(it->second);
+            index.erase(it);
+        }
+
+        items.push_front(Item{ key, version, std::move(entry) });
+        index.emplace(key, items.begin());
+        evict();
+    }
+
+    void NoisePrewhitenerCache::invalidate(const std::string& noise_dependency_file) {
+        {
+            std::lock_guard<std::mutex> guard(m);
+            for (auto it = items.begin(); it != items.end();) {
+                if (it->key.noise_dependency_file == noise_dependency_file) {
+                    index.erase(it->key);
+                    it = items.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        if (!persistent)
+            return;
+
+        // Stored entries no longer match the file anyway; this only keeps them from piling up.
+        namespace bf = boost::filesystem;
+        auto prefix  = bf::path(noise_dependency_file).filename().string() + ".prewhitener-";
+        auto folder  = bf::path(noise_dependency_file).parent_path();
+        if (folder.empty())
+            folder = ".";
+
+        boost::system::error_code error;
+        for (bf::directory_iterator it(folder, error), end; !error && it != end; it.increment(error)) {
+            if (it->path().filename().string().compare(0, prefix.size(), prefix) == 0) {
+                boost::system::error_code remove_error;
+                bf::remove(it->path(), remove_error);
+            }
+        }
+    }
+
+    std::optional<NoisePrewhitenerCache::Entry> NoisePrewhitenerCache::load(const Key& key, const Version& version) {
+        using namespace Core::IO;
+
+        std::ifstream file(stored_entry_file(key), std::ios::in | std::ios::binary);
+        if (!file.good())
+            return std::nullopt;
+
+        try {
+            if (read_string_from_stream<uint32_t>(file) != stored_entry_marker)
+                return std::nullopt;
+
+            auto coils = read<uint32_t>(file);
+            std::vector<std::string> coil_names;
+            for (uint32_t c = 0; c < coils && file.good(); c++)
+                coil_names.push_back(read_string_from_stream<uint32_t>(file));
+
+            std::vector<uint64_t> scale_only_channels;
+            read(file, scale_only_channels);
+
+            auto size = read<uint64_t>(file);
+            auto hash = read<uint64_t>(file);
+
+            Entry entry;
+            entry.noise_dwell_time_us = read<float>(file);
+            read(file, entry.prewhitening_matrix);
+
+            if (!file.good())
+                return std::nullopt;
+
+            bool matches = coil_names == key.coil_names
+                           && std::equal(scale_only_channels.begin(), scale_only_channels.end(),
+                               key.scale_only_channels.begin(), key.scale_only_channels.end())
+                           && Version{ size, hash } == version;
+            if (!matches)
+                return std::nullopt;
+
+            return entry;
+        } catch (const std::exception& e) {
+            GWARN_STREAM("Unable to load the stored noise prewhitener " << stored_entry_file(key) << ": " << e.what());
+            return std::nullopt;
+        }
+    }
+
+    void NoisePrewhitenerCache::store(const Key& key, const Version& version, const Entry& entry) {
+        using namespace Core::IO;
+        namespace bf = boost::filesystem;
+
+        // Written under a name of its own and renamed, so that other connections never read a partial entry
+        auto filename  = stored_entry_file(key);
+        auto temporary = filename + "." + bf::unique_path().string();
+
+        try {
+            {
+                std::ofstream file(temporary, std::ios::out | std::ios::binary);
+                if (!file.good())
+                    throw std::runtime_error("unable to open " + temporary);
+
+                write_string_to_stream<uint32_t>(file, stored_entry_marker);
+                write(file, uint32_t(key.coil_names.size()));
+                for (const auto& name : key.coil_names)
+                    write_string_to_stream<uint32_t>(file, name);
+                write(file, std::vector<uint64_t>(key.scale_only_channels.begin(), key.scale_only_channels.end()));
+                write(file, uint64_t(version.size));
+                write(file, uint64_t(version.hash));
+                write(file, entry.noise_dwell_time_us);
+                write(file, entry.prewhitening_matrix);
+
+                if (!file.good())
+                    throw std::runtime_error("unable to write " + temporary);
+            }
+            bf::rename(temporary, filename);
+        } catch (const std::exception& e) {
+            GWARN_STREAM("Unable to store the noise prewhitener " << filename << ": " << e.what());
+            boost::system::error_code error;
+            bf::remove(temporary, error);
+        }
+    }
+
+    void NoisePrewhitenerCache::set_capacity(size_t capacity) {
+        std::lock_guard<std::mutex> guard(m);
+        max_entries = capacity;
+        evict();
+    }
+
+    size_t NoisePrewhitenerCache::capacity() {
+        std::lock_guard<std::mutex> guard(m);
+        return max_entries;
+    }
+
+    void NoisePrewhitenerCache::clear() {
+        std::lock_guard<std::mutex> guard(m);
+        items.clear();
+        index.clear();
+        stats = Statistics{};
+    }
+
+    NoisePrewhitenerCache::Statistics NoisePrewhitenerCache::statistics() {
+        std::lock_guard<std::mutex> guard(m);
+        auto result    = stats;
+        result.entries = items.size();
+        return result;
+    }
+
+    std::string NoisePrewhitenerCache::summary() {
+        auto s        = statistics();
+        auto lookups  = s.hits + s.misses;
+        std::stringstream stream;
+        stream << s.hits << " hits (" << s.stored_hits << " stored), " << s.misses << " misses (" << s.stale
+               << " stale)";
+        if (lookups > 0)
+            stream << ", hit rate " << (100 * s.hits) / lookups << "%";
+        stream << ", " << s.entries << " entries, " << s.evictions << " evictions";
+        return stream.str();
+    }
+
+    void NoisePrewhitenerCache::evict() {
+        while (items.size() > max_entries) {
+            index.erase(items.back().key);
+            items.pop_back();
+            stats.evictions++;
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "gadgetron_mricore_export.h"
+#include "hoNDArray.h"
+
+#include <complex>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Gadgetron {
+
+    /**
+     * Cache of noise prewhiteners computed from stored noise dependencies, so that series referencing the same noise
+     * scan do not each read the file, parse its header, reorder the channels and invert the Cholesky factor again.
+     *
+     * Entries are keyed by the noise dependency file, the coil labels of the data, in order, and the channels that
+     * are only scaled. Each entry remembers the size and a hash of the contents of the file it was computed from, and
+     * is dropped when the file on disk no longer matches. The file is small next to the work the cache saves, and
+     * unlike its modification time, which many file systems only keep to the second, its contents tell apart two
+     * noise scans written in quick succession. The least recently used entry is evicted once the cache
+     * holds capacity() entries.
+     *
+     * The server handles each connection in a process of its own, so entries held in memory do not outlive the
+     * connection that computed them. A persistent cache therefore also stores each entry beside the noise dependency
+     * file, named after it and a fingerprint of the coil labels and scale only channels, and entries missing from
+     * memory are loaded from there; later series, and later connections, skip the computation entirely. The stored
+     * entry records the key and the version of the noise dependency file, and is ignored unless both match.
+     *
+     * The cached prewhitener is not yet scaled for the dwell time of the data, which is only known once the first
+     * acquisition arrives.
+     */
+    class EXPORTGADGETSMRICORE NoisePrewhitenerCache {
+    public:
+        struct Key {
+            std::string noise_dependency_file;
+            std::vector<std::string> coil_names;
+            std::vector<size_t> scale_only_channels;
+
+            bool operator<(const Key& other) const;
+        };
+
+        /// Size and content hash of a noise dependency file
+        struct Version {
+            uintmax_t size;
+            uint64_t hash;
+
+            bool operator==(const Version& other) const;
+        };
+
+        struct Entry {
+            hoNDArray<std::complex<float>> prewhitening_matrix;
+            float noise_dwell_time_us;
+        };
+
+        struct Statistics {
+            size_t hits = 0;
+            size_t stored_hits = 0; // hits loaded from a stored entry, included in hits
+            size_t misses = 0;
+            size_t stale = 0;
+            size_t evictions = 0;
+            size_t entries = 0;
+        };
+
+        explicit NoisePrewhitenerCache(bool persistent = false);
+
+        /// The cache shared by the process, which is persistent
+        static NoisePrewhitenerCache& instance();
+
+        /// The current version of the file, or none if it does not exist
+        static std::optional<Version> version(const std::string& noise_dependency_file);
+
+        /// Where a persistent cache stores the entry for the key
+        static std::string stored_entry_file(const Key& key);
+
+        /// The entry for the key, if the noise dependency file still matches the version it was computed from
+        std::optional<Entry> find(const Key& key);
+
+        /// Stores an entry computed from the given version of the noise dependency file, as read before loading it
+        void insert(const Key& key, const Version& version, Entry entry);
+
+        /// Drops all entries computed from the file, stored ones included, e.g. because it has just been written
+        void invalidate(const std::string& noise_dependency_file);
+
+        void set_capacity(size_t capacity);
+        size_t capacity();
+
+        void clear();
+
+        Statistics statistics();
+        std::string summary();
+
+    private:
+        struct Item {
+            Key key;
+            Version version;
+            Entry entry;
+        };
+
+        void emplace(const Key& key, const Version& version, Entry entry);
+        void evict();
+
+        static std::optional<Entry> load(const Key& key, const Version& version);
+        static void store(const Key& key, const Version& version, const Entry& entry);
+
+        bool persistent;
+        std::mutex m;
+        size_t max_entries = 16;
+        std::list<Item> items; // most recently used first
+        std::map<Key, std::list<Item>::iterator> index;
+        Statistics stats;
+    };
+}
@@ -11,15 +11,25 @@
 #include "hoNDArray_fileio.h"
 #include "hoNDKLT.h"
 #include "hoNDArray_linalg.h"
+#include "mri_core_utility.h"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/split.hpp>
 
+#include <algorithm>
+
+#ifdef USE_OMP
+    #include "omp.h"
+#endif // USE_OMP
+
 namespace Gadgetron {
 
     PCACoilGadget::PCACoilGadget()
         : max_buffered_profiles_(100)
         , samples_to_use_(16)
+        , latency_total_ms_(0)
+        , latency_max_ms_(0)
+        , latency_profiles_(0)
     {
     }
 
@@ -34,6 +44,11 @@ namespace Gadgetron {
             }
             it++;
         }
+
+        for (auto& loc : incremental_) {
+            for (auto& p : loc.second.pending) p.header->release();
+            loc.second.pending.clear();
+        }
     }
 
     int PCACoilGadget::process_config(ACE_Message_Block *mb)
@@ -62,10 +77,6 @@ namespace Gadgetron {
         present_uncombined_channels.value((int)uncombined_channels_.size());
         GDEBUG("Number of uncombined channels (present_uncombined_channels) set to %d\n", uncombined_channels_.size());
 
-#ifdef USE_OMP
-        omp_set_num_threads(1);
-#endif // USE_OMP
-
         return GADGET_OK;
     }
 
@@ -79,6 +90,9 @@ namespace Gadgetron {
             return GADGET_OK;
         }
 
+        if (mode.value() == "incremental") {
+            return process_incremental(m1, m2);
+        }
 
         std::map<int, bool>::iterator it;
         int location = m1->getObjectPtr()->idx.slice;
@@ -239,7 +253,16 @@ namespace Gadgetron {
 
             if (pca_coefficients_[location] != 0)
             {
+                //A single profile is too small to be worth threading, so OpenMP (and with it BLAS) is kept to this
+                //thread for the transform only
+#ifdef USE_OMP
+                int num_threads = omp_get_max_threads();
+                if (!omp_in_parallel() && num_threads > 1) omp_set_num_threads(1);
+#endif // USE_OMP
                 pca_coefficients_[location]->transform(*(m2->getObjectPtr()), *(m3->getObjectPtr()), 1);
+#ifdef USE_OMP
+                if (!omp_in_parallel() && num_threads > 1) omp_set_num_threads(num_threads);
+#endif // USE_OMP
             }
 
             m1->cont(m3);
@@ -258,5 +281,209 @@ namespace Gadgetron {
         return GADGET_OK;
     }
 
+    int PCACoilGadget::process_incremental(GadgetContainerMessage<ISMRMRD::AcquisitionHeader> *m1, GadgetContainerMessage<hoNDArray<std::complex<float> > > *m2)
+    {
+        auto arrival = std::chrono::steady_clock::now();
+
+        int location = m1->getObjectPtr()->idx.slice;
+        IncrementalState& state = incremental_[location];
+
+        hoNDArray< std::complex<float> >& data = *m2->getObjectPtr();
+        size_t samples_per_profile = data.get_size(0);
+        size_t channels = data.get_size(1);
+
+        if (state.klt.number_of_channels() != channels) {
+            //Profiles already held back keep the channels they came with
+            if (flush_incremental(state) != GADGET_OK) return GADGET_FAIL;
+            if (state.next_basis.valid()) state.next_basis.wait();
+            state.next_basis = {};
+
+            std::vector<size_t> untransformed;
+            for (auto c : uncombined_channels_) {
+                if (c < channels) untransformed.push_back(c);
+            }
+
+            try { state.klt.reset(channels, untransformed); }
+            catch (std::runtime_error& err) {
+                GEXCEPTION(err, "Unable to set up the PCA coefficients\n");
+                m1->release();
+                return GADGET_FAIL;
+            }
+        }
+
+        //The same central samples as in buffered mode go into the covariance
+        size_t samples_to_use = std::min(samples_per_profile, (size_t)samples_to_use_);
+        size_t data_offset = 0;
+        if (m1->getObjectPtr()->center_sample >= (samples_to_use >> 1)) {
+            data_offset = m1->getObjectPtr()->center_sample - (samples_to_use >> 1);
+        }
+        data_offset = std::min(data_offset, samples_per_profile - samples_to_use);
+
+        try { state.klt.update(data, data_offset, samples_to_use); }
+        catch (std::runtime_error& err) {
+            GEXCEPTION(err, "Unable to update the PCA covariance\n");
+            m1->release();
+            return GADGET_FAIL;
+        }
+
+        state.pending.push_back(PendingProfile{ m1, arrival });
+
+        bool is_calibration = m1->getObjectPtr()->isFlagSet(ISMRMRD::ISMRMRD_ACQ_IS_PARALLEL_CALIBRATION)
+            || m1->getObjectPtr()->isFlagSet(ISMRMRD::ISMRMRD_ACQ_IS_PARALLEL_CALIBRATION_AND_IMAGING);
+        if (is_calibration && !state.calibration_compressed) {
+            state.calibration_compressed = true;
+            if (basis_update.value() != "never") {
+                GINFO_STREAM("PCACoilGadget: location " << location
+                    << " has calibration data, its coefficients will no longer change");
+            }
+        }
+
+        bool is_last_scan_in_repetition = m1->getObjectPtr()->isFlagSet(ISMRMRD::ISMRMRD_ACQ_LAST_IN_REPETITION);
+        bool end_of_batch = is_last_scan_in_repetition
+            || m1->getObjectPtr()->isFlagSet(ISMRMRD::ISMRMRD_ACQ_LAST_IN_SLICE)
+            || m1->getObjectPtr()->isFlagSet(ISMRMRD::ISMRMRD_ACQ_LAST_IN_MEASUREMENT);
+
+        //Profiles are held back until there are enough of them for a first basis
+        if (!state.klt.has_basis() && !end_of_batch && state.pending.size() < (size_t)warmup_profiles.value()) {
+            return GADGET_OK;
+        }
+
+        if (end_of_batch || state.pending.size() >= (size_t)batch_size.value()) {
+            if (flush_incremental(state) != GADGET_OK) return GADGET_FAIL;
+        }
+
+        //The basis only changes between repetitions, so that all data of a repetition, and the calibration data
+        //used to reconstruct it, are in the same virtual coils
+        if (is_last_scan_in_repetition) {
+            for (auto& loc : incremental_) {
+                if (flush_incremental(loc.second) != GADGET_OK) return GADGET_FAIL;
+            }
+            for (auto& loc : incremental_) {
+                update_basis(loc.first, loc.second);
+            }
+        }
+
+        return GADGET_OK;
+    }
+
+    int PCACoilGadget::flush_incremental(IncrementalState& state)
+    {
+        if (state.pending.empty()) return GADGET_OK;
+
+        std::vector<PendingProfile> batch;
+        batch.swap(state.pending);
+
+        std::vector< hoNDArray< std::complex<float> >* > data(batch.size());
+        for (size_t p = 0; p < batch.size(); p++) {
+            data[p] = AsContainerMessage< hoNDArray< std::complex<float> > >(batch[p].header->cont())->getObjectPtr();
+        }
+
+        try {
+            if (!state.klt.has_basis()) {
+                state.klt.prepare();
+                state.bases_computed++;
+            }
+
+            apply_channel_matrix(data, state.klt.basis(), false, transform_buf_);
+        }
+        catch (std::runtime_error& err) {
+            GEXCEPTION(err, "Unable to calculate PCA coils\n");
+            for (auto& p : batch) p.header->release();
+            return GADGET_FAIL;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        for (auto& p : batch) {
+            double latency = std::chrono::duration<double, std::milli>(now - p.arrival).count();
+            latency_total_ms_ += latency;
+            latency_max_ms_ = std::max(latency_max_ms_, latency);
+            latency_profiles_++;
+        }
+
+        for (size_t p = 0; p < batch.size(); p++) {
+            if (this->next()->putq(batch[p].header) < 0) {
+                GDEBUG("Unable to put message on Q");
+                for (size_t q = p + 1; q < batch.size(); q++) batch[q].header->release();
+                return GADGET_FAIL;
+            }
+        }
+
+        return GADGET_OK;
+    }
+
+    void PCACoilGadget::update_basis(int location, IncrementalState& state)
+    {
+        if (basis_update.value() == "never" || state.calibration_compressed) return;
+
+        try {
+            if (state.next_basis.valid()) {
+                if (state.next_basis.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                    auto basis = state.next_basis.get();
+                    auto drift = state.klt.drift();
+                    state.klt.set_basis(basis.first, basis.second);
+                    state.bases_computed++;
+                    GINFO_STREAM("PCACoilGadget: new coefficients for location " << location << " after a drift of "
+                        << drift << "; data from here on are in different virtual coils");
+                }
+            }
+            else if (state.klt.has_basis() && state.klt.drift() > drift_threshold.value()) {
+                hoNDArray< std::complex<float> > C;
+                state.klt.covariance(C);
+                std::vector<size_t> untransformed = state.klt.untransformed();
+
+                state.next_basis = std::async(std::launch::async, [C, untransformed]() {
+                    std::pair< hoNDArray< std::complex<float> >, hoNDArray<float> > basis;
+                    hoIncrementalKLT< std::complex<float> >::eigen_basis(C, untransformed, basis.first, basis.second);
+                    return basis;
+                });
+            }
+
+            if (forgetting_factor.value() < 1.0f) {
+                state.klt.forget(forgetting_factor.value());
+            }
+        }
+        catch (std::exception& err) {
+            GWARN_STREAM("PCACoilGadget: unable to update the PCA coefficients, keeping the current ones: " << err.what());
+        }
+    }
+
+    int PCACoilGadget::close(unsigned long flags)
+    {
+        int ret = GADGET_OK;
+
+        for (auto& loc : incremental_) {
+            if (flush_incremental(loc.second) != GADGET_OK) ret = GADGET_FAIL;
+        }
+
+        if (latency_profiles_ > 0) {
+            GINFO_STREAM("PCACoilGadget: " << latency_profiles_ << " profiles, added latency mean "
+                << latency_total_ms_ / latency_profiles_ << " ms, max " << latency_max_ms_ << " ms");
+        }
+
+        for (auto& loc : incremental_) {
+            const hoIncrementalKLT< std::complex<float> >& klt = loc.second.klt;
+            if (!klt.has_basis()) continue;
+
+            try {
+                size_t N = klt.number_of_channels();
+                size_t K95 = N, K99 = N;
+                for (size_t K = N; K > 0; K--) {
+                    float retained = klt.energy_retained(K);
+                    if (retained >= 0.95f) K95 = K;
+                    if (retained >= 0.99f) K99 = K;
+                }
+
+                GINFO_STREAM("PCACoilGadget: location " << loc.first << ", " << loc.second.bases_computed
+                    << " sets of coefficients computed, drift " << klt.drift() << ", 95% of the energy in "
+                    << K95 << " and 99% in " << K99 << " of " << N << " channels");
+            }
+            catch (std::runtime_error& err) {
+                GEXCEPTION(err, "Unable to report the energy retained\n");
+            }
+        }
+
+        return ret;
+    }
+
     GADGET_FACTORY_DECLARE(PCACoilGadget)
 }
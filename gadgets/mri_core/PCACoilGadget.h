@@ -5,10 +5,14 @@
 #include "Gadget.h"
 #include "hoNDArray.h"
 #include "hoNDKLT.h"
+#include "hoIncrementalKLT.h"
 #include "ismrmrd/ismrmrd.h"
 
+#include <chrono>
 #include <complex>
+#include <future>
 #include <map>
+#include <utility>
 
 namespace Gadgetron {
 
@@ -26,8 +30,47 @@ namespace Gadgetron {
     virtual int process_config(ACE_Message_Block* mb);
     virtual int process(GadgetContainerMessage<ISMRMRD::AcquisitionHeader>* m1,
 			GadgetContainerMessage< hoNDArray< std::complex<float> > >* m2);
+    virtual int close(unsigned long flags);
+
+    struct PendingProfile
+    {
+      GadgetContainerMessage<ISMRMRD::AcquisitionHeader>* header;
+      std::chrono::steady_clock::time_point arrival;
+    };
+
+    //Incremental mode: the covariance is accumulated from every profile. If enabled, the basis is re-estimated in
+    //the background once the current one has drifted from it, and swapped in between repetitions
+    struct IncrementalState
+    {
+      hoIncrementalKLT< std::complex<float> > klt;
+      std::vector<PendingProfile> pending;
+      std::future< std::pair< hoNDArray< std::complex<float> >, hoNDArray<float> > > next_basis;
+      size_t bases_computed = 0;
+      //Once calibration data have been compressed, all data must stay in the same virtual coils as them
+      bool calibration_compressed = false;
+    };
+
+    int process_incremental(GadgetContainerMessage<ISMRMRD::AcquisitionHeader>* m1,
+			    GadgetContainerMessage< hoNDArray< std::complex<float> > >* m2);
+
+    //Transforms all pending profiles of a location with its current basis and passes them on
+    int flush_incremental(IncrementalState& state);
+
+    //At the end of a repetition: swaps in a basis computed in the background, or starts computing one if the
+    //current basis has drifted
+    void update_basis(int location, IncrementalState& state);
 
   private:
+    GADGET_PROPERTY_LIMITS(mode, std::string, "buffered computes the coefficients once per location from the first profiles; incremental keeps updating them from every profile", "buffered",
+                           GadgetPropertyLimitsEnumeration, "buffered", "incremental");
+    GADGET_PROPERTY(warmup_profiles, int, "Incremental mode: profiles held back for each location before the first coefficients are computed", 16);
+    GADGET_PROPERTY_LIMITS(batch_size, int, "Incremental mode: number of profiles transformed together", 1,
+                           GadgetPropertyLimitsRange, 1, 1024);
+    GADGET_PROPERTY_LIMITS(basis_update, std::string, "Incremental mode: never keeps the first coefficients of each location; repetition recomputes them between repetitions once they have drifted, until calibration data have been compressed", "never",
+                           GadgetPropertyLimitsEnumeration, "never", "repetition");
+    GADGET_PROPERTY(drift_threshold, float, "Incremental mode: drift of the coefficients from the current covariance above which new ones are computed, checked at the end of each repetition", 0.05f);
+    GADGET_PROPERTY(forgetting_factor, float, "Incremental mode: weight kept by the accumulated covariance at the end of each repetition; 1 weights all profiles equally", 1.0f);
+
     GADGET_PROPERTY(uncombined_channels_by_name, std::string, "List of comma separated channels by name", "");
     GADGET_PROPERTY(present_uncombined_channels, int, "Number of uncombined channels found", 0);
 
@@ -44,6 +87,14 @@ namespace Gadgetron {
 
     int max_buffered_profiles_;
     int samples_to_use_;
+
+    std::map<int, IncrementalState> incremental_;
+    hoNDArray< std::complex<float> > transform_buf_;
+
+    //Time profiles spend in the gadget in incremental mode
+    double latency_total_ms_;
+    double latency_max_ms_;
+    size_t latency_profiles_;
   };
 }
 
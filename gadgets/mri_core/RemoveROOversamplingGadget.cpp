@@ -1,14 +1,17 @@
 #include "RemoveROOversamplingGadget.h"
-#include "hoNDFFT.h"
+#include "mri_core_readout_oversampling.h"
 #include "ismrmrd/xml.h"
 
+#include <cmath>
+#include <cstring>
+
 #ifdef USE_OMP
     #include "omp.h"
 #endif // USE_OMP
 
 namespace Gadgetron{
 
-    RemoveROOversamplingGadget::RemoveROOversamplingGadget()
+    RemoveROOversamplingGadget::RemoveROOversamplingGadget() : fir_filter_RO_(0)
     {
     }
 
@@ -37,12 +40,22 @@ namespace Gadgetron{
         reconNx_   = r_space.matrixSize.x;
         reconFOV_  = r_space.fieldOfView_mm.x;
 
-        // limit the number of threads used to be 1
+        // limit the number of threads used to be 1, as a single readout is too small to share out;
+        // batches of readouts are transformed with all threads
 #ifdef USE_OMP
-        omp_set_num_threads(1);
-        GDEBUG_STREAM("RemoveROOversamplingGadget:omp_set_num_threads(1) ... ");
+        if (batch_size.value() == 1)
+        {
+            omp_set_num_threads(1);
+            GDEBUG_STREAM("RemoveROOversamplingGadget:omp_set_num_threads(1) ... ");
+        }
 #endif // USE_OMP
 
+        if (method.value() == "fir" && std::abs(encodeFOV_ / reconFOV_ - 2.0f) > 1e-3f)
+        {
+            GWARN_STREAM("RemoveROOversamplingGadget: the fir method needs 2x oversampling, the readout ratio is "
+                << encodeFOV_ / reconFOV_ << "; using the fft method");
+        }
+
     // If the encoding and recon matrix size and FOV are the same
     // then the data is not oversampled and we can safely pass
     // the data onto the next gadget
@@ -57,87 +70,167 @@ namespace Gadgetron{
         return GADGET_OK;
     }
 
+    int RemoveROOversamplingGadget::process(ACE_Message_Block* mb)
+    {
+      GadgetContainerMessage<ISMRMRD::AcquisitionHeader>* m1 = AsContainerMessage<ISMRMRD::AcquisitionHeader>(mb);
+      GadgetContainerMessage< hoNDArray< std::complex<float> > >* m2 = nullptr;
+      if (m1) m2 = AsContainerMessage< hoNDArray< std::complex<float> > >(m1->cont());
+
+      if (m1 && m2) return this->process(m1, m2);
+
+      if (flush() != GADGET_OK) return GADGET_FAIL;
+      return this->next()->putq(mb);
+    }
+
     int RemoveROOversamplingGadget
         ::process(GadgetContainerMessage<ISMRMRD::AcquisitionHeader>* m1,
         GadgetContainerMessage< hoNDArray< std::complex<float> > >* m2)
     {
 
       // If we have work to do, do it, otherwise do nothing
-      if (dowork_) {
-
-        GadgetContainerMessage< hoNDArray< std::complex<float> > >* m3 
-            = new GadgetContainerMessage< hoNDArray< std::complex<float> > >();
-
-        if (!m3)
+      if (!dowork_) {
+        if (this->next()->putq(m1) == -1)
         {
-            return GADGET_FAIL;
+          GERROR("RemoveROOversamplingGadget::process, passing data on to next gadget");
+          return GADGET_FAIL;
         }
+        return GADGET_OK;
+      }
 
-        std::vector<size_t> data_out_dims = *m2->getObjectPtr()->get_dimensions();
-        if ( !ifft_buf_.dimensions_equal(&data_out_dims) )
-        {
-            ifft_buf_.create(data_out_dims);
-            ifft_res_.create(data_out_dims);
-        }
+      // readouts are batched while they have the same size, and a batch is not held past the end of a slice
+      if (!pending_.empty() && !pending_[0].data->getObjectPtr()->dimensions_equal(m2->getObjectPtr()))
+      {
+        if (flush() != GADGET_OK) return GADGET_FAIL;
+      }
 
-        float ratioFOV = encodeFOV_/reconFOV_;
+      pending_.push_back(PendingReadout{ m1, m2 });
 
-        data_out_dims[0] = (size_t)(data_out_dims[0]/ratioFOV);
-        if ( !fft_buf_.dimensions_equal(&data_out_dims) )
-        {
-            fft_buf_.create(data_out_dims);
-            fft_res_.create(data_out_dims);
-        }
+      bool last_in_slice = m1->getObjectPtr()->isFlagSet(ISMRMRD::ISMRMRD_ACQ_LAST_IN_SLICE)
+          || m1->getObjectPtr()->isFlagSet(ISMRMRD::ISMRMRD_ACQ_LAST_IN_REPETITION)
+          || m1->getObjectPtr()->isFlagSet(ISMRMRD::ISMRMRD_ACQ_LAST_IN_MEASUREMENT);
 
-        try{ m3->getObjectPtr()->create(data_out_dims);}
-        catch (std::runtime_error &err)
-        {
-            GEXCEPTION(err,"Unable to create new data array for downsampled data\n");
-            return GADGET_FAIL;
-        }
+      if (last_in_slice || pending_.size() >= (size_t)batch_size.value())
+      {
+        return flush();
+      }
 
-        size_t sRO = m2->getObjectPtr()->get_size(0);
-        size_t start = (size_t)( (m2->getObjectPtr()->get_size(0)-data_out_dims[0])/ratioFOV );
+      return GADGET_OK;
+    }
 
-        size_t dRO = m3->getObjectPtr()->get_size(0);
-        size_t numOfBytes = data_out_dims[0]*sizeof(std::complex<float>);
+    int RemoveROOversamplingGadget::close(unsigned long flags)
+    {
+      return flush();
+    }
+
+    int RemoveROOversamplingGadget::flush()
+    {
+      if (pending_.empty()) return GADGET_OK;
 
-        int c;
+      std::vector<PendingReadout> batch;
+      batch.swap(pending_);
 
-        int CHA = (int)(data_out_dims[1]);
+      const hoNDArray< std::complex<float> >& first = *batch[0].data->getObjectPtr();
+      size_t N = batch.size();
+      size_t elements = first.get_number_of_elements();
 
-        std::complex<float>* data_in, *data_out;
+      float ratioFOV = encodeFOV_/reconFOV_;
 
-        hoNDFFT<float>::instance()->ifft1c(*m2->getObjectPtr(), ifft_res_, ifft_buf_);
-        data_in  = ifft_res_.get_data_ptr();
-        data_out = m3->getObjectPtr()->get_data_ptr();
+      std::vector<size_t> data_out_dims = first.dimensions();
+      data_out_dims[0] = (size_t)(data_out_dims[0]/ratioFOV);
+      size_t out_elements = elements / first.get_size(0) * data_out_dims[0];
 
-        for ( c=0; c<CHA; c++)
+      std::vector< GadgetContainerMessage< hoNDArray< std::complex<float> > >* > outputs(N);
+
+      try
+      {
+        for (size_t n = 0; n < N; n++)
+        {
+          outputs[n] = new GadgetContainerMessage< hoNDArray< std::complex<float> > >();
+          outputs[n]->getObjectPtr()->create(data_out_dims);
+        }
+
+        if (N == 1)
         {
-            memcpy( data_out+c*dRO, data_in+c*sRO+start, numOfBytes );
+          remove_oversampling(first, *outputs[0]->getObjectPtr());
         }
+        else
+        {
+          // one [RO CHA N] array, so that all readouts go through a single multi-line transform
+          std::vector<size_t> batch_dims = { first.get_size(0), elements / first.get_size(0), N };
+          if (!batch_in_.dimensions_equal(&batch_dims)) batch_in_.create(batch_dims);
+
+          for (size_t n = 0; n < N; n++)
+          {
+            memcpy(batch_in_.begin() + n*elements, batch[n].data->getObjectPtr()->begin(), sizeof(std::complex<float>)*elements);
+          }
+
+          remove_oversampling(batch_in_, batch_out_);
 
-        hoNDFFT<float>::instance()->fft1c(*m3->getObjectPtr(), fft_res_, fft_buf_);
+          for (size_t n = 0; n < N; n++)
+          {
+            memcpy(outputs[n]->getObjectPtr()->begin(), batch_out_.begin() + n*out_elements, sizeof(std::complex<float>)*out_elements);
+          }
+        }
+      }
+      catch (std::runtime_error &err)
+      {
+        GEXCEPTION(err,"Unable to remove the readout oversampling\n");
+        for (size_t n = 0; n < N; n++)
+        {
+          if (outputs[n]) outputs[n]->release();
+          batch[n].header->release();
+        }
+        return GADGET_FAIL;
+      }
 
-        memcpy(m3->getObjectPtr()->begin(), fft_res_.begin(), fft_res_.get_number_of_bytes());
+      for (size_t n = 0; n < N; n++)
+      {
+        GadgetContainerMessage<ISMRMRD::AcquisitionHeader>* m1 = batch[n].header;
 
-        m2->release(); //We are done with this data
+        batch[n].data->release(); //We are done with this data
+        m1->cont(outputs[n]);
 
-        m1->cont(m3);
         m1->getObjectPtr()->number_of_samples = data_out_dims[0];
         m1->getObjectPtr()->center_sample = (uint16_t)(m1->getObjectPtr()->center_sample/ratioFOV);
         m1->getObjectPtr()->discard_pre = (uint16_t)(m1->getObjectPtr()->discard_pre / ratioFOV);
         m1->getObjectPtr()->discard_post = (uint16_t)(m1->getObjectPtr()->discard_post / ratioFOV);
 
-      } // end if (dowork_)
+        if (this->next()->putq(m1) == -1)
+        {
+          GERROR("RemoveROOversamplingGadget::process, passing data on to next gadget");
+          for (size_t k = n + 1; k < N; k++)
+          {
+            outputs[k]->release();
+            batch[k].header->release();
+          }
+          return GADGET_FAIL;
+        }
+      }
+
+      return GADGET_OK;
+    }
 
-      if (this->next()->putq(m1) == -1)
+    void RemoveROOversamplingGadget::remove_oversampling(const hoNDArray< std::complex<float> >& data, hoNDArray< std::complex<float> >& res)
+    {
+      float ratioFOV = encodeFOV_/reconFOV_;
+
+      size_t sRO = data.get_size(0);
+      size_t dRO = (size_t)(sRO/ratioFOV);
+      size_t start = (size_t)( (sRO-dRO)/ratioFOV );
+
+      if (method.value() == "fir" && sRO % 4 == 0 && dRO == sRO / 2 && start == sRO / 4)
       {
-        GERROR("RemoveROOversamplingGadget::process, passing data on to next gadget");
-        return GADGET_FAIL;
+        if (fir_filter_RO_ != sRO || fir_filter_.get_number_of_elements() != (size_t)fir_taps.value() + 1)
+        {
+          generate_readout_decimation_filter(sRO, (size_t)fir_taps.value(), fir_filter_);
+          fir_filter_RO_ = sRO;
+        }
+
+        decimate_readout(data, fir_filter_, res);
+        return;
       }
 
-      return GADGET_OK;
+      remove_readout_oversampling(data, start, dRO, res, readout_image_);
     }
 
 
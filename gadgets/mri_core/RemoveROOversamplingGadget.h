@@ -6,11 +6,11 @@
 
 #include <ismrmrd/ismrmrd.h>
 #include <complex>
+#include <vector>
 
 namespace Gadgetron{
 
-    class EXPORTGADGETSMRICORE RemoveROOversamplingGadget :
-        public Gadget2<ISMRMRD::AcquisitionHeader,hoNDArray< std::complex<float> > >
+    class EXPORTGADGETSMRICORE RemoveROOversamplingGadget : public BasicPropertyGadget
     {
     public:
         GADGET_DECLARE(RemoveROOversamplingGadget);
@@ -19,17 +19,43 @@ namespace Gadgetron{
         virtual ~RemoveROOversamplingGadget();
 
     protected:
+        GADGET_PROPERTY_LIMITS(batch_size, int, "Number of readouts transformed together; 1 processes every readout as it arrives", 1,
+                               GadgetPropertyLimitsRange, 1, 1024);
+        GADGET_PROPERTY_LIMITS(method, std::string, "fft crops the readout image; fir uses a half-band filter, for 2x oversampling only", "fft",
+                               GadgetPropertyLimitsEnumeration, "fft", "fir");
+        GADGET_PROPERTY_LIMITS(fir_taps, int, "Half-band filter taps on either side of the centre, for the fir method", 16,
+                               GadgetPropertyLimitsRange, 1, 64);
 
         virtual int process_config(ACE_Message_Block* mb);
 
+        // readouts go to the other process; anything else flushes the pending readouts first, so that it stays
+        // behind them
+        virtual int process(ACE_Message_Block* mb);
+
         virtual int process(GadgetContainerMessage<ISMRMRD::AcquisitionHeader>* m1,
             GadgetContainerMessage< hoNDArray< std::complex<float> > >* m2);
 
-        hoNDArray< std::complex<float> > fft_res_;
-        hoNDArray< std::complex<float> > ifft_res_;
+        virtual int close(unsigned long flags);
+
+        // removes the oversampling from all pending readouts and passes them on
+        int flush();
+
+        // data: [RO CHA N], res: [RO/ratioFOV CHA N]
+        void remove_oversampling(const hoNDArray< std::complex<float> >& data, hoNDArray< std::complex<float> >& res);
+
+        struct PendingReadout
+        {
+            GadgetContainerMessage<ISMRMRD::AcquisitionHeader>* header;
+            GadgetContainerMessage< hoNDArray< std::complex<float> > >* data;
+        };
+
+        std::vector<PendingReadout> pending_;
 
-        hoNDArray< std::complex<float> > fft_buf_;
-        hoNDArray< std::complex<float> > ifft_buf_;
+        hoNDArray< std::complex<float> > batch_in_;
+        hoNDArray< std::complex<float> > batch_out_;
+        hoNDArray< std::complex<float> > readout_image_;
+        hoNDArray< std::complex<float> > fir_filter_;
+        size_t fir_filter_RO_;
 
         int   encodeNx_;
         float encodeFOV_;
@@ -103,13 +103,11 @@ namespace Gadgetron {
             if (comp.size() != data.get_number_of_elements() * 2) { //*2 for complex
                 std::stringstream error;
                 error << "Mismatch between uncompressed data samples " << comp.size();
-                error << " and expected number of samples" << data.get_number_of_elements() * 2;
+                error << " and expected number of samples " << data.get_number_of_elements() * 2;
+                throw std::runtime_error(error.str());
             }
 
-            float *d_ptr = (float *) data.get_data_ptr();
-            for (size_t i = 0; i < comp.size(); i++) {
-                d_ptr[i] = comp[i]; //This uncompresses sample by sample into the uncompressed array
-            }
+            comp.decompress(reinterpret_cast<float *>(data.get_data_ptr()));
 
             //At this point the data is no longer compressed and we should clear the flag
             header.clearFlag(ISMRMRD::ISMRMRD_ACQ_COMPRESSION2);
@@ -0,0 +1,70 @@
+#include "mri_core_coil_map_estimation.h"
+#include "complext.h"
+
+#include <gtest/gtest.h>
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace Gadgetron;
+using testing::Types;
+
+template <typename T> class coil_map_estimation_Test : public ::testing::Test {
+protected:
+  typedef typename realType<T>::Type REAL;
+
+  // A smooth object seen through smooth, complex coil sensitivities, plus noise; dims is [RO E1 (E2) CHA]
+  hoNDArray<T> coil_images(const std::vector<size_t>& dims) {
+    hoNDArray<T> data(dims);
+    size_t CHA = dims.back();
+    size_t N = data.get_number_of_elements() / CHA;
+    size_t RO = dims[0], E1 = dims[1];
+
+    std::mt19937 rng(17);
+    std::normal_distribution<REAL> noise(0, REAL(0.05));
+    for (size_t cha = 0; cha < CHA; cha++) {
+      for (size_t n = 0; n < N; n++) {
+        double x = double(n % RO) / RO, y = double((n / RO) % E1) / E1, z = double(n / (RO * E1)) / (N / (RO * E1));
+        double object = 1 + 0.5 * std::cos(6 * x) * std::sin(4 * y + z);
+        double weight = std::exp(-2 * ((x - double(cha) / CHA) * (x - double(cha) / CHA) + (y - 0.5) * (y - 0.5)));
+        double phase = 2 * x + 3 * y * cha / CHA + z + cha;
+        data[n + cha * N] = T(REAL(object * weight * std::cos(phase)) + noise(rng),
+                              REAL(object * weight * std::sin(phase)) + noise(rng));
+      }
+    }
+    return data;
+  }
+
+  void expect_near(const hoNDArray<T>& expected, const hoNDArray<T>& actual) {
+    const REAL tolerance = sizeof(REAL) == sizeof(float) ? REAL(1e-3) : REAL(1e-9);
+    ASSERT_EQ(expected.get_number_of_elements(), actual.get_number_of_elements());
+    for (size_t n = 0; n < expected.get_number_of_elements(); n++) {
+      ASSERT_NEAR(real(expected[n]), real(actual[n]), tolerance) << "at " << n;
+      ASSERT_NEAR(imag(expected[n]), imag(actual[n]), tolerance) << "at " << n;
+    }
+  }
+};
+
+typedef Types<std::complex<float>, std::complex<double>, float_complext, double_complext> cplxTypes;
+
+TYPED_TEST_SUITE(coil_map_estimation_Test, cplxTypes);
+
+TYPED_TEST(coil_map_estimation_Test,inati2DMatchesDirect){
+  auto data = this->coil_images({61, 47, 8});
+
+  for (size_t ks : {5, 7}) {
+    hoNDArray<TypeParam> expected, actual;
+    coil_map_2d_Inati_direct(data, expected, ks, 3);
+    coil_map_2d_Inati(data, actual, ks, 3);
+    this->expect_near(expected, actual);
+  }
+}
+
+TYPED_TEST(coil_map_estimation_Test,inati3DMatchesDirect){
+  auto data = this->coil_images({29, 23, 11, 6});
+
+  hoNDArray<TypeParam> expected, actual;
+  coil_map_3d_Inati_direct(data, expected, 5, 3, 3);
+  coil_map_3d_Inati(data, actual, 5, 3, 3);
+  this->expect_near(expected, actual);
+}
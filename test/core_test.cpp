@@ -227,3 +227,89 @@ TEST(TypeTests, tupletype3) {
 }
 
 
+
+TEST(MessageTests, clonesSharePayload) {
+    using namespace Gadgetron::Core;
+    using namespace Gadgetron;
+
+    hoNDArray<float> array(64, 64);
+    array.fill(2.0f);
+    auto storage = array.data();
+
+    Message message(std::move(array), std::string("header"));
+    auto clone = message.clone();
+
+    // Unpacking while the payload is shared copies it, leaving the clone as its only owner.
+    auto first = force_unpack<hoNDArray<float>, std::string>(std::move(message));
+    EXPECT_NE(std::get<0>(first).data(), storage);
+    EXPECT_EQ(std::get<0>(first)[100], 2.0f);
+
+    auto second = force_unpack<hoNDArray<float>, std::string>(std::move(clone));
+    EXPECT_EQ(std::get<0>(second).data(), storage);
+    EXPECT_EQ(std::get<1>(second), "header");
+}
+
+TEST(MessageTests, copyOnWrite) {
+    using namespace Gadgetron::Core;
+    using namespace Gadgetron;
+
+    TypedMessageChunk<hoNDArray<float>> chunk(hoNDArray<float>(16));
+    chunk.mutable_data().fill(1.0f);
+
+    auto clone = chunk.clone();
+    auto& shared = static_cast<TypedMessageChunk<hoNDArray<float>>&>(*clone);
+    EXPECT_TRUE(chunk.shared());
+    EXPECT_EQ(chunk.data().data(), shared.data().data());
+
+    shared.mutable_data().fill(3.0f);
+    EXPECT_FALSE(chunk.shared());
+    EXPECT_EQ(chunk.data()[0], 1.0f);
+    EXPECT_EQ(shared.data()[0], 3.0f);
+}
+
+TEST(MessageTests, unpackView) {
+    using namespace Gadgetron::Core;
+    using namespace Gadgetron;
+
+    hoNDArray<float> array(32);
+    array.fill(5.0f);
+    auto storage = array.data();
+    Message message(std::move(array), optional<hoNDArray<float>>(), 7);
+
+    auto [view, missing, number] = unpack_view<hoNDArray<float>, optional<hoNDArray<float>>, int>(message);
+    EXPECT_EQ(view.data(), storage);
+    EXPECT_FALSE(missing);
+    EXPECT_EQ(number, 7);
+
+    // The message is left intact.
+    auto owned = force_unpack<hoNDArray<float>, int>(std::move(message));
+    EXPECT_EQ(std::get<0>(owned).data(), storage);
+    EXPECT_EQ(std::get<1>(owned), 7);
+}
+
+TEST(MessageTests, unpackForReading) {
+    using namespace Gadgetron::Core;
+    using namespace Gadgetron;
+
+    hoNDArray<float> array(32);
+    array.fill(5.0f);
+    auto storage = array.data();
+    Message message(std::move(array), std::string("header"));
+    auto clone = message.clone();
+
+    // Shared arrays are viewed, while parts only this message holds are moved out.
+    auto [view, header] = unpack_for_reading<hoNDArray<float>, std::string>(message);
+    EXPECT_EQ(view.data(), storage);
+    EXPECT_EQ(header, "header");
+
+    // The clone was left sharing the array with the message, so it is not moved out of the clone either.
+    EXPECT_EQ(unpack_view<hoNDArray<float>>(clone).data(), storage);
+
+    hoNDArray<float> other(16);
+    auto other_storage = other.data();
+    Message single(std::move(other));
+    auto owned = unpack_for_reading<hoNDArray<float>>(single);
+    EXPECT_EQ(owned.data(), other_storage);
+    auto& chunk = static_cast<TypedMessageChunk<hoNDArray<float>>&>(*single.messages()[0]);
+    EXPECT_EQ(chunk.data().data(), nullptr);
+}
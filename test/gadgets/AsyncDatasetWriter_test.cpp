@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "../../gadgets/mri_core/AsyncDatasetWriter.h"
+
+#include <future>
+#include <stdexcept>
+
+using namespace Gadgetron;
+using namespace std::chrono_literals;
+
+namespace {
+
+    template <class T> bool blocked(std::future<T>& future) {
+        return future.wait_for(50ms) == std::future_status::timeout;
+    }
+
+    /// What a FakeDestination saw; shared with the test, as the writer owns the destination.
+    struct Log {
+        std::mutex m;
+        std::vector<uint32_t> scan_counters;
+        bool closed = false;
+
+        // The first append signals entered, then waits for release, then throws if fail is set.
+        std::promise<void> entered;
+        std::shared_future<void> release;
+        bool fail = false;
+    };
+
+    class FakeDestination : public AsyncDatasetWriter::Destination {
+    public:
+        explicit FakeDestination(std::shared_ptr<Log> log) : log(std::move(log)) {}
+
+        ~FakeDestination() override {
+            std::lock_guard<std::mutex> guard(log->m);
+            log->closed = true;
+        }
+
+        void append(const ISMRMRD::Acquisition& acquisition) override {
+            if (first) {
+                first = false;
+                log->entered.set_value();
+                if (log->release.valid()) log->release.wait();
+                if (log->fail) throw std::runtime_error("disk full");
+            }
+            std::lock_guard<std::mutex> guard(log->m);
+            log->scan_counters.push_back(acquisition.getHead().scan_counter);
+        }
+
+        void append(const ISMRMRD::Waveform&) override {}
+
+    private:
+        std::shared_ptr<Log> log;
+        bool first = true;
+    };
+
+    std::unique_ptr<ISMRMRD::Acquisition> acquisition(AsyncDatasetWriter& writer, uint32_t scan_counter) {
+        auto acquisition = writer.acquisition();
+        ISMRMRD::AcquisitionHeader head{};
+        head.number_of_samples = 4;
+        head.active_channels = 2;
+        head.available_channels = 2;
+        head.scan_counter = scan_counter;
+        acquisition->setHead(head);
+        return acquisition;
+    }
+
+    AsyncDatasetWriter::Settings settings(size_t queue_size, size_t batch_size) {
+        AsyncDatasetWriter::Settings settings;
+        settings.queue_size = queue_size;
+        settings.batch_size = batch_size;
+        return settings;
+    }
+}
+
+TEST(AsyncDatasetWriterTest, writesEverythingInOrderBeforeClosing) {
+    auto log = std::make_shared<Log>();
+    AsyncDatasetWriter writer(std::make_unique<FakeDestination>(log), settings(8, 4));
+
+    for (uint32_t i = 0; i < 103; i++) writer.append(acquisition(writer, i));
+    writer.close();
+
+    EXPECT_TRUE(log->closed);
+    ASSERT_EQ(log->scan_counters.size(), 103u);
+    for (uint32_t i = 0; i < 103; i++) EXPECT_EQ(log->scan_counters[i], i);
+
+    auto stats = writer.statistics();
+    EXPECT_EQ(stats.acquisitions, 103u);
+    EXPECT_LE(stats.largest_batch, 8u);
+}
+
+TEST(AsyncDatasetWriterTest, appendBlocksWhileTheQueueIsFull) {
+    auto log = std::make_shared<Log>();
+    std::promise<void> release;
+    log->release = release.get_future().share();
+    auto entered = log->entered.get_future();
+
+    AsyncDatasetWriter writer(std::make_unique<FakeDestination>(log), settings(2, 1));
+    writer.append(acquisition(writer, 0));
+    entered.wait();
+
+    // The writer is stuck on the first item; two more fill the queue, and the next has to wait for room
+    writer.append(acquisition(writer, 1));
+    writer.append(acquisition(writer, 2));
+    auto third = std::async(std::launch::async, [&]() { writer.append(acquisition(writer, 3)); });
+    EXPECT_TRUE(blocked(third));
+
+    release.set_value();
+    third.get();
+    writer.close();
+
+    EXPECT_EQ(log->scan_counters, (std::vector<uint32_t>{ 0, 1, 2, 3 }));
+    EXPECT_GT(writer.statistics().blocked.count(), 0);
+}
+
+TEST(AsyncDatasetWriterTest, writeErrorsReachTheAppendingThread) {
+    auto log = std::make_shared<Log>();
+    std::promise<void> release;
+    log->release = release.get_future().share();
+    log->fail = true;
+    auto entered = log->entered.get_future();
+
+    AsyncDatasetWriter writer(std::make_unique<FakeDestination>(log), settings(1, 1));
+    writer.append(acquisition(writer, 0));
+    entered.wait();
+
+    writer.append(acquisition(writer, 1));
+    auto blocked_append = std::async(std::launch::async, [&]() { writer.append(acquisition(writer, 2)); });
+    EXPECT_TRUE(blocked(blocked_append));
+
+    release.set_value();
+    EXPECT_THROW(blocked_append.get(), std::runtime_error);
+    EXPECT_THROW(writer.close(), std::runtime_error);
+    EXPECT_TRUE(log->closed);
+}
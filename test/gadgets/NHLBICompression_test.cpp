@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "../../gadgets/mri_core/NHLBICompression.h"
+
+#include <limits>
+#include <random>
+
+namespace {
+
+    std::vector<float> random_samples(size_t count, float amplitude) {
+        std::mt19937 engine(count);
+        std::normal_distribution<float> distribution(0, amplitude);
+        std::vector<float> samples(count);
+        for (auto& sample : samples)
+            sample = distribution(engine);
+        return samples;
+    }
+
+    // One bit at a time, straight from the description of the format.
+    std::vector<uint8_t> reference_stream(const std::vector<float>& samples, float scale, unsigned int bits) {
+        std::vector<uint8_t> stream(static_cast<size_t>(std::ceil((bits * samples.size()) / 8.0f)), 0);
+        for (size_t i = 0; i < samples.size(); i++) {
+            auto value = static_cast<uint64_t>(static_cast<int64_t>(std::round(samples[i] * scale)));
+            for (unsigned int b = 0; b < bits; b++) {
+                size_t bit = i * bits + b;
+                if (value & (uint64_t(1) << b))
+                    stream[bit / 8] |= uint8_t(1) << (bit % 8);
+            }
+        }
+        return stream;
+    }
+
+    float scale_of(std::vector<uint8_t>& serialized) {
+        CompressionHeader header;
+        memcpy(&header, serialized.data(), sizeof(header));
+        return header.scale_;
+    }
+}
+
+class NHLBICompressionTest : public ::testing::TestWithParam<unsigned int> {};
+
+TEST_P(NHLBICompressionTest, matchesReferenceStream) {
+    auto bits    = GetParam();
+    auto samples = random_samples(1003, 100.0f);
+
+    CompressedBuffer<float> compressed(samples, -1.0f, bits);
+    auto serialized = compressed.serialize();
+    auto reference  = reference_stream(samples, scale_of(serialized), bits);
+
+    ASSERT_EQ(serialized.size(), reference.size() + sizeof(CompressionHeader));
+    EXPECT_TRUE(std::equal(reference.begin(), reference.end(), serialized.begin() + sizeof(CompressionHeader)));
+}
+
+TEST_P(NHLBICompressionTest, roundTrip) {
+    auto bits    = GetParam();
+    auto samples = random_samples(4099, 10.0f);
+
+    CompressedBuffer<float> compressed(samples, -1.0f, bits);
+    auto serialized = compressed.serialize();
+    auto scale      = std::abs(scale_of(serialized));
+
+    CompressedBuffer<float> received;
+    received.deserialize(serialized);
+    ASSERT_EQ(received.size(), samples.size());
+
+    std::vector<float> decompressed(samples.size());
+    received.decompress(decompressed.data());
+
+    for (size_t i = 0; i < samples.size(); i++) {
+        ASSERT_EQ(decompressed[i], received[i]) << "sample " << i;
+        // At high bit widths the quantization step is below single precision resolution.
+        auto error = 0.5f / scale * 1.001f + 4 * std::numeric_limits<float>::epsilon() * std::abs(samples[i]);
+        ASSERT_NEAR(decompressed[i], samples[i], error) << "sample " << i;
+    }
+}
+
+TEST_P(NHLBICompressionTest, portableMatchesAVX2) {
+    if (!NHLBI::avx2_supported())
+        GTEST_SKIP() << "AVX2 not supported";
+#if defined(NHLBI_AVX2_TARGET)
+    auto bits    = GetParam();
+    auto samples = random_samples(2053, 1000.0f);
+
+    // Include exact halfway cases, which must round away from zero.
+    for (size_t i = 0; i < 64; i++)
+        samples[i] = (float(i) - 32.0f) + 0.5f;
+    float scale = 1.0f;
+    if (bits < 8)
+        scale = 0.5f / 1000.0f * (1 << (bits - 1));
+
+    std::vector<uint8_t> portable(bits * samples.size() / 8 + NHLBI::padding + 1, 0);
+    std::vector<uint8_t> avx2(portable.size(), 0);
+    NHLBI::pack_portable(samples.data(), samples.size(), scale, bits, portable.data());
+    NHLBI::pack_avx2(samples.data(), samples.size(), scale, bits, avx2.data());
+    ASSERT_EQ(portable, avx2);
+
+    std::vector<float> unpacked_portable(samples.size());
+    std::vector<float> unpacked_avx2(samples.size());
+    NHLBI::unpack_portable(portable.data(), samples.size(), scale, bits, unpacked_portable.data());
+    NHLBI::unpack_avx2(portable.data(), samples.size(), scale, bits, unpacked_avx2.data());
+    ASSERT_EQ(unpacked_portable, unpacked_avx2);
+#endif
+}
+
+INSTANTIATE_TEST_SUITE_P(BitWidths, NHLBICompressionTest, ::testing::Range(4u, 33u));
+
+TEST(NHLBICompression, tolerance) {
+    auto samples   = random_samples(1000, 50.0f);
+    float tolerance = 0.01f;
+
+    CompressedBuffer<float> compressed(samples, tolerance);
+    std::vector<float> decompressed(samples.size());
+    compressed.decompress(decompressed.data());
+
+    for (size_t i = 0; i < samples.size(); i++)
+        ASSERT_NEAR(decompressed[i], samples[i], tolerance * 1.001f);
+}
+
+TEST(NHLBICompression, rejectsInvalidBuffers) {
+    auto samples    = random_samples(100, 1.0f);
+    auto serialized = CompressedBuffer<float>(samples, -1.0f, 16).serialize();
+
+    CompressedBuffer<float> received;
+    auto truncated = serialized;
+    truncated.pop_back();
+    EXPECT_THROW(received.deserialize(truncated), std::runtime_error);
+
+    auto too_wide = serialized;
+    too_wide[sizeof(CompressionHeader) - 1] = 40;
+    EXPECT_THROW(received.deserialize(too_wide), std::runtime_error);
+
+    EXPECT_THROW(CompressedBuffer<float>(samples, -1.0f, 33), std::runtime_error);
+}
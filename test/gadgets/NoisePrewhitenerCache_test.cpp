@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include "../../gadgets/mri_core/NoisePrewhitenerCache.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#if !(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace Gadgetron;
+
+namespace {
+
+    class NoisePrewhitenerCacheTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            folder = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+            boost::filesystem::create_directories(folder);
+            cache.set_capacity(16);
+        }
+
+        void TearDown() override {
+            boost::filesystem::remove_all(folder);
+        }
+
+        std::string noise_file(const std::string& name, const std::string& content) {
+            auto path = (folder / name).string();
+            std::ofstream(path) << content;
+            return path;
+        }
+
+        static NoisePrewhitenerCache::Entry entry(float value) {
+            NoisePrewhitenerCache::Entry result{ hoNDArray<std::complex<float>>(2, 2), 5.0f };
+            result.prewhitening_matrix.fill(value);
+            return result;
+        }
+
+        static NoisePrewhitenerCache::Key key(const std::string& file) {
+            return { file, { "coil0", "coil1" }, {} };
+        }
+
+        void insert(const std::string& file, float value) {
+            cache.insert(key(file), *NoisePrewhitenerCache::version(file), entry(value));
+        }
+
+        boost::filesystem::path folder;
+        NoisePrewhitenerCache cache;
+    };
+}
+
+TEST_F(NoisePrewhitenerCacheTest, returnsInsertedEntry) {
+    auto file = noise_file("noise", "covariance");
+    EXPECT_FALSE(cache.find(key(file)));
+    insert(file, 3.0f);
+
+    auto found = cache.find(key(file));
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found->prewhitening_matrix[0], std::complex<float>(3.0f));
+    EXPECT_EQ(found->noise_dwell_time_us, 5.0f);
+
+    auto statistics = cache.statistics();
+    EXPECT_EQ(statistics.hits, 1u);
+    EXPECT_EQ(statistics.misses, 1u);
+    EXPECT_EQ(statistics.entries, 1u);
+}
+
+TEST_F(NoisePrewhitenerCacheTest, keyIncludesCoilOrder) {
+    auto file = noise_file("noise", "covariance");
+    insert(file, 3.0f);
+
+    EXPECT_FALSE(cache.find({ file, { "coil1", "coil0" }, {} }));
+    EXPECT_FALSE(cache.find({ file, { "coil0", "coil1" }, { 1 } }));
+    EXPECT_TRUE(cache.find(key(file)));
+}
+
+TEST_F(NoisePrewhitenerCacheTest, dropsEntriesWhenFileChanges) {
+    auto file = noise_file("noise", "covariance");
+    insert(file, 3.0f);
+
+    noise_file("noise", "a different covariance");
+    EXPECT_FALSE(cache.find(key(file)));
+    EXPECT_EQ(cache.statistics().stale, 1u);
+    EXPECT_EQ(cache.statistics().entries, 0u);
+
+    insert(file, 4.0f);
+    boost::filesystem::remove(file);
+    EXPECT_FALSE(cache.find(key(file)));
+}
+
+TEST_F(NoisePrewhitenerCacheTest, dropsEntriesWhenFileIsRewrittenAtOnce) {
+    // Same size and, on most file systems, the same modification time to the second
+    auto file = noise_file("noise", "covariance");
+    insert(file, 3.0f);
+
+    noise_file("noise", "COVARIANCE");
+    EXPECT_FALSE(cache.find(key(file)));
+    EXPECT_EQ(cache.statistics().stale, 1u);
+}
+
+TEST_F(NoisePrewhitenerCacheTest, invalidatesByFile) {
+    auto file  = noise_file("noise", "covariance");
+    auto other = noise_file("other", "covariance");
+    insert(file, 3.0f);
+    insert(other, 4.0f);
+
+    cache.invalidate(file);
+    EXPECT_FALSE(cache.find(key(file)));
+    EXPECT_TRUE(cache.find(key(other)));
+}
+
+TEST_F(NoisePrewhitenerCacheTest, evictsLeastRecentlyUsed) {
+    cache.set_capacity(2);
+    auto a = noise_file("a", "covariance");
+    auto b = noise_file("b", "covariance");
+    auto c = noise_file("c", "covariance");
+    insert(a, 1.0f);
+    insert(b, 2.0f);
+    EXPECT_TRUE(cache.find(key(a)));
+    insert(c, 3.0f);
+
+    EXPECT_TRUE(cache.find(key(a)));
+    EXPECT_FALSE(cache.find(key(b)));
+    EXPECT_TRUE(cache.find(key(c)));
+    EXPECT_EQ(cache.statistics().evictions, 1u);
+}
+
+TEST_F(NoisePrewhitenerCacheTest, persistentCacheStoresEntriesBesideTheFile) {
+    auto file = noise_file("noise", "covariance");
+
+    // A cache of its own for each connection, as each is handled in a process of its own
+    NoisePrewhitenerCache first(true);
+    first.insert(key(file), *NoisePrewhitenerCache::version(file), entry(3.0f));
+    EXPECT_TRUE(boost::filesystem::exists(NoisePrewhitenerCache::stored_entry_file(key(file))));
+
+    NoisePrewhitenerCache second(true);
+    auto found = second.find(key(file));
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found->prewhitening_matrix[3], std::complex<float>(3.0f));
+    EXPECT_EQ(found->noise_dwell_time_us, 5.0f);
+    EXPECT_EQ(second.statistics().stored_hits, 1u);
+
+    EXPECT_FALSE(second.find({ file, { "coil1", "coil0" }, {} }));
+
+    // Found in memory from then on
+    EXPECT_TRUE(second.find(key(file)));
+    EXPECT_EQ(second.statistics().stored_hits, 1u);
+    EXPECT_EQ(second.statistics().hits, 2u);
+}
+
+TEST_F(NoisePrewhitenerCacheTest, persistentCacheIgnoresStoredEntriesOfChangedFiles) {
+    auto file = noise_file("noise", "covariance");
+    NoisePrewhitenerCache(true).insert(key(file), *NoisePrewhitenerCache::version(file), entry(3.0f));
+
+    noise_file("noise", "a different covariance");
+    EXPECT_FALSE(NoisePrewhitenerCache(true).find(key(file)));
+
+    NoisePrewhitenerCache cache(true);
+    cache.insert(key(file), *NoisePrewhitenerCache::version(file), entry(4.0f));
+    cache.invalidate(file);
+    EXPECT_FALSE(boost::filesystem::exists(NoisePrewhitenerCache::stored_entry_file(key(file))));
+    EXPECT_FALSE(NoisePrewhitenerCache(true).find(key(file)));
+}
+
+#if !(_WIN32)
+TEST_F(NoisePrewhitenerCacheTest, persistentCacheHitsAcrossForkedConnections) {
+    auto file = noise_file("noise", "covariance");
+
+    // The first connection computes the prewhitener in a child process, as the server does
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        auto& cache = NoisePrewhitenerCache::instance();
+        bool missed = !cache.find(key(file));
+        cache.insert(key(file), *NoisePrewhitenerCache::version(file), entry(3.0f));
+        _exit(missed ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    // and the second finds it without having computed anything
+    NoisePrewhitenerCache second(true);
+    auto found = second.find(key(file));
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found->prewhitening_matrix[0], std::complex<float>(3.0f));
+    EXPECT_EQ(second.statistics().stored_hits, 1u);
+}
+#endif
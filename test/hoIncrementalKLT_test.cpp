@@ -0,0 +1,167 @@
+#include "hoIncrementalKLT.h"
+#include "mri_core_utility.h"
+
+#include <gtest/gtest.h>
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace Gadgetron;
+using testing::Types;
+
+template <typename T> class hoIncrementalKLT_Test : public ::testing::Test {
+protected:
+  typedef typename realType<T>::Type REAL;
+
+  void SetUp() override {
+    rng.seed(3);
+    N = 8;
+  }
+
+  // samples [E N] of N channels mixing a few sources with decaying strength, plus a mean
+  hoNDArray<T> samples(size_t E, size_t seed) {
+    std::mt19937 gen(seed);
+    std::normal_distribution<REAL> dist;
+    hoNDArray<T> mixing(N, N);
+    for (auto& m : mixing) m = T(dist(gen), dist(gen));
+
+    hoNDArray<T> data(E, N);
+    for (size_t e = 0; e < E; e++) {
+      for (size_t n = 0; n < N; n++) {
+        T v = T(1, -2);
+        for (size_t s = 0; s < N; s++) v += mixing(n, s) * T(dist(rng), dist(rng)) / REAL(1 + 2 * s);
+        data(e, n) = v;
+      }
+    }
+    return data;
+  }
+
+  // covariance of rows [start, start+length) of data, with the mean removed
+  hoNDArray<T> reference_covariance(const hoNDArray<T>& data, size_t start, size_t length) {
+    std::vector<T> mean(N, T(0));
+    for (size_t n = 0; n < N; n++)
+      for (size_t e = start; e < start + length; e++) mean[n] += data(e, n) / REAL(length);
+
+    hoNDArray<T> C(N, N);
+    for (size_t j = 0; j < N; j++) {
+      for (size_t i = 0; i < N; i++) {
+        T c = 0;
+        for (size_t e = start; e < start + length; e++) c += std::conj(data(e, i) - mean[i]) * (data(e, j) - mean[j]);
+        C(i, j) = c;
+      }
+    }
+    return C;
+  }
+
+  std::mt19937 rng;
+  size_t N;
+};
+
+typedef Types<std::complex<float>, std::complex<double>> cplxTypes;
+
+TYPED_TEST_SUITE(hoIncrementalKLT_Test, cplxTypes);
+
+TYPED_TEST(hoIncrementalKLT_Test,covarianceMatchesAllSamples){
+  auto a = this->samples(100, 1);
+  auto b = this->samples(60, 1);
+
+  hoIncrementalKLT<TypeParam> klt(this->N);
+  klt.update(a, 20, 50);
+  klt.update(b);
+  EXPECT_EQ(klt.number_of_samples(), 110);
+
+  hoNDArray<TypeParam> all(110, this->N);
+  for (size_t n = 0; n < this->N; n++) {
+    for (size_t e = 0; e < 50; e++) all(e, n) = a(20 + e, n);
+    for (size_t e = 0; e < 60; e++) all(50 + e, n) = b(e, n);
+  }
+  auto expected = this->reference_covariance(all, 0, 110);
+
+  hoNDArray<TypeParam> C;
+  klt.covariance(C);
+  for (size_t i = 0; i < C.get_number_of_elements(); i++)
+    EXPECT_NEAR(std::abs(C[i] - expected[i]), 0, 1e-3 * std::abs(expected[i]) + 1e-2);
+}
+
+TYPED_TEST(hoIncrementalKLT_Test,basisDiagonalizesCovariance){
+  hoIncrementalKLT<TypeParam> klt(this->N);
+  klt.update(this->samples(200, 1));
+  EXPECT_FALSE(klt.has_basis());
+  klt.prepare();
+  ASSERT_TRUE(klt.has_basis());
+
+  EXPECT_LT(klt.drift(), 1e-3);
+
+  auto& E = klt.eigen_value();
+  for (size_t n = 1; n < this->N; n++) EXPECT_GE(E(n - 1), E(n));
+
+  // for a current basis, the energy retained is the fraction of the sum of the eigen values
+  double total = 0, retained = 0;
+  for (size_t n = 0; n < this->N; n++) total += E(n);
+  for (size_t K = 1; K <= this->N; K++) {
+    retained += E(K - 1);
+    EXPECT_NEAR(klt.energy_retained(K), retained / total, 1e-4);
+  }
+  EXPECT_GT(klt.energy_retained(1), 1.0 / this->N);
+}
+
+TYPED_TEST(hoIncrementalKLT_Test,keepsUntransformedChannelsFirst){
+  std::vector<size_t> untransformed = { 5, 2 };
+  hoIncrementalKLT<TypeParam> klt(this->N, untransformed);
+  auto data = this->samples(100, 1);
+  klt.update(data);
+  klt.prepare();
+
+  auto original = data;
+  hoNDArray<TypeParam> buf;
+  apply_channel_matrix({ &data }, klt.basis(), false, buf);
+
+  for (size_t e = 0; e < data.get_size(0); e++) {
+    EXPECT_EQ(data(e, 0), original(e, 5));
+    EXPECT_EQ(data(e, 1), original(e, 2));
+  }
+  EXPECT_LT(klt.drift(), 1e-3);
+}
+
+TYPED_TEST(hoIncrementalKLT_Test,driftFollowsChangesInTheData){
+  hoIncrementalKLT<TypeParam> klt(this->N);
+  klt.update(this->samples(200, 1));
+  klt.prepare();
+
+  klt.forget(0.1);
+  klt.update(this->samples(200, 2));
+  auto drift = klt.drift();
+  EXPECT_GT(drift, 0.1);
+
+  klt.prepare();
+  EXPECT_LT(klt.drift(), 1e-3);
+}
+
+TYPED_TEST(hoIncrementalKLT_Test,batchedProductAppliesBasis){
+  hoIncrementalKLT<TypeParam> klt(this->N);
+  klt.update(this->samples(100, 1));
+  klt.prepare();
+  auto& V = klt.basis();
+
+  std::vector<hoNDArray<TypeParam>> data = { this->samples(32, 4), this->samples(7, 5), this->samples(64, 6) };
+  std::vector<hoNDArray<TypeParam>> expected;
+  std::vector<hoNDArray<TypeParam>*> pointers;
+  for (auto& d : data) {
+    hoNDArray<TypeParam> res(d.get_size(0), this->N);
+    for (size_t e = 0; e < d.get_size(0); e++) {
+      for (size_t c = 0; c < this->N; c++) {
+        TypeParam sum = 0;
+        for (size_t k = 0; k < this->N; k++) sum += d(e, k) * V(k, c);
+        res(e, c) = sum;
+      }
+    }
+    expected.push_back(res);
+    pointers.push_back(&d);
+  }
+
+  hoNDArray<TypeParam> buf;
+  apply_channel_matrix(pointers, klt.basis(), false, buf);
+  for (size_t n = 0; n < data.size(); n++)
+    for (size_t i = 0; i < data[n].get_number_of_elements(); i++)
+      EXPECT_NEAR(std::abs(data[n][i] - expected[n][i]), 0, 1e-4 * std::abs(expected[n][i]) + 1e-4);
+}
@@ -0,0 +1,121 @@
+#include "hoMemoryPool.h"
+#include "hoNDArray.h"
+
+#include <gtest/gtest.h>
+#include <complex>
+#include <cstdint>
+#include <thread>
+
+using namespace Gadgetron;
+
+class hoMemoryPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override { hoMemoryPool::enable(); }
+    void TearDown() override {
+        hoMemoryPool::enable(false);
+        hoMemoryPool::release_cached();
+    }
+};
+
+TEST_F(hoMemoryPoolTest, aligned) {
+    for (size_t bytes : { 1, 63, 65, 1000, 4097, 1 << 20, (1 << 20) + 1 }) {
+        auto data = hoMemoryPool::allocate(bytes);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % hoMemoryPool::alignment, 0u);
+        hoMemoryPool::deallocate(data);
+    }
+}
+
+TEST_F(hoMemoryPoolTest, reusesBlocksOfTheSameClass) {
+    auto first = hoMemoryPool::allocate(10000);
+    hoMemoryPool::deallocate(first);
+
+    auto before = hoMemoryPool::statistics();
+    auto second = hoMemoryPool::allocate(9990);
+    auto after  = hoMemoryPool::statistics();
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(after.reused, before.reused + 1);
+    hoMemoryPool::deallocate(second);
+}
+
+TEST_F(hoMemoryPoolTest, cacheLimitCoversThreadCaches) {
+    auto data   = hoMemoryPool::allocate(1000);
+    auto before = hoMemoryPool::statistics();
+    hoMemoryPool::set_cache_limit(before.cached_bytes);
+
+    hoMemoryPool::deallocate(data);
+    auto after = hoMemoryPool::statistics();
+    hoMemoryPool::set_cache_limit(size_t(1) << 30);
+
+    EXPECT_EQ(after.cached_bytes, before.cached_bytes);
+}
+
+TEST_F(hoMemoryPoolTest, tracksLiveAndPeak) {
+    auto before = hoMemoryPool::statistics();
+    auto a      = hoMemoryPool::allocate(1 << 16);
+    auto b      = hoMemoryPool::allocate(1 << 16);
+    auto during = hoMemoryPool::statistics();
+    hoMemoryPool::deallocate(a);
+    hoMemoryPool::deallocate(b);
+    auto after = hoMemoryPool::statistics();
+
+    EXPECT_EQ(during.live_bytes, before.live_bytes + (2u << 16));
+    EXPECT_GE(during.peak_bytes, during.live_bytes);
+    EXPECT_EQ(after.live_bytes, before.live_bytes);
+}
+
+TEST_F(hoMemoryPoolTest, arenaReleasesCachedMemory) {
+    auto arena = std::make_shared<hoMemoryPool::Arena>();
+    void* outlives_arena;
+    {
+        hoMemoryPool::ArenaScope scope(arena);
+        for (int i = 0; i < 32; i++)
+            hoMemoryPool::deallocate(hoMemoryPool::allocate(4u << 20));
+        outlives_arena = hoMemoryPool::allocate(1000);
+
+        auto statistics = arena->statistics();
+        EXPECT_EQ(statistics.allocations, 33u);
+        EXPECT_EQ(statistics.reused, 31u);
+        EXPECT_EQ(statistics.cached_bytes, 4u << 20);
+    }
+
+    auto cached = hoMemoryPool::statistics().cached_bytes;
+    arena.reset();
+    EXPECT_EQ(hoMemoryPool::statistics().cached_bytes, cached - (4u << 20));
+
+    // Blocks may be freed after their arena has been closed.
+    hoMemoryPool::deallocate(outlives_arena);
+}
+
+TEST_F(hoMemoryPoolTest, freedOnAnotherThread) {
+    std::vector<void*> blocks;
+    for (int i = 0; i < 64; i++)
+        blocks.push_back(hoMemoryPool::allocate(512 * i + 1));
+
+    auto live = hoMemoryPool::statistics().live_bytes;
+    std::thread([&]() {
+        for (auto block : blocks)
+            hoMemoryPool::deallocate(block);
+    }).join();
+
+    EXPECT_LT(hoMemoryPool::statistics().live_bytes, live);
+}
+
+TEST_F(hoMemoryPoolTest, hoNDArray) {
+    hoNDArray<std::complex<float>> array(128, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(array.data()) % hoMemoryPool::alignment, 0u);
+    EXPECT_EQ(array[0], std::complex<float>(0));
+    array.fill(std::complex<float>(1, 2));
+
+    auto copy  = array;
+    auto moved = std::move(array);
+    EXPECT_EQ(copy, moved);
+
+    // Arrays allocated from the pool can be freed with the pool disabled, and vice versa.
+    hoMemoryPool::enable(false);
+    hoNDArray<float> unpooled(100);
+    moved = hoNDArray<std::complex<float>>(3);
+    hoMemoryPool::enable();
+    unpooled.create(1000);
+    EXPECT_EQ(unpooled.get_number_of_elements(), 1000u);
+}
@@ -2,7 +2,9 @@
 #include "complext.h"
 
 #include <gtest/gtest.h>
+#include <cmath>
 #include <complex>
+#include <limits>
 #include <vector>
 
 using namespace Gadgetron;
@@ -394,6 +396,81 @@ EXPECT_FLOAT_EQ(11,real(this->Array[33425]));
 EXPECT_FLOAT_EQ(-3,imag(this->Array[33425]));
 }
 
+TYPED_TEST(hoNDArray_elemwise_TestCplx2,simdLevelsAgree){
+  using REAL = typename realType<TypeParam>::Type;
+  const size_t N = 1031; // Not a multiple of any vector width
+  std::vector<TypeParam> x(N), y(N), product(N), product_conj(N), result(N);
+  std::vector<REAL> magnitude(N), result_abs(N);
+  for (size_t i = 0; i < N; i++) {
+    x[i] = TypeParam(REAL(i % 17) - REAL(8.5), REAL(i % 13) * REAL(0.3) - 1);
+    y[i] = TypeParam(REAL(i % 7) * REAL(1.7), 3 - REAL(i % 11));
+  }
+
+  auto original = SIMD::level();
+  SIMD::set_level(SIMD::Level::none);
+  SIMD::multiply(N, x.data(), y.data(), product.data());
+  SIMD::multiply_conj(N, x.data(), y.data(), product_conj.data());
+  SIMD::abs(N, x.data(), magnitude.data());
+  EXPECT_FLOAT_EQ(real(x[5] * y[5]), real(product[5]));
+  EXPECT_FLOAT_EQ(imag(x[5] * conj(y[5])), imag(product_conj[5]));
+  EXPECT_FLOAT_EQ(std::abs(x[5]), magnitude[5]);
+
+  for (auto level : {SIMD::Level::sse3, SIMD::Level::avx2, SIMD::Level::avx512}) {
+    if (SIMD::set_level(level) != level) continue;
+    SIMD::multiply(N, x.data(), y.data(), result.data());
+    EXPECT_EQ(product, result) << SIMD::to_string(level);
+    SIMD::multiply_conj(N, x.data(), y.data(), result.data());
+    EXPECT_EQ(product_conj, result) << SIMD::to_string(level);
+    SIMD::abs(N, x.data(), result_abs.data());
+    EXPECT_EQ(magnitude, result_abs) << SIMD::to_string(level);
+  }
+  SIMD::set_level(original);
+}
+
+TEST(hoNDArray_elemwise_transform,callsFunctionInOrder){
+  // Larger than one chunk of the threaded element-wise operations; user functions may keep state
+  hoNDArray<float> x(1024 * 1024);
+  fill(&x, 1.0f);
+  long long calls = 0;
+  hoNDArray<float> r(x.dimensions());
+  transform(x, r, [&calls](float v) { return v * float(calls++ % 1000); });
+  EXPECT_EQ(calls, (long long)x.size());
+  EXPECT_FLOAT_EQ(float(777777 % 1000), r[777777]);
+
+  calls = 0;
+  auto s = transform(r, [&calls](float v) { return v + float(calls++ % 1000); });
+  EXPECT_FLOAT_EQ(float(777777 % 1000) * 2, s[777777]);
+}
+
+TYPED_TEST(hoNDArray_elemwise_TestCplx2,simdAbsScalesLikeHypot){
+  using REAL = typename realType<TypeParam>::Type;
+  const REAL big = std::sqrt(std::numeric_limits<REAL>::max());
+  const REAL small = std::sqrt(std::numeric_limits<REAL>::min());
+  const REAL inf = std::numeric_limits<REAL>::infinity();
+  // Squares of these overflow or underflow; zero and infinite values go through std::hypot amid regular ones
+  std::vector<TypeParam> x;
+  for (size_t i = 0; i < 64; i++) {
+    REAL scale = (i % 3 == 0) ? big * 4 : (i % 3 == 1) ? small / 4 : REAL(1);
+    x.push_back(TypeParam(REAL(3) * scale, REAL(i % 2 ? -4 : 4) * scale));
+  }
+  x[17] = TypeParam(0, 0);
+  x[42] = TypeParam(-inf, 1);
+  x[43] = TypeParam(inf, inf);
+
+  std::vector<REAL> expected(x.size()), result(x.size());
+  for (size_t i = 0; i < x.size(); i++) expected[i] = std::hypot(real(x[i]), imag(x[i]));
+
+  auto original = SIMD::level();
+  for (auto level : {SIMD::Level::none, SIMD::Level::sse3, SIMD::Level::avx2, SIMD::Level::avx512}) {
+    if (SIMD::set_level(level) != level) continue;
+    SIMD::abs(x.size(), x.data(), result.data());
+    for (size_t i = 0; i < x.size(); i++) {
+      EXPECT_FLOAT_EQ(expected[i], result[i]) << SIMD::to_string(level) << " at " << i;
+    }
+  }
+  SIMD::set_level(original);
+}
+
 TYPED_TEST_CASE(hoNDArray_elemwise_TestCplx3, cplxtImplementations);
 
 TYPED_TEST(hoNDArray_elemwise_TestCplx3,realToCplxTest){
@@ -0,0 +1,145 @@
+#include "hoNDArray_expressions.h"
+#include "complext.h"
+
+#include <gtest/gtest.h>
+#include <complex>
+#include <vector>
+
+using namespace Gadgetron;
+using testing::Types;
+
+template <typename T> class hoNDArray_expressions_TestCplx : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    size_t vdims[] = {37, 49, 23, 19}; //Using prime numbers for setup because they are messy
+    dims = std::vector<size_t>(vdims,vdims+sizeof(vdims)/sizeof(size_t));
+    a = hoNDArray<T>(dims);
+    b = hoNDArray<T>(dims);
+    c = hoNDArray<T>(dims);
+    using R = typename realType<T>::Type;
+    for (size_t i = 0; i < a.get_number_of_elements(); i++) {
+      a[i] = T(R(i % 13), R(1 + i % 7));
+      b[i] = T(R(2) - R(i % 5), R(i % 11));
+      c[i] = T(R(i % 3), R(-1.5));
+    }
+  }
+  std::vector<size_t> dims;
+  hoNDArray<T> a, b, c;
+};
+
+typedef Types<std::complex<float>, std::complex<double>, float_complext, double_complext> cplxTypes;
+
+TYPED_TEST_SUITE(hoNDArray_expressions_TestCplx, cplxTypes);
+
+TYPED_TEST(hoNDArray_expressions_TestCplx,fusedMatchesUnfused){
+  using T = TypeParam;
+  using R = typename realType<T>::Type;
+  T alpha(R(0.5), R(-2));
+
+  hoNDArray<T> r;
+  r = this->a * conj(this->b) + alpha * this->c;
+  EXPECT_TRUE(r.dimensions_equal(&this->dims));
+
+  hoNDArray<T> expected, tmp(this->c);
+  multiplyConj(this->a, this->b, expected);
+  tmp *= alpha;
+  expected += tmp;
+  for (size_t i = 0; i < r.get_number_of_elements(); i++) {
+    EXPECT_NEAR(real(expected[i]), real(r[i]), 1e-4);
+    EXPECT_NEAR(imag(expected[i]), imag(r[i]), 1e-4);
+  }
+}
+
+TYPED_TEST(hoNDArray_expressions_TestCplx,inPlace){
+  using T = TypeParam;
+  hoNDArray<T> expected(this->a);
+  for (size_t i = 0; i < expected.get_number_of_elements(); i++)
+    expected[i] = -(this->a[i] - this->b[i] / T(2)) * this->b[i];
+
+  // Assigning to an operand writes into its existing storage
+  T* data = this->a.get_data_ptr();
+  this->a = -(this->a - this->b / T(2)) * this->b;
+  EXPECT_EQ(data, this->a.get_data_ptr());
+  for (size_t i = 0; i < expected.get_number_of_elements(); i++) {
+    EXPECT_NEAR(real(expected[i]), real(this->a[i]), 1e-3);
+    EXPECT_NEAR(imag(expected[i]), imag(this->a[i]), 1e-3);
+  }
+}
+
+TYPED_TEST(hoNDArray_expressions_TestCplx,broadcasting){
+  using T = TypeParam;
+  using R = typename realType<T>::Type;
+
+  // Per-image weights repeated over the last two dimensions, as in multiply
+  std::vector<size_t> image_dims = {37, 49};
+  hoNDArray<T> weights(image_dims);
+  for (size_t i = 0; i < weights.get_number_of_elements(); i++)
+    weights[i] = T(R(i % 4), R(1));
+
+  hoNDArray<T> expected;
+  multiply(this->a, weights, expected);
+  expected += this->c;
+
+  // r is a different size, so it is recreated with the dimensions of the largest operand
+  hoNDArray<T> r(image_dims);
+  r = weights * this->a + this->c;
+  EXPECT_TRUE(r.dimensions_equal(&this->dims));
+  for (size_t i = 0; i < r.get_number_of_elements(); i++) {
+    EXPECT_NEAR(real(expected[i]), real(r[i]), 1e-4);
+    EXPECT_NEAR(imag(expected[i]), imag(r[i]), 1e-4);
+  }
+
+  hoNDArray<T> unrelated(std::vector<size_t>{5});
+  EXPECT_THROW(r = this->a * unrelated, std::runtime_error);
+}
+
+TYPED_TEST(hoNDArray_expressions_TestCplx,realResults){
+  using T = TypeParam;
+  using R = typename realType<T>::Type;
+
+  hoNDArray<R> magnitude = abs(this->a * this->b) + real(conj(this->c)) * R(2);
+  EXPECT_TRUE(magnitude.dimensions_equal(&this->dims));
+  for (size_t i = 0; i < magnitude.get_number_of_elements(); i++) {
+    R expected = abs(this->a[i] * this->b[i]) + R(2) * real(this->c[i]);
+    EXPECT_NEAR(expected, magnitude[i], 1e-3);
+  }
+}
+
+TYPED_TEST(hoNDArray_expressions_TestCplx,autoKeepsTemporaries){
+  using T = TypeParam;
+  using R = typename realType<T>::Type;
+
+  // The copies of a and c are gone by the time the expression is evaluated
+  auto expression = hoNDArray<T>(this->a) * this->b + conj(hoNDArray<T>(this->c)) * R(2);
+  auto magnitude = abs(expression - hoNDArray<T>(this->b));
+  this->c.fill(T(0));
+
+  hoNDArray<T> r(expression);
+  hoNDArray<R> m(magnitude);
+  for (size_t i = 0; i < r.get_number_of_elements(); i++) {
+    T expected = this->a[i] * this->b[i] + conj(T(R(i % 3), R(-1.5))) * R(2);
+    EXPECT_NEAR(real(expected), real(r[i]), 1e-3);
+    EXPECT_NEAR(imag(expected), imag(r[i]), 1e-3);
+    EXPECT_NEAR(abs(expected - this->b[i]), m[i], 1e-3);
+  }
+}
+
+TYPED_TEST(hoNDArray_expressions_TestCplx,insideParallelRegion){
+  using T = TypeParam;
+  using R = typename realType<T>::Type;
+
+  // As in the per-coil loops of grappa: every thread evaluates expressions of its own
+  std::vector<hoNDArray<T>> results(8);
+#pragma omp parallel for
+  for (int n = 0; n < (int)results.size(); n++) {
+    results[n] = this->a * T(R(n)) + this->b;
+  }
+
+  for (size_t n = 0; n < results.size(); n++) {
+    for (size_t i = 0; i < this->a.get_number_of_elements(); i += 101) {
+      T expected = this->a[i] * T(R(n)) + this->b[i];
+      EXPECT_NEAR(real(expected), real(results[n][i]), 1e-3);
+      EXPECT_NEAR(imag(expected), imag(results[n][i]), 1e-3);
+    }
+  }
+}
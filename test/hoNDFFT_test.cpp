@@ -3,6 +3,7 @@
 #include "complext.h"
 #include <gtest/gtest.h>
 #include <boost/random.hpp>
+#include <limits>
 #include <random>
 
 using namespace Gadgetron;
@@ -168,3 +169,131 @@ TEST(FFTshiftTest, shift3d_random){
 }
 
 
+
+TEST(FFTPlanCacheTest,reusesPlans){
+    hoNDArray<std::complex<float>> array(64, 32, 4);
+    std::fill(array.begin(), array.end(), std::complex<float>(1, 2));
+
+    hoNDFFT<float>::instance()->fft2(array);
+    auto before = FFT::plan_cache_statistics();
+    hoNDFFT<float>::instance()->fft2(array);
+    hoNDFFT<float>::instance()->fft2(array);
+    auto after = FFT::plan_cache_statistics();
+
+    EXPECT_EQ(after.misses, before.misses);
+    EXPECT_EQ(after.hits, before.hits + 2);
+}
+
+namespace {
+    // The planning mode is shared by the whole process; restores it for the tests that follow, even on failure
+    struct PlanningModeGuard {
+        PlanningModeGuard(FFT::PlanningMode mode) : previous(FFT::get_planning_mode()) { FFT::set_planning_mode(mode); }
+        ~PlanningModeGuard() { FFT::set_planning_mode(previous); }
+        FFT::PlanningMode previous;
+    };
+}
+
+TEST(FFTPlanCacheTest,measureMatchesEstimate){
+    boost::random::mt19937 rng;
+    boost::random::uniform_real_distribution<float> uni(0,1);
+    hoNDArray<std::complex<float>> array(48, 40, 3);
+    for (auto& value : array) value = std::complex<float>(uni(rng), uni(rng));
+
+    auto estimated = array;
+    hoNDFFT<float>::instance()->fft2c(estimated);
+
+    auto measured = array;
+    {
+        PlanningModeGuard guard(FFT::PlanningMode::Measure);
+        hoNDFFT<float>::instance()->fft2c(measured);
+    }
+
+    measured -= estimated;
+    EXPECT_LE(nrm2(&measured), nrm2(&estimated)*1e-5);
+}
+
+TEST(FFTshiftTest,shift2d_odd){
+    auto array = make_random_array(5,3,2);
+    auto output = array;
+    hoNDFFT<float>::instance()->fftshift2D(array,output);
+    for (size_t n = 0; n < 2; n++)
+        for (size_t y = 0; y < 3; y++)
+            for (size_t x = 0; x < 5; x++)
+                EXPECT_EQ(output((x + 2) % 5, (y + 1) % 3, n), array(x, y, n));
+
+    auto inplace = array;
+    hoNDFFT<float>::instance()->fftshift2D(inplace);
+    EXPECT_EQ(inplace,output);
+    hoNDFFT<float>::instance()->ifftshift2D(inplace);
+    EXPECT_EQ(inplace,array);
+}
+
+TEST(FFTshiftTest,shift3d_odd){
+    auto array = make_random_array(6,5,7,2);
+    auto output = array;
+    hoNDFFT<float>::instance()->fftshift3D(array,output);
+    for (size_t n = 0; n < 2; n++)
+        for (size_t z = 0; z < 7; z++)
+            for (size_t y = 0; y < 5; y++)
+                for (size_t x = 0; x < 6; x++)
+                    EXPECT_EQ(output((x + 3) % 6, (y + 2) % 5, (z + 3) % 7, n), array(x, y, z, n));
+
+    auto inplace = array;
+    hoNDFFT<float>::instance()->fftshift3D(inplace);
+    EXPECT_EQ(inplace,output);
+    hoNDFFT<float>::instance()->ifftshift3D(inplace);
+    EXPECT_EQ(inplace,array);
+}
+
+template<typename REAL> class hoNDFFT_centered_test : public ::testing::Test {
+protected:
+    hoNDArray<std::complex<REAL>> random_array(std::vector<size_t> dimensions){
+        boost::random::mt19937 rng;
+        boost::random::uniform_real_distribution<REAL> uni(-1,1);
+        hoNDArray<std::complex<REAL>> array(dimensions);
+        for (auto& value : array) value = std::complex<REAL>(uni(rng), uni(rng));
+        return array;
+    }
+
+    // Batched plans may round differently from single ones, so results are compared with a relative tolerance
+    void expect_close(const hoNDArray<std::complex<REAL>>& result, const hoNDArray<std::complex<REAL>>& expected){
+        ASSERT_TRUE(result.dimensions_equal(&expected));
+        REAL difference = 0, reference = 0;
+        for (size_t i = 0; i < result.size(); i++){
+            difference += std::norm(result[i] - expected[i]);
+            reference += std::norm(expected[i]);
+        }
+        EXPECT_LE(std::sqrt(difference), 100 * std::numeric_limits<REAL>::epsilon() * std::sqrt(reference));
+    }
+};
+TYPED_TEST_CASE(hoNDFFT_centered_test, realImplementations);
+
+// The centered transforms fold the shifts into the transform, and must match shifting separately
+TYPED_TEST(hoNDFFT_centered_test,matchesSeparateShifts){
+    auto fft = hoNDFFT<TypeParam>::instance();
+    for (auto dimensions : std::vector<std::vector<size_t>>{{64, 48, 3}, {37, 25, 2}, {32, 17, 5, 2}, {16, 300}}){
+        auto array = this->random_array(dimensions);
+
+        hoNDArray<std::complex<TypeParam>> expected, result;
+        fft->ifftshift1D(array, expected);
+        fft->fft1(expected);
+        fft->fftshift1D(expected);
+        fft->fft1c(array, result);
+        this->expect_close(result, expected);
+
+        fft->ifftshift2D(array, expected);
+        fft->ifft2(expected);
+        fft->fftshift2D(expected);
+        result = array;
+        fft->ifft2c(result);
+        this->expect_close(result, expected);
+
+        if (dimensions.size() < 4) continue;
+        fft->ifftshift3D(array, expected);
+        fft->fft3(expected);
+        fft->fftshift3D(expected);
+        hoNDArray<std::complex<TypeParam>> buffer;
+        fft->fft3c(array, result, buffer);
+        this->expect_close(result, expected);
+    }
+}
@@ -0,0 +1,97 @@
+#include "mri_core_noise_prewhitening.h"
+
+#include <gtest/gtest.h>
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace Gadgetron;
+using testing::Types;
+
+template <typename T> class noise_prewhitening_Test : public ::testing::Test {
+protected:
+  typedef typename realType<T>::Type REAL;
+
+  void SetUp() override {
+    rng.seed(7);
+    CHA = 12;
+    for (size_t E : { 64, 17, 128, 5 }) {
+      acquisitions.emplace_back(E, CHA);
+      fill(acquisitions.back());
+    }
+
+    triangular.create(CHA, CHA);
+    fill(triangular);
+    for (size_t c = 0; c < CHA; c++)
+      for (size_t r = c + 1; r < CHA; r++)
+        triangular(r, c) = T(0);
+
+    full.create(CHA, CHA);
+    fill(full);
+  }
+
+  void fill(hoNDArray<T>& a) {
+    std::normal_distribution<REAL> dist;
+    for (auto& v : a) v = T(dist(rng), dist(rng));
+  }
+
+  // data * prewhitener, one sample at a time
+  static hoNDArray<T> reference(const hoNDArray<T>& data, const hoNDArray<T>& prewhitener) {
+    size_t E = data.get_size(0), CHA = data.get_size(1);
+    hoNDArray<T> res(E, CHA);
+    for (size_t e = 0; e < E; e++) {
+      for (size_t c = 0; c < CHA; c++) {
+        T sum = 0;
+        for (size_t k = 0; k < CHA; k++) sum += data(e, k) * prewhitener(k, c);
+        res(e, c) = sum;
+      }
+    }
+    return res;
+  }
+
+  void check(const hoNDArray<T>& prewhitener, size_t batch) {
+    std::vector<hoNDArray<T>> expected;
+    std::vector<hoNDArray<T>*> data;
+    for (size_t n = 0; n < batch; n++) {
+      expected.push_back(reference(acquisitions[n], prewhitener));
+      data.push_back(&acquisitions[n]);
+    }
+
+    hoNDArray<T> buf;
+    apply_noise_prewhitening(data, prewhitener, buf);
+
+    for (size_t n = 0; n < batch; n++)
+      for (size_t i = 0; i < expected[n].get_number_of_elements(); i++)
+        EXPECT_NEAR(std::abs(expected[n][i] - acquisitions[n][i]), 0, 1e-4 * std::abs(expected[n][i]) + 1e-4);
+  }
+
+  std::mt19937 rng;
+  size_t CHA;
+  std::vector<hoNDArray<T>> acquisitions;
+  hoNDArray<T> triangular, full;
+};
+
+typedef Types<std::complex<float>, std::complex<double>> cplxTypes;
+
+TYPED_TEST_SUITE(noise_prewhitening_Test, cplxTypes);
+
+TYPED_TEST(noise_prewhitening_Test,detectsTriangular){
+  EXPECT_TRUE(is_upper_triangular(this->triangular));
+  EXPECT_FALSE(is_upper_triangular(this->full));
+}
+
+TYPED_TEST(noise_prewhitening_Test,triangularSingle){
+  this->check(this->triangular, 1);
+}
+
+TYPED_TEST(noise_prewhitening_Test,triangularBatch){
+  this->check(this->triangular, this->acquisitions.size());
+}
+
+TYPED_TEST(noise_prewhitening_Test,fullSingle){
+  this->check(this->full, 1);
+}
+
+TYPED_TEST(noise_prewhitening_Test,fullBatch){
+  this->check(this->full, this->acquisitions.size());
+}
@@ -0,0 +1,84 @@
+//
+// Centered FFTs with the shifts folded into the transform (fft2c/fft3c), against the same transform with separate
+// ifftshift and fftshift passes around it, for typical RO x E1 x CHA and 3D sizes. Reports ms per transform.
+//
+
+#include "hoNDFFT.h"
+
+#include <chrono>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Gadgetron;
+using Clock = std::chrono::steady_clock;
+using Complex = std::complex<float>;
+
+namespace {
+
+    template <class F> double milliseconds(F&& f, size_t repetitions) {
+        f(); // warm up, and create the plans
+        auto start = Clock::now();
+        for (size_t i = 0; i < repetitions; i++)
+            f();
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repetitions;
+    }
+
+    std::string format(const std::vector<size_t>& dimensions) {
+        std::string result;
+        for (auto d : dimensions)
+            result += (result.empty() ? "" : "x") + std::to_string(d);
+        return result;
+    }
+}
+
+int main() {
+    auto fft = hoNDFFT<float>::instance();
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> uni(-1, 1);
+
+    std::cout << std::left << std::setw(10) << "rank" << std::setw(18) << "dims" << std::right << std::setw(12)
+              << "separate" << std::setw(12) << "fused" << std::setw(10) << "speedup" << std::endl;
+
+    for (auto dimensions : std::vector<std::vector<size_t>>{
+             { 256, 256, 32 }, { 384, 384, 16 }, { 192, 144, 32 }, { 255, 191, 16 }, { 128, 128, 64, 8 },
+             { 192, 192, 96, 4 } }) {
+        hoNDArray<Complex> data(dimensions);
+        for (auto& value : data)
+            value = Complex(uni(rng), uni(rng));
+        hoNDArray<Complex> result(dimensions);
+
+        bool volume = dimensions.size() == 4;
+        size_t repetitions = volume ? 5 : 20;
+
+        auto separate = milliseconds(
+            [&]() {
+                if (volume) {
+                    fft->ifftshift3D(data, result);
+                    fft->fft3(result);
+                    fft->fftshift3D(result);
+                } else {
+                    fft->ifftshift2D(data, result);
+                    fft->fft2(result);
+                    fft->fftshift2D(result);
+                }
+            },
+            repetitions);
+        auto fused = milliseconds(
+            [&]() {
+                if (volume)
+                    fft->fft3c(data, result);
+                else
+                    fft->fft2c(data, result);
+            },
+            repetitions);
+
+        std::cout << std::left << std::setw(10) << (volume ? "3D" : "2D") << std::setw(18) << format(dimensions)
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(12) << separate << std::setw(12)
+                  << fused << std::setprecision(1) << std::setw(10) << separate / fused << std::endl;
+    }
+    return 0;
+}
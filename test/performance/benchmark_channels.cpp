@@ -0,0 +1,65 @@
+//
+// Throughput of the channel implementations with many concurrent, saturated producer/consumer pairs,
+// roughly mimicking a wide chain where every node is busy.
+//
+
+#include "Channel.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace Gadgetron::Core;
+
+template <class CHANNEL, class... ARGS>
+double time_channels(size_t number_of_channels, size_t messages_per_channel, ARGS... args) {
+
+    std::vector<ChannelPair> channels;
+    for (size_t i = 0; i < number_of_channels; i++)
+        channels.push_back(make_channel<CHANNEL>(args...));
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+    for (auto& channel : channels) {
+        threads.emplace_back([&channel, messages_per_channel]() {
+            auto output = std::move(channel.output);
+            for (size_t i = 0; i < messages_per_channel; i++)
+                output.push(i);
+        });
+        threads.emplace_back([&channel, messages_per_channel]() {
+            size_t sum = 0;
+            for (auto message : channel.input)
+                sum += force_unpack<size_t>(std::move(message));
+            if (sum != messages_per_channel * (messages_per_channel - 1) / 2)
+                std::cerr << "Messages were lost" << std::endl;
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    return number_of_channels * messages_per_channel / seconds;
+}
+
+int main(int argc, char** argv) {
+    size_t number_of_channels   = argc > 1 ? std::stoul(argv[1]) : 32;
+    size_t messages_per_channel = argc > 2 ? std::stoul(argv[2]) : 200000;
+
+    std::cout << "Channels: " << number_of_channels << " Messages per channel: " << messages_per_channel << std::endl;
+
+    std::cout << "MessageChannel        " << time_channels<MessageChannel>(number_of_channels, messages_per_channel)
+              << " messages/s" << std::endl;
+
+    for (size_t capacity : { 64, 1024 }) {
+        std::cout << "BoundedMessageChannel(" << capacity << ") "
+                  << time_channels<BoundedMessageChannel>(number_of_channels, messages_per_channel, capacity)
+                  << " messages/s" << std::endl;
+        std::cout << "SPSCMessageChannel(" << capacity << ")    "
+                  << time_channels<SPSCMessageChannel>(number_of_channels, messages_per_channel, capacity)
+                  << " messages/s" << std::endl;
+    }
+}
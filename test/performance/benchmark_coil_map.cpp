@@ -0,0 +1,88 @@
+//
+// Inati coil map estimation: the direct method, which forms the local data matrix and its correlation matrix for
+// every pixel, against the sliding window method, across channel counts and kernel sizes. Also reports the largest
+// difference between the two maps.
+//
+
+#include "mri_core_coil_map_estimation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace Gadgetron;
+using Complex = std::complex<float>;
+
+namespace {
+
+    hoNDArray<Complex> coil_images(std::vector<size_t> dimensions) {
+        hoNDArray<Complex> data(dimensions);
+        std::mt19937 rng(42);
+        std::normal_distribution<float> noise(0, 0.05f);
+
+        size_t CHA = dimensions.back();
+        size_t N   = data.get_number_of_elements() / CHA;
+        for (size_t cha = 0; cha < CHA; cha++) {
+            for (size_t n = 0; n < N; n++) {
+                float x      = float(n % dimensions[0]) / dimensions[0];
+                float y      = float((n / dimensions[0]) % dimensions[1]) / dimensions[1];
+                float weight = std::exp(-3 * ((x - float(cha) / CHA) * (x - float(cha) / CHA) + (y - 0.5f) * (y - 0.5f)));
+                data[n + cha * N] = std::polar(weight, x + 2 * y + cha) + Complex(noise(rng), noise(rng));
+            }
+        }
+        return data;
+    }
+
+    template <class F> double seconds(F&& f) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    float max_difference(const hoNDArray<Complex>& a, const hoNDArray<Complex>& b) {
+        float result = 0;
+        for (size_t n = 0; n < a.get_number_of_elements(); n++)
+            result = std::max(result, std::abs(a[n] - b[n]));
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t matrix = argc > 1 ? std::stoul(argv[1]) : 192;
+
+    std::cout << "Seconds per coil map, " << matrix << "x" << matrix << " (2D) and " << matrix / 2 << "x"
+              << matrix / 2 << "x32 (3D)" << std::endl;
+    std::cout << std::setw(6) << "dims" << std::setw(6) << "CHA" << std::setw(6) << "ks" << std::setw(12) << "direct"
+              << std::setw(12) << "sliding" << std::setw(10) << "speedup" << std::setw(12) << "max diff" << std::endl;
+
+    for (size_t CHA : { 8, 16, 32, 64 }) {
+        for (size_t ks : { 5, 7, 9 }) {
+            auto data = coil_images({ matrix, matrix, CHA });
+            hoNDArray<Complex> direct, sliding;
+            auto direct_time  = seconds([&]() { coil_map_2d_Inati_direct(data, direct, ks, 3); });
+            auto sliding_time = seconds([&]() { coil_map_2d_Inati(data, sliding, ks, 3); });
+
+            std::cout << std::setw(6) << "2D" << std::setw(6) << CHA << std::setw(6) << ks << std::fixed
+                      << std::setprecision(3) << std::setw(12) << direct_time << std::setw(12) << sliding_time
+                      << std::setprecision(1) << std::setw(10) << direct_time / sliding_time << std::scientific
+                      << std::setprecision(1) << std::setw(12) << max_difference(direct, sliding) << std::endl;
+        }
+    }
+
+    for (size_t CHA : { 8, 32 }) {
+        auto data = coil_images({ matrix / 2, matrix / 2, 32, CHA });
+        hoNDArray<Complex> direct, sliding;
+        auto direct_time  = seconds([&]() { coil_map_3d_Inati_direct(data, direct, 7, 5, 3); });
+        auto sliding_time = seconds([&]() { coil_map_3d_Inati(data, sliding, 7, 5, 3); });
+
+        std::cout << std::setw(6) << "3D" << std::setw(6) << CHA << std::setw(6) << 7 << std::fixed
+                  << std::setprecision(3) << std::setw(12) << direct_time << std::setw(12) << sliding_time
+                  << std::setprecision(1) << std::setw(10) << direct_time / sliding_time << std::scientific
+                  << std::setprecision(1) << std::setw(12) << max_difference(direct, sliding) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+//
+// Throughput and latency of the distributed job pool, using local stand-in workers with variable service times
+// and one slow worker. Compares ordered and unordered delivery with the previous dispatcher, which spawned a
+// thread per job and blocked it on the job's response.
+//
+
+#include "connection/stream/distributed/LocalWorker.h"
+#include "connection/stream/distributed/Pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Gadgetron::Core;
+using namespace Gadgetron::Server::Connection::Stream;
+
+using Clock = std::chrono::steady_clock;
+
+struct Job {
+    size_t id;
+    Clock::time_point pushed;
+};
+
+struct Result {
+    double jobs_per_second;
+    double p50_ms, p99_ms;
+    size_t out_of_order;
+};
+
+std::list<std::unique_ptr<Worker>> make_workers(size_t count, std::chrono::microseconds mean_service) {
+    std::list<std::unique_ptr<Worker>> workers;
+    for (size_t i = 0; i < count; i++) {
+        auto mean = i == 0 ? 5 * mean_service : mean_service; // One straggler.
+        auto random = std::make_shared<std::mt19937>(i);
+        workers.push_back(std::make_unique<LocalWorker>([=](Message message) {
+            std::exponential_distribution<double> service(1.0 / mean.count());
+            std::this_thread::sleep_for(std::chrono::microseconds(int64_t(service(*random))));
+            return message;
+        }, "local-" + std::to_string(i)));
+    }
+    return workers;
+}
+
+struct Received {
+    size_t id;
+    Clock::duration latency;
+};
+
+Result summarize(const std::vector<Received>& received, Clock::time_point start, Clock::time_point end) {
+    std::vector<double> latencies;
+    size_t out_of_order = 0;
+    for (size_t i = 0; i < received.size(); i++) {
+        if (received[i].id != i) out_of_order++;
+        latencies.push_back(std::chrono::duration<double, std::milli>(received[i].latency).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    return Result{ received.size() / std::chrono::duration<double>(end - start).count(),
+        latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], out_of_order };
+}
+
+Received receive(Message message) {
+    auto job = force_unpack<Job>(std::move(message));
+    return Received{ job.id, Clock::now() - job.pushed };
+}
+
+Result run_pool(size_t workers, size_t jobs, std::chrono::microseconds service, Pool::Settings settings) {
+    Pool pool(make_workers(workers, service), settings);
+    std::vector<Received> received;
+
+    auto start    = Clock::now();
+    auto producer = std::thread([&]() {
+        for (size_t i = 0; i < jobs; i++)
+            pool.push(Message(Job{ i, Clock::now() }));
+        pool.close();
+    });
+
+    try {
+        while (true)
+            received.push_back(receive(pool.pop()));
+    } catch (const ChannelClosed&) {
+    }
+    auto end = Clock::now();
+    producer.join();
+
+    return summarize(received, start, end);
+}
+
+// The previous dispatcher: one std::async per job, blocking until the least loaded worker has responded.
+Result run_blocking(size_t count, size_t jobs, std::chrono::microseconds service) {
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (auto& worker : make_workers(count, service)) workers.push_back(std::move(worker));
+    std::vector<std::atomic<size_t>> load(workers.size());
+
+    auto send = [&](Message message) {
+        auto best = std::min_element(load.begin(), load.end(),
+            [](auto& a, auto& b) { return a.load() < b.load(); }) - load.begin();
+        load[best]++;
+        std::promise<Message> response;
+        workers[best]->push(std::move(message),
+            [&](Message result) { response.set_value(std::move(result)); },
+            [&](std::exception_ptr e) { response.set_exception(e); });
+        auto result = response.get_future().get();
+        load[best]--;
+        return result;
+    };
+
+    auto start = Clock::now();
+    std::vector<std::future<Message>> futures;
+    for (size_t i = 0; i < jobs; i++)
+        futures.push_back(std::async(std::launch::async, send, Message(Job{ i, Clock::now() })));
+
+    std::vector<Received> received;
+    for (auto& future : futures)
+        received.push_back(receive(future.get()));
+    auto end = Clock::now();
+
+    return summarize(received, start, end);
+}
+
+void print(const std::string& name, const Result& result) {
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << result.jobs_per_second << " jobs/s"
+              << std::setw(10) << result.p50_ms << " ms p50"
+              << std::setw(10) << result.p99_ms << " ms p99"
+              << std::setw(8) << result.out_of_order << " out of order" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t workers = argc > 1 ? std::stoul(argv[1]) : 4;
+    size_t jobs    = argc > 2 ? std::stoul(argv[2]) : 2000;
+    auto service   = std::chrono::microseconds(argc > 3 ? std::stoul(argv[3]) : 500);
+
+    std::cout << workers << " workers, " << jobs << " jobs, mean service time " << service.count()
+              << " us (" << 5 * service.count() << " us on worker 0)" << std::endl;
+
+    print("blocking, thread per job", run_blocking(workers, jobs, service));
+    for (size_t in_flight : { 1, 2, 4 }) {
+        print("ordered, in flight " + std::to_string(in_flight),
+            run_pool(workers, jobs, service, Pool::Settings{ in_flight, true }));
+        print("unordered, in flight " + std::to_string(in_flight),
+            run_pool(workers, jobs, service, Pool::Settings{ in_flight, false }));
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+//
+// Simulated distributed reconstruction, comparing the pool's scheduling policies. The local stand-in workers
+// differ in speed, and each has to calibrate (e.g. compute GRAPPA weights) the first time it sees a slice, which
+// costs several times an ordinary job. Reports throughput, latency and the number of calibrations per policy.
+//
+
+#include "connection/stream/distributed/LocalWorker.h"
+#include "connection/stream/distributed/Pool.h"
+#include "connection/stream/distributed/SchedulingPolicy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace Gadgetron::Core;
+using namespace Gadgetron::Server::Connection::Stream;
+
+using Clock = std::chrono::steady_clock;
+
+struct Simulation {
+    std::vector<double> slowdowns;
+    size_t slices;
+    size_t jobs;
+    std::chrono::microseconds service;
+    double calibration_cost;
+};
+
+struct Result {
+    double jobs_per_second;
+    double p50_ms, p99_ms;
+    size_t calibrations;
+};
+
+std::list<std::unique_ptr<Worker>> make_workers(const Simulation& simulation, std::atomic<size_t>& calibrations) {
+    std::list<std::unique_ptr<Worker>> workers;
+    for (size_t i = 0; i < simulation.slowdowns.size(); i++) {
+        auto slowdown   = simulation.slowdowns[i];
+        auto calibrated = std::make_shared<std::set<uint16_t>>();
+        auto random     = std::make_shared<std::mt19937>(i);
+        workers.push_back(std::make_unique<LocalWorker>([=, &calibrations](Message message) {
+            auto slice = unpack_view<ISMRMRD::AcquisitionHeader>(message).idx.slice;
+            std::uniform_real_distribution<double> jitter(0.8, 1.2);
+            auto cost = slowdown * jitter(*random);
+            if (calibrated->insert(slice).second) {
+                cost += simulation.calibration_cost * slowdown;
+                calibrations++;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(int64_t(cost * simulation.service.count())));
+            return message;
+        }, "local-" + std::to_string(i)));
+    }
+    return workers;
+}
+
+Result run(const Simulation& simulation, const std::string& policy) {
+    std::atomic<size_t> calibrations{ 0 };
+    Pool pool(make_workers(simulation, calibrations), Pool::Settings{ 2, true },
+        make_scheduling_policy(policy, "slice"));
+
+    auto start    = Clock::now();
+    auto producer = std::thread([&]() {
+        for (size_t i = 0; i < simulation.jobs; i++) {
+            ISMRMRD::AcquisitionHeader header{};
+            header.idx.slice = uint16_t(i % simulation.slices);
+            pool.push(Message(header, Clock::now()));
+        }
+        pool.close();
+    });
+
+    std::vector<double> latencies;
+    try {
+        while (true) {
+            auto pushed = std::get<1>(force_unpack<ISMRMRD::AcquisitionHeader, Clock::time_point>(pool.pop()));
+            latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - pushed).count());
+        }
+    } catch (const ChannelClosed&) {
+    }
+    auto end = Clock::now();
+    producer.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    return Result{ latencies.size() / std::chrono::duration<double>(end - start).count(),
+        latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], calibrations.load() };
+}
+
+int main(int argc, char** argv) {
+    Simulation simulation{ { 1.0, 1.0, 2.0, 4.0 },
+        argc > 1 ? std::stoul(argv[1]) : 8,
+        argc > 2 ? std::stoul(argv[2]) : 1000,
+        std::chrono::microseconds(argc > 3 ? std::stoul(argv[3]) : 500),
+        0.0 };
+
+    for (double calibration_cost : { 10.0, 100.0 }) {
+        simulation.calibration_cost = calibration_cost;
+        std::cout << "Workers slowed down by 1, 1, 2 and 4; " << simulation.slices << " slices, " << simulation.jobs
+                  << " jobs, service time " << simulation.service.count() << " us, calibration "
+                  << int(simulation.calibration_cost) << " times that" << std::endl;
+
+        for (auto policy : { "least_loaded", "latency", "power_of_two", "sticky" }) {
+            auto result = run(simulation, policy);
+            std::cout << std::left << std::setw(14) << policy << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << result.jobs_per_second << " jobs/s"
+                      << std::setw(10) << result.p50_ms << " ms p50"
+                      << std::setw(10) << result.p99_ms << " ms p99"
+                      << std::setw(6) << result.calibrations << " calibrations" << std::endl;
+        }
+    }
+    return 0;
+}
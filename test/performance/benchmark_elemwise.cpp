@@ -0,0 +1,128 @@
+//
+// Element-wise operations on complex arrays: a plain single threaded loop (as transform_impl used to be), the
+// threaded engine with scalar kernels, and the threaded engine with the best SIMD kernels this CPU supports.
+// Reports GiB/s of data touched per operation and array size.
+//
+
+#include "hoNDArray_elemwise.h"
+#include "hoNDArray_elemwise_simd.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Gadgetron;
+using Clock = std::chrono::steady_clock;
+using Complex = std::complex<float>;
+
+namespace {
+
+    struct Operation {
+        std::string name;
+        size_t bytes_per_element;
+        std::function<void(hoNDArray<Complex>&, hoNDArray<Complex>&, hoNDArray<Complex>&, hoNDArray<float>&)> plain;
+        std::function<void(hoNDArray<Complex>&, hoNDArray<Complex>&, hoNDArray<Complex>&, hoNDArray<float>&)> engine;
+    };
+
+    // The loops as they were before the engine; complext avoids the NaN handling of std::complex multiplication.
+    template <class F> void plain_loop(const hoNDArray<Complex>& x, const hoNDArray<Complex>& y, hoNDArray<Complex>& r, F f) {
+        auto a = reinterpret_cast<const float_complext*>(x.data());
+        auto b = reinterpret_cast<const float_complext*>(y.data());
+        auto c = reinterpret_cast<float_complext*>(r.data());
+        for (long long n = 0; n < (long long)x.size(); n++)
+            c[n] = f(a[n], b[n]);
+    }
+
+    std::vector<Operation> operations() {
+        using A = hoNDArray<Complex>;
+        using R = hoNDArray<float>;
+        return {
+            { "multiply", 3 * sizeof(Complex),
+                [](A& x, A& y, A& r, R&) { plain_loop(x, y, r, std::multiplies<>()); },
+                [](A& x, A& y, A& r, R&) { multiply(x, y, r); } },
+            { "multiplyConj", 3 * sizeof(Complex),
+                [](A& x, A& y, A& r, R&) { plain_loop(x, y, r, [](auto a, auto b) { return a * conj(b); }); },
+                [](A& x, A& y, A& r, R&) { multiplyConj(x, y, r); } },
+            { "abs", sizeof(Complex) + sizeof(float),
+                [](A& x, A&, A&, R& m) {
+                    for (long long n = 0; n < (long long)x.size(); n++)
+                        m[n] = std::abs(x[n]);
+                },
+                [](A& x, A&, A&, R& m) { Gadgetron::abs(x, m); } },
+            { "conjugate", 2 * sizeof(Complex),
+                [](A& x, A&, A& r, R&) {
+                    for (long long n = 0; n < (long long)x.size(); n++)
+                        r[n] = std::conj(x[n]);
+                },
+                [](A& x, A&, A& r, R&) { conjugate(x, r); } },
+            { "+= array", 3 * sizeof(Complex),
+                [](A& x, A& y, A&, R&) { plain_loop(x, y, x, std::plus<>()); },
+                [](A& x, A& y, A&, R&) { x += y; } },
+            { "*= scalar", 2 * sizeof(Complex),
+                [](A& x, A&, A&, R&) {
+                    for (long long n = 0; n < (long long)x.size(); n++)
+                        x[n] *= Complex(0.6f, 0.8f);
+                },
+                [](A& x, A&, A&, R&) { x *= Complex(0.6f, 0.8f); } },
+        };
+    }
+
+    template <class F> double gib_per_second(F&& f, size_t bytes, size_t repetitions) {
+        f(); // warm up, and fault in the result arrays
+        auto start = Clock::now();
+        for (size_t i = 0; i < repetitions; i++)
+            f();
+        auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return double(bytes) * repetitions / seconds / double(1u << 30);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t largest = argc > 1 ? std::stoul(argv[1]) : size_t(16) << 20;
+    auto best = SIMD::supported_level();
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+
+    std::cout << "GiB/s touched; " << threads << " threads, best SIMD level " << SIMD::to_string(best) << std::endl;
+    std::cout << std::left << std::setw(14) << "operation" << std::right << std::setw(12) << "elements"
+              << std::setw(10) << "plain" << std::setw(10) << "threads" << std::setw(10)
+              << SIMD::to_string(best) << std::endl;
+
+    for (auto& operation : operations()) {
+        for (size_t elements = 1u << 14; elements <= largest; elements *= 8) {
+            hoNDArray<Complex> x(elements), y(elements), r(elements);
+            hoNDArray<float> magnitude(elements);
+            for (size_t n = 0; n < elements; n++) {
+                x[n] = Complex(float(n % 17), 1.0f);
+                y[n] = Complex(1.0f, float(n % 5));
+            }
+
+            size_t bytes = elements * operation.bytes_per_element;
+            size_t repetitions = std::max<size_t>(3, (size_t(4) << 30) / bytes);
+            auto plain = [&]() { operation.plain(x, y, r, magnitude); };
+            auto engine = [&]() { operation.engine(x, y, r, magnitude); };
+
+            auto plain_rate = gib_per_second(plain, bytes, repetitions);
+            SIMD::set_level(SIMD::Level::none);
+            auto threaded_rate = gib_per_second(engine, bytes, repetitions);
+            SIMD::set_level(best);
+            auto simd_rate = gib_per_second(engine, bytes, repetitions);
+
+            std::cout << std::left << std::setw(14) << operation.name << std::right << std::setw(12) << elements
+                      << std::fixed << std::setprecision(2) << std::setw(10) << plain_rate << std::setw(10)
+                      << threaded_rate << std::setw(10) << simd_rate << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+//
+// Chains of element-wise operations written as calls to the hoNDArray_elemwise functions, which stream a temporary
+// through memory per step, and as a single expression, which reads each operand once. Reports the time per
+// evaluation for each chain and array size.
+//
+
+#include "hoNDArray_elemwise.h"
+#include "hoNDArray_expressions.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Gadgetron;
+using Clock = std::chrono::steady_clock;
+using Complex = std::complex<float>;
+using Array = hoNDArray<Complex>;
+
+namespace {
+
+    struct Operands {
+        Array a, b, c, r, tmp;
+        hoNDArray<float> magnitude;
+    };
+
+    struct Chain {
+        std::string name;
+        std::function<void(Operands&)> unfused;
+        std::function<void(Operands&)> fused;
+    };
+
+    std::vector<Chain> chains() {
+        const Complex alpha(0.6f, 0.8f);
+        return {
+            { "r = a*conj(b) + alpha*c",
+                [=](Operands& o) {
+                    multiplyConj(o.a, o.b, o.r);
+                    o.tmp = o.c;
+                    o.tmp *= alpha;
+                    o.r += o.tmp;
+                },
+                [=](Operands& o) { o.r = o.a * conj(o.b) + alpha * o.c; } },
+            { "r += a*conj(b)",
+                [](Operands& o) {
+                    multiplyConj(o.a, o.b, o.tmp);
+                    add(o.r, o.tmp, o.r);
+                },
+                [](Operands& o) { o.r = o.r + o.a * conj(o.b); } },
+            { "r = (a - b) * c",
+                [](Operands& o) {
+                    subtract(o.a, o.b, o.tmp);
+                    multiply(o.tmp, o.c, o.r);
+                },
+                [](Operands& o) { o.r = (o.a - o.b) * o.c; } },
+            { "m = abs(a*b)",
+                [](Operands& o) {
+                    multiply(o.a, o.b, o.tmp);
+                    for (size_t n = 0; n < o.tmp.size(); n++)
+                        o.magnitude[n] = std::abs(o.tmp[n]);
+                },
+                [](Operands& o) { o.magnitude = abs(o.a * o.b); } },
+        };
+    }
+
+    template <class F> double milliseconds(F&& f, size_t repetitions) {
+        f(); // warm up, and fault in the result arrays
+        auto start = Clock::now();
+        for (size_t i = 0; i < repetitions; i++)
+            f();
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repetitions;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t largest = argc > 1 ? std::stoul(argv[1]) : size_t(16) << 20;
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+
+    std::cout << "ms per evaluation; " << threads << " threads" << std::endl;
+    std::cout << std::left << std::setw(26) << "chain" << std::right << std::setw(12) << "elements" << std::setw(12)
+              << "unfused" << std::setw(12) << "fused" << std::endl;
+
+    for (auto& chain : chains()) {
+        for (size_t elements = 1u << 14; elements <= largest; elements *= 8) {
+            Operands operands;
+            operands.a.create(elements);
+            operands.b.create(elements);
+            operands.c.create(elements);
+            operands.r.create(elements);
+            operands.tmp.create(elements);
+            operands.magnitude.create(elements);
+            for (size_t n = 0; n < elements; n++) {
+                operands.a[n] = Complex(float(n % 17), 1.0f);
+                operands.b[n] = Complex(1.0f, float(n % 5));
+                operands.c[n] = Complex(0.5f, -0.5f);
+                operands.r[n] = Complex(0.0f, 0.0f);
+            }
+
+            size_t repetitions = std::max<size_t>(3, (size_t(256) << 20) / elements);
+            auto unfused = milliseconds([&]() { chain.unfused(operands); }, repetitions);
+            auto fused = milliseconds([&]() { chain.fused(operands); }, repetitions);
+
+            std::cout << std::left << std::setw(26) << chain.name << std::right << std::setw(12) << elements
+                      << std::fixed << std::setprecision(3) << std::setw(12) << unfused << std::setw(12) << fused
+                      << std::endl;
+        }
+    }
+    return 0;
+}
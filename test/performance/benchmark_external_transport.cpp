@@ -0,0 +1,125 @@
+//
+// Loopback round trip to an external module: arrays are written to a peer, which reads them and sends them back,
+// as a Python gadget passing images through would. Compares the TCP transport with the local (Unix socket and
+// shared memory) transport for a range of array sizes.
+//
+
+#include "connection/LocalStream.h"
+#include "connection/SocketStreamBuf.h"
+#include "hoNDArray.h"
+#include "io/primitives.h"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <complex>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace Gadgetron;
+using tcp   = boost::asio::ip::tcp;
+using local = boost::asio::local::stream_protocol;
+
+using Array = hoNDArray<std::complex<float>>;
+
+struct Streams {
+    std::unique_ptr<std::iostream> gadgetron, module;
+};
+
+Streams tcp_streams(boost::asio::io_service& ios) {
+    tcp::acceptor acceptor(ios, tcp::endpoint(tcp::v4(), 0));
+    auto port   = acceptor.local_endpoint().port();
+    auto module = std::async(std::launch::async, [&]() {
+        return Connection::remote_stream("localhost", std::to_string(port));
+    });
+
+    auto socket = std::make_unique<tcp::socket>(ios);
+    acceptor.accept(*socket);
+    return Streams{ Connection::stream_from_socket(std::move(socket)), module.get() };
+}
+
+Streams local_streams(boost::asio::io_service& ios) {
+    auto gadgetron = std::make_unique<local::socket>(ios);
+    auto module    = std::make_unique<local::socket>(ios);
+    boost::asio::local::connect_pair(*gadgetron, *module);
+
+    auto module_stream = std::async(std::launch::async, [&]() {
+        return Connection::stream_from_local_socket(std::move(module));
+    });
+    auto gadgetron_stream = Connection::stream_from_local_socket(std::move(gadgetron));
+    return Streams{ std::move(gadgetron_stream), module_stream.get() };
+}
+
+double round_trip(Streams streams, const std::vector<size_t>& dimensions, size_t count) {
+    const uint16_t image_message = 1022;
+    Array image(dimensions);
+    image.fill(std::complex<float>(1.0f, 2.0f));
+
+    auto echo = std::async(std::launch::async, [&]() {
+        Array received;
+        for (size_t i = 0; i < count; i++) {
+            auto id = Core::IO::read<uint16_t>(*streams.module);
+            Core::IO::read(*streams.module, received);
+            Core::IO::write(*streams.module, id);
+            Core::IO::write(*streams.module, received);
+            streams.module->flush();
+        }
+    });
+
+    auto start  = std::chrono::steady_clock::now();
+    auto sender = std::async(std::launch::async, [&]() {
+        for (size_t i = 0; i < count; i++) {
+            Core::IO::write(*streams.gadgetron, image_message);
+            Core::IO::write(*streams.gadgetron, image);
+            streams.gadgetron->flush();
+        }
+    });
+
+    Array result;
+    for (size_t i = 0; i < count; i++) {
+        Core::IO::read<uint16_t>(*streams.gadgetron);
+        Core::IO::read(*streams.gadgetron, result);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    sender.get();
+    echo.get();
+
+    if (result.get_number_of_elements() != image.get_number_of_elements() || result(0) != image(0))
+        throw std::runtime_error("Array was corrupted in transit");
+
+    return 2.0 * count * image.get_number_of_bytes() / elapsed / (1024.0 * 1024.0);
+}
+
+int main(int argc, char** argv) {
+    size_t total_mib = argc > 1 ? std::stoul(argv[1]) : 4096;
+    boost::asio::io_service ios;
+
+    if (!Connection::local_streams_supported()) {
+        std::cout << "Local streams are not supported on this platform." << std::endl;
+        return 0;
+    }
+
+    std::cout << "Round trip throughput, MiB/s (both directions)" << std::endl;
+    std::cout << std::setw(20) << "array" << std::setw(12) << "tcp" << std::setw(12) << "local" << std::endl;
+
+    for (auto dimensions : std::vector<std::vector<size_t>>{
+             { 128, 128 }, { 256, 256, 8 }, { 256, 256, 32 }, { 512, 512, 64 } }) {
+        size_t bytes = sizeof(std::complex<float>);
+        std::string name;
+        for (auto d : dimensions) {
+            bytes *= d;
+            name += (name.empty() ? "" : "x") + std::to_string(d);
+        }
+        auto count = std::max<size_t>(4, (total_mib << 20) / bytes);
+
+        auto tcp_throughput   = round_trip(tcp_streams(ios), dimensions, count);
+        auto local_throughput = round_trip(local_streams(ios), dimensions, count);
+
+        std::cout << std::setw(20) << name << std::fixed << std::setprecision(0) << std::setw(12) << tcp_throughput
+                  << std::setw(12) << local_throughput << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+//
+// Reconstruction throughput with raw data dumping off, dumping synchronously on the pipeline thread (as the
+// IsmrmrdDumpGadget used to), and dumping through the AsyncDatasetWriter. The reconstruction is simulated by a
+// fixed amount of work per acquisition.
+//
+
+#include "AsyncDatasetWriter.h"
+
+#include <ismrmrd/dataset.h>
+#include <ismrmrd/ismrmrd.h>
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <complex>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Gadgetron;
+using Clock = std::chrono::steady_clock;
+
+struct Scan {
+    uint16_t samples;
+    uint16_t channels;
+    size_t acquisitions;
+    std::chrono::microseconds recon;
+};
+
+enum class Dump { off, synchronous, asynchronous };
+
+struct Result {
+    double acquisitions_per_second;
+    double close_ms;
+    double file_mib;
+};
+
+static void reconstruct(const ISMRMRD::AcquisitionHeader&, const std::vector<std::complex<float>>& data,
+    std::chrono::microseconds duration) {
+    auto end = Clock::now() + duration;
+    volatile float sink = 0;
+    while (Clock::now() < end)
+        for (auto& sample : data) sink = sink + std::norm(sample);
+}
+
+static Result run(const Scan& scan, Dump dump, const std::string& filename) {
+    ISMRMRD::AcquisitionHeader header{};
+    header.number_of_samples = scan.samples;
+    header.active_channels = scan.channels;
+    header.available_channels = scan.channels;
+    std::vector<std::complex<float>> data(size_t(scan.samples) * scan.channels, { 1.0f, 2.0f });
+
+    boost::filesystem::remove(filename);
+    std::unique_ptr<ISMRMRD::Dataset> dataset;
+    std::unique_ptr<AsyncDatasetWriter> writer;
+    if (dump != Dump::off) {
+        dataset = std::make_unique<ISMRMRD::Dataset>(filename.c_str(), "dataset", true);
+        dataset->writeHeader("<ismrmrdHeader/>");
+    }
+    if (dump == Dump::asynchronous) writer = std::make_unique<AsyncDatasetWriter>(std::move(dataset), AsyncDatasetWriter::Settings{});
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < scan.acquisitions; i++) {
+        header.scan_counter = uint32_t(i);
+
+        if (dump == Dump::synchronous) {
+            ISMRMRD::Acquisition acquisition;
+            acquisition.setHead(header);
+            std::memcpy(acquisition.getDataPtr(), data.data(), data.size() * sizeof(std::complex<float>));
+            dataset->appendAcquisition(acquisition);
+        }
+        if (dump == Dump::asynchronous) {
+            auto acquisition = writer->acquisition();
+            acquisition->setHead(header);
+            std::memcpy(acquisition->getDataPtr(), data.data(), data.size() * sizeof(std::complex<float>));
+            writer->append(std::move(acquisition));
+        }
+
+        reconstruct(header, data, scan.recon);
+    }
+    auto recon_done = Clock::now();
+
+    // The file is only complete once it is closed; that is part of the cost.
+    if (writer) writer->close();
+    dataset.reset();
+    auto closed = Clock::now();
+
+    return Result{ scan.acquisitions / std::chrono::duration<double>(recon_done - start).count(),
+        std::chrono::duration<double, std::milli>(closed - recon_done).count(),
+        dump == Dump::off ? 0.0 : boost::filesystem::file_size(filename) / (1024.0 * 1024.0) };
+}
+
+int main(int argc, char** argv) {
+    Scan scan{ uint16_t(argc > 1 ? std::stoul(argv[1]) : 256), uint16_t(argc > 2 ? std::stoul(argv[2]) : 32),
+        argc > 3 ? std::stoul(argv[3]) : 20000, std::chrono::microseconds(argc > 4 ? std::stoul(argv[4]) : 50) };
+    auto filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("dump-%%%%%%.h5")).string();
+
+    std::cout << scan.acquisitions << " acquisitions of " << scan.samples << " samples by " << scan.channels
+              << " channels, " << scan.recon.count() << " us of reconstruction each" << std::endl;
+
+    for (auto mode : { std::make_pair(Dump::off, "off"), std::make_pair(Dump::synchronous, "synchronous"),
+             std::make_pair(Dump::asynchronous, "asynchronous") }) {
+        auto result = run(scan, mode.first, filename);
+        std::cout << std::left << std::setw(14) << mode.second << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << result.acquisitions_per_second << " acquisitions/s"
+                  << std::setw(10) << result.close_ms << " ms to close"
+                  << std::setw(10) << result.file_mib << " MiB written" << std::endl;
+    }
+
+    boost::filesystem::remove(filename);
+    return 0;
+}
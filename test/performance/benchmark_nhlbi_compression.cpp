@@ -0,0 +1,92 @@
+//
+// Throughput of NHLBI compression across bit widths: the previous one sample at a time packing, the portable word
+// at a time routines and the AVX2 routines.
+//
+
+#include "../../gadgets/mri_core/NHLBICompression.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace {
+
+    // Packing as it was before the bulk routines: one unaligned read-modify-write of a 64 bit word per sample.
+    void pack_per_sample(const float* values, size_t count, float scale, unsigned int bits, uint8_t* out) {
+        const uint64_t mask = (uint64_t(1) << bits) - 1;
+        for (size_t i = 0; i < count; i++) {
+            size_t sb      = (i * bits) / 8;
+            size_t upshift = i * bits - sb * 8;
+            uint64_t word;
+            memcpy(&word, out + sb, sizeof(word));
+            auto compact = static_cast<uint64_t>(static_cast<int64_t>(std::round(values[i] * scale))) & mask;
+            word         = (word & ~(mask << upshift)) | (compact << upshift);
+            memcpy(out + sb, &word, sizeof(word));
+        }
+    }
+
+    void unpack_per_sample(const uint8_t* in, size_t count, float scale, unsigned int bits, float* out) {
+        const uint64_t mask = (uint64_t(1) << bits) - 1;
+        for (size_t i = 0; i < count; i++) {
+            size_t sb      = (i * bits) / 8;
+            size_t upshift = i * bits - sb * 8;
+            uint64_t word;
+            memcpy(&word, in + sb, sizeof(word));
+            auto compact = static_cast<uint32_t>((word >> upshift) & mask);
+            out[i]       = NHLBI::sign_extend(compact, bits) / scale;
+        }
+    }
+
+    template <class F> double seconds(F&& f) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    template <class F> double samples_per_second(size_t samples, F&& f) {
+        const int repetitions = 20;
+        f();
+        double best = std::numeric_limits<double>::max();
+        for (int i = 0; i < repetitions; i++)
+            best = std::min(best, seconds(f));
+        return samples / best;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t samples = argc > 1 ? std::stoul(argv[1]) : 32 * 1024 * 2;
+
+    std::mt19937 engine(42);
+    std::normal_distribution<float> distribution(0, 100);
+    std::vector<float> input(samples);
+    for (auto& value : input)
+        value = distribution(engine);
+
+    std::vector<float> output(samples);
+    std::vector<uint8_t> stream(4 * samples + NHLBI::padding);
+
+    std::cout << "Samples: " << samples << ", AVX2: " << (NHLBI::avx2_supported() ? "yes" : "no") << std::endl;
+    std::cout << "Throughput in Msamples/s" << std::endl;
+    std::cout << std::setw(6) << "bits" << std::setw(12) << "pack old" << std::setw(12) << "portable"
+              << std::setw(12) << "simd" << std::setw(14) << "unpack old" << std::setw(12) << "portable"
+              << std::setw(12) << "simd" << std::endl;
+
+    for (unsigned int bits = 4; bits <= 32; bits += 4) {
+        float scale = float((uint64_t(1) << (bits - 1)) - 2) / 500.0f;
+
+        auto pack_old      = samples_per_second(samples, [&]() { pack_per_sample(input.data(), samples, scale, bits, stream.data()); });
+        auto pack_portable = samples_per_second(samples, [&]() { NHLBI::pack_portable(input.data(), samples, scale, bits, stream.data()); });
+        auto pack          = samples_per_second(samples, [&]() { NHLBI::pack(input.data(), samples, scale, bits, stream.data()); });
+
+        auto unpack_old      = samples_per_second(samples, [&]() { unpack_per_sample(stream.data(), samples, scale, bits, output.data()); });
+        auto unpack_portable = samples_per_second(samples, [&]() { NHLBI::unpack_portable(stream.data(), samples, scale, bits, output.data()); });
+        auto unpack          = samples_per_second(samples, [&]() { NHLBI::unpack(stream.data(), samples, scale, bits, output.data()); });
+
+        std::cout << std::fixed << std::setprecision(0) << std::setw(6) << bits << std::setw(12) << pack_old / 1e6
+                  << std::setw(12) << pack_portable / 1e6 << std::setw(12) << pack / 1e6 << std::setw(14)
+                  << unpack_old / 1e6 << std::setw(12) << unpack_portable / 1e6 << std::setw(12) << unpack / 1e6
+                  << std::endl;
+    }
+}
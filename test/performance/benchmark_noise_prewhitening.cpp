@@ -0,0 +1,91 @@
+//
+// Noise prewhitening of acquisitions [E CHA]: one full matrix product per acquisition into a temporary, as
+// NoiseAdjustGadget used to do, against apply_noise_prewhitening on one acquisition and on batches, with the upper
+// triangular prewhitener and with a full one. Reports acquisitions per second.
+//
+
+#include "cpp_blas.h"
+#include "mri_core_noise_prewhitening.h"
+
+#include <chrono>
+#include <complex>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace Gadgetron;
+using Clock = std::chrono::steady_clock;
+using Complex = std::complex<float>;
+
+namespace {
+
+    void fill(hoNDArray<Complex>& a, std::mt19937& rng) {
+        std::normal_distribution<float> dist;
+        for (auto& v : a)
+            v = Complex(dist(rng), dist(rng));
+    }
+
+    template <class F> double acquisitions_per_second(F&& f, size_t acquisitions) {
+        f();
+        size_t repetitions = 0;
+        auto start = Clock::now();
+        double elapsed = 0;
+        while (elapsed < 0.5) {
+            f();
+            repetitions++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        return acquisitions * repetitions / elapsed;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t E = argc > 1 ? std::stoul(argv[1]) : 256;
+    const size_t N = 64;
+
+    std::cout << "acquisitions per second, " << E << " samples per acquisition" << std::endl;
+    std::cout << std::setw(6) << "CHA" << std::setw(8) << "batch" << std::setw(14) << "per acq" << std::setw(14)
+              << "full" << std::setw(14) << "triangular" << std::endl;
+
+    std::mt19937 rng(42);
+    for (size_t CHA : { 8, 16, 32, 64 }) {
+        std::vector<hoNDArray<Complex>> acquisitions(N, hoNDArray<Complex>(E, CHA));
+        for (auto& acq : acquisitions)
+            fill(acq, rng);
+
+        hoNDArray<Complex> full(CHA, CHA), triangular(CHA, CHA);
+        fill(full, rng);
+        triangular = full;
+        for (size_t c = 0; c < CHA; c++)
+            for (size_t r = c + 1; r < CHA; r++)
+                triangular(r, c) = 0;
+
+        // the previous per acquisition path: a full product into a temporary, copied back
+        auto per_acquisition = acquisitions_per_second(
+            [&]() {
+                hoNDArray<Complex> res(E, CHA);
+                BLAS::gemm(false, false, E, CHA, CHA, Complex(1), acquisitions[0].begin(), E, full.begin(), CHA,
+                    Complex(0), res.begin(), E);
+                std::memcpy(acquisitions[0].begin(), res.begin(), res.get_number_of_bytes());
+            },
+            1);
+
+        for (size_t batch : { 1, 8, 64 }) {
+            std::vector<hoNDArray<Complex>*> data;
+            for (size_t n = 0; n < batch; n++)
+                data.push_back(&acquisitions[n]);
+
+            hoNDArray<Complex> buf;
+            auto batched_full = acquisitions_per_second([&]() { apply_noise_prewhitening(data, full, buf); }, batch);
+            auto batched_triangular
+                = acquisitions_per_second([&]() { apply_noise_prewhitening(data, triangular, buf); }, batch);
+
+            std::cout << std::setw(6) << CHA << std::setw(8) << batch << std::fixed << std::setprecision(0)
+                      << std::setw(14) << per_acquisition << std::setw(14) << batched_full << std::setw(14)
+                      << batched_triangular << std::endl;
+        }
+    }
+    return 0;
+}
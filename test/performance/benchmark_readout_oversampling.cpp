@@ -0,0 +1,116 @@
+//
+// Readout oversampling removal as RemoveROOversamplingGadget used to do it, one readout at a time (ifft1c, crop,
+// fft1c), against transforming a batch of readouts together and against the half-band FIR decimator, for 2x
+// oversampling. Reports readouts per second and the error of the FIR decimator relative to the exact crop, over the
+// whole field of view and over its central 80%.
+//
+
+#include "hoNDFFT.h"
+#include "mri_core_readout_oversampling.h"
+
+#include <chrono>
+#include <complex>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace Gadgetron;
+using Clock = std::chrono::steady_clock;
+using Complex = std::complex<float>;
+
+namespace {
+
+    // [RO CHA N] readouts of an object covering 80% of the oversampled field of view
+    hoNDArray<Complex> readouts(size_t RO, size_t CHA, size_t N) {
+        hoNDArray<Complex> im(RO, CHA, N);
+        std::mt19937 rng(42);
+        std::normal_distribution<float> noise(0, 0.01f);
+        for (size_t n = 0; n < CHA * N; n++) {
+            for (size_t ro = 0; ro < RO; ro++) {
+                float x = (float(ro) - RO / 2) / (RO / 2);
+                float object = std::abs(x) < 0.8f ? 1.0f : 0.0f;
+                im[ro + n * RO] = Complex(object * (1 + 0.5f * std::cos(7 * x + n)), object * 0.3f * std::sin(11 * x))
+                                  + Complex(noise(rng), noise(rng));
+            }
+        }
+        hoNDArray<Complex> data;
+        hoNDFFT<float>::instance()->fft1c(im, data);
+        return data;
+    }
+
+    template <class F> double readouts_per_second(F&& f, size_t readouts) {
+        f(); // warm up, and create the plans
+        size_t repetitions = 0;
+        auto start = Clock::now();
+        double elapsed = 0;
+        while (elapsed < 0.5) {
+            f();
+            repetitions++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        return readouts * repetitions / elapsed;
+    }
+
+    // relative RMS error of b against a in the image domain, over the central fraction of every readout
+    double relative_error(const hoNDArray<Complex>& a, const hoNDArray<Complex>& b, double fraction) {
+        hoNDArray<Complex> a_im, b_im;
+        hoNDFFT<float>::instance()->ifft1c(a, a_im);
+        hoNDFFT<float>::instance()->ifft1c(b, b_im);
+        size_t M = a.get_size(0);
+        size_t margin = size_t(M * (1 - fraction) / 2);
+        double error = 0, signal = 0;
+        for (size_t n = 0; n < a.get_number_of_elements() / M; n++) {
+            for (size_t ro = margin; ro < M - margin; ro++) {
+                error += std::norm(a_im[ro + n * M] - b_im[ro + n * M]);
+                signal += std::norm(a_im[ro + n * M]);
+            }
+        }
+        return std::sqrt(error / signal);
+    }
+}
+
+int main() {
+    const size_t N = 64; // readouts per batch
+
+    std::cout << "readouts per second; batches of " << N << " readouts" << std::endl;
+    std::cout << std::setw(6) << "RO" << std::setw(6) << "CHA" << std::setw(14) << "per readout" << std::setw(14)
+              << "batched" << std::setw(14) << "fir" << std::setw(14) << "fir batched" << std::setw(12) << "fir err"
+              << std::setw(12) << "central" << std::endl;
+
+    for (size_t RO : { 256, 512 }) {
+        for (size_t CHA : { 16, 32, 64 }) {
+            auto data = readouts(RO, CHA, N);
+            size_t M = RO / 2;
+
+            // one readout at a time, as the gadget did before batching
+            hoNDArray<Complex> line(RO, CHA), image, image_buf, cropped(M, CHA), fft_res, fft_buf;
+            std::memcpy(line.begin(), data.begin(), sizeof(Complex) * RO * CHA);
+            auto per_readout = readouts_per_second(
+                [&]() {
+                    hoNDFFT<float>::instance()->ifft1c(line, image, image_buf);
+                    for (size_t c = 0; c < CHA; c++)
+                        std::memcpy(cropped.begin() + c * M, image.begin() + c * RO + M / 2, sizeof(Complex) * M);
+                    hoNDFFT<float>::instance()->fft1c(cropped, fft_res, fft_buf);
+                    std::memcpy(cropped.begin(), fft_res.begin(), fft_res.get_number_of_bytes());
+                },
+                1);
+
+            hoNDArray<Complex> exact;
+            auto batched = readouts_per_second([&]() { remove_readout_oversampling(data, RO / 4, M, exact); }, N);
+
+            hoNDArray<Complex> filter, fir, fir_line;
+            generate_readout_decimation_filter(RO, 16, filter);
+            auto fir_single = readouts_per_second([&]() { decimate_readout(line, filter, fir_line); }, 1);
+            auto fir_batched = readouts_per_second([&]() { decimate_readout(data, filter, fir); }, N);
+
+            std::cout << std::setw(6) << RO << std::setw(6) << CHA << std::fixed << std::setprecision(0)
+                      << std::setw(14) << per_readout << std::setw(14) << batched << std::setw(14) << fir_single
+                      << std::setw(14) << fir_batched << std::scientific << std::setprecision(1) << std::setw(12)
+                      << relative_error(exact, fir, 1.0) << std::setw(12) << relative_error(exact, fir, 0.8)
+                      << std::endl;
+        }
+    }
+    return 0;
+}
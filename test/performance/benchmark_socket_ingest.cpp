@@ -0,0 +1,100 @@
+//
+// Loopback ingest throughput: a sender streams serialized acquisitions over TCP, and the receiver parses them
+// with the AcquisitionReader, as the connection input thread would. Compares the default and throughput socket
+// ingest modes.
+//
+
+#include "MessageID.h"
+#include "connection/SocketStreamBuf.h"
+#include "io/primitives.h"
+#include "readers/AcquisitionReader.h"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <complex>
+#include <future>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace Gadgetron;
+using tcp = boost::asio::ip::tcp;
+
+std::vector<char> serialize_acquisitions(size_t samples, size_t channels, size_t count) {
+    std::stringstream stream;
+    ISMRMRD::AcquisitionHeader header{};
+    header.number_of_samples = samples;
+    header.active_channels   = channels;
+    header.available_channels = channels;
+
+    auto data = std::vector<std::complex<float>>(samples * channels, std::complex<float>(1.0f, -1.0f));
+    for (size_t i = 0; i < count; i++) {
+        header.scan_counter = i;
+        Core::IO::write(stream, uint16_t(Core::MessageID::GADGET_MESSAGE_ISMRMRD_ACQUISITION));
+        Core::IO::write(stream, header);
+        Core::IO::write(stream, data.data(), data.size());
+    }
+
+    auto serialized = stream.str();
+    return std::vector<char>(serialized.begin(), serialized.end());
+}
+
+double time_ingest(const Connection::SocketOptions& options, const std::vector<char>& block, size_t block_count,
+    size_t acquisitions_per_block) {
+
+    boost::asio::io_service ios;
+    tcp::acceptor acceptor(ios, tcp::endpoint(tcp::v4(), 0));
+    auto port = acceptor.local_endpoint().port();
+
+    auto sender = std::async(std::launch::async, [&]() {
+        tcp::socket socket{ ios };
+        acceptor.accept(socket);
+        for (size_t i = 0; i < block_count; i++)
+            boost::asio::write(socket, boost::asio::buffer(block.data(), block.size()));
+    });
+
+    auto stream = Connection::remote_stream("localhost", std::to_string(port), options);
+    Core::Readers::AcquisitionReader reader;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t acquisitions = block_count * acquisitions_per_block;
+    for (size_t i = 0; i < acquisitions; i++) {
+        auto id = Core::IO::read<uint16_t>(*stream);
+        if (id != Core::MessageID::GADGET_MESSAGE_ISMRMRD_ACQUISITION) {
+            std::cerr << "Unexpected message id " << id << std::endl;
+            return 0;
+        }
+        auto message = reader.read(*stream);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    sender.get();
+
+    return acquisitions / std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t block_count = argc > 1 ? std::stoul(argv[1]) : 200;
+
+    for (auto [samples, channels] : std::vector<std::pair<size_t, size_t>>{ { 256, 8 }, { 512, 32 } }) {
+        const size_t acquisitions_per_block = 64;
+        auto block = serialize_acquisitions(samples, channels, acquisitions_per_block);
+        auto bytes_per_acquisition = double(block.size()) / acquisitions_per_block;
+
+        std::cout << "Acquisitions of " << samples << " samples x " << channels << " channels ("
+                  << bytes_per_acquisition / 1024 << " KiB)" << std::endl;
+
+        for (auto [name, options] : std::vector<std::pair<std::string, Connection::SocketOptions>>{
+                 { "default   ", Connection::SocketOptions{} },
+                 { "throughput", Connection::SocketOptions::ingest() } }) {
+            auto rate = time_ingest(options, block, block_count, acquisitions_per_block);
+            std::cout << "  " << name << " " << rate << " acquisitions/s, "
+                      << rate * bytes_per_acquisition / (1 << 20) << " MiB/s" << std::endl;
+        }
+    }
+
+    return 0;
+}
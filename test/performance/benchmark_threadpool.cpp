@@ -0,0 +1,129 @@
+//
+// Many tiny tasks through the work-stealing ThreadPool, compared against the previous single-queue pool.
+//
+
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace Gadgetron::Core;
+
+namespace {
+
+    // The pool as it was before work stealing: one MPMCChannel shared by all workers and a heap allocated
+    // task plus promise per submission.
+    class SingleQueueThreadPool {
+        class Work {
+        public:
+            virtual void execute() = 0;
+            virtual ~Work()        = default;
+        };
+
+        template <class F> class ConcreteWork : public Work {
+        public:
+            explicit ConcreteWork(F f) : f{ std::move(f) } {}
+            void execute() override {
+                try {
+                    f();
+                    promise.set_value();
+                } catch (...) {
+                    promise.set_exception(std::current_exception());
+                }
+            }
+            F f;
+            std::promise<void> promise;
+        };
+
+    public:
+        explicit SingleQueueThreadPool(unsigned int workers) {
+            for (auto i = 0u; i < workers; i++) {
+                threads.emplace_back([this]() {
+                    try {
+                        while (true)
+                            this->work_queue.pop()->execute();
+                    } catch (const ChannelClosed&) {
+                    }
+                });
+            }
+        }
+
+        template <class F> std::future<void> async(F f) {
+            auto work   = std::make_unique<ConcreteWork<F>>(std::move(f));
+            auto future = work->promise.get_future();
+            work_queue.push(std::move(work));
+            return future;
+        }
+
+        void join() {
+            work_queue.close();
+            for (auto& thread : threads)
+                thread.join();
+        }
+
+    private:
+        MPMCChannel<std::unique_ptr<Work>> work_queue;
+        std::vector<std::thread> threads;
+    };
+
+    template <class F> double seconds(F&& f) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    std::atomic<size_t> counter{ 0 };
+    void tiny_task() { counter.fetch_add(1, std::memory_order_relaxed); }
+}
+
+int main(int argc, char** argv) {
+    unsigned int workers = argc > 1 ? std::stoul(argv[1]) : std::thread::hardware_concurrency();
+    std::cout << "Workers: " << workers << std::endl;
+
+    for (size_t tasks : { 10000, 100000, 1000000 }) {
+        std::cout << "Tasks: " << tasks << std::endl;
+
+        {
+            SingleQueueThreadPool pool{ workers };
+            std::vector<std::future<void>> futures;
+            futures.reserve(tasks);
+            auto time = seconds([&]() {
+                for (size_t i = 0; i < tasks; i++)
+                    futures.push_back(pool.async(tiny_task));
+                for (auto& future : futures)
+                    future.get();
+            });
+            pool.join();
+            std::cout << "  Single queue async   " << tasks / time << " tasks/s" << std::endl;
+        }
+
+        {
+            ThreadPool pool{ workers };
+            std::vector<std::future<void>> futures;
+            futures.reserve(tasks);
+            auto time = seconds([&]() {
+                for (size_t i = 0; i < tasks; i++)
+                    futures.push_back(pool.async(tiny_task));
+                for (auto& future : futures)
+                    future.get();
+            });
+            pool.join();
+            std::cout << "  Work stealing async  " << tasks / time << " tasks/s" << std::endl;
+        }
+
+        {
+            ThreadPool pool{ workers };
+            auto time = seconds([&]() { parallel_for(pool, 0, tasks, [](size_t) { tiny_task(); }, 1); });
+            pool.join();
+            std::cout << "  parallel_for grain 1 " << tasks / time << " tasks/s" << std::endl;
+        }
+
+        {
+            ThreadPool pool{ workers };
+            auto time = seconds([&]() { parallel_for(pool, 0, tasks, [](size_t) { tiny_task(); }); });
+            pool.join();
+            std::cout << "  parallel_for         " << tasks / time << " tasks/s" << std::endl;
+        }
+    }
+}
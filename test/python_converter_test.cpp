@@ -166,6 +166,53 @@ TEST_F(python_converter_test, numpy_hoNDArray_three_outputs)
     EXPECT_FLOAT_EQ(c[20], 255);
 }
 
+TEST_F(python_converter_test, numpy_hoNDArray_view)
+{
+    GDEBUG_STREAM(" --------------------------------------------------------------------------------------------------");
+    GDEBUG_STREAM("Test handing hoNDArray storage to numpy and adopting it back without copies");
+    {
+        GILLock gl;     // this is needed
+        boost::python::object main(boost::python::import("__main__"));
+        boost::python::object global(main.attr("__dict__"));
+        boost::python::exec("import numpy as np\n"
+            "def scale_in_place(a): \n"
+            "   a *= 2\n"
+            "   return a\n"
+            "def is_writeable(a): \n"
+            "   return a.flags.writeable\n"
+            "def transpose(a): \n"
+            "   return a.T\n",
+            global, global);
+    }
+
+    hoNDArray<float> a(32, 64);
+    Gadgetron::fill(a, float(45));
+    const float* storage = a.get_data_ptr();
+
+    PythonFunction<hoNDArray<float>> scale_in_place("__main__", "scale_in_place");
+    scale_in_place.set_numpy_conversion(NumPyConversion::view);
+    hoNDArray<float> b = scale_in_place(std::move(a));
+
+    EXPECT_EQ(b.get_data_ptr(), storage);
+    EXPECT_EQ(b.get_size(0), 32);
+    EXPECT_EQ(b.get_size(1), 64);
+    EXPECT_FLOAT_EQ(b[12], 90);
+
+    // Arrays passed by reference are only lent to Python
+    PythonFunction<bool> is_writeable("__main__", "is_writeable");
+    is_writeable.set_numpy_conversion(NumPyConversion::view);
+    EXPECT_FALSE(is_writeable(b));
+    EXPECT_TRUE(is_writeable(hoNDArray<float>(b)));
+
+    // A C-ordered result is copied into Fortran order
+    PythonFunction<hoNDArray<float>> transpose("__main__", "transpose");
+    transpose.set_numpy_conversion(NumPyConversion::view);
+    hoNDArray<float> c = transpose(b);
+    EXPECT_NE(c.get_data_ptr(), b.get_data_ptr());
+    EXPECT_EQ(c.get_size(0), 64);
+    EXPECT_FLOAT_EQ(c(1, 0), b(0, 1));
+}
+
 TEST_F(python_converter_test, ismrmrd_acquisitionheader)
 {
     {
@@ -0,0 +1,83 @@
+#include "mri_core_readout_oversampling.h"
+#include "hoNDFFT.h"
+
+#include <gtest/gtest.h>
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace Gadgetron;
+using testing::Types;
+
+template <typename T> class readout_oversampling_Test : public ::testing::Test {
+protected:
+  typedef typename realType<T>::Type REAL;
+
+  // Readouts [RO CHA N] of a smooth object covering 80% of the oversampled field of view, plus a little noise
+  hoNDArray<T> readouts(size_t RO, size_t CHA, size_t N) {
+    hoNDArray<T> im(RO, CHA, N);
+    std::mt19937 rng(11);
+    std::normal_distribution<REAL> noise(0, REAL(0.01));
+    for (size_t n = 0; n < CHA * N; n++) {
+      for (size_t ro = 0; ro < RO; ro++) {
+        REAL x = (REAL(ro) - RO / 2) / (RO / 2);
+        REAL object = std::abs(x) < REAL(0.8) ? REAL(1) : REAL(0);
+        im[ro + n * RO] = T(object * (1 + REAL(0.5) * std::cos(7 * x + n)), object * REAL(0.3) * std::sin(11 * x))
+                          + T(noise(rng), noise(rng));
+      }
+    }
+    hoNDArray<T> data;
+    hoNDFFT<REAL>::instance()->fft1c(im, data);
+    return data;
+  }
+};
+
+typedef Types<std::complex<float>, std::complex<double>> cplxTypes;
+
+TYPED_TEST_SUITE(readout_oversampling_Test, cplxTypes);
+
+TYPED_TEST(readout_oversampling_Test,batchMatchesSingleReadouts){
+  size_t RO = 256, CHA = 4, N = 6;
+  auto data = this->readouts(RO, CHA, N);
+
+  hoNDArray<TypeParam> batch;
+  remove_readout_oversampling(data, RO / 4, RO / 2, batch);
+  ASSERT_EQ(batch.get_size(0), RO / 2);
+  ASSERT_EQ(batch.get_size(2), N);
+
+  // The readout image buffer is reused between the single readouts, as the gadget does
+  hoNDArray<TypeParam> buf;
+  for (size_t n = 0; n < N; n++) {
+    hoNDArray<TypeParam> single(RO, CHA), res;
+    std::copy(data.begin() + n * RO * CHA, data.begin() + (n + 1) * RO * CHA, single.begin());
+    remove_readout_oversampling(single, RO / 4, RO / 2, res, buf);
+    for (size_t i = 0; i < res.get_number_of_elements(); i++)
+      EXPECT_EQ(res[i], batch[i + n * res.get_number_of_elements()]);
+  }
+}
+
+TYPED_TEST(readout_oversampling_Test,firMatchesCropInsideFieldOfView){
+  typedef typename realType<TypeParam>::Type REAL;
+  size_t RO = 512, CHA = 4, N = 2, M = RO / 2;
+  auto data = this->readouts(RO, CHA, N);
+
+  hoNDArray<TypeParam> exact, filter, fir;
+  remove_readout_oversampling(data, RO / 4, M, exact);
+  generate_readout_decimation_filter(RO, 16, filter);
+  decimate_readout(data, filter, fir);
+  ASSERT_TRUE(fir.dimensions_equal(&exact));
+
+  // The filter only approximates the crop close to the edges of the field of view, so compare the central 80%
+  hoNDArray<TypeParam> exact_im, fir_im;
+  hoNDFFT<REAL>::instance()->ifft1c(exact, exact_im);
+  hoNDFFT<REAL>::instance()->ifft1c(fir, fir_im);
+
+  double error = 0, signal = 0;
+  for (size_t n = 0; n < CHA * N; n++) {
+    for (size_t ro = M / 10; ro < M - M / 10; ro++) {
+      error += std::norm(exact_im[ro + n * M] - fir_im[ro + n * M]);
+      signal += std::norm(exact_im[ro + n * M]);
+    }
+  }
+  EXPECT_LT(std::sqrt(error / signal), 1e-4);
+}
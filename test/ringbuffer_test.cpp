@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "Channel.h"
+#include "RingBuffer.h"
+
+#include <numeric>
+#include <thread>
+
+using namespace Gadgetron::Core;
+
+template <class T> class RingBufferTest : public ::testing::Test {};
+
+using RingBufferTypes = ::testing::Types<MPMCRingBuffer<std::unique_ptr<int>>, SPSCRingBuffer<std::unique_ptr<int>>>;
+TYPED_TEST_SUITE(RingBufferTest, RingBufferTypes);
+
+TYPED_TEST(RingBufferTest, fifo) {
+    TypeParam channel{ 8 };
+    for (int i = 0; i < 8; i++)
+        channel.push(std::make_unique<int>(i));
+
+    for (int i = 0; i < 8; i++)
+        EXPECT_EQ(*channel.pop(), i);
+
+    EXPECT_FALSE(channel.try_pop());
+}
+
+TYPED_TEST(RingBufferTest, bounded) {
+    TypeParam channel{ 4 };
+    EXPECT_EQ(channel.capacity(), 4u);
+
+    for (int i = 0; i < 4; i++) {
+        auto value = std::make_unique<int>(i);
+        EXPECT_TRUE(channel.try_push(value));
+    }
+
+    auto value = std::make_unique<int>(4);
+    EXPECT_FALSE(channel.try_push(value));
+    EXPECT_TRUE(value);
+    EXPECT_EQ(channel.size(), 4u);
+}
+
+TYPED_TEST(RingBufferTest, closeDrains) {
+    TypeParam channel{ 4 };
+    channel.push(std::make_unique<int>(1));
+    channel.push(std::make_unique<int>(2));
+    channel.close();
+
+    EXPECT_THROW(channel.push(std::make_unique<int>(3)), ChannelClosed);
+    EXPECT_EQ(*channel.pop(), 1);
+    EXPECT_EQ(*channel.pop(), 2);
+    EXPECT_THROW(channel.pop(), ChannelClosed);
+}
+
+TYPED_TEST(RingBufferTest, closeWakesBlockedProducer) {
+    TypeParam channel{ 2, 16 };
+    channel.push(std::make_unique<int>(1));
+    channel.push(std::make_unique<int>(2));
+
+    auto producer = std::thread([&]() { EXPECT_THROW(channel.push(std::make_unique<int>(3)), ChannelClosed); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    channel.close();
+    producer.join();
+}
+
+TYPED_TEST(RingBufferTest, backpressure) {
+    TypeParam channel{ 16, 16 };
+    const int count = 100000;
+
+    auto producer = std::thread([&]() {
+        for (int i = 0; i < count; i++)
+            channel.push(std::make_unique<int>(i));
+        channel.close();
+    });
+
+    int expected = 0;
+    try {
+        while (true) {
+            EXPECT_EQ(*channel.pop(), expected);
+            expected++;
+        }
+    } catch (const ChannelClosed&) {
+    }
+    producer.join();
+    EXPECT_EQ(expected, count);
+}
+
+TEST(RingBufferTest, multipleProducersAndConsumers) {
+    MPMCRingBuffer<long> channel{ 64, 16 };
+    const long per_producer = 50000;
+    const int producers     = 4;
+    const int consumers     = 4;
+
+    std::vector<std::thread> producer_threads;
+    for (int p = 0; p < producers; p++)
+        producer_threads.emplace_back([&, p]() {
+            for (long i = 0; i < per_producer; i++)
+                channel.push(p * per_producer + i);
+        });
+
+    std::vector<long> sums(consumers, 0);
+    std::vector<std::thread> consumer_threads;
+    for (int c = 0; c < consumers; c++)
+        consumer_threads.emplace_back([&, c]() {
+            try {
+                while (true)
+                    sums[c] += channel.pop();
+            } catch (const ChannelClosed&) {
+            }
+        });
+
+    for (auto& thread : producer_threads)
+        thread.join();
+    channel.close();
+    for (auto& thread : consumer_threads)
+        thread.join();
+
+    long total = producers * per_producer;
+    EXPECT_EQ(std::accumulate(sums.begin(), sums.end(), 0l), total * (total - 1) / 2);
+}
+
+TEST(RingBufferTest, messageChannel) {
+    auto channel = make_channel<BoundedMessageChannel>(4);
+
+    channel.output.push(std::string("Penguins"), int(4));
+    auto message = channel.input.pop();
+    EXPECT_TRUE((convertible_to<std::string, int>(message)));
+
+    channel.output.push(std::string("Are"));
+    auto spsc = make_channel<SPSCMessageChannel>(4);
+    spsc.output.push_message(channel.input.pop());
+    EXPECT_EQ(force_unpack<std::string>(spsc.input.pop()), "Are");
+    EXPECT_FALSE(spsc.input.try_pop());
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "Channel.h"
+#include "Telemetry.h"
+
+#include <thread>
+
+using namespace Gadgetron::Core;
+using namespace std::chrono_literals;
+
+TEST(TelemetryTest, histogramQuantiles) {
+    Telemetry::Histogram histogram;
+    for (int i = 0; i < 90; i++)
+        histogram.record(3us);
+    for (int i = 0; i < 10; i++)
+        histogram.record(1000us);
+
+    EXPECT_EQ(histogram.count(), 100u);
+    EXPECT_EQ(histogram.quantile(0.5), 4us);
+    EXPECT_EQ(histogram.quantile(0.9), 4us);
+    EXPECT_EQ(histogram.quantile(0.99), 1024us);
+
+    histogram.record(1h);
+    EXPECT_EQ(histogram.counts().back(), 1u);
+}
+
+TEST(TelemetryTest, channelCounters) {
+    auto channel    = make_channel<MessageChannel>();
+    auto statistics = std::make_shared<Telemetry::ChannelStatistics>();
+    channel.output.instrument(statistics, nullptr);
+    channel.input.instrument(statistics, nullptr);
+
+    for (int i = 0; i < 5; i++)
+        channel.output.push(std::string("Penguins"));
+    EXPECT_EQ(statistics->depth, 5);
+
+    channel.input.pop();
+    channel.input.pop();
+
+    EXPECT_EQ(statistics->messages, 5u);
+    EXPECT_EQ(statistics->bytes, 5 * sizeof(std::string));
+    EXPECT_EQ(statistics->depth, 3);
+    EXPECT_EQ(statistics->max_depth, 5);
+}
+
+TEST(TelemetryTest, nodeCounters) {
+    auto channel    = make_channel<MessageChannel>();
+    auto statistics = std::make_shared<Telemetry::NodeStatistics>();
+    channel.input.instrument(nullptr, statistics);
+
+    auto producer = std::thread([&]() {
+        std::this_thread::sleep_for(20ms);
+        channel.output.push(1);
+        channel.output.push(2);
+        auto closing = std::move(channel.output);
+    });
+
+    channel.input.pop();
+    std::this_thread::sleep_for(10ms);
+    channel.input.pop();
+    EXPECT_THROW(channel.input.pop(), ChannelClosed);
+    producer.join();
+
+    EXPECT_EQ(statistics->messages, 2u);
+    EXPECT_EQ(statistics->latency.count(), 2u);
+    EXPECT_GE(statistics->input_wait(), 15ms);
+    EXPECT_GE(statistics->busy(), 10ms);
+    EXPECT_GE(statistics->latency.quantile(1.0), 8ms);
+}
+
+TEST(TelemetryTest, registry) {
+    auto& registry = Telemetry::Registry::instance();
+    auto node      = std::make_shared<Telemetry::NodeStatistics>();
+    auto channel   = std::make_shared<Telemetry::ChannelStatistics>();
+    registry.add("test/\"quoted\"", node);
+    registry.add("test/a -> b", channel);
+
+    auto json = registry.json();
+    EXPECT_NE(json.find("\"name\":\"test/\\\"quoted\\\"\""), std::string::npos);
+    EXPECT_NE(registry.summary().find("channel test/a -> b"), std::string::npos);
+
+    node.reset();
+    channel.reset();
+    EXPECT_EQ(registry.json().find("test/"), std::string::npos);
+}
+
+TEST(TelemetryTest, registryDropsExpiredEntriesOnAdd) {
+    auto& registry = Telemetry::Registry::instance();
+    auto before    = registry.size();
+
+    for (int i = 0; i < 100; i++) {
+        registry.add("test/expired", std::make_shared<Telemetry::NodeStatistics>());
+        registry.add("test/expired", std::make_shared<Telemetry::ChannelStatistics>());
+    }
+    EXPECT_LE(registry.size(), before + 2);
+}
@@ -4,6 +4,7 @@
 
 #include <gtest/gtest.h>
 #include "ThreadPool.h"
+#include "ThreadPoolBlocks.h"
 
 using namespace Gadgetron::Core;
 TEST(ThreadPoolTest,VoidTest){
@@ -24,3 +25,46 @@ TEST(ThreadPoolTest,moveTest){
     pool.join();
 
 }
+
+TEST(ThreadPoolTest,exceptionTest){
+    ThreadPool pool{2};
+    auto return_value = pool.async([](){ throw std::runtime_error("Penguins"); });
+    EXPECT_THROW(return_value.get(),std::runtime_error);
+    pool.join();
+}
+
+TEST(ThreadPoolTest,parallelForTest){
+    ThreadPool pool{4};
+    std::vector<size_t> values(100000, 0);
+    parallel_for(pool, 0, values.size(), [&](size_t i){ values[i] = i; });
+    for (size_t i = 0; i < values.size(); i++) ASSERT_EQ(values[i], i);
+
+    EXPECT_THROW(parallel_for(pool, 0, 1000, [](size_t i){ if (i == 500) throw std::runtime_error("Cats"); }),
+                 std::runtime_error);
+}
+
+TEST(ThreadPoolTest,nestedParallelForTest){
+    ThreadPool pool{2};
+    std::atomic<long> total{0};
+    parallel_for(pool, 0, 64, [&](size_t){
+        parallel_for(pool, 0, 1000, [&](size_t){ total++; });
+    });
+    EXPECT_EQ(total, 64000);
+}
+
+TEST(ThreadPoolTest,parallelReduceTest){
+    ThreadPool pool{4};
+    auto sum = parallel_reduce(pool, 0, 1001, 0l, [](size_t i){ return long(i); }, std::plus<long>());
+    EXPECT_EQ(sum, 500500);
+}
+
+TEST(ThreadPoolTest,parallelForEachBlockTest){
+    ThreadPool pool{4};
+    Gadgetron::hoNDArray<float> array(8, 16, 4);
+    parallel_for_each_block(pool, array, 2, [](auto& block, size_t index){
+        EXPECT_EQ(block.get_number_of_elements(), 8*16);
+        std::fill(block.begin(), block.end(), float(index));
+    });
+    EXPECT_EQ(array(0, 0, 0), 0.0f);
+    EXPECT_EQ(array(7, 15, 3), 3.0f);
+}
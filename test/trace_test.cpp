@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "trace.h"
+#include "Channel.h"
+#include "Telemetry.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace Gadgetron;
+
+namespace {
+    std::string read_file(const std::string& filename) {
+        std::ifstream file(filename);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    size_t occurrences(const std::string& text, const std::string& pattern) {
+        size_t count = 0;
+        for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+            count++;
+        return count;
+    }
+
+    std::string temporary_filename() {
+        return (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("trace-%%%%%%%%.json")).string();
+    }
+}
+
+TEST(TraceTest, inactiveWithoutSession) {
+    EXPECT_FALSE(Trace::active());
+    Trace::Span span("nowhere");
+    EXPECT_EQ(Trace::current_session(), nullptr);
+}
+
+TEST(TraceTest, scopesNestAndRestore) {
+    auto outer = std::make_shared<Trace::Session>(temporary_filename());
+    auto inner = std::make_shared<Trace::Session>(temporary_filename());
+    {
+        Trace::SessionScope outer_scope(outer);
+        {
+            Trace::SessionScope inner_scope(inner);
+            EXPECT_EQ(Trace::current_session(), inner);
+        }
+        EXPECT_EQ(Trace::current_session(), outer);
+    }
+    EXPECT_FALSE(Trace::active());
+
+    auto filenames = std::vector<std::string>{outer->filename(), inner->filename()};
+    outer.reset();
+    inner.reset();
+    for (auto& filename : filenames) boost::filesystem::remove(filename);
+}
+
+TEST(TraceTest, writesSpansFromAllThreads) {
+    auto filename = temporary_filename();
+    {
+        auto session = std::make_shared<Trace::Session>(filename);
+        Trace::SessionScope scope(session);
+        Trace::name_thread("main \"thread\"");
+
+        { Trace::Span span("outer"); Trace::Span nested("inner"); }
+
+        auto worker = std::thread([session]() {
+            Trace::SessionScope scope(session);
+            Trace::name_thread("worker");
+            for (int i = 0; i < 5000; i++) Trace::Span span("work");
+        });
+        worker.join();
+    }
+
+    auto trace = read_file(filename);
+    boost::filesystem::remove(filename);
+
+    ASSERT_EQ(trace.find("{\"traceEvents\":["), 0u);
+    EXPECT_EQ(occurrences(trace, "\"name\":\"outer\""), 1u);
+    EXPECT_EQ(occurrences(trace, "\"name\":\"inner\""), 1u);
+    EXPECT_EQ(occurrences(trace, "\"name\":\"work\""), 5000u);
+    EXPECT_EQ(occurrences(trace, "\"ph\":\"X\""), 5002u);
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"main \\\"thread\\\"\"}"), std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"worker\"}"), std::string::npos);
+    EXPECT_EQ(occurrences(trace, "{"), occurrences(trace, "}"));
+}
+
+TEST(TraceTest, nodeSpansFromTelemetry) {
+    auto filename = temporary_filename();
+    {
+        auto session = std::make_shared<Trace::Session>(filename);
+        Trace::SessionScope scope(session);
+
+        auto channel    = Core::make_channel<Core::MessageChannel>();
+        auto statistics = std::make_shared<Core::Telemetry::NodeStatistics>();
+        statistics->name = "PenguinGadget";
+        channel.input.instrument(nullptr, statistics);
+
+        channel.output.push(1);
+        channel.output.push(2);
+        channel.input.pop();
+        channel.input.pop();
+        channel.input.try_pop();
+    }
+
+    auto trace = read_file(filename);
+    boost::filesystem::remove(filename);
+    EXPECT_EQ(occurrences(trace, "\"name\":\"PenguinGadget\""), 2u);
+}
@@ -15,6 +15,7 @@
 
 #include <string>
 #include "log.h"
+#include "trace.h"
 
 namespace Gadgetron{
 
@@ -66,6 +67,7 @@ namespace Gadgetron{
 #else
         gettimeofday(&start_, NULL);
 #endif
+        trace_start_ = Trace::Clock::now();
     }
 
     void start(const char* name)
@@ -85,6 +87,7 @@ namespace Gadgetron{
         time_in_us = ((end_.tv_sec * 1e6) + end_.tv_usec) - ((start_.tv_sec * 1e6) + start_.tv_usec);
 #endif
 	GDEBUG("%s:%f ms\n", name_.c_str(), time_in_us/1000.0);
+        Trace::record(name_, trace_start_, Trace::Clock::now());
         return time_in_us;
     }
 
@@ -103,6 +106,9 @@ namespace Gadgetron{
 
     std::string name_;
 
+    // The timed interval also becomes a span in the current trace, if any.
+    Trace::Clock::time_point trace_start_;
+
     bool timing_in_destruction_;
   };
 }
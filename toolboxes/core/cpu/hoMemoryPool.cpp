@@ -0,0 +1,329 @@
+#include "hoMemoryPool.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace Gadgetron {
+
+    namespace {
+
+        // Four size classes per power of two, from 64 bytes up to 256 MiB. Larger blocks are not recycled.
+        constexpr size_t number_of_classes    = 89;
+        constexpr uint32_t unpooled_class     = UINT32_MAX;
+        constexpr uint32_t block_magic        = 0x9ade7a11;
+
+        // The per-thread cache holds a few blocks of each class up to 1 MiB.
+        constexpr size_t thread_cached_classes = 57;
+        constexpr size_t thread_cache_depth    = 8;
+
+        size_t floor_log2(size_t value) {
+            size_t result = 0;
+            while (value >>= 1) result++;
+            return result;
+        }
+
+        size_t size_class(size_t bytes) {
+            if (bytes <= 64) return 0;
+            auto msb  = floor_log2(bytes - 1);
+            auto step = ((bytes - 1) >> (msb - 2)) & 3;
+            return (msb - 6) * 4 + step + 1;
+        }
+
+        size_t class_size(size_t size_class) {
+            if (size_class == 0) return 64;
+            auto msb  = (size_class - 1) / 4 + 6;
+            auto step = (size_class - 1) % 4;
+            return (4 + step + 1) << (msb - 2);
+        }
+
+        struct Counters {
+            std::atomic<size_t> live{ 0 };
+            std::atomic<size_t> peak{ 0 };
+            std::atomic<size_t> cached{ 0 };
+            std::atomic<size_t> allocations{ 0 };
+            std::atomic<size_t> reused{ 0 };
+
+            void allocated(size_t bytes, bool from_cache) {
+                auto live_now = live.fetch_add(bytes) + bytes;
+                auto current_peak = peak.load();
+                while (live_now > current_peak && !peak.compare_exchange_weak(current_peak, live_now)) {}
+                allocations++;
+                if (from_cache) reused++;
+            }
+
+            hoMemoryPool::Statistics snapshot() const {
+                hoMemoryPool::Statistics statistics;
+                statistics.live_bytes   = live.load();
+                statistics.peak_bytes   = peak.load();
+                statistics.cached_bytes = cached.load();
+                statistics.allocations  = allocations.load();
+                statistics.reused       = reused.load();
+                return statistics;
+            }
+        };
+
+        Counters& global_counters() {
+            static auto counters = new Counters();
+            return *counters;
+        }
+
+        std::atomic<bool> pool_enabled{ false };
+        std::atomic<size_t> cache_limit{ size_t(1) << 30 };
+    }
+
+    struct alignas(hoMemoryPool::alignment) hoMemoryBlock {
+        hoMemoryArenaState* arena;
+        uint32_t size_class;
+        uint32_t magic;
+        size_t capacity;
+    };
+
+    /*
+     * An arena is referenced by its handle and by every block it has handed out or cached, so that blocks can be
+     * returned to it safely however long they outlive the handle.
+     */
+    struct hoMemoryArenaState {
+        std::mutex m;
+        std::array<std::vector<hoMemoryBlock*>, number_of_classes> free_blocks;
+        std::atomic<size_t> references{ 1 };
+        bool closed = false;
+        Counters counters;
+    };
+
+    namespace {
+
+        hoMemoryArenaState* process_arena() {
+            static auto arena = new hoMemoryArenaState();
+            return arena;
+        }
+
+        thread_local std::shared_ptr<hoMemoryPool::Arena> current;
+
+        void release(hoMemoryArenaState* arena) {
+            if (arena->references.fetch_sub(1) == 1) delete arena;
+        }
+
+        void* data_of(hoMemoryBlock* block) {
+            return reinterpret_cast<char*>(block) + sizeof(hoMemoryBlock);
+        }
+
+        hoMemoryBlock* block_of(void* data) {
+            return reinterpret_cast<hoMemoryBlock*>(static_cast<char*>(data) - sizeof(hoMemoryBlock));
+        }
+
+        void add_cached(hoMemoryArenaState* arena, size_t bytes) {
+            arena->counters.cached += bytes;
+            global_counters().cached += bytes;
+        }
+
+        void remove_cached(hoMemoryArenaState* arena, size_t bytes) {
+            arena->counters.cached -= bytes;
+            global_counters().cached -= bytes;
+        }
+
+        hoMemoryBlock* new_block(hoMemoryArenaState* arena, uint32_t size_class, size_t capacity) {
+            auto memory = ::operator new(sizeof(hoMemoryBlock) + capacity, std::align_val_t(hoMemoryPool::alignment));
+            arena->references++;
+            return new (memory) hoMemoryBlock{ arena, size_class, block_magic, capacity };
+        }
+
+        void delete_block(hoMemoryBlock* block) {
+            auto arena   = block->arena;
+            block->magic = 0;
+            ::operator delete(block, std::align_val_t(hoMemoryPool::alignment));
+            release(arena);
+        }
+
+        hoMemoryBlock* take_from_arena(hoMemoryArenaState* arena, size_t size_class) {
+            std::lock_guard<std::mutex> guard(arena->m);
+            auto& blocks = arena->free_blocks[size_class];
+            if (blocks.empty()) return nullptr;
+
+            auto block = blocks.back();
+            blocks.pop_back();
+            remove_cached(arena, block->capacity);
+            return block;
+        }
+
+        void return_to_arena(hoMemoryBlock* block) {
+            auto arena = block->arena;
+            {
+                std::lock_guard<std::mutex> guard(arena->m);
+                if (!arena->closed && global_counters().cached + block->capacity <= cache_limit) {
+                    arena->free_blocks[block->size_class].push_back(block);
+                    add_cached(arena, block->capacity);
+                    return;
+                }
+            }
+            delete_block(block);
+        }
+
+        void release_free_blocks(hoMemoryArenaState* arena, bool close) {
+            std::vector<hoMemoryBlock*> blocks;
+            {
+                std::lock_guard<std::mutex> guard(arena->m);
+                arena->closed |= close;
+                for (auto& free_blocks : arena->free_blocks) {
+                    blocks.insert(blocks.end(), free_blocks.begin(), free_blocks.end());
+                    free_blocks.clear();
+                }
+            }
+            for (auto block : blocks) {
+                remove_cached(arena, block->capacity);
+                delete_block(block);
+            }
+        }
+
+        class ThreadCache {
+        public:
+            ~ThreadCache() {
+                for (auto& slot : slots) {
+                    for (size_t i = 0; i < slot.count; i++) {
+                        remove_cached(slot.blocks[i]->arena, slot.blocks[i]->capacity);
+                        return_to_arena(slot.blocks[i]);
+                    }
+                }
+            }
+
+            hoMemoryBlock* take(size_t size_class, hoMemoryArenaState* arena) {
+                if (size_class >= thread_cached_classes) return nullptr;
+                auto& slot = slots[size_class];
+                for (size_t i = slot.count; i-- > 0;) {
+                    auto block = slot.blocks[i];
+                    if (block->arena != arena) continue;
+                    slot.blocks[i] = slot.blocks[--slot.count];
+                    remove_cached(arena, block->capacity);
+                    return block;
+                }
+                return nullptr;
+            }
+
+            bool put(hoMemoryBlock* block) {
+                if (block->size_class >= thread_cached_classes) return false;
+                auto& slot = slots[block->size_class];
+                if (slot.count == thread_cache_depth) return false;
+                // Counted against the same limit as the arenas, as every thread may hold a full cache
+                if (global_counters().cached + block->capacity > cache_limit) return false;
+                slot.blocks[slot.count++] = block;
+                add_cached(block->arena, block->capacity);
+                return true;
+            }
+
+        private:
+            struct Slot {
+                std::array<hoMemoryBlock*, thread_cache_depth> blocks;
+                size_t count = 0;
+            };
+
+            std::array<Slot, thread_cached_classes> slots;
+        };
+
+        ThreadCache& thread_cache() {
+            thread_local ThreadCache cache;
+            return cache;
+        }
+
+        void record_allocation(hoMemoryArenaState* arena, size_t bytes, bool reused) {
+            global_counters().allocated(bytes, reused);
+            if (arena != process_arena()) arena->counters.allocated(bytes, reused);
+        }
+
+        void record_free(hoMemoryArenaState* arena, size_t bytes) {
+            global_counters().live -= bytes;
+            if (arena != process_arena()) arena->counters.live -= bytes;
+        }
+    }
+
+    hoMemoryArenaState* hoMemoryPool::current_state() {
+        return current ? current->state : process_arena();
+    }
+
+    hoMemoryPool::Arena::Arena() : state(new hoMemoryArenaState()) {}
+
+    hoMemoryPool::Arena::~Arena() {
+        release_free_blocks(state, true);
+        release(state);
+    }
+
+    hoMemoryPool::Statistics hoMemoryPool::Arena::statistics() const {
+        return state->counters.snapshot();
+    }
+
+    hoMemoryPool::ArenaScope::ArenaScope(std::shared_ptr<Arena> arena) : previous(std::move(current)) {
+        current = std::move(arena);
+    }
+
+    hoMemoryPool::ArenaScope::~ArenaScope() {
+        current = std::move(previous);
+    }
+
+    void hoMemoryPool::enable(bool enabled) {
+        pool_enabled = enabled;
+    }
+
+    bool hoMemoryPool::enabled() {
+        return pool_enabled.load(std::memory_order_relaxed);
+    }
+
+    void* hoMemoryPool::allocate(size_t bytes) {
+        bytes      = std::max<size_t>(bytes, 1);
+        auto arena = current_state();
+        auto index = size_class(bytes);
+
+        if (index >= number_of_classes) {
+            auto block = new_block(arena, unpooled_class, bytes);
+            record_allocation(arena, bytes, false);
+            return data_of(block);
+        }
+
+        auto block = thread_cache().take(index, arena);
+        if (!block) block = take_from_arena(arena, index);
+
+        bool reused = block != nullptr;
+        if (!reused) block = new_block(arena, uint32_t(index), class_size(index));
+
+        record_allocation(arena, block->capacity, reused);
+        return data_of(block);
+    }
+
+    void hoMemoryPool::deallocate(void* data) {
+        if (!data) return;
+
+        auto block = block_of(data);
+        if (block->magic != block_magic)
+            throw std::runtime_error("hoMemoryPool::deallocate: memory was not allocated by the pool");
+
+        record_free(block->arena, block->capacity);
+
+        if (block->size_class == unpooled_class) {
+            delete_block(block);
+            return;
+        }
+
+        // Only blocks of the thread's own arena go in its cache, so they are found again by the same connection.
+        if (block->arena == current_state() && thread_cache().put(block)) return;
+        return_to_arena(block);
+    }
+
+    void hoMemoryPool::set_cache_limit(size_t bytes) {
+        cache_limit = bytes;
+    }
+
+    void hoMemoryPool::release_cached() {
+        release_free_blocks(process_arena(), false);
+    }
+
+    hoMemoryPool::Statistics hoMemoryPool::statistics() {
+        return global_counters().snapshot();
+    }
+
+    std::shared_ptr<hoMemoryPool::Arena> hoMemoryPool::current_arena() {
+        return current;
+    }
+}
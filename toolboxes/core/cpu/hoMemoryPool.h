@@ -0,0 +1,90 @@
+/** \file hoMemoryPool.h
+    \brief Size-class pool for hoNDArray storage
+*/
+
+#pragma once
+
+#include "cpucore_export.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace Gadgetron {
+
+    struct hoMemoryArenaState;
+
+    /**
+     * Recycles the storage of host arrays. Requests are rounded up to one of four size classes per power of two and
+     * freed blocks are kept on free lists (with a small per-thread cache in front) for the next request of the same
+     * class, instead of going back to the system. All blocks are 64 byte aligned.
+     *
+     * The pool is disabled by default, in which case hoNDArray allocates with new[] as it always has.
+     *
+     * Blocks are allocated from the calling thread's current Arena, or from the process wide pool if there is none.
+     * Closing an Arena (destroying the last reference to it) releases the blocks it has cached, so memory cached on
+     * behalf of one connection does not outlive it.
+     */
+    class EXPORTCPUCORE hoMemoryPool {
+    public:
+        struct Statistics {
+            size_t live_bytes   = 0; ///< Bytes currently handed out
+            size_t peak_bytes   = 0; ///< Highest value of live_bytes
+            size_t cached_bytes = 0; ///< Bytes held on free lists, ready for reuse
+            size_t allocations  = 0; ///< Number of allocations served
+            size_t reused       = 0; ///< Number of allocations served from a free list
+        };
+
+        class Arena {
+        public:
+            Arena();
+            ~Arena();
+
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            Statistics statistics() const;
+
+        private:
+            friend class hoMemoryPool;
+            hoMemoryArenaState* state;
+        };
+
+        /// Makes arena the current arena of the calling thread for the lifetime of the scope.
+        class ArenaScope {
+        public:
+            explicit ArenaScope(std::shared_ptr<Arena> arena);
+            ~ArenaScope();
+
+            ArenaScope(const ArenaScope&) = delete;
+            ArenaScope& operator=(const ArenaScope&) = delete;
+
+        private:
+            std::shared_ptr<Arena> previous;
+        };
+
+        static void enable(bool enabled = true);
+        static bool enabled();
+
+        /// Allocates at least bytes bytes, aligned to 64 bytes.
+        static void* allocate(size_t bytes);
+
+        /// Returns memory obtained from allocate to the pool.
+        static void deallocate(void* data);
+
+        /// Upper bound on the bytes kept on free lists across all arenas. Blocks freed beyond it go to the system.
+        static void set_cache_limit(size_t bytes);
+
+        /// Releases all blocks cached by the process wide pool.
+        static void release_cached();
+
+        /// Statistics for the process wide pool and all arenas combined.
+        static Statistics statistics();
+
+        static std::shared_ptr<Arena> current_arena();
+
+        static constexpr size_t alignment = 64;
+
+    private:
+        static hoMemoryArenaState* current_state();
+    };
+}
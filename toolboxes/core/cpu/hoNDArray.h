@@ -6,7 +6,9 @@
 
 #include "NDArray.h"
 #include "complext.h"
+#include "hoMemoryPool.h"
 #include "vector_td.h"
+#include <memory>
 #include <type_traits>
 #include <boost/shared_ptr.hpp>
 #include <stdexcept>
@@ -65,6 +67,10 @@ namespace Gadgetron{
     }
    template<class T> class hoNDArray;
 
+   namespace Expressions {
+       template<class Node> class Expression;
+   }
+
 
    template<class T, size_t D, bool contigous = false>
    class hoNDArrayView {
@@ -131,6 +137,10 @@ namespace Gadgetron{
     hoNDArray(std::initializer_list<size_t> dimensions);
     hoNDArray(std::initializer_list<size_t> dimensions,T* data, bool delete_data_on_destruct = false);
 
+    /// Wraps storage owned by another object, e.g. a NumPy array. The array keeps owner alive until it no longer
+    /// uses data, instead of deleting data itself.
+    hoNDArray(const std::vector<size_t> &dimensions, T* data, std::shared_ptr<void> owner);
+
     explicit hoNDArray(size_t len);
     hoNDArray(size_t sx, size_t sy);
     hoNDArray(size_t sx, size_t sy, size_t sz);
@@ -172,6 +182,13 @@ namespace Gadgetron{
     template<unsigned int D, bool C>
     hoNDArray& operator=(const hoNDArrayView<T,D,C>& view);
 
+    // Element-wise expressions are evaluated in a single pass, see hoNDArray_expressions.h
+    template<class Node>
+    hoNDArray(const Expressions::Expression<Node>& expression);
+
+    template<class Node>
+    hoNDArray& operator=(const Expressions::Expression<Node>& expression);
+
     bool operator==(const hoNDArray& rhs) const;
     virtual void create(const std::vector<size_t>& dimensions);
 
@@ -317,14 +334,37 @@ namespace Gadgetron{
 
     template<class X> void _allocate_memory( size_t size, X** data )
     {
+      if constexpr (std::is_trivially_destructible<X>::value) {
+        if (hoMemoryPool::enabled()) {
+          *data = static_cast<X*>(hoMemoryPool::allocate(size * sizeof(X)));
+          std::uninitialized_default_construct_n(*data, size);
+          pooled_ = true;
+          return;
+        }
+      }
       *data = new X[size];
+      pooled_ = false;
     }
 
     template<class X> void _deallocate_memory( X* data )
     {
+      if (owner_) {
+        owner_.reset();
+        return;
+      }
+      if (pooled_) {
+        hoMemoryPool::deallocate(data);
+        pooled_ = false;
+        return;
+      }
       delete [] data;
     }
 
+    // Whether data_ came from hoMemoryPool rather than new[]. Memory handed in by pointer is always taken to be new[].
+    bool pooled_ = false;
+    // Set when data_ belongs to another object; releasing it stands in for deleting data_.
+    std::shared_ptr<void> owner_;
+
 
   };
 
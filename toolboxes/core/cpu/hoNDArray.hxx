@@ -38,6 +38,12 @@ namespace Gadgetron {
         this->create(dimensions, data, delete_data_on_destruct);
     }
 
+    template<class T>
+    hoNDArray<T>::hoNDArray(const std::vector<size_t> &dimensions, T *data, std::shared_ptr<void> owner) {
+        this->create(dimensions, data, true);
+        owner_ = std::move(owner);
+    }
+
     template<typename T>
     hoNDArray<T>::hoNDArray(size_t len) : NDArray<T>::NDArray() {
         std::vector<size_t> dim(1);
@@ -252,9 +258,12 @@ namespace Gadgetron {
     template<typename T>
     hoNDArray<T>::hoNDArray(hoNDArray<T> &&a) noexcept : NDArray<T>::NDArray() {
         data_ = a.data_;
+        pooled_ = a.pooled_;
+        owner_ = std::move(a.owner_);
         this->dimensions_ = a.dimensions_;
         this->elements_ = a.elements_;
         a.data_ = nullptr;
+        a.pooled_ = false;
         this->offsetFactors_ = a.offsetFactors_;
         this->delete_data_on_destruct_ = a.delete_data_on_destruct_;
     }
@@ -299,7 +308,10 @@ namespace Gadgetron {
         this->offsetFactors_ = rhs.offsetFactors_;
         this->elements_ = rhs.elements_;
         data_ = rhs.data_;
+        pooled_ = rhs.pooled_;
+        owner_ = std::move(rhs.owner_);
         rhs.data_ = nullptr;
+        rhs.pooled_ = false;
         this->delete_data_on_destruct_ = rhs.delete_data_on_destruct_;
         return *this;
     }
@@ -356,6 +368,8 @@ namespace Gadgetron {
 
             BaseClass::create(dimensions, data, delete_data_on_destruct);
         }
+        pooled_ = false;
+        owner_.reset();
     }
 
     template<typename T>
@@ -378,6 +392,8 @@ namespace Gadgetron {
 
             BaseClass::create(dimensions, data, delete_data_on_destruct);
         }
+        pooled_ = false;
+        owner_.reset();
     }
 
     template<typename T>
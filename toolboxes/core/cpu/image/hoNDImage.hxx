@@ -539,6 +539,7 @@ namespace Gadgetron
         }
 
         this->data_ = data;
+        this->pooled_ = false;
         this->delete_data_on_destruct_ = delete_data_on_destruct;
         this->dimensions_ = dimensions;
 
@@ -579,6 +580,7 @@ namespace Gadgetron
         }
 
         this->data_ = data;
+        this->pooled_ = false;
         this->delete_data_on_destruct_ = delete_data_on_destruct;
         this->dimensions_ = dimensions;
 
@@ -619,6 +621,7 @@ namespace Gadgetron
         }
 
         this->data_ = data;
+        this->pooled_ = false;
         this->delete_data_on_destruct_ = delete_data_on_destruct;
         this->dimensions_ = dimensions;
 
@@ -675,6 +678,7 @@ namespace Gadgetron
         }
 
         this->data_ = data;
+        this->pooled_ = false;
         this->delete_data_on_destruct_ = delete_data_on_destruct;
 
         dimensions_ = dimensions;
@@ -328,3 +328,23 @@ void Gadgetron::BLAS::herk(bool upper, bool trans, size_t n, size_t k, double al
     cblas_zherk(CblasColMajor, upper ? CblasUpper : CblasLower, trans ? CblasConjTrans : CblasNoTrans, n, k, alpha,
                 (double*)a, lda, beta, (double*)c, ldc);
 }
+void Gadgetron::BLAS::trmm(bool left, bool upper, bool transa, size_t m, size_t n, float alpha, const float* a,
+    size_t lda, float* b, size_t ldb) {
+    cblas_strmm(CblasColMajor, left ? CblasLeft : CblasRight, upper ? CblasUpper : CblasLower,
+        transa ? CblasTrans : CblasNoTrans, CblasNonUnit, m, n, alpha, a, lda, b, ldb);
+}
+void Gadgetron::BLAS::trmm(bool left, bool upper, bool transa, size_t m, size_t n, double alpha, const double* a,
+    size_t lda, double* b, size_t ldb) {
+    cblas_dtrmm(CblasColMajor, left ? CblasLeft : CblasRight, upper ? CblasUpper : CblasLower,
+        transa ? CblasTrans : CblasNoTrans, CblasNonUnit, m, n, alpha, a, lda, b, ldb);
+}
+void Gadgetron::BLAS::trmm(bool left, bool upper, bool transa, size_t m, size_t n, std::complex<float> alpha,
+    const std::complex<float>* a, size_t lda, std::complex<float>* b, size_t ldb) {
+    cblas_ctrmm(CblasColMajor, left ? CblasLeft : CblasRight, upper ? CblasUpper : CblasLower,
+        transa ? CblasConjTrans : CblasNoTrans, CblasNonUnit, m, n, (float*)&alpha, (float*)a, lda, (float*)b, ldb);
+}
+void Gadgetron::BLAS::trmm(bool left, bool upper, bool transa, size_t m, size_t n, std::complex<double> alpha,
+    const std::complex<double>* a, size_t lda, std::complex<double>* b, size_t ldb) {
+    cblas_ztrmm(CblasColMajor, left ? CblasLeft : CblasRight, upper ? CblasUpper : CblasLower,
+        transa ? CblasConjTrans : CblasNoTrans, CblasNonUnit, m, n, (double*)&alpha, (double*)a, lda, (double*)b, ldb);
+}
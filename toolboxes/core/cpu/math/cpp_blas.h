@@ -82,6 +82,12 @@ namespace Gadgetron {
          void herk(bool upper, bool trans, size_t n, size_t k, float alpha, const std::complex<float>* a, size_t lda, float beta, std::complex<float>* c, size_t ldc);
          void herk(bool upper, bool trans, size_t n, size_t k, double alpha, const std::complex<double>* a, size_t lda, double beta, std::complex<double>* c, size_t ldc);
 
+         // b = a*b (left) or b*a (right), with a triangular, in place
+         void trmm(bool left, bool upper, bool transa, size_t m, size_t n, float alpha, const float* a, size_t lda, float* b, size_t ldb);
+         void trmm(bool left, bool upper, bool transa, size_t m, size_t n, double alpha, const double* a, size_t lda, double* b, size_t ldb);
+         void trmm(bool left, bool upper, bool transa, size_t m, size_t n, std::complex<float> alpha, const std::complex<float>* a, size_t lda, std::complex<float>* b, size_t ldb);
+         void trmm(bool left, bool upper, bool transa, size_t m, size_t n, std::complex<double> alpha, const std::complex<double>* a, size_t lda, std::complex<double>* b, size_t ldb);
+
 
 
     }
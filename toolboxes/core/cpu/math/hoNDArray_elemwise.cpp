@@ -23,7 +23,28 @@
 #define NumElementsUseThreading 64 * 1024
 
 namespace {
+    template <class T, class R> void abs_impl(const Gadgetron::hoNDArray<T>& x, Gadgetron::hoNDArray<R>& r) {
+        using std::abs;
+        ::gadgetron_detail::parallel_transform(x, r, [](auto val) { return abs(val); });
+    }
 
+    // The magnitude of complex arrays has explicit SIMD kernels
+    template <class C, class T> void abs_simd(const Gadgetron::hoNDArray<C>& x, Gadgetron::hoNDArray<T>& r) {
+        const C* px = x.data();
+        T* pr = r.data();
+        ::gadgetron_detail::for_each_chunk(x.get_number_of_elements(), [&](long long begin, long long end) {
+            Gadgetron::SIMD::abs(end - begin, px + begin, pr + begin);
+        });
+    }
+
+    template <class T> void abs_impl(const Gadgetron::hoNDArray<std::complex<T>>& x, Gadgetron::hoNDArray<T>& r) {
+        abs_simd(x, r);
+    }
+
+    template <class T>
+    void abs_impl(const Gadgetron::hoNDArray<Gadgetron::complext<T>>& x, Gadgetron::hoNDArray<T>& r) {
+        abs_simd(x, r);
+    }
 }
 
 namespace Gadgetron {
@@ -32,7 +53,7 @@ namespace Gadgetron {
         if (r.get_number_of_elements() != x.get_number_of_elements()) {
             r.create(x.dimensions());
         }
-        Gadgetron::transform(x,r,[](auto val){return conj(val);});
+        ::gadgetron_detail::parallel_transform(x,r,[](auto val){return conj(val);});
     }
 
     template  void conjugate(
@@ -49,7 +70,7 @@ namespace Gadgetron {
     template <typename T> void addEpsilon(hoNDArray<T>& x) {
         constexpr auto eps = std::numeric_limits<realType_t<T>>::epsilon();
         using std::abs;
-        transform(x,x,[&](auto val){return (abs(val) < eps ) ? val+eps : val; });
+        ::gadgetron_detail::parallel_transform(x,x,[&](auto val){return (abs(val) < eps ) ? val+eps : val; });
     }
 
     template  void addEpsilon(hoNDArray<float>& x);
@@ -66,7 +87,7 @@ namespace Gadgetron {
             r.create(x.dimensions());
         }
         using std::arg;
-        transform(x,r,[](auto val){return arg(val);});
+        ::gadgetron_detail::parallel_transform(x,r,[](auto val){return arg(val);});
     }
 
     template  void argument(const hoNDArray<std::complex<float>>& x, hoNDArray<float>& r);
@@ -74,7 +95,7 @@ namespace Gadgetron {
 
     template <class T> hoNDArray<realType_t<T>> argument(const hoNDArray<T>& x) {
         using std::arg;
-        return Gadgetron::transform(x,[](const auto& v){return arg(v);});
+        return ::gadgetron_detail::parallel_transform(x,[](const auto& v){return arg(v);});
     }
 
     template  hoNDArray<float> argument(const hoNDArray<std::complex<float>>& x);
@@ -86,7 +107,7 @@ namespace Gadgetron {
         if (!r.dimensions_equal(&x)) {
             r = x;
         }
-        transform(x,r,[](auto val){return T(1)/val;});
+        ::gadgetron_detail::parallel_transform(x,r,[](auto val){return T(1)/val;});
     }
 
     template  void inv(const hoNDArray<float>& x, hoNDArray<float>& r);
@@ -102,7 +123,7 @@ namespace Gadgetron {
         if (r.get_number_of_elements() != x.get_number_of_elements()) {
             r.create(x.dimensions());
         }
-        transform(x,r,[](auto val){return abs(val);});
+        abs_impl(x, r);
     }
 
     template  void abs(const hoNDArray<float>& x, hoNDArray<float>& r);
@@ -117,8 +138,9 @@ namespace Gadgetron {
     template  void abs(const hoNDArray<complext<double>>& x, hoNDArray<complext<double>>& r);
 
     template <class T> hoNDArray<realType_t<T>> abs(const hoNDArray<T>& x) {
-        using std::abs;
-        return transform(x,[](auto val){return abs(val);}) ;
+        hoNDArray<realType_t<T>> r(x.dimensions());
+        abs_impl(x, r);
+        return r;
     }
 
     template  hoNDArray<float> abs(const hoNDArray<float>& x);
@@ -316,7 +338,7 @@ namespace Gadgetron {
 
 
     template<class T> hoNDArray<realType_t<T>> real(const hoNDArray<T>& x){
-        return Gadgetron::transform(x,[](const auto& cplx){return real(cplx);});
+        return ::gadgetron_detail::parallel_transform(x,[](const auto& cplx){return real(cplx);});
     }
 
     template hoNDArray<float> real(const hoNDArray<std::complex<float>>&);
@@ -352,7 +374,7 @@ namespace Gadgetron {
     }
 
     template<class T> hoNDArray<realType_t<T>> imag(const hoNDArray<T>& x){
-        return Gadgetron::transform(x,[](const auto& cplx){return imag(cplx);});
+        return ::gadgetron_detail::parallel_transform(x,[](const auto& cplx){return imag(cplx);});
     }
 
     template hoNDArray<float> imag(const hoNDArray<std::complex<float>>&);
@@ -3,6 +3,16 @@
 //
 
 #pragma once
+
+#include "hoNDArray_elemwise_simd.h"
+
+#include <algorithm>
+#include <functional>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif // USE_OMP
+
 namespace {
     using namespace Gadgetron;
     namespace gadgetron_detail {
@@ -15,6 +25,88 @@ namespace {
 
         // --------------------------------------------------------------------------------
 
+        // Element-wise loops are split into chunks of this many elements, run in parallel when there is more than one.
+        constexpr long long elementwise_chunk_size = 64 * 1024;
+
+        // Calls f(begin, end) for consecutive ranges covering [0, size), in parallel for large sizes. Inside a
+        // parallel region, e.g. a loop over coils, the caller's thread does all the work.
+        template <class F> inline void for_each_chunk(long long size, long long chunk_size, F&& f) {
+            long long chunks = (size + chunk_size - 1) / chunk_size;
+            bool in_parallel = false;
+#ifdef USE_OMP
+            in_parallel = omp_in_parallel();
+#endif // USE_OMP
+            if (chunks <= 1 || in_parallel) {
+                f(0ll, size);
+                return;
+            }
+#pragma omp parallel for schedule(static)
+            for (long long chunk = 0; chunk < chunks; chunk++) {
+                long long begin = chunk * chunk_size;
+                f(begin, std::min(size, begin + chunk_size));
+            }
+        }
+
+        template <class F> inline void for_each_chunk(long long size, F&& f) {
+            for_each_chunk(size, elementwise_chunk_size, std::forward<F>(f));
+        }
+
+        // Gadgetron::transform in parallel chunks. Only for the library's own kernels, which are pure functions of one
+        // element; Gadgetron::transform itself stays serial, as user functions need not be safe to call concurrently.
+        template <class T, class S, class F>
+        void parallel_transform(const hoNDArray<T>& input, hoNDArray<S>& output, const F& fun) {
+            if (output.size() != input.size()) {
+                throw std::runtime_error("Input and output arrays have different number of elements");
+            }
+            const T* in = input.data();
+            S* out = output.data();
+            for_each_chunk(input.size(), [&](long long begin, long long end) {
+#pragma omp simd
+                for (long long i = begin; i < end; i++) {
+                    out[i] = fun(in[i]);
+                }
+            });
+        }
+
+        template <class T, class F> auto parallel_transform(const hoNDArray<T>& input, const F& fun) {
+            hoNDArray<std::invoke_result_t<const F&, const T&>> output(input.dimensions());
+            parallel_transform(input, output, fun);
+            return output;
+        }
+
+        struct multiplies_conj {
+            template <class T, class S> auto operator()(const T& a, const S& b) const { return a * conj(b); }
+        };
+
+        // Operations with explicit SIMD kernels. Everything else returns false and takes the plain loop, which
+        // the compiler vectorizes well enough.
+        template <class T, class S, class R, class BinaryOperator>
+        inline bool simd_transform(long long, const T*, const S*, R*, const BinaryOperator&) {
+            return false;
+        }
+
+        template <class T>
+        inline bool simd_transform(long long size, const complext<T>* a, const complext<T>* b, complext<T>* c,
+                                   const std::multiplies<>&) {
+            SIMD::multiply(size, a, b, c);
+            return true;
+        }
+
+        template <class T>
+        inline bool simd_transform(long long size, const complext<T>* a, const complext<T>* b, complext<T>* c,
+                                   const multiplies_conj&) {
+            SIMD::multiply_conj(size, a, b, c);
+            return true;
+        }
+
+        template <class T, class S, class R, class BinaryOperator>
+        inline void transform_range(long long size, const T* a, const S* b, R* c, BinaryOperator& op) {
+            if (simd_transform(size, a, b, c, op)) return;
+            for (long long n = 0; n < size; n++) {
+                c[n] = op(a[n], b[n]);
+            }
+        }
+
         // internal low level function for element-wise addition of two arrays
         template<class T, class S, class BinaryOperator>
         inline void transform_impl(size_t sizeX, size_t sizeY, const T *x, const S *y,
@@ -30,26 +122,20 @@ namespace {
 
             if (sizeX == sizeY) {
                 // No Broadcasting
-                long long loopsize = sizeX;
-                long long n;
-
-                for ( long long n = 0; n < loopsize; n++) {
-                    c[n] = op(a[n], b[n]);
-                }
+                for_each_chunk(sizeX, [&](long long begin, long long end) {
+                    transform_range(end - begin, a + begin, b + begin, c + begin, op);
+                });
             } else {
-                // Broadcasting
+                // Broadcasting; chunks are whole repetitions of y
                 long long outerloopsize = sizeX / sizeY;
                 long long innerloopsize = sizeX / outerloopsize;
-                // No OMP at All
-                for (long long outer = 0; outer < outerloopsize; outer++) {
-                    size_t offset = outer * innerloopsize;
-                    const typename mathInternalType<T>::type *ai = &a[offset];
-                    typename mathInternalType<typename mathReturnType<T, S>::type>::type *ci = &c[offset];
-                    for (long long n = 0; n < innerloopsize; n++) {
-                        ci[n] = op(ai[n], b[n]);
+                long long repetitions = std::max(1ll, elementwise_chunk_size / innerloopsize);
+                for_each_chunk(outerloopsize, repetitions, [&](long long begin, long long end) {
+                    for (long long outer = begin; outer < end; outer++) {
+                        size_t offset = outer * innerloopsize;
+                        transform_range(innerloopsize, a + offset, b, c + offset, op);
                     }
-                }
-
+                });
             }
         }
 
@@ -117,7 +203,7 @@ void Gadgetron::divide(
 template <class T, class S>
 void Gadgetron::multiplyConj(
     const hoNDArray<T>& x, const hoNDArray<S>& y, hoNDArray<typename mathReturnType<T, S>::type>& r) {
-    ::gadgetron_detail::transform_arrays(x, y, r, [](auto& a, auto& b) { return a * conj(b); });
+    ::gadgetron_detail::transform_arrays(x, y, r, ::gadgetron_detail::multiplies_conj());
 }
 
 template <class T, class S> Gadgetron::hoNDArray<T>& Gadgetron::operator+=(hoNDArray<T>& x, const hoNDArray<S>& y) {
@@ -138,56 +224,46 @@ template <class T, class S> Gadgetron::hoNDArray<T>& Gadgetron::operator/=(hoNDA
 }
 
 template <class T, class S> Gadgetron::hoNDArray<T>& Gadgetron::operator+=(hoNDArray<T>& x, const S& y) {
-    long long n;
-    size_t N = x.get_number_of_elements();
-
-    for (n = 0; n < (long long)N; ++n) {
-        x[n] += y;
-    }
+    T* data = x.data();
+    ::gadgetron_detail::for_each_chunk(x.get_number_of_elements(), [&](long long begin, long long end) {
+        for (long long n = begin; n < end; n++) {
+            data[n] += y;
+        }
+    });
     return x;
 }
 
 // --------------------------------------------------------------------------------
 
 template <class T, class S> Gadgetron::hoNDArray<T>& Gadgetron::operator-=(hoNDArray<T>& x, const S& y) {
-
-    long long n;
-
-    size_t N = x.get_number_of_elements();
-
-    for (n = 0; n < (long long)N; ++n) {
-        x[n] -= y;
-    }
-
+    T* data = x.data();
+    ::gadgetron_detail::for_each_chunk(x.get_number_of_elements(), [&](long long begin, long long end) {
+        for (long long n = begin; n < end; n++) {
+            data[n] -= y;
+        }
+    });
     return x;
 }
 
 template <class T, class S> Gadgetron::hoNDArray<T>& Gadgetron::operator*=(hoNDArray<T>& x, const S& y) {
-
-    long long n;
-
-    size_t N = x.get_number_of_elements();
-
-    for (n = 0; n < (long long)N; ++n) {
-        x[n] *= y;
-    }
-
+    T* data = x.data();
+    ::gadgetron_detail::for_each_chunk(x.get_number_of_elements(), [&](long long begin, long long end) {
+        for (long long n = begin; n < end; n++) {
+            data[n] *= y;
+        }
+    });
     return x;
 }
 
 // --------------------------------------------------------------------------------
 
 template <class T, class S> Gadgetron::hoNDArray<T>& Gadgetron::operator/=(hoNDArray<T>& x, const S& y) {
-
-    long long n;
-
-    size_t N = x.get_number_of_elements();
-
-
-    for (n = 0; n < (long long)N; ++n) {
-        x[n] /= y;
-    }
-
+    T* data = x.data();
+    ::gadgetron_detail::for_each_chunk(x.get_number_of_elements(), [&](long long begin, long long end) {
+        for (long long n = begin; n < end; n++) {
+            data[n] /= y;
+        }
+    });
     return x;
 }
 
@@ -0,0 +1,415 @@
+#include "hoNDArray_elemwise_simd.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GADGETRON_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace Gadgetron {
+    namespace SIMD {
+        namespace {
+
+            namespace scalar {
+                template <class T>
+                void multiply(size_t N, const std::complex<T>* x, const std::complex<T>* y, std::complex<T>* r) {
+                    auto a = reinterpret_cast<const T*>(x);
+                    auto b = reinterpret_cast<const T*>(y);
+                    auto c = reinterpret_cast<T*>(r);
+                    for (size_t i = 0; i < 2 * N; i += 2) {
+                        T re = a[i] * b[i] - a[i + 1] * b[i + 1];
+                        T im = a[i + 1] * b[i] + a[i] * b[i + 1];
+                        c[i] = re;
+                        c[i + 1] = im;
+                    }
+                }
+
+                template <class T>
+                void multiply_conj(size_t N, const std::complex<T>* x, const std::complex<T>* y, std::complex<T>* r) {
+                    auto a = reinterpret_cast<const T*>(x);
+                    auto b = reinterpret_cast<const T*>(y);
+                    auto c = reinterpret_cast<T*>(r);
+                    for (size_t i = 0; i < 2 * N; i += 2) {
+                        T re = a[i] * b[i] + a[i + 1] * b[i + 1];
+                        T im = a[i + 1] * b[i] - a[i] * b[i + 1];
+                        c[i] = re;
+                        c[i + 1] = im;
+                    }
+                }
+
+                // |re + i im| scaled by the larger component, so that it neither overflows nor underflows where
+                // re*re + im*im would. Zero, infinite and NaN magnitudes are left to std::hypot.
+                template <class T> T magnitude(T re, T im) {
+                    T x = std::abs(re), y = std::abs(im);
+                    T m = std::max(x, y);
+                    if (!(m > T(0) && m < std::numeric_limits<T>::infinity())) return std::hypot(re, im);
+                    T q = std::min(x, y) / m;
+                    return m * std::sqrt(T(1) + q * q);
+                }
+
+                template <class T> void abs(size_t N, const std::complex<T>* x, T* r) {
+                    auto a = reinterpret_cast<const T*>(x);
+                    for (size_t i = 0; i < N; i++)
+                        r[i] = magnitude(a[2 * i], a[2 * i + 1]);
+                }
+            }
+
+#ifdef GADGETRON_SIMD_X86
+
+// Each instruction set provides Ops<T>, holding `lanes` complex numbers per vector V. The loops are stamped out
+// per instruction set, as the intrinsics only inline into functions compiled for the same target.
+#define GADGETRON_SIMD_LOOPS(TARGET)                                                                                   \
+    template <class T>                                                                                                 \
+    __attribute__((target(TARGET))) void multiply(                                                                     \
+        size_t N, const std::complex<T>* x, const std::complex<T>* y, std::complex<T>* r) {                            \
+        size_t i = 0;                                                                                                  \
+        for (; i + Ops<T>::lanes <= N; i += Ops<T>::lanes)                                                             \
+            Ops<T>::store(r + i, Ops<T>::multiply(Ops<T>::load(x + i), Ops<T>::load(y + i)));                          \
+        scalar::multiply(N - i, x + i, y + i, r + i);                                                                  \
+    }                                                                                                                  \
+    template <class T>                                                                                                 \
+    __attribute__((target(TARGET))) void multiply_conj(                                                                \
+        size_t N, const std::complex<T>* x, const std::complex<T>* y, std::complex<T>* r) {                            \
+        size_t i = 0;                                                                                                  \
+        for (; i + Ops<T>::lanes <= N; i += Ops<T>::lanes)                                                             \
+            Ops<T>::store(r + i, Ops<T>::multiply_conj(Ops<T>::load(x + i), Ops<T>::load(y + i)));                     \
+        scalar::multiply_conj(N - i, x + i, y + i, r + i);                                                             \
+    }                                                                                                                  \
+    template <class T> __attribute__((target(TARGET))) void abs(size_t N, const std::complex<T>* x, T* r) {            \
+        size_t i = 0;                                                                                                  \
+        for (; i + 2 * Ops<T>::lanes <= N; i += 2 * Ops<T>::lanes) {                                                   \
+            typename Ops<T>::V magnitudes;                                                                             \
+            if (Ops<T>::abs(Ops<T>::load(x + i), Ops<T>::load(x + i + Ops<T>::lanes), magnitudes))                     \
+                Ops<T>::store_real(r + i, magnitudes);                                                                 \
+            else                                                                                                       \
+                scalar::abs(2 * Ops<T>::lanes, x + i, r + i);                                                          \
+        }                                                                                                              \
+        scalar::abs(N - i, x + i, r + i);                                                                              \
+    }
+
+            // abs(a0, a1, r) computes scalar::magnitude of the complex numbers in a0 and a1 into r, and returns false
+            // if any of them is zero, infinite or NaN, leaving those to the scalar code.
+            //
+            // The products are t1 = (a.re*b.re, a.im*b.re) and t2 = (a.im*b.im, a.re*b.im); x*y is (t1 - t2, t1 + t2)
+            // and x*conj(y) is (t1 + t2, t1 - t2), lane by lane.
+            namespace sse3 {
+                template <class T> struct Ops;
+
+                template <> struct Ops<float> {
+                    using V = __m128;
+                    static constexpr size_t lanes = 2;
+                    __attribute__((target("sse3"))) static V load(const std::complex<float>* p) {
+                        return _mm_loadu_ps(reinterpret_cast<const float*>(p));
+                    }
+                    __attribute__((target("sse3"))) static void store(std::complex<float>* p, V v) {
+                        _mm_storeu_ps(reinterpret_cast<float*>(p), v);
+                    }
+                    __attribute__((target("sse3"))) static void store_real(float* p, V v) { _mm_storeu_ps(p, v); }
+                    __attribute__((target("sse3"))) static V t1(V a, V b) { return _mm_mul_ps(a, _mm_moveldup_ps(b)); }
+                    __attribute__((target("sse3"))) static V t2(V a, V b) {
+                        return _mm_mul_ps(_mm_shuffle_ps(a, a, 0xB1), _mm_movehdup_ps(b));
+                    }
+                    __attribute__((target("sse3"))) static V multiply(V a, V b) {
+                        return _mm_addsub_ps(t1(a, b), t2(a, b));
+                    }
+                    __attribute__((target("sse3"))) static V multiply_conj(V a, V b) {
+                        return _mm_addsub_ps(t1(a, b), _mm_xor_ps(t2(a, b), _mm_set1_ps(-0.0f)));
+                    }
+                    __attribute__((target("sse3"))) static bool abs(V a0, V a1, V& r) {
+                        const V sign = _mm_set1_ps(-0.0f);
+                        V x = _mm_andnot_ps(sign, _mm_shuffle_ps(a0, a1, 0x88));
+                        V y = _mm_andnot_ps(sign, _mm_shuffle_ps(a0, a1, 0xDD));
+                        V m = _mm_max_ps(x, y), q = _mm_div_ps(_mm_min_ps(x, y), m);
+                        r = _mm_mul_ps(m, _mm_sqrt_ps(_mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(q, q))));
+                        V regular = _mm_and_ps(_mm_cmpgt_ps(m, _mm_setzero_ps()),
+                                               _mm_cmplt_ps(m, _mm_set1_ps(std::numeric_limits<float>::infinity())));
+                        return _mm_movemask_ps(regular) == 0xF;
+                    }
+                };
+
+                template <> struct Ops<double> {
+                    using V = __m128d;
+                    static constexpr size_t lanes = 1;
+                    __attribute__((target("sse3"))) static V load(const std::complex<double>* p) {
+                        return _mm_loadu_pd(reinterpret_cast<const double*>(p));
+                    }
+                    __attribute__((target("sse3"))) static void store(std::complex<double>* p, V v) {
+                        _mm_storeu_pd(reinterpret_cast<double*>(p), v);
+                    }
+                    __attribute__((target("sse3"))) static void store_real(double* p, V v) { _mm_storeu_pd(p, v); }
+                    __attribute__((target("sse3"))) static V t1(V a, V b) { return _mm_mul_pd(a, _mm_movedup_pd(b)); }
+                    __attribute__((target("sse3"))) static V t2(V a, V b) {
+                        return _mm_mul_pd(_mm_shuffle_pd(a, a, 1), _mm_unpackhi_pd(b, b));
+                    }
+                    __attribute__((target("sse3"))) static V multiply(V a, V b) {
+                        return _mm_addsub_pd(t1(a, b), t2(a, b));
+                    }
+                    __attribute__((target("sse3"))) static V multiply_conj(V a, V b) {
+                        return _mm_addsub_pd(t1(a, b), _mm_xor_pd(t2(a, b), _mm_set1_pd(-0.0)));
+                    }
+                    __attribute__((target("sse3"))) static bool abs(V a0, V a1, V& r) {
+                        const V sign = _mm_set1_pd(-0.0);
+                        V x = _mm_andnot_pd(sign, _mm_unpacklo_pd(a0, a1));
+                        V y = _mm_andnot_pd(sign, _mm_unpackhi_pd(a0, a1));
+                        V m = _mm_max_pd(x, y), q = _mm_div_pd(_mm_min_pd(x, y), m);
+                        r = _mm_mul_pd(m, _mm_sqrt_pd(_mm_add_pd(_mm_set1_pd(1.0), _mm_mul_pd(q, q))));
+                        V regular = _mm_and_pd(_mm_cmpgt_pd(m, _mm_setzero_pd()),
+                                               _mm_cmplt_pd(m, _mm_set1_pd(std::numeric_limits<double>::infinity())));
+                        return _mm_movemask_pd(regular) == 0x3;
+                    }
+                };
+
+                GADGETRON_SIMD_LOOPS("sse3")
+            }
+
+            namespace avx2 {
+                template <class T> struct Ops;
+
+                template <> struct Ops<float> {
+                    using V = __m256;
+                    static constexpr size_t lanes = 4;
+                    __attribute__((target("avx2"))) static V load(const std::complex<float>* p) {
+                        return _mm256_loadu_ps(reinterpret_cast<const float*>(p));
+                    }
+                    __attribute__((target("avx2"))) static void store(std::complex<float>* p, V v) {
+                        _mm256_storeu_ps(reinterpret_cast<float*>(p), v);
+                    }
+                    __attribute__((target("avx2"))) static void store_real(float* p, V v) { _mm256_storeu_ps(p, v); }
+                    __attribute__((target("avx2"))) static V t1(V a, V b) {
+                        return _mm256_mul_ps(a, _mm256_moveldup_ps(b));
+                    }
+                    __attribute__((target("avx2"))) static V t2(V a, V b) {
+                        return _mm256_mul_ps(_mm256_permute_ps(a, 0xB1), _mm256_movehdup_ps(b));
+                    }
+                    __attribute__((target("avx2"))) static V multiply(V a, V b) {
+                        return _mm256_addsub_ps(t1(a, b), t2(a, b));
+                    }
+                    __attribute__((target("avx2"))) static V multiply_conj(V a, V b) {
+                        return _mm256_addsub_ps(t1(a, b), _mm256_xor_ps(t2(a, b), _mm256_set1_ps(-0.0f)));
+                    }
+                    // Shuffles work within 128 bit halves, giving a0[0..1] a1[0..1] a0[2..3] a1[2..3]
+                    __attribute__((target("avx2"))) static V in_order(V v) {
+                        return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), 0xD8));
+                    }
+                    __attribute__((target("avx2"))) static bool abs(V a0, V a1, V& r) {
+                        const V sign = _mm256_set1_ps(-0.0f);
+                        V x = _mm256_andnot_ps(sign, in_order(_mm256_shuffle_ps(a0, a1, 0x88)));
+                        V y = _mm256_andnot_ps(sign, in_order(_mm256_shuffle_ps(a0, a1, 0xDD)));
+                        V m = _mm256_max_ps(x, y), q = _mm256_div_ps(_mm256_min_ps(x, y), m);
+                        r = _mm256_mul_ps(m, _mm256_sqrt_ps(_mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(q, q))));
+                        V regular = _mm256_and_ps(
+                            _mm256_cmp_ps(m, _mm256_setzero_ps(), _CMP_GT_OQ),
+                            _mm256_cmp_ps(m, _mm256_set1_ps(std::numeric_limits<float>::infinity()), _CMP_LT_OQ));
+                        return _mm256_movemask_ps(regular) == 0xFF;
+                    }
+                };
+
+                template <> struct Ops<double> {
+                    using V = __m256d;
+                    static constexpr size_t lanes = 2;
+                    __attribute__((target("avx2"))) static V load(const std::complex<double>* p) {
+                        return _mm256_loadu_pd(reinterpret_cast<const double*>(p));
+                    }
+                    __attribute__((target("avx2"))) static void store(std::complex<double>* p, V v) {
+                        _mm256_storeu_pd(reinterpret_cast<double*>(p), v);
+                    }
+                    __attribute__((target("avx2"))) static void store_real(double* p, V v) { _mm256_storeu_pd(p, v); }
+                    __attribute__((target("avx2"))) static V t1(V a, V b) {
+                        return _mm256_mul_pd(a, _mm256_movedup_pd(b));
+                    }
+                    __attribute__((target("avx2"))) static V t2(V a, V b) {
+                        return _mm256_mul_pd(_mm256_permute_pd(a, 0x5), _mm256_permute_pd(b, 0xF));
+                    }
+                    __attribute__((target("avx2"))) static V multiply(V a, V b) {
+                        return _mm256_addsub_pd(t1(a, b), t2(a, b));
+                    }
+                    __attribute__((target("avx2"))) static V multiply_conj(V a, V b) {
+                        return _mm256_addsub_pd(t1(a, b), _mm256_xor_pd(t2(a, b), _mm256_set1_pd(-0.0)));
+                    }
+                    __attribute__((target("avx2"))) static bool abs(V a0, V a1, V& r) {
+                        const V sign = _mm256_set1_pd(-0.0);
+                        V x = _mm256_andnot_pd(sign, _mm256_permute4x64_pd(_mm256_unpacklo_pd(a0, a1), 0xD8));
+                        V y = _mm256_andnot_pd(sign, _mm256_permute4x64_pd(_mm256_unpackhi_pd(a0, a1), 0xD8));
+                        V m = _mm256_max_pd(x, y), q = _mm256_div_pd(_mm256_min_pd(x, y), m);
+                        r = _mm256_mul_pd(m, _mm256_sqrt_pd(_mm256_add_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(q, q))));
+                        V regular = _mm256_and_pd(
+                            _mm256_cmp_pd(m, _mm256_setzero_pd(), _CMP_GT_OQ),
+                            _mm256_cmp_pd(m, _mm256_set1_pd(std::numeric_limits<double>::infinity()), _CMP_LT_OQ));
+                        return _mm256_movemask_pd(regular) == 0xF;
+                    }
+                };
+
+                GADGETRON_SIMD_LOOPS("avx2")
+            }
+
+            namespace avx512 {
+                template <class T> struct Ops;
+
+                // AVX-512 has no addsub; the imaginary (odd) lanes are computed with a mask instead.
+                template <> struct Ops<float> {
+                    using V = __m512;
+                    static constexpr size_t lanes = 8;
+                    static constexpr __mmask16 imag = 0xAAAA;
+                    __attribute__((target("avx512f"))) static V load(const std::complex<float>* p) {
+                        return _mm512_loadu_ps(reinterpret_cast<const float*>(p));
+                    }
+                    __attribute__((target("avx512f"))) static void store(std::complex<float>* p, V v) {
+                        _mm512_storeu_ps(reinterpret_cast<float*>(p), v);
+                    }
+                    __attribute__((target("avx512f"))) static void store_real(float* p, V v) {
+                        _mm512_storeu_ps(p, v);
+                    }
+                    __attribute__((target("avx512f"))) static V t1(V a, V b) {
+                        return _mm512_mul_ps(a, _mm512_moveldup_ps(b));
+                    }
+                    __attribute__((target("avx512f"))) static V t2(V a, V b) {
+                        return _mm512_mul_ps(_mm512_permute_ps(a, 0xB1), _mm512_movehdup_ps(b));
+                    }
+                    __attribute__((target("avx512f"))) static V multiply(V a, V b) {
+                        V x = t1(a, b), y = t2(a, b);
+                        return _mm512_mask_add_ps(_mm512_sub_ps(x, y), imag, x, y);
+                    }
+                    __attribute__((target("avx512f"))) static V multiply_conj(V a, V b) {
+                        V x = t1(a, b), y = t2(a, b);
+                        return _mm512_mask_sub_ps(_mm512_add_ps(x, y), imag, x, y);
+                    }
+                    __attribute__((target("avx512f"))) static bool abs(V a0, V a1, V& r) {
+                        const __m512i even = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0);
+                        const __m512i odd = _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1);
+                        V x = _mm512_abs_ps(_mm512_permutex2var_ps(a0, even, a1));
+                        V y = _mm512_abs_ps(_mm512_permutex2var_ps(a0, odd, a1));
+                        V m = _mm512_max_ps(x, y), q = _mm512_div_ps(_mm512_min_ps(x, y), m);
+                        r = _mm512_mul_ps(m, _mm512_sqrt_ps(_mm512_add_ps(_mm512_set1_ps(1.0f), _mm512_mul_ps(q, q))));
+                        __mmask16 regular = _mm512_cmp_ps_mask(m, _mm512_setzero_ps(), _CMP_GT_OQ)
+                            & _mm512_cmp_ps_mask(m, _mm512_set1_ps(std::numeric_limits<float>::infinity()), _CMP_LT_OQ);
+                        return regular == 0xFFFF;
+                    }
+                };
+
+                template <> struct Ops<double> {
+                    using V = __m512d;
+                    static constexpr size_t lanes = 4;
+                    static constexpr __mmask8 imag = 0xAA;
+                    __attribute__((target("avx512f"))) static V load(const std::complex<double>* p) {
+                        return _mm512_loadu_pd(reinterpret_cast<const double*>(p));
+                    }
+                    __attribute__((target("avx512f"))) static void store(std::complex<double>* p, V v) {
+                        _mm512_storeu_pd(reinterpret_cast<double*>(p), v);
+                    }
+                    __attribute__((target("avx512f"))) static void store_real(double* p, V v) {
+                        _mm512_storeu_pd(p, v);
+                    }
+                    __attribute__((target("avx512f"))) static V t1(V a, V b) {
+                        return _mm512_mul_pd(a, _mm512_movedup_pd(b));
+                    }
+                    __attribute__((target("avx512f"))) static V t2(V a, V b) {
+                        return _mm512_mul_pd(_mm512_permute_pd(a, 0x55), _mm512_permute_pd(b, 0xFF));
+                    }
+                    __attribute__((target("avx512f"))) static V multiply(V a, V b) {
+                        V x = t1(a, b), y = t2(a, b);
+                        return _mm512_mask_add_pd(_mm512_sub_pd(x, y), imag, x, y);
+                    }
+                    __attribute__((target("avx512f"))) static V multiply_conj(V a, V b) {
+                        V x = t1(a, b), y = t2(a, b);
+                        return _mm512_mask_sub_pd(_mm512_add_pd(x, y), imag, x, y);
+                    }
+                    __attribute__((target("avx512f"))) static bool abs(V a0, V a1, V& r) {
+                        const __m512i even = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+                        const __m512i odd = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+                        V x = _mm512_abs_pd(_mm512_permutex2var_pd(a0, even, a1));
+                        V y = _mm512_abs_pd(_mm512_permutex2var_pd(a0, odd, a1));
+                        V m = _mm512_max_pd(x, y), q = _mm512_div_pd(_mm512_min_pd(x, y), m);
+                        r = _mm512_mul_pd(m, _mm512_sqrt_pd(_mm512_add_pd(_mm512_set1_pd(1.0), _mm512_mul_pd(q, q))));
+                        __mmask8 regular = _mm512_cmp_pd_mask(m, _mm512_setzero_pd(), _CMP_GT_OQ)
+                            & _mm512_cmp_pd_mask(m, _mm512_set1_pd(std::numeric_limits<double>::infinity()), _CMP_LT_OQ);
+                        return regular == 0xFF;
+                    }
+                };
+
+                GADGETRON_SIMD_LOOPS("avx512f")
+            }
+
+#undef GADGETRON_SIMD_LOOPS
+
+            Level detect_level() {
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f")) return Level::avx512;
+                if (__builtin_cpu_supports("avx2")) return Level::avx2;
+                if (__builtin_cpu_supports("sse3")) return Level::sse3;
+                return Level::none;
+            }
+#else
+            Level detect_level() {
+                return Level::none;
+            }
+#endif
+
+            std::atomic<Level>& current_level() {
+                static std::atomic<Level> level{ supported_level() };
+                return level;
+            }
+        }
+
+        Level supported_level() {
+            static const Level level = detect_level();
+            return level;
+        }
+
+        Level level() {
+            return current_level().load(std::memory_order_relaxed);
+        }
+
+        Level set_level(Level level) {
+            level = std::min(level, supported_level());
+            current_level().store(level, std::memory_order_relaxed);
+            return level;
+        }
+
+        const char* to_string(Level level) {
+            switch (level) {
+            case Level::sse3: return "sse3";
+            case Level::avx2: return "avx2";
+            case Level::avx512: return "avx512";
+            default: return "scalar";
+            }
+        }
+
+#ifdef GADGETRON_SIMD_X86
+#define GADGETRON_SIMD_DISPATCH(function, ...)                                                                         \
+    switch (level()) {                                                                                                 \
+    case Level::avx512: return avx512::function(__VA_ARGS__);                                                          \
+    case Level::avx2: return avx2::function(__VA_ARGS__);                                                              \
+    case Level::sse3: return sse3::function(__VA_ARGS__);                                                              \
+    default: return scalar::function(__VA_ARGS__);                                                                     \
+    }
+#else
+#define GADGETRON_SIMD_DISPATCH(function, ...) return scalar::function(__VA_ARGS__);
+#endif
+
+        void multiply(size_t N, const std::complex<float>* x, const std::complex<float>* y, std::complex<float>* r) {
+            GADGETRON_SIMD_DISPATCH(multiply, N, x, y, r)
+        }
+        void multiply(size_t N, const std::complex<double>* x, const std::complex<double>* y, std::complex<double>* r) {
+            GADGETRON_SIMD_DISPATCH(multiply, N, x, y, r)
+        }
+        void multiply_conj(size_t N, const std::complex<float>* x, const std::complex<float>* y, std::complex<float>* r) {
+            GADGETRON_SIMD_DISPATCH(multiply_conj, N, x, y, r)
+        }
+        void multiply_conj(
+            size_t N, const std::complex<double>* x, const std::complex<double>* y, std::complex<double>* r) {
+            GADGETRON_SIMD_DISPATCH(multiply_conj, N, x, y, r)
+        }
+        void abs(size_t N, const std::complex<float>* x, float* r) {
+            GADGETRON_SIMD_DISPATCH(abs, N, x, r)
+        }
+        void abs(size_t N, const std::complex<double>* x, double* r) {
+            GADGETRON_SIMD_DISPATCH(abs, N, x, r)
+        }
+
+#undef GADGETRON_SIMD_DISPATCH
+    }
+}
@@ -0,0 +1,65 @@
+/** \file   hoNDArray_elemwise_simd.h
+    \brief  Vectorized kernels for the element-wise operations on complex arrays that compilers do not vectorize well.
+
+    The instruction set is picked at runtime from what the CPU supports (SSE3, AVX2 or AVX-512 on x86-64, scalar
+    code elsewhere). Products use the same formula as complext, (a.re*b.re - a.im*b.im, a.im*b.re + a.re*b.im).
+    Magnitudes are computed as max * sqrt(1 + (min/max)^2) of the absolute components, which, like std::hypot,
+    does not overflow or underflow for large or small values; zero, infinite and NaN magnitudes are std::hypot.
+    No level uses fused multiply-adds, so results do not depend on the level.
+ */
+
+#pragma once
+
+#include "complext.h"
+#include <complex>
+
+namespace Gadgetron {
+    namespace SIMD {
+
+        enum class Level { none, sse3, avx2, avx512 };
+
+        /// The best level supported by this CPU
+        Level supported_level();
+        /// The level in use; supported_level() unless changed by set_level
+        Level level();
+        /// Use at most the given level, e.g. to compare levels. Returns the level now in use.
+        Level set_level(Level level);
+
+        const char* to_string(Level level);
+
+        /// r = x * y
+        void multiply(size_t N, const std::complex<float>* x, const std::complex<float>* y, std::complex<float>* r);
+        void multiply(size_t N, const std::complex<double>* x, const std::complex<double>* y, std::complex<double>* r);
+
+        /// r = x * conj(y)
+        void multiply_conj(size_t N, const std::complex<float>* x, const std::complex<float>* y, std::complex<float>* r);
+        void multiply_conj(size_t N, const std::complex<double>* x, const std::complex<double>* y, std::complex<double>* r);
+
+        /// r = |x|
+        void abs(size_t N, const std::complex<float>* x, float* r);
+        void abs(size_t N, const std::complex<double>* x, double* r);
+
+        inline void multiply(size_t N, const complext<float>* x, const complext<float>* y, complext<float>* r) {
+            multiply(N, reinterpret_cast<const std::complex<float>*>(x), reinterpret_cast<const std::complex<float>*>(y),
+                reinterpret_cast<std::complex<float>*>(r));
+        }
+        inline void multiply(size_t N, const complext<double>* x, const complext<double>* y, complext<double>* r) {
+            multiply(N, reinterpret_cast<const std::complex<double>*>(x), reinterpret_cast<const std::complex<double>*>(y),
+                reinterpret_cast<std::complex<double>*>(r));
+        }
+        inline void multiply_conj(size_t N, const complext<float>* x, const complext<float>* y, complext<float>* r) {
+            multiply_conj(N, reinterpret_cast<const std::complex<float>*>(x),
+                reinterpret_cast<const std::complex<float>*>(y), reinterpret_cast<std::complex<float>*>(r));
+        }
+        inline void multiply_conj(size_t N, const complext<double>* x, const complext<double>* y, complext<double>* r) {
+            multiply_conj(N, reinterpret_cast<const std::complex<double>*>(x),
+                reinterpret_cast<const std::complex<double>*>(y), reinterpret_cast<std::complex<double>*>(r));
+        }
+        inline void abs(size_t N, const complext<float>* x, float* r) {
+            abs(N, reinterpret_cast<const std::complex<float>*>(x), r);
+        }
+        inline void abs(size_t N, const complext<double>* x, double* r) {
+            abs(N, reinterpret_cast<const std::complex<double>*>(x), r);
+        }
+    }
+}
@@ -0,0 +1,359 @@
+/** \file   hoNDArray_expressions.h
+    \brief  Lazily evaluated element-wise arithmetic on hoNDArrays.
+
+    The arithmetic operators (+, -, *, /, unary -) on hoNDArrays and scalars, and conj on hoNDArrays, return an
+    expression rather than an array. Expressions combine further with arrays, scalars, expressions and
+    conj/abs/real/imag, and are evaluated in a single pass when assigned to (or used to construct) a hoNDArray:
+
+        r = a * conj(b) + alpha * c;
+
+    reads a, b and c once and writes r once, where multiplyConj, scal and add would stream two temporaries through
+    memory. Evaluation is split across threads the same way as the functions in hoNDArray_elemwise.h, and stays on
+    the calling thread inside a parallel region.
+
+    Broadcasting follows add/multiply: an operand with fewer elements is repeated, and its number of elements must
+    divide that of the largest operand. The result has the dimensions of the largest operand. Assigning to an array
+    with the same number of elements writes into its existing storage, which may be one of the operands;
+    otherwise the array is recreated.
+
+    Expressions refer to the arrays they are built from, which must outlive them. Temporary arrays are moved into
+    the expression instead, so an expression kept in an auto variable may still use them:
+
+        auto e = load(...) * b;   // e keeps the array returned by load; b must outlive e
+ */
+
+#pragma once
+
+#include "hoNDArray_elemwise.h"
+
+#include <algorithm>
+#include <complex>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace Gadgetron {
+    namespace Expressions {
+
+        template <class T> using internal_type_t = typename ::gadgetron_detail::mathInternalType<T>::type;
+
+        template <class S> struct is_scalar : std::is_arithmetic<S> {};
+        template <class S> struct is_scalar<std::complex<S>> : std::true_type {};
+        // complext has overloads of its own; see the operators below
+
+        template <class S> constexpr bool is_scalar_v = is_scalar<S>::value;
+
+        //
+        // Nodes. Each node reports the number of elements and dimensions of its result, and is evaluated in
+        // contiguous runs: seek(begin) positions the node at element begin, after which node[i] is element
+        // begin + i, as long as begin + i is before run_end(begin), the first element at which a broadcast operand
+        // wraps around.
+        //
+
+        template <class T> class ArrayNode {
+        public:
+            using value_type = internal_type_t<T>;
+
+            explicit ArrayNode(const hoNDArray<T>& array)
+                : array(&array), data(reinterpret_cast<const value_type*>(array.data())), position(data) {}
+
+            // Takes over a temporary array, shared by all copies of the node
+            explicit ArrayNode(hoNDArray<T>&& temporary)
+                : ArrayNode(std::make_shared<const hoNDArray<T>>(std::move(temporary))) {}
+
+            size_t size() const { return array->size(); }
+            const std::vector<size_t>& dimensions() const { return array->dimensions(); }
+
+            size_t run_end(size_t begin) const { return begin - begin % size() + size(); }
+            void seek(size_t begin) { position = data + begin % size(); }
+            value_type operator[](size_t i) const { return position[i]; }
+
+        private:
+            explicit ArrayNode(std::shared_ptr<const hoNDArray<T>> owned) : ArrayNode(*owned) {
+                this->owned = std::move(owned);
+            }
+
+            std::shared_ptr<const hoNDArray<T>> owned;
+            const hoNDArray<T>* array;
+            const value_type* data;
+            const value_type* position;
+        };
+
+        template <class S> class ScalarNode {
+        public:
+            using value_type = internal_type_t<S>;
+
+            explicit ScalarNode(const S& value) : value(value) {}
+
+            size_t size() const { return 1; }
+            const std::vector<size_t>& dimensions() const {
+                static const std::vector<size_t> scalar_dimensions{ 1 };
+                return scalar_dimensions;
+            }
+
+            size_t run_end(size_t) const { return std::numeric_limits<size_t>::max(); }
+            void seek(size_t) {}
+            value_type operator[](size_t) const { return value; }
+
+        private:
+            value_type value;
+        };
+
+        template <class Op, class E> class UnaryNode {
+        public:
+            using value_type = std::decay_t<decltype(std::declval<Op>()(std::declval<typename E::value_type>()))>;
+
+            explicit UnaryNode(E operand) : operand(std::move(operand)) {}
+
+            size_t size() const { return operand.size(); }
+            const std::vector<size_t>& dimensions() const { return operand.dimensions(); }
+
+            size_t run_end(size_t begin) const { return operand.run_end(begin); }
+            void seek(size_t begin) { operand.seek(begin); }
+            value_type operator[](size_t i) const { return Op()(operand[i]); }
+
+        private:
+            E operand;
+        };
+
+        template <class Op, class L, class R> class BinaryNode {
+        public:
+            using value_type = std::decay_t<decltype(
+                std::declval<Op>()(std::declval<typename L::value_type>(), std::declval<typename R::value_type>()))>;
+
+            BinaryNode(L left, R right) : left(std::move(left)), right(std::move(right)) {
+                size_t nl = this->left.size();
+                size_t nr = this->right.size();
+                if ((nl == 0 || nr == 0) ? nl != nr : std::max(nl, nr) % std::min(nl, nr) != 0) {
+                    throw std::runtime_error("Expression operands have incompatible dimensions.");
+                }
+            }
+
+            size_t size() const { return std::max(left.size(), right.size()); }
+            const std::vector<size_t>& dimensions() const {
+                return left.size() >= right.size() ? left.dimensions() : right.dimensions();
+            }
+
+            size_t run_end(size_t begin) const { return std::min(left.run_end(begin), right.run_end(begin)); }
+            void seek(size_t begin) {
+                left.seek(begin);
+                right.seek(begin);
+            }
+            value_type operator[](size_t i) const { return Op()(left[i], right[i]); }
+
+        private:
+            L left;
+            R right;
+        };
+
+        struct conjugate {
+            template <class T> auto operator()(const T& x) const { return Gadgetron::conj(x); }
+        };
+
+        struct absolute {
+            template <class T> auto operator()(const T& x) const {
+                using Gadgetron::abs;
+                using std::abs;
+                return abs(x);
+            }
+        };
+
+        struct real_part {
+            template <class T> auto operator()(const T& x) const { return Gadgetron::real(x); }
+        };
+
+        struct imaginary_part {
+            template <class T> auto operator()(const T& x) const { return Gadgetron::imag(x); }
+        };
+
+        /**
+         * An element-wise expression. Every operator returns an Expression, whatever its nodes, which keeps these
+         * overloads more specialised than the generic scalar operators of complext.
+         */
+        template <class Node> class Expression {
+        public:
+            using value_type = typename Node::value_type;
+
+            explicit Expression(Node node) : node_(std::move(node)) {}
+
+            const Node& node() const { return node_; }
+            size_t size() const { return node_.size(); }
+            const std::vector<size_t>& dimensions() const { return node_.dimensions(); }
+
+            /**
+             * Evaluates the expression into r. r keeps its storage (and dimensions) if it has as many elements as
+             * the expression, and is recreated with the dimensions of the expression otherwise.
+             */
+            template <class R> void evaluate(hoNDArray<R>& r) const {
+                if (r.size() != size()) {
+                    // r may be one of the (broadcast) operands, so evaluate before replacing it
+                    hoNDArray<R> result(dimensions());
+                    evaluate_into(reinterpret_cast<internal_type_t<R>*>(result.data()));
+                    r = std::move(result);
+                    return;
+                }
+                evaluate_into(reinterpret_cast<internal_type_t<R>*>(r.data()));
+            }
+
+        private:
+            template <class R> void evaluate_into(R* out) const {
+                ::gadgetron_detail::for_each_chunk(size(), [&](long long chunk_begin, long long chunk_end) {
+                    Node node = node_; // Positions are per thread
+                    size_t begin = chunk_begin;
+                    while (begin < size_t(chunk_end)) {
+                        size_t end = std::min<size_t>(chunk_end, node.run_end(begin));
+                        node.seek(begin);
+                        R* run = out + begin;
+                        for (long long n = 0; n < (long long)(end - begin); n++) {
+                            run[n] = node[n];
+                        }
+                        begin = end;
+                    }
+                });
+            }
+
+            Node node_;
+        };
+
+        template <class T> ArrayNode<T> as_node(const hoNDArray<T>& array) { return ArrayNode<T>(array); }
+        template <class T> ArrayNode<T> as_node(hoNDArray<T>&& array) { return ArrayNode<T>(std::move(array)); }
+        template <class Node> const Node& as_node(const Expression<Node>& expression) { return expression.node(); }
+        template <class S> ScalarNode<S> as_node(const S& scalar) { return ScalarNode<S>(scalar); }
+
+        template <class Op, class A> auto make_expression(A&& a) {
+            using Node = UnaryNode<Op, std::decay_t<decltype(as_node(std::forward<A>(a)))>>;
+            return Expression<Node>(Node(as_node(std::forward<A>(a))));
+        }
+
+        template <class Op, class A, class B> auto make_expression(A&& a, B&& b) {
+            using Node = BinaryNode<Op, std::decay_t<decltype(as_node(std::forward<A>(a)))>,
+                std::decay_t<decltype(as_node(std::forward<B>(b)))>>;
+            return Expression<Node>(Node(as_node(std::forward<A>(a)), as_node(std::forward<B>(b))));
+        }
+
+        template <class Node> auto conj(const Expression<Node>& x) { return make_expression<conjugate>(x); }
+        template <class Node> auto abs(const Expression<Node>& x) { return make_expression<absolute>(x); }
+        template <class Node> auto real(const Expression<Node>& x) { return make_expression<real_part>(x); }
+        template <class Node> auto imag(const Expression<Node>& x) { return make_expression<imaginary_part>(x); }
+
+        template <class Node> auto operator-(const Expression<Node>& x) { return make_expression<std::negate<>>(x); }
+
+#define GADGETRON_EXPRESSION_OPERATOR(OP, FUNCTOR)                                                                    \
+    template <class L, class R> auto operator OP(const Expression<L>& x, const Expression<R>& y) {                    \
+        return make_expression<FUNCTOR>(x, y);                                                                        \
+    }                                                                                                                 \
+    template <class L, class T> auto operator OP(const Expression<L>& x, const hoNDArray<T>& y) {                     \
+        return make_expression<FUNCTOR>(x, y);                                                                        \
+    }                                                                                                                 \
+    template <class T, class R> auto operator OP(const hoNDArray<T>& x, const Expression<R>& y) {                     \
+        return make_expression<FUNCTOR>(x, y);                                                                        \
+    }                                                                                                                 \
+    template <class L, class T> auto operator OP(const Expression<L>& x, hoNDArray<T>&& y) {                          \
+        return make_expression<FUNCTOR>(x, std::move(y));                                                             \
+    }                                                                                                                 \
+    template <class T, class R> auto operator OP(hoNDArray<T>&& x, const Expression<R>& y) {                          \
+        return make_expression<FUNCTOR>(std::move(x), y);                                                             \
+    }                                                                                                                 \
+    template <class L, class S, class = std::enable_if_t<is_scalar_v<S>>>                                             \
+    auto operator OP(const Expression<L>& x, const S& y) {                                                            \
+        return make_expression<FUNCTOR>(x, y);                                                                        \
+    }                                                                                                                 \
+    template <class S, class R, class = std::enable_if_t<is_scalar_v<S>>>                                             \
+    auto operator OP(const S& x, const Expression<R>& y) {                                                            \
+        return make_expression<FUNCTOR>(x, y);                                                                        \
+    }                                                                                                                 \
+    template <class L, class S> auto operator OP(const Expression<L>& x, const complext<S>& y) {                      \
+        return make_expression<FUNCTOR>(x, y);                                                                        \
+    }                                                                                                                 \
+    template <class S, class R> auto operator OP(const complext<S>& x, const Expression<R>& y) {                      \
+        return make_expression<FUNCTOR>(x, y);                                                                        \
+    }
+
+        GADGETRON_EXPRESSION_OPERATOR(+, std::plus<>)
+        GADGETRON_EXPRESSION_OPERATOR(-, std::minus<>)
+        GADGETRON_EXPRESSION_OPERATOR(*, std::multiplies<>)
+        GADGETRON_EXPRESSION_OPERATOR(/, std::divides<>)
+#undef GADGETRON_EXPRESSION_OPERATOR
+    }
+
+    //
+    // Operators on arrays alone live in the namespace of hoNDArray, so that argument dependent lookup finds them
+    //
+
+    template <class T> auto conj(const hoNDArray<T>& x) {
+        return Expressions::make_expression<Expressions::conjugate>(x);
+    }
+    template <class T> auto conj(hoNDArray<T>&& x) {
+        return Expressions::make_expression<Expressions::conjugate>(std::move(x));
+    }
+
+    template <class T> auto operator-(const hoNDArray<T>& x) {
+        return Expressions::make_expression<std::negate<>>(x);
+    }
+    template <class T> auto operator-(hoNDArray<T>&& x) {
+        return Expressions::make_expression<std::negate<>>(std::move(x));
+    }
+
+#define GADGETRON_ARRAY_OPERATOR(OP, FUNCTOR)                                                                         \
+    template <class T, class S> auto operator OP(const hoNDArray<T>& x, const hoNDArray<S>& y) {                      \
+        return Expressions::make_expression<FUNCTOR>(x, y);                                                           \
+    }                                                                                                                 \
+    template <class T, class S, class = std::enable_if_t<Expressions::is_scalar_v<S>>>                                \
+    auto operator OP(const hoNDArray<T>& x, const S& y) {                                                             \
+        return Expressions::make_expression<FUNCTOR>(x, y);                                                           \
+    }                                                                                                                 \
+    template <class S, class T, class = std::enable_if_t<Expressions::is_scalar_v<S>>>                                \
+    auto operator OP(const S& x, const hoNDArray<T>& y) {                                                             \
+        return Expressions::make_expression<FUNCTOR>(x, y);                                                           \
+    }                                                                                                                 \
+    template <class T, class S> auto operator OP(const hoNDArray<T>& x, const complext<S>& y) {                       \
+        return Expressions::make_expression<FUNCTOR>(x, y);                                                           \
+    }                                                                                                                 \
+    template <class S, class T> auto operator OP(const complext<S>& x, const hoNDArray<T>& y) {                       \
+        return Expressions::make_expression<FUNCTOR>(x, y);                                                           \
+    }                                                                                                                 \
+    template <class T, class S> auto operator OP(hoNDArray<T>&& x, const hoNDArray<S>& y) {                           \
+        return Expressions::make_expression<FUNCTOR>(std::move(x), y);                                                \
+    }                                                                                                                 \
+    template <class T, class S> auto operator OP(const hoNDArray<T>& x, hoNDArray<S>&& y) {                           \
+        return Expressions::make_expression<FUNCTOR>(x, std::move(y));                                                \
+    }                                                                                                                 \
+    template <class T, class S> auto operator OP(hoNDArray<T>&& x, hoNDArray<S>&& y) {                                \
+        return Expressions::make_expression<FUNCTOR>(std::move(x), std::move(y));                                     \
+    }                                                                                                                 \
+    template <class T, class S, class = std::enable_if_t<Expressions::is_scalar_v<S>>>                                \
+    auto operator OP(hoNDArray<T>&& x, const S& y) {                                                                  \
+        return Expressions::make_expression<FUNCTOR>(std::move(x), y);                                                \
+    }                                                                                                                 \
+    template <class S, class T, class = std::enable_if_t<Expressions::is_scalar_v<S>>>                                \
+    auto operator OP(const S& x, hoNDArray<T>&& y) {                                                                  \
+        return Expressions::make_expression<FUNCTOR>(x, std::move(y));                                                \
+    }                                                                                                                 \
+    template <class T, class S> auto operator OP(hoNDArray<T>&& x, const complext<S>& y) {                            \
+        return Expressions::make_expression<FUNCTOR>(std::move(x), y);                                                \
+    }                                                                                                                 \
+    template <class S, class T> auto operator OP(const complext<S>& x, hoNDArray<T>&& y) {                            \
+        return Expressions::make_expression<FUNCTOR>(x, std::move(y));                                                \
+    }
+
+    GADGETRON_ARRAY_OPERATOR(+, std::plus<>)
+    GADGETRON_ARRAY_OPERATOR(-, std::minus<>)
+    GADGETRON_ARRAY_OPERATOR(*, std::multiplies<>)
+    GADGETRON_ARRAY_OPERATOR(/, std::divides<>)
+#undef GADGETRON_ARRAY_OPERATOR
+
+    template <class T>
+    template <class Node>
+    hoNDArray<T>::hoNDArray(const Expressions::Expression<Node>& expression) : hoNDArray(expression.dimensions()) {
+        expression.evaluate(*this);
+    }
+
+    template <class T>
+    template <class Node>
+    hoNDArray<T>& hoNDArray<T>::operator=(const Expressions::Expression<Node>& expression) {
+        expression.evaluate(*this);
+        return *this;
+    }
+}
@@ -2,3 +2,4 @@
 
 #include "hoNDArray_elemwise.h"
 #include "hoNDArray_reductions.h"
+#include "hoNDArray_expressions.h"
@@ -2,6 +2,7 @@
 // Include for Visual studio, 'cos reasons.
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <cstdio>
 #include <numeric>
 #include <set>
 
@@ -9,7 +10,15 @@
 #include "hoNDArray_elemwise.h"
 #include "hoNDArray_math.h"
 #include "hoNDFFT.h"
+#include "log.h"
+#include "trace.h"
 #include <boost/container/flat_set.hpp>
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <map>
+#include <random>
+#include <string>
 
 namespace Gadgetron {
 
@@ -47,13 +56,220 @@ namespace Gadgetron {
             static std::mutex lock;
         };
         std::mutex FFTLock::lock;
-        template <class T> class SingleFFTPlan : FFTLock {
+
+        std::atomic<FFT::PlanningMode> planning_mode{ FFT::PlanningMode::Estimate };
+
+        template <class T> struct fftw_wisdom {};
+
+        template <> struct fftw_wisdom<float> {
+            static constexpr auto import_from_file = fftwf_import_wisdom_from_filename;
+            static constexpr auto export_to_file   = fftwf_export_wisdom_to_filename;
+            static constexpr auto malloc           = fftwf_malloc;
+            static constexpr auto free             = fftwf_free;
+            static int alignment_of(const std::complex<float>* ptr) {
+                return fftwf_alignment_of((float*)ptr);
+            }
+            static std::string filename() { return "fftw_wisdom_float"; }
+        };
+
+        template <> struct fftw_wisdom<double> {
+            static constexpr auto import_from_file = fftw_import_wisdom_from_filename;
+            static constexpr auto export_to_file   = fftw_export_wisdom_to_filename;
+            static constexpr auto malloc           = fftw_malloc;
+            static constexpr auto free             = fftw_free;
+            static int alignment_of(const std::complex<double>* ptr) {
+                return fftw_alignment_of((double*)ptr);
+            }
+            static std::string filename() { return "fftw_wisdom_double"; }
+        };
+
+        /*
+         * Plans are shared between all threads and kept for the lifetime of the process. A cached plan is only
+         * reused for arrays with the same geometry, direction, placement (in or out of place) and SIMD alignment,
+         * since that is what FFTW's new-array execute functions require. Only planning and destruction need the
+         * FFTW planner lock; executing a plan is thread safe.
+         */
+        template <class T> class PlanCache : FFTLock {
+        public:
+            using Plan = std::shared_ptr<typename fftw_types<T>::plan>;
+            using FFTWComplex = typename fftw_types<T>::complex;
+
+            static PlanCache& instance() {
+                static auto cache = new PlanCache();
+                return *cache;
+            }
+
+            Plan get(const std::vector<fftw_iodim64>& dimensions, const std::complex<T>* input,
+                std::complex<T>* output, bool forward, bool aligned, const std::vector<fftw_iodim64>& howmany = {}) {
+
+                auto mode = planning_mode.load();
+                auto key  = std::vector<ptrdiff_t>{ forward, input == output, aligned, ptrdiff_t(mode) };
+                for (auto& dim : dimensions) {
+                    key.push_back(dim.n);
+                    key.push_back(dim.is);
+                    key.push_back(dim.os);
+                }
+                key.push_back(howmany.size());
+                for (auto& dim : howmany) {
+                    key.push_back(dim.n);
+                    key.push_back(dim.is);
+                    key.push_back(dim.os);
+                }
+
+                {
+                    std::lock_guard<std::mutex> guard(cache_mutex);
+                    auto it = plans.find(key);
+                    if (it != plans.end()) {
+                        hits++;
+                        recently_used.splice(recently_used.begin(), recently_used, it->second.position);
+                        return it->second.plan;
+                    }
+                }
+
+                misses++;
+                auto plan = create_plan(dimensions, howmany, input, output, forward, aligned, mode);
+
+                std::lock_guard<std::mutex> guard(cache_mutex);
+                auto inserted = plans.emplace(key, Entry{ plan, recently_used.end() });
+                if (inserted.second) {
+                    recently_used.push_front(key);
+                    inserted.first->second.position = recently_used.begin();
+                    if (plans.size() > max_cached_plans) {
+                        plans.erase(recently_used.back());
+                        recently_used.pop_back();
+                    }
+                }
+                return inserted.first->second.plan;
+            }
+
+            void clear() {
+                std::lock_guard<std::mutex> guard(cache_mutex);
+                plans.clear();
+                recently_used.clear();
+            }
+
+            FFT::PlanCacheStatistics statistics() {
+                std::lock_guard<std::mutex> guard(cache_mutex);
+                return { hits.load(), misses.load(), plans.size() };
+            }
+
+            void import_wisdom(const std::string& folder) {
+                std::lock_guard<std::mutex> guard(lock);
+                wisdom_file = folder + "/" + fftw_wisdom<T>::filename();
+                if (fftw_wisdom<T>::import_from_file(wisdom_file.c_str())) {
+                    GDEBUG_STREAM("Imported FFTW wisdom from " << wisdom_file);
+                }
+            }
+
+            void export_wisdom() {
+                std::lock_guard<std::mutex> guard(lock);
+                export_wisdom_unlocked();
+            }
+
+        private:
+            static constexpr size_t max_cached_plans = 512;
+
+            struct Entry {
+                Plan plan;
+                typename std::list<std::vector<ptrdiff_t>>::iterator position;
+            };
+
+            // Written under a name of its own and renamed, so that other processes never import partial wisdom
+            void export_wisdom_unlocked() {
+                if (wisdom_file.empty())
+                    return;
+
+                std::random_device random;
+                auto temporary = wisdom_file + "." + std::to_string(random()) + std::to_string(random());
+                if (!fftw_wisdom<T>::export_to_file(temporary.c_str())) {
+                    GWARN_STREAM("Failed to export FFTW wisdom to " << temporary);
+                    std::remove(temporary.c_str());
+                    return;
+                }
+#ifdef _WIN32
+                std::remove(wisdom_file.c_str()); // rename does not replace an existing file here
+#endif
+                if (std::rename(temporary.c_str(), wisdom_file.c_str()) != 0) {
+                    GWARN_STREAM("Failed to export FFTW wisdom to " << wisdom_file);
+                    std::remove(temporary.c_str());
+                }
+            }
+
+            Plan create_plan(const std::vector<fftw_iodim64>& dimensions, const std::vector<fftw_iodim64>& howmany,
+                const std::complex<T>* input, std::complex<T>* output, bool forward, bool aligned,
+                FFT::PlanningMode mode) {
+
+                unsigned flags = mode == FFT::PlanningMode::Measure ? FFTW_MEASURE : FFTW_ESTIMATE;
+                if (!aligned)
+                    flags |= FFTW_UNALIGNED;
+
+                std::lock_guard<std::mutex> guard(lock);
+
+                typename fftw_types<T>::plan* plan;
+                if (mode == FFT::PlanningMode::Measure) {
+                    // Measuring overwrites the arrays, so plan on scratch buffers covering the same extent.
+                    ptrdiff_t extent = 1;
+                    for (auto& dim : dimensions)
+                        extent += (dim.n - 1) * std::max(dim.is, dim.os);
+                    for (auto& dim : howmany)
+                        extent += (dim.n - 1) * std::max(dim.is, dim.os);
+
+                    bool in_place = input == output;
+                    auto scratch_in  = (FFTWComplex*)fftw_wisdom<T>::malloc(extent * sizeof(FFTWComplex));
+                    auto scratch_out = in_place ? scratch_in
+                                                : (FFTWComplex*)fftw_wisdom<T>::malloc(extent * sizeof(FFTWComplex));
+
+                    plan = fftw_types<T>::plan_guru(dimensions.size(), dimensions.data(), howmany.size(),
+                        howmany.data(), scratch_in, scratch_out, forward ? FFTW_FORWARD : FFTW_BACKWARD, flags);
+
+                    fftw_wisdom<T>::free(scratch_in);
+                    if (!in_place)
+                        fftw_wisdom<T>::free(scratch_out);
+                    if (plan)
+                        export_wisdom_unlocked();
+                } else {
+                    plan = fftw_types<T>::plan_guru(dimensions.size(), dimensions.data(), howmany.size(),
+                        howmany.data(), (FFTWComplex*)input, (FFTWComplex*)output,
+                        forward ? FFTW_FORWARD : FFTW_BACKWARD, flags);
+                }
+
+                if (plan == nullptr)
+                    throw std::runtime_error("Illegal FFT plan created");
+
+                return Plan(plan, [](typename fftw_types<T>::plan* plan) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    fftw_types<T>::destroy_plan(plan);
+                });
+            }
+
+            std::mutex cache_mutex;
+            std::map<std::vector<ptrdiff_t>, Entry> plans;
+            std::list<std::vector<ptrdiff_t>> recently_used;
+            std::atomic<size_t> hits{ 0 };
+            std::atomic<size_t> misses{ 0 };
+            std::string wisdom_file;
+        };
+
+        /*
+         * Whether every pointer a plan will be executed on shares the SIMD alignment of the first. Checking the first
+         * batch offset is enough, as all other batches are multiples of it.
+         */
+        template <class T>
+        bool simd_aligned(const std::complex<T>* input, const std::complex<T>* output,
+            std::initializer_list<size_t> batch_offsets) {
+            auto aligned = [](const std::complex<T>* ptr) { return fftw_wisdom<T>::alignment_of(ptr) == 0; };
+            if (!aligned(input) || !aligned(output))
+                return false;
+            return std::all_of(batch_offsets.begin(), batch_offsets.end(),
+                [&](size_t offset) { return aligned(input + offset) && aligned(output + offset); });
+        }
+
+        template <class T> class SingleFFTPlan {
         public:
             using FFTWComplex = typename fftw_types<T>::complex;
 
             SingleFFTPlan(int dimension, const hoNDArray<std::complex<T>>& input, hoNDArray<std::complex<T>>& output,
                 bool forward) {
-                std::lock_guard<std::mutex> guard(lock);
 
                 const auto& dimensions = input.dimensions();
                 size_t stride
@@ -61,29 +277,24 @@ namespace Gadgetron {
 
                 auto fftw_dimensions = fftw_iodim64{ static_cast<ptrdiff_t>(dimensions[dimension]), static_cast<ptrdiff_t>(stride), static_cast<ptrdiff_t>(stride) };
 
-                plan = fftw_types<T>::plan_guru(1, &fftw_dimensions, 0, nullptr, (FFTWComplex*)input.data(),
-                    (FFTWComplex*)output.data(), forward ? FFTW_FORWARD : FFTW_BACKWARD, FFTW_ESTIMATE);
-            }
-
-            ~SingleFFTPlan() {
-                std::lock_guard<std::mutex> guard(lock);
-                fftw_types<T>::destroy_plan(plan);
+                bool aligned = simd_aligned(input.data(), output.data(), { size_t(1), stride * dimensions[dimension] });
+                plan = PlanCache<T>::instance().get({ fftw_dimensions }, input.data(), output.data(), forward, aligned);
             }
 
             void execute(const std::complex<T>* input, std::complex<T>* output) {
-                fftw_types<T>::execute_dft(plan, (FFTWComplex*)input, (FFTWComplex*)output);
+                fftw_types<T>::execute_dft(plan.get(), (FFTWComplex*)input, (FFTWComplex*)output);
             }
 
         private:
-            typename fftw_types<T>::plan* plan;
+            typename PlanCache<T>::Plan plan;
         };
 
-        template <class T> class ContigousFFTPlan : FFTLock {
+        template <class T> class ContigousFFTPlan {
         public:
             using FFTWComplex = typename fftw_types<T>::complex;
-            ContigousFFTPlan(
-                int rank, const hoNDArray<std::complex<T>>& input, hoNDArray<std::complex<T>>& output, bool forward) {
-                std::lock_guard<std::mutex> guard(lock);
+            /// Transforms howmany consecutive batches of the first rank dimensions per execution.
+            ContigousFFTPlan(int rank, const hoNDArray<std::complex<T>>& input, hoNDArray<std::complex<T>>& output,
+                bool forward, size_t howmany = 1) {
 
                 const auto& dimensions = input.dimensions();
 
@@ -97,22 +308,22 @@ namespace Gadgetron {
                     fftw_dimensions[i] = { (int64_t)dimensions[i], (int64_t)strides[i], (int64_t)strides[i] };
                 }
                 std::reverse(fftw_dimensions.begin(),fftw_dimensions.end());
-                plan = fftw_types<T>::plan_guru(rank, fftw_dimensions.data(), 0, nullptr, (FFTWComplex*)input.data(),
-                    (FFTWComplex*)output.data(), forward ? FFTW_FORWARD : FFTW_BACKWARD, FFTW_ESTIMATE);
 
-                if (plan == nullptr) throw std::runtime_error("Illegal FFT plan created");
-            }
-            ~ContigousFFTPlan() {
-                std::lock_guard<std::mutex> guard(lock);
-                fftw_types<T>::destroy_plan(plan);
+                auto batches = std::vector<fftw_iodim64>();
+                if (howmany > 1)
+                    batches.push_back({ (int64_t)howmany, (int64_t)strides[rank], (int64_t)strides[rank] });
+
+                bool aligned = simd_aligned(input.data(), output.data(), { strides[rank] });
+                plan = PlanCache<T>::instance().get(
+                    fftw_dimensions, input.data(), output.data(), forward, aligned, batches);
             }
 
             void execute(const std::complex<T>* input, std::complex<T>* output) {
-                fftw_types<T>::execute_dft(plan, (FFTWComplex*)input, (FFTWComplex*)output);
+                fftw_types<T>::execute_dft(plan.get(), (FFTWComplex*)input, (FFTWComplex*)output);
             }
 
         private:
-            typename fftw_types<T>::plan* plan;
+            typename PlanCache<T>::Plan plan;
         };
 
 
@@ -129,6 +340,7 @@ namespace Gadgetron {
         template <typename T>
         static void contigous_fftn(const hoNDArray<std::complex<T>>& input, hoNDArray<std::complex<T>>& output, int rank,
             bool forward, bool normalize) {
+            GADGETRON_TRACE_SPAN(forward ? "fft_contiguous" : "ifft_contiguous");
 
             auto plan = ContigousFFTPlan<T>(rank, input, output, forward);
             size_t batch_size
@@ -149,6 +361,7 @@ namespace Gadgetron {
         static void single_fft(int dimension, const hoNDArray<std::complex<T>>& a, hoNDArray<std::complex<T>>& r,
             bool forward, bool normalize) {
             assert(dimension >= 0);
+            GADGETRON_TRACE_SPAN(forward ? "fft_single_dimension" : "ifft_single_dimension");
             auto plan              = SingleFFTPlan<T>(dimension, a, r, forward);
             const auto& dimensions = a.dimensions();
             size_t inner_batches
@@ -189,7 +402,7 @@ namespace Gadgetron {
             size_t n2, INDICES... indices) {
             for (size_t i = 0; i < n; i++) {
                 auto line_begin  = a + i * stride;
-                size_t new_y     = i < pivot ? i + pivot : i - pivot;
+                size_t new_y     = i < pivot ? i + n - pivot : i - pivot;
                 auto output_line = r + new_y * stride;
                 fftshift(line_begin, output_line, stride / n2, n2, indices...);
             }
@@ -224,6 +437,103 @@ namespace Gadgetron {
             }
         }
 
+        /*
+         * Copies a block of dimensions[0..dim] from a to r, rotating each dimension left by its pivot and multiplying
+         * by scale, unless scale is one. strides[d] is the number of elements in dimensions[0..d).
+         */
+        template <typename T>
+        void fftshift(const std::complex<T>* a, std::complex<T>* r, const size_t* dimensions, const size_t* strides,
+            const size_t* pivots, int dim, T scale) {
+            size_t n = dimensions[dim], pivot = pivots[dim];
+            if (dim == 0) {
+                if (scale == T(1)) {
+                    std::rotate_copy(a, a + pivot, a + n, r);
+                } else {
+                    auto scaled = [scale](const std::complex<T>& value) { return value * scale; };
+                    std::transform(a + pivot, a + n, r, scaled);
+                    std::transform(a, a + pivot, r + n - pivot, scaled);
+                }
+                return;
+            }
+            for (size_t i = 0; i < n; i++) {
+                size_t shifted = i < pivot ? i + n - pivot : i - pivot;
+                fftshift(a + i * strides[dim], r + shifted * strides[dim], dimensions, strides, pivots, dim - 1, scale);
+            }
+        }
+
+        /*
+         * Centered transform, fftshift(fft(ifftshift(a))), over the first rank dimensions. Batches are copied into a
+         * per-thread buffer with the ifftshift folded into the copy, transformed in place there, and copied out with
+         * the normalization and the fftshift folded in. Every element is read and written once, instead of in a
+         * separate pass for each shift and for the normalization. Small batches (e.g. single lines for fft1c) are
+         * gathered into chunks of up to centered_chunk_elements and transformed by one howmany plan, so FFTW is not
+         * entered once per line. The result matches shifting separately up to floating point rounding; FFTW may pick
+         * different algorithms for the batched plan.
+         */
+        constexpr size_t centered_chunk_elements = 16384;
+
+        template <typename T>
+        void centered_fftn(
+            const hoNDArray<std::complex<T>>& a, hoNDArray<std::complex<T>>& r, int rank, bool forward) {
+            GADGETRON_TRACE_SPAN(forward ? "fft_centered" : "ifft_centered");
+
+            if (!r.dimensions_equal(&a))
+                r.create(a.dimensions());
+
+            auto dimensions       = std::vector<size_t>(rank);
+            auto strides          = std::vector<size_t>(rank, 1);
+            auto ifftshift_pivots = std::vector<size_t>(rank);
+            auto fftshift_pivots  = std::vector<size_t>(rank);
+            for (int d = 0; d < rank; d++) {
+                dimensions[d]       = a.get_size(d);
+                ifftshift_pivots[d] = dimensions[d] - (dimensions[d] + 1) / 2;
+                fftshift_pivots[d]  = (dimensions[d] + 1) / 2;
+                if (d > 0)
+                    strides[d] = strides[d - 1] * dimensions[d - 1];
+            }
+
+            size_t batch_size = std::accumulate(dimensions.begin(), dimensions.end(), size_t(1), std::multiplies<>());
+            size_t batches    = a.size() / batch_size;
+            if (batches == 0)
+                return;
+
+            // Chunks no larger than an even share of the batches, so that every thread gets work
+            size_t threads = omp_get_max_threads();
+            size_t chunk   = std::max<size_t>(1, centered_chunk_elements / batch_size);
+            chunk          = std::min(chunk, (batches + threads - 1) / threads);
+            size_t chunks  = (batches + chunk - 1) / chunk;
+            size_t tail    = batches - (chunks - 1) * chunk;
+
+            // Every thread transforms in a buffer allocated like this one, so they share its alignment
+            auto buffer_dimensions = dimensions;
+            buffer_dimensions.push_back(chunk);
+            hoNDArray<std::complex<T>> buffer(buffer_dimensions);
+            auto plan      = ContigousFFTPlan<T>(rank, buffer, buffer, forward, chunk);
+            auto tail_plan = tail == chunk ? plan : ContigousFFTPlan<T>(rank, buffer, buffer, forward, tail);
+            const T scale  = T(1) / std::sqrt(T(batch_size));
+
+#pragma omp parallel if (chunks > 1) default(shared)
+            {
+                hoNDArray<std::complex<T>> thread_buffer;
+                if (omp_get_thread_num() > 0)
+                    thread_buffer.create(buffer_dimensions);
+                auto& local = omp_get_thread_num() > 0 ? thread_buffer : buffer;
+
+#pragma omp for
+                for (long long c = 0; c < (long long)chunks; c++) {
+                    size_t first = c * chunk;
+                    size_t count = std::min(chunk, batches - first);
+                    for (size_t i = 0; i < count; i++)
+                        fftshift(a.data() + (first + i) * batch_size, local.data() + i * batch_size,
+                            dimensions.data(), strides.data(), ifftshift_pivots.data(), rank - 1, T(1));
+                    (count == chunk ? plan : tail_plan).execute(local.data(), local.data());
+                    for (size_t i = 0; i < count; i++)
+                        fftshift(local.data() + i * batch_size, r.data() + (first + i) * batch_size,
+                            dimensions.data(), strides.data(), fftshift_pivots.data(), rank - 1, scale);
+                }
+            }
+        }
+
     }
 
     template <typename T> static void fftshiftPivot1D(std::complex<T>* a, size_t x, size_t n, size_t pivot) {
@@ -304,6 +614,13 @@ namespace Gadgetron {
         if (a == NULL)
             throw std::runtime_error("hoNDFFT::fftshiftPivot2D: void ptr provided");
 
+        // Swapping lines pairwise only rotates an even number of them, so odd sizes are shifted from a copy
+        if (y % 2) {
+            std::vector<std::complex<T>> copy(a, a + x * y * n);
+            fftshiftPivot2D(copy.data(), a, x, y, n, pivotx, pivoty);
+            return;
+        }
+
 #pragma omp parallel if (n > 16) default(shared)
         {
             std::vector<std::complex<T>> buffer(x);
@@ -385,6 +702,13 @@ namespace Gadgetron {
         if (a == NULL)
             throw std::runtime_error("hoNDFFT::fftshiftPivot3D: void ptr provided");
 
+        // Swapping lines pairwise only rotates an even number of them, so odd sizes are shifted from a copy
+        if (y % 2 || z % 2) {
+            std::vector<std::complex<T>> copy(a, a + x * y * z * n);
+            fftshiftPivot3D(copy.data(), a, x, y, z, n, pivotx, pivoty, pivotz);
+            return;
+        }
+
         long long tt;
 
 #pragma omp parallel private(tt)  if (n > 16) default(shared)
@@ -507,43 +831,31 @@ namespace Gadgetron {
     }
 
     template <typename T> inline void hoNDFFT<T>::fft1c(hoNDArray<ComplexType>& a) {
-        ifftshift1D(a);
-        fft1(a);
-        fftshift1D(a);
+        centered_fftn(a, a, 1, true);
     }
 
     template <typename T> inline void hoNDFFT<T>::ifft1c(hoNDArray<ComplexType>& a) {
-        ifftshift1D(a);
-        ifft1(a);
-        fftshift1D(a);
+        centered_fftn(a, a, 1, false);
     }
 
     template <typename T> inline void hoNDFFT<T>::fft1c(const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r) {
-        ifftshift1D(a, r);
-        fft1(r);
-        fftshift1D(r);
+        centered_fftn(a, r, 1, true);
     }
 
     template <typename T> inline void hoNDFFT<T>::ifft1c(const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r) {
-        ifftshift1D(a, r);
-        ifft1(r);
-        fftshift1D(r);
+        centered_fftn(a, r, 1, false);
     }
 
     template <typename T>
     inline void hoNDFFT<T>::fft1c(
         const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r, hoNDArray<ComplexType>& buf) {
-        ifftshift1D(a, r);
-        fft1(r, buf);
-        fftshift1D(buf, r);
+        centered_fftn(a, r, 1, true);
     }
 
     template <typename T>
     inline void hoNDFFT<T>::ifft1c(
         const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r, hoNDArray<ComplexType>& buf) {
-        ifftshift1D(a, r);
-        ifft1(r, buf);
-        fftshift1D(buf, r);
+        centered_fftn(a, r, 1, false);
     }
 
     // -----------------------------------------------------------------------------------------
@@ -573,43 +885,31 @@ namespace Gadgetron {
     }
 
     template <typename T> inline void hoNDFFT<T>::fft2c(hoNDArray<ComplexType>& a) {
-        ifftshift2D(a);
-        fft2(a);
-        fftshift2D(a);
+        centered_fftn(a, a, 2, true);
     }
 
     template <typename T> inline void hoNDFFT<T>::ifft2c(hoNDArray<ComplexType>& a) {
-        ifftshift2D(a);
-        ifft2(a);
-        fftshift2D(a);
+        centered_fftn(a, a, 2, false);
     }
 
     template <typename T> inline void hoNDFFT<T>::fft2c(const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r) {
-        ifftshift2D(a, r);
-        fft2(r);
-        fftshift2D(r);
+        centered_fftn(a, r, 2, true);
     }
 
     template <typename T> inline void hoNDFFT<T>::ifft2c(const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r) {
-        ifftshift2D(a, r);
-        ifft2(r);
-        fftshift2D(r);
+        centered_fftn(a, r, 2, false);
     }
 
     template <typename T>
     inline void hoNDFFT<T>::fft2c(
         const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r, hoNDArray<ComplexType>& buf) {
-        ifftshift2D(a, r);
-        fft2(r, buf);
-        fftshift2D(buf, r);
+        centered_fftn(a, r, 2, true);
     }
 
     template <typename T>
     inline void hoNDFFT<T>::ifft2c(
         const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r, hoNDArray<ComplexType>& buf) {
-        ifftshift2D(a, r);
-        ifft2(r, buf);
-        fftshift2D(buf, r);
+        centered_fftn(a, r, 2, false);
     }
 
     // -----------------------------------------------------------------------------------------
@@ -639,43 +939,31 @@ namespace Gadgetron {
     }
 
     template <typename T> inline void hoNDFFT<T>::fft3c(hoNDArray<ComplexType>& a) {
-        ifftshift3D(a);
-        fft3(a);
-        fftshift3D(a);
+        centered_fftn(a, a, 3, true);
     }
 
     template <typename T> inline void hoNDFFT<T>::ifft3c(hoNDArray<ComplexType>& a) {
-        ifftshift3D(a);
-        ifft3(a);
-        fftshift3D(a);
+        centered_fftn(a, a, 3, false);
     }
 
     template <typename T> inline void hoNDFFT<T>::fft3c(const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r) {
-        ifftshift3D(a, r);
-        fft3(r);
-        fftshift3D(r);
+        centered_fftn(a, r, 3, true);
     }
 
     template <typename T> inline void hoNDFFT<T>::ifft3c(const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r) {
-        ifftshift3D(a, r);
-        ifft3(r);
-        fftshift3D(r);
+        centered_fftn(a, r, 3, false);
     }
 
     template <typename T>
     inline void hoNDFFT<T>::fft3c(
         const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r, hoNDArray<ComplexType>& buf) {
-        ifftshift3D(a, r);
-        fft3(r, buf);
-        fftshift3D(buf, r);
+        centered_fftn(a, r, 3, true);
     }
 
     template <typename T>
     inline void hoNDFFT<T>::ifft3c(
         const hoNDArray<ComplexType>& a, hoNDArray<ComplexType>& r, hoNDArray<ComplexType>& buf) {
-        ifftshift3D(a, r);
-        ifft3(r, buf);
-        fftshift3D(buf, r);
+        centered_fftn(a, r, 3, false);
     }
 
     template <typename T> void fft1(hoNDArray<std::complex<T>>& a, bool forward) {
@@ -879,6 +1167,35 @@ namespace Gadgetron {
     // Instantiation
     //
 
+    void FFT::set_planning_mode(PlanningMode mode) {
+        planning_mode = mode;
+    }
+
+    FFT::PlanningMode FFT::get_planning_mode() {
+        return planning_mode;
+    }
+
+    FFT::PlanCacheStatistics FFT::plan_cache_statistics() {
+        auto single = PlanCache<float>::instance().statistics();
+        auto doubles = PlanCache<double>::instance().statistics();
+        return { single.hits + doubles.hits, single.misses + doubles.misses, single.plans + doubles.plans };
+    }
+
+    void FFT::clear_plan_cache() {
+        PlanCache<float>::instance().clear();
+        PlanCache<double>::instance().clear();
+    }
+
+    void FFT::use_wisdom_folder(const std::string& folder) {
+        PlanCache<float>::instance().import_wisdom(folder);
+        PlanCache<double>::instance().import_wisdom(folder);
+    }
+
+    void FFT::export_wisdom() {
+        PlanCache<float>::instance().export_wisdom();
+        PlanCache<double>::instance().export_wisdom();
+    }
+
     template class EXPORTCPUFFT hoNDFFT<float>;
     template class EXPORTCPUFFT hoNDFFT<double>;
 
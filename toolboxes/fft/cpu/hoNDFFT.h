@@ -13,6 +13,7 @@
 #include <fftw3.h>
 #include <iostream>
 #include <mutex>
+#include <string>
 
 #ifdef USE_OMP
 #include "omp.h"
@@ -223,7 +224,31 @@ dimensions Access using e.g. FFT<float>::instance()
 
     namespace FFT {
 
-
+        /**
+         * How much effort FFTW spends on planning. Plans are cached per array geometry, so Measure trades a slower
+         * first transform of each shape for faster transforms afterwards.
+         */
+        enum class PlanningMode { Estimate, Measure };
+
+        EXPORTCPUFFT void set_planning_mode(PlanningMode mode);
+        EXPORTCPUFFT PlanningMode get_planning_mode();
+
+        struct PlanCacheStatistics {
+            size_t hits;
+            size_t misses;
+            size_t plans;
+        };
+
+        /// Hits and misses of the process wide FFTW plan cache, summed over float and double precision
+        EXPORTCPUFFT PlanCacheStatistics plan_cache_statistics();
+        EXPORTCPUFFT void clear_plan_cache();
+
+        /**
+         * Imports FFTW wisdom from the folder, if present, and exports wisdom back to it whenever a new plan is
+         * measured. The folder must exist.
+         */
+        EXPORTCPUFFT void use_wisdom_folder(const std::string& folder);
+        EXPORTCPUFFT void export_wisdom();
     }
 
 }
@@ -0,0 +1,261 @@
+#include "hoIncrementalKLT.h"
+#include "cpp_blas.h"
+#include "hoNDArray_elemwise.h"
+#include "hoNDArray_linalg.h"
+
+#include <algorithm>
+
+namespace Gadgetron{
+
+template<typename T>
+hoIncrementalKLT<T>::hoIncrementalKLT() : N_(0), samples_(0)
+{
+}
+
+template<typename T>
+hoIncrementalKLT<T>::hoIncrementalKLT(size_t N, const std::vector<size_t>& untransformed) : N_(0), samples_(0)
+{
+    this->reset(N, untransformed);
+}
+
+template<typename T>
+void hoIncrementalKLT<T>::reset(size_t N, const std::vector<size_t>& untransformed)
+{
+    GADGET_CHECK_THROW(untransformed.size() < N);
+    for (auto u : untransformed) GADGET_CHECK_THROW(u < N);
+
+    N_ = N;
+    untransformed_ = untransformed;
+
+    sum_.create(N);
+    product_.create(N, N);
+    Gadgetron::clear(sum_);
+    Gadgetron::clear(product_);
+    samples_ = 0;
+
+    V_.clear();
+    E_.clear();
+}
+
+template<typename T>
+void hoIncrementalKLT<T>::update(const hoNDArray<T>& data, size_t start, size_t length)
+{
+    size_t E = data.get_size(0);
+    GADGET_CHECK_THROW(data.get_number_of_elements() == E*N_);
+    GADGET_CHECK_THROW(start <= E);
+
+    if (length == 0) length = E - start;
+    GADGET_CHECK_THROW(start + length <= E);
+    if (length == 0) return;
+
+    const T* pData = data.begin() + start;
+
+    // product += data' * data, upper triangle only
+    BLAS::herk(true, true, N_, length, value_type(1), pData, E, value_type(1), product_.begin(), N_);
+
+    for (size_t n = 0; n < N_; n++)
+    {
+        const T* pChannel = pData + n*E;
+        T s = 0;
+        for (size_t e = 0; e < length; e++) s += pChannel[e];
+        sum_(n) += s;
+    }
+
+    samples_ += length;
+}
+
+template<typename T>
+void hoIncrementalKLT<T>::forget(value_type factor)
+{
+    Gadgetron::scal(T(factor), sum_);
+    Gadgetron::scal(T(factor), product_);
+    samples_ *= factor;
+}
+
+template<typename T>
+size_t hoIncrementalKLT<T>::number_of_channels() const
+{
+    return N_;
+}
+
+template<typename T>
+typename hoIncrementalKLT<T>::value_type hoIncrementalKLT<T>::number_of_samples() const
+{
+    return samples_;
+}
+
+template<typename T>
+void hoIncrementalKLT<T>::covariance(hoNDArray<T>& C) const
+{
+    C.create(N_, N_);
+
+    for (size_t j = 0; j < N_; j++)
+    {
+        for (size_t i = 0; i <= j; i++)
+        {
+            T c = product_(i, j);
+            if (samples_ > 0) c -= std::conj(sum_(i)) * sum_(j) / samples_;
+
+            C(i, j) = c;
+            C(j, i) = std::conj(c);
+        }
+        C(j, j) = std::real(C(j, j));
+    }
+}
+
+template<typename T>
+void hoIncrementalKLT<T>::prepare()
+{
+    hoNDArray<T> C;
+    this->covariance(C);
+    eigen_basis(C, untransformed_, V_, E_);
+}
+
+template<typename T>
+void hoIncrementalKLT<T>::eigen_basis(const hoNDArray<T>& C, const std::vector<size_t>& untransformed, hoNDArray<T>& V, hoNDArray<value_type>& E)
+{
+    try
+    {
+        size_t N = C.get_size(0);
+        GADGET_CHECK_THROW(C.get_size(1) == N);
+
+        size_t unN = untransformed.size();
+        GADGET_CHECK_THROW(unN < N);
+
+        std::vector<size_t> transformed;
+        for (size_t n = 0; n < N; n++)
+        {
+            if (std::find(untransformed.begin(), untransformed.end(), n) == untransformed.end()) transformed.push_back(n);
+        }
+        size_t Nt = transformed.size();
+
+        hoNDArray<T> Ct(Nt, Nt);
+        for (size_t b = 0; b < Nt; b++)
+        {
+            for (size_t a = 0; a < Nt; a++)
+            {
+                Ct(a, b) = C(transformed[a], transformed[b]);
+            }
+        }
+
+        // eigen values in ascending order, eigen vectors in the columns of Ct
+        hoNDArray<value_type> D;
+        Gadgetron::heev(Ct, D);
+
+        V.create(N, N);
+        E.create(N);
+        Gadgetron::clear(V);
+
+        for (size_t d = 0; d < unN; d++)
+        {
+            V(untransformed[d], d) = 1;
+            E(d) = D(Nt - 1);
+        }
+
+        for (size_t k = 0; k < Nt; k++)
+        {
+            size_t col = Nt - 1 - k;
+            for (size_t a = 0; a < Nt; a++)
+            {
+                V(transformed[a], unN + k) = Ct(a, col);
+            }
+            E(unN + k) = D(col);
+        }
+    }
+    catch (...)
+    {
+        GADGET_THROW("Errors in hoIncrementalKLT<T>::eigen_basis(...) ... ");
+    }
+}
+
+template<typename T>
+void hoIncrementalKLT<T>::set_basis(const hoNDArray<T>& V, const hoNDArray<value_type>& E)
+{
+    GADGET_CHECK_THROW(V.get_size(0) == N_ && V.get_size(1) == N_);
+    GADGET_CHECK_THROW(E.get_number_of_elements() == N_);
+    V_ = V;
+    E_ = E;
+}
+
+template<typename T>
+bool hoIncrementalKLT<T>::has_basis() const
+{
+    return !V_.empty();
+}
+
+template<typename T>
+const hoNDArray<T>& hoIncrementalKLT<T>::basis() const
+{
+    return V_;
+}
+
+template<typename T>
+const hoNDArray<typename hoIncrementalKLT<T>::value_type>& hoIncrementalKLT<T>::eigen_value() const
+{
+    return E_;
+}
+
+template<typename T>
+const std::vector<size_t>& hoIncrementalKLT<T>::untransformed() const
+{
+    return untransformed_;
+}
+
+template<typename T>
+void hoIncrementalKLT<T>::projected_covariance(hoNDArray<T>& D) const
+{
+    GADGET_CHECK_THROW(this->has_basis());
+
+    hoNDArray<T> C, CV(N_, N_);
+    this->covariance(C);
+
+    D.create(N_, N_);
+    BLAS::gemm(false, false, N_, N_, N_, T(1), C.begin(), N_, V_.begin(), N_, T(0), CV.begin(), N_);
+    BLAS::gemm(true, false, N_, N_, N_, T(1), V_.begin(), N_, CV.begin(), N_, T(0), D.begin(), N_);
+}
+
+template<typename T>
+typename hoIncrementalKLT<T>::value_type hoIncrementalKLT<T>::drift() const
+{
+    hoNDArray<T> D;
+    this->projected_covariance(D);
+
+    // the untransformed channels are not decorrelated from the others, so only the eigen channels count
+    size_t unN = untransformed_.size();
+    value_type off = 0, total = 0;
+    for (size_t j = unN; j < N_; j++)
+    {
+        for (size_t i = unN; i < N_; i++)
+        {
+            value_type e = std::norm(D(i, j));
+            total += e;
+            if (i != j) off += e;
+        }
+    }
+
+    return (total > 0) ? std::sqrt(off / total) : value_type(0);
+}
+
+template<typename T>
+typename hoIncrementalKLT<T>::value_type hoIncrementalKLT<T>::energy_retained(size_t K) const
+{
+    hoNDArray<T> D;
+    this->projected_covariance(D);
+
+    value_type retained = 0, total = 0;
+    for (size_t n = 0; n < N_; n++)
+    {
+        total += std::real(D(n, n));
+        if (n < K) retained += std::real(D(n, n));
+    }
+
+    return (total > 0) ? retained / total : value_type(1);
+}
+
+// ------------------------------------------------------------
+// Instantiation
+// ------------------------------------------------------------
+
+template class EXPORTCPUKLT hoIncrementalKLT< std::complex<float> >;
+template class EXPORTCPUKLT hoIncrementalKLT< std::complex<double> >;
+}
@@ -0,0 +1,90 @@
+/** \file   hoIncrementalKLT.h
+    \brief  Karhunen-Loeve transform estimated from a stream of samples, without keeping the samples
+*/
+
+#pragma once
+
+#include "hoNDArray.h"
+#include "cpuklt_export.h"
+
+#include <vector>
+
+namespace Gadgetron{
+
+    /*
+        Accumulates the sum and the sum of outer products of the samples it is given, so the covariance, and from it
+        the KL transform, can be computed at any time at a cost that does not depend on the number of samples.
+
+        The basis has the same layout as the eigen vector matrix of hoNDKLT: untransformed channels come first and
+        are kept as they are, followed by the eigen channels in descending order of eigen value. It is only replaced
+        by prepare() or set_basis(), so samples can keep being accumulated while the data are transformed with a
+        fixed basis, and a new basis computed with eigen_basis() on another thread can be swapped in when convenient.
+
+        Data [E N] are transformed as data * basis, e.g. with apply_channel_matrix from the mri_core toolbox,
+        which batches several arrays into one matrix product.
+
+        Only complex types are supported.
+    */
+    template <typename T> class EXPORTCPUKLT hoIncrementalKLT
+    {
+    public:
+
+        typedef typename realType<T>::Type value_type;
+
+        hoIncrementalKLT();
+        hoIncrementalKLT(size_t N, const std::vector<size_t>& untransformed = std::vector<size_t>());
+
+        /// start over with N channels, no samples and no basis
+        void reset(size_t N, const std::vector<size_t>& untransformed = std::vector<size_t>());
+
+        /// accumulate the rows [start, start+length) of data [E N] as samples; length == 0 means all rows from start
+        void update(const hoNDArray<T>& data, size_t start = 0, size_t length = 0);
+
+        /// scale down the weight of the samples accumulated so far, so the covariance follows changes in the data
+        void forget(value_type factor);
+
+        size_t number_of_channels() const;
+        /// weight of the accumulated samples, the number of samples unless forget() has been called
+        value_type number_of_samples() const;
+
+        /// covariance of the accumulated samples, mean removed and not normalized, [N N]
+        void covariance(hoNDArray<T>& C) const;
+
+        /// compute the basis from the samples accumulated so far
+        void prepare();
+
+        /// eigen vectors of the covariance C [N N] as the columns of V, laid out as described above, and the
+        /// eigen values E; untransformed channels are given the largest eigen value
+        static void eigen_basis(const hoNDArray<T>& C, const std::vector<size_t>& untransformed, hoNDArray<T>& V, hoNDArray<value_type>& E);
+
+        void set_basis(const hoNDArray<T>& V, const hoNDArray<value_type>& E);
+        bool has_basis() const;
+        const hoNDArray<T>& basis() const;
+        const hoNDArray<value_type>& eigen_value() const;
+        const std::vector<size_t>& untransformed() const;
+
+        /// how far the basis is from diagonalizing the current covariance, as the root of the fraction of the
+        /// energy of V'*C*V off the diagonal; 0 if the basis was computed from the current covariance
+        value_type drift() const;
+
+        /// fraction of the energy of the current covariance retained by the first K channels of the basis
+        value_type energy_retained(size_t K) const;
+
+    protected:
+
+        /// V'*C*V for the current covariance
+        void projected_covariance(hoNDArray<T>& D) const;
+
+        size_t N_;
+        std::vector<size_t> untransformed_;
+
+        /// sum of the samples, [N]
+        hoNDArray<T> sum_;
+        /// sum of the outer products of the samples, upper triangle, [N N]
+        hoNDArray<T> product_;
+        value_type samples_;
+
+        hoNDArray<T> V_;
+        hoNDArray<value_type> E_;
+    };
+}
@@ -0,0 +1,141 @@
+#include "trace.h"
+#include "log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <utility>
+
+namespace Gadgetron
+{
+  namespace Trace
+  {
+    namespace
+    {
+      // Spans are handed to the session in batches of this size; the remainder when the session changes.
+      constexpr size_t batch_size = 4096;
+
+      std::atomic<unsigned int> next_thread{ 1 };
+
+      struct ThreadBuffer
+      {
+        const unsigned int thread = next_thread++;
+        std::string name;
+        std::shared_ptr<Session> session;
+        std::vector<Event> events;
+
+        void flush()
+        {
+          if (session && !events.empty()) session->append(events, thread, name);
+          events.clear();
+        }
+
+        ~ThreadBuffer() { flush(); }
+      };
+
+      ThreadBuffer& thread_buffer()
+      {
+        thread_local ThreadBuffer buffer;
+        return buffer;
+      }
+
+      std::string escape(const std::string& name)
+      {
+        std::string result;
+        for (auto c : name) {
+          if (c == '"' || c == '\\') result += '\\';
+          if (static_cast<unsigned char>(c) < 0x20) continue;
+          result += c;
+        }
+        return result;
+      }
+
+      double microseconds(Clock::duration duration)
+      {
+        return std::chrono::duration<double, std::micro>(duration).count();
+      }
+    }
+
+    Session::Session(std::string filename) : filename_(std::move(filename)), origin_(Clock::now()) {}
+
+    Session::~Session()
+    {
+      write();
+    }
+
+    void Session::append(std::vector<Event>& events, unsigned int thread, const std::string& thread_name)
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      std::move(events.begin(), events.end(), std::back_inserter(events_));
+
+      if (thread_name.empty()) return;
+      auto named = std::find_if(threads_.begin(), threads_.end(), [&](auto& entry) { return entry.first == thread; });
+      if (named == threads_.end()) threads_.emplace_back(thread, thread_name);
+      else named->second = thread_name;
+    }
+
+    void Session::write()
+    {
+      std::ofstream file(filename_);
+      if (!file) {
+        GERROR_STREAM("Unable to write trace to " << filename_);
+        return;
+      }
+
+      file << std::fixed << std::setprecision(3);
+      file << "{\"traceEvents\":[\n";
+      file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"gadgetron\"}}";
+      for (auto& [thread, name] : threads_) {
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+             << ",\"args\":{\"name\":\"" << escape(name) << "\"}}";
+      }
+      for (auto& event : events_) {
+        file << ",\n{\"name\":\"" << escape(event.name) << "\",\"cat\":\"gadgetron\",\"ph\":\"X\""
+             << ",\"ts\":" << microseconds(event.start - origin_)
+             << ",\"dur\":" << microseconds(event.end - event.start)
+             << ",\"pid\":1,\"tid\":" << event.thread << "}";
+      }
+      file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+      GDEBUG_STREAM("Wrote " << events_.size() << " trace events to " << filename_);
+    }
+
+    SessionScope::SessionScope(std::shared_ptr<Session> session)
+    {
+      auto& buffer = thread_buffer();
+      if (buffer.session != session) buffer.flush();
+      previous_ = std::exchange(buffer.session, std::move(session));
+    }
+
+    SessionScope::~SessionScope()
+    {
+      auto& buffer = thread_buffer();
+      if (buffer.session != previous_) buffer.flush();
+      buffer.session = std::move(previous_);
+    }
+
+    std::shared_ptr<Session> current_session()
+    {
+      return thread_buffer().session;
+    }
+
+    bool active()
+    {
+      return bool(thread_buffer().session);
+    }
+
+    void record(std::string name, Clock::time_point start, Clock::time_point end)
+    {
+      auto& buffer = thread_buffer();
+      if (!buffer.session) return;
+      buffer.events.push_back(Event{ std::move(name), start, end, buffer.thread });
+      if (buffer.events.size() >= batch_size) buffer.flush();
+    }
+
+    void name_thread(std::string name)
+    {
+      thread_buffer().name = std::move(name);
+    }
+  }
+}
@@ -0,0 +1,118 @@
+#ifndef GADGETRON_TRACE_H
+#define GADGETRON_TRACE_H
+
+#include "log_export.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Gadgetron
+{
+  /**
+     Timeline tracing in the Chrome trace format (chrome://tracing, https://ui.perfetto.dev).
+
+     Spans are recorded into a buffer local to the recording thread, and handed to the thread's current Session
+     in batches, so recording a span takes no locks. A thread records nothing unless a Session has been made
+     current for it with a Trace::SessionScope; the Session writes all spans it has been given to its file when
+     it is destroyed.
+
+     Use the GADGETRON_TRACE_SPAN macro to time a scope:
+
+     GADGETRON_TRACE_SPAN("grappa2d_calib");
+
+     The macro compiles to nothing unless the Gadgetron is built with tracing (BUILD_WITH_TRACING).
+   */
+  namespace Trace
+  {
+    using Clock = std::chrono::steady_clock;
+
+    struct Event
+    {
+      std::string name;
+      Clock::time_point start;
+      Clock::time_point end;
+      unsigned int thread;
+    };
+
+    class EXPORTGADGETRONLOG Session
+    {
+    public:
+      explicit Session(std::string filename);
+      ~Session();
+
+      Session(const Session&) = delete;
+      Session& operator=(const Session&) = delete;
+
+      const std::string& filename() const { return filename_; }
+
+      void append(std::vector<Event>& events, unsigned int thread, const std::string& thread_name);
+
+    private:
+      void write();
+
+      const std::string filename_;
+      const Clock::time_point origin_;
+      std::mutex mutex_;
+      std::vector<Event> events_;
+      std::vector<std::pair<unsigned int, std::string>> threads_;
+    };
+
+    /// Makes session the current session of the calling thread for the lifetime of the scope.
+    class EXPORTGADGETRONLOG SessionScope
+    {
+    public:
+      explicit SessionScope(std::shared_ptr<Session> session);
+      ~SessionScope();
+
+      SessionScope(const SessionScope&) = delete;
+      SessionScope& operator=(const SessionScope&) = delete;
+
+    private:
+      std::shared_ptr<Session> previous_;
+    };
+
+    EXPORTGADGETRONLOG std::shared_ptr<Session> current_session();
+
+    /// True if the calling thread has a current session.
+    EXPORTGADGETRONLOG bool active();
+
+    EXPORTGADGETRONLOG void record(std::string name, Clock::time_point start, Clock::time_point end);
+
+    /// Names the calling thread in the traces it contributes to.
+    EXPORTGADGETRONLOG void name_thread(std::string name);
+
+    class Span
+    {
+    public:
+      explicit Span(const char* name) : name_(active() ? name : nullptr)
+      {
+        if (name_) start_ = Clock::now();
+      }
+
+      ~Span()
+      {
+        if (name_) record(name_, start_, Clock::now());
+      }
+
+      Span(const Span&) = delete;
+      Span& operator=(const Span&) = delete;
+
+    private:
+      const char* name_;
+      Clock::time_point start_;
+    };
+  }
+}
+
+#if defined(GADGETRON_TRACING)
+#define GADGETRON_TRACE_CONCATENATE_DETAIL(a, b) a##b
+#define GADGETRON_TRACE_CONCATENATE(a, b) GADGETRON_TRACE_CONCATENATE_DETAIL(a, b)
+#define GADGETRON_TRACE_SPAN(name) ::Gadgetron::Trace::Span GADGETRON_TRACE_CONCATENATE(gadgetron_trace_span_, __LINE__)(name)
+#else
+#define GADGETRON_TRACE_SPAN(name)
+#endif
+
+#endif //GADGETRON_TRACE_H
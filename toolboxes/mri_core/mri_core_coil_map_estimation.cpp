@@ -11,6 +11,10 @@
 #include "hoNDArray_reductions.h"
 #include "complext.h"
 #include "GadgetronTimer.h"
+#include "trace.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
 #ifdef USE_OMP
     #include <omp.h>
 #endif // USE_OMP
@@ -19,8 +23,9 @@ namespace Gadgetron
 {
 
 template<typename T> 
-void coil_map_2d_Inati(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks, size_t power)
+void coil_map_2d_Inati_direct(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks, size_t power)
 {
+    GADGETRON_TRACE_SPAN("coil_map_2d_Inati_direct");
     try
     {
         typedef typename realType<T>::Type value_type;
@@ -216,21 +221,22 @@ void coil_map_2d_Inati(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t k
     }
     catch (...)
     {
-        GERROR_STREAM("Errors in coil_map_2d_Inati(...) ... ");
+        GERROR_STREAM("Errors in coil_map_2d_Inati_direct(...) ... ");
         throw;
     }
 }
 
-template void coil_map_2d_Inati(const hoNDArray< std::complex<float> >& data, hoNDArray< std::complex<float> >& coilMap, size_t ks, size_t power);
-template void coil_map_2d_Inati(const hoNDArray< std::complex<double> >& data, hoNDArray< std::complex<double> >& coilMap, size_t ks, size_t power);
+template void coil_map_2d_Inati_direct(const hoNDArray< std::complex<float> >& data, hoNDArray< std::complex<float> >& coilMap, size_t ks, size_t power);
+template void coil_map_2d_Inati_direct(const hoNDArray< std::complex<double> >& data, hoNDArray< std::complex<double> >& coilMap, size_t ks, size_t power);
 
-template void coil_map_2d_Inati(const hoNDArray< complext<float> >& data, hoNDArray< complext<float> >& coilMap, size_t ks, size_t power);
-template void coil_map_2d_Inati(const hoNDArray< complext<double> >& data, hoNDArray< complext<double> >& coilMap, size_t ks, size_t power);
+template void coil_map_2d_Inati_direct(const hoNDArray< complext<float> >& data, hoNDArray< complext<float> >& coilMap, size_t ks, size_t power);
+template void coil_map_2d_Inati_direct(const hoNDArray< complext<double> >& data, hoNDArray< complext<double> >& coilMap, size_t ks, size_t power);
 // ------------------------------------------------------------------------
 
 template<typename T> 
-void coil_map_3d_Inati(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks, size_t kz, size_t power)
+void coil_map_3d_Inati_direct(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks, size_t kz, size_t power)
 {
+    GADGETRON_TRACE_SPAN("coil_map_3d_Inati_direct");
     try
     {
         typedef typename realType<T>::Type value_type;
@@ -392,6 +398,370 @@ void coil_map_3d_Inati(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t k
         }
     }
     catch (...)
+    {
+        GERROR_STREAM("Errors in coil_map_3d_Inati_direct(...) ... ");
+        throw;
+    }
+}
+
+template void coil_map_3d_Inati_direct(const hoNDArray< std::complex<float> >& data, hoNDArray< std::complex<float> >& coilMap, size_t ks, size_t kz, size_t power);
+template void coil_map_3d_Inati_direct(const hoNDArray< std::complex<double> >& data, hoNDArray< std::complex<double> >& coilMap, size_t ks, size_t kz, size_t power);
+
+template void coil_map_3d_Inati_direct(const hoNDArray< complext<float> >& data, hoNDArray< complext<float> >& coilMap, size_t ks, size_t kz, size_t power);
+template void coil_map_3d_Inati_direct(const hoNDArray< complext<double> >& data, hoNDArray< complext<double> >& coilMap, size_t ks, size_t kz, size_t power);
+// ------------------------------------------------------------------------
+
+namespace
+{
+    inline long long wrap(long long i, long long n)
+    {
+        i %= n;
+        return i < 0 ? i + n : i;
+    }
+
+    // Local channel statistics for the Inati method, updated as the window slides instead of rebuilt per pixel.
+    //
+    // With d_p the channel vector of pixel p in the window around a pixel, the direct method computes
+    //     s = sum_p d_p                  the initial coil map estimate; the object phase is s^T v
+    //     C = sum_p conj(d_p) d_p^T      D^H D, whose dominant eigenvector v is the coil map
+    // Both are sums over the window, so they are kept per readout position as column sums over the E1 (and E2)
+    // extent of the window, and then summed over the readout extent, adding the terms entering the window and
+    // subtracting those leaving it. C is Hermitian, so only its upper triangle is kept. Sums are in double precision
+    // so that the additions and subtractions do not drift for single precision data.
+    class InatiWindow
+    {
+    public:
+        InatiWindow(long long RO, long long CHA)
+            : RO_(RO), CHA_(CHA), pairs_(CHA*(CHA + 1) / 2),
+              colCov_(2 * RO*pairs_), colSum_(2 * RO*CHA), cov_(2 * pairs_), sum_(2 * CHA), x_(2 * CHA)
+        {
+        }
+
+        void clear_columns()
+        {
+            std::fill(colCov_.begin(), colCov_.end(), 0.0);
+            std::fill(colSum_.begin(), colSum_.end(), 0.0);
+        }
+
+        // adds scale times the terms of the pixel at p, whose channels are stride apart, to column ro
+        template <typename T> void add_to_column(long long ro, const T* p, size_t stride, double scale)
+        {
+            for (long long cha = 0; cha < CHA_; cha++)
+            {
+                x_[2 * cha] = p[cha*stride].real();
+                x_[2 * cha + 1] = p[cha*stride].imag();
+            }
+
+            double* pCov = colCov_.data() + 2 * ro*pairs_;
+            for (long long i = 0; i < CHA_; i++)
+            {
+                const double ar = scale*x_[2 * i];
+                const double ai = -scale*x_[2 * i + 1];
+                for (long long j = i; j < CHA_; j++)
+                {
+                    const double br = x_[2 * j];
+                    const double bi = x_[2 * j + 1];
+                    pCov[0] += ar*br - ai*bi;
+                    pCov[1] += ar*bi + ai*br;
+                    pCov += 2;
+                }
+            }
+
+            double* pSum = colSum_.data() + 2 * ro*CHA_;
+            for (long long n = 0; n < 2 * CHA_; n++)
+            {
+                pSum[n] += scale*x_[n];
+            }
+        }
+
+        // sums the columns of the window around readout position 0
+        void start_row(long long halfKs)
+        {
+            std::fill(cov_.begin(), cov_.end(), 0.0);
+            std::fill(sum_.begin(), sum_.end(), 0.0);
+            for (long long kro = -halfKs; kro <= halfKs; kro++)
+            {
+                add_column(wrap(kro, RO_), 1.0);
+            }
+        }
+
+        // moves the window by one readout position
+        void slide(long long entering, long long leaving)
+        {
+            add_column(entering, 1.0);
+            add_column(leaving, -1.0);
+        }
+
+        // writes the coil map of the current window to p, with channels stride apart; the power method runs on
+        // DH_D, V1 and V as in the direct method. It takes one gemm per pixel and step: a power method batched over a
+        // tile of pixels, with the pixel innermost so that it vectorises across them, was measured to be slower, as the
+        // per pixel products already run in vectorised BLAS kernels and only make up a small part of the time, which is
+        // spent on the window updates.
+        template <typename T> void coil_map(size_t power, hoNDArray<T>& DH_D, hoNDArray<T>& V1, hoNDArray<T>& V, T* p, size_t stride)
+        {
+            typedef typename realType<T>::Type value_type;
+
+            T* pDH_D = DH_D.begin();
+            const double* pCov = cov_.data();
+            for (long long i = 0; i < CHA_; i++)
+            {
+                for (long long j = i; j < CHA_; j++)
+                {
+                    pDH_D[i + j*CHA_] = T((value_type)pCov[0], (value_type)pCov[1]);
+                    pDH_D[j + i*CHA_] = T((value_type)pCov[0], (value_type)(-pCov[1]));
+                    pCov += 2;
+                }
+            }
+
+            T* pV1 = V1.begin();
+            for (long long cha = 0; cha < CHA_; cha++)
+            {
+                pV1[cha] = T((value_type)sum_[2 * cha], (value_type)sum_[2 * cha + 1]);
+            }
+            normalize(V1);
+
+            for (size_t po = 0; po < power; po++)
+            {
+                gemm(V, DH_D, false, V1, false);
+                memcpy(V1.begin(), V.begin(), V.get_number_of_bytes());
+                normalize(V1);
+            }
+
+            // object phase, s^T v
+            double pr = 0, pi = 0;
+            for (long long cha = 0; cha < CHA_; cha++)
+            {
+                const double a = pV1[cha].real();
+                const double b = pV1[cha].imag();
+                pr += sum_[2 * cha] * a - sum_[2 * cha + 1] * b;
+                pi += sum_[2 * cha] * b + sum_[2 * cha + 1] * a;
+            }
+            const double phaseNorm = std::sqrt(pr*pr + pi*pi);
+            const value_type c = (value_type)(pr / phaseNorm);
+            const value_type d = (value_type)(pi / phaseNorm);
+
+            for (long long cha = 0; cha < CHA_; cha++)
+            {
+                const value_type a = pV1[cha].real();
+                const value_type b = pV1[cha].imag();
+                p[cha*stride] = T(a*c + b*d, a*d - b*c);
+            }
+        }
+
+    private:
+        void add_column(long long ro, double scale)
+        {
+            const double* pCov = colCov_.data() + 2 * ro*pairs_;
+            for (long long n = 0; n < 2 * pairs_; n++)
+            {
+                cov_[n] += scale*pCov[n];
+            }
+
+            const double* pSum = colSum_.data() + 2 * ro*CHA_;
+            for (long long n = 0; n < 2 * CHA_; n++)
+            {
+                sum_[n] += scale*pSum[n];
+            }
+        }
+
+        template <typename T> void normalize(hoNDArray<T>& V1) const
+        {
+            typedef typename realType<T>::Type value_type;
+
+            T* pV1 = V1.begin();
+            value_type sum(0);
+            for (long long cha = 0; cha < CHA_; cha++)
+            {
+                const value_type re = pV1[cha].real();
+                const value_type im = pV1[cha].imag();
+                sum += ((re*re) + (im * im));
+            }
+
+            value_type v1NormInv = (value_type)1.0 / std::sqrt(sum);
+            for (long long cha = 0; cha < CHA_; cha++)
+            {
+                pV1[cha] *= v1NormInv;
+            }
+        }
+
+        long long RO_, CHA_, pairs_;
+        std::vector<double> colCov_, colSum_;
+        std::vector<double> cov_, sum_;
+        std::vector<double> x_;
+    };
+
+    // data and coil map: [RO E1 E2 CHA]; ks and kz are odd
+    template<typename T>
+    void coil_map_Inati_sliding(const T* pData, T* pSen, long long RO, long long E1, long long E2, long long CHA, long long ks, long long kz, size_t power)
+    {
+        const long long halfKs = ks / 2;
+        const long long halfKz = kz / 2;
+        const size_t stride = RO*E1*E2;
+
+        // Each task is a band of E1 lines at one E2 position. A band starts from full column sums and then slides,
+        // so longer bands amortise the start while shorter ones spread the work over more threads.
+        long long bandLength = 4 * ks;
+#ifdef USE_OMP
+        bandLength = std::max(ks, std::min(bandLength, E1*E2 / (4 * (long long)omp_get_max_threads())));
+#endif // USE_OMP
+        bandLength = std::min(bandLength, E1);
+
+        const long long bands = (E1 + bandLength - 1) / bandLength;
+        const long long tasks = bands*E2;
+
+        #pragma omp parallel
+        {
+            InatiWindow window(RO, CHA);
+
+            hoNDArray<T> DH_D(CHA, CHA);
+            hoNDArray<T> V1(CHA, 1);
+            hoNDArray<T> V(CHA, 1);
+
+            std::vector<const T*> entering(kz), leaving(kz);
+            std::vector<char> moved(RO);
+
+            #pragma omp for schedule(dynamic)
+            for (long long task = 0; task < tasks; task++)
+            {
+                const long long e2 = task / bands;
+                const long long e1Start = (task % bands)*bandLength;
+                const long long e1End = std::min(E1, e1Start + bandLength);
+
+                // line e1 of E2 position e2, wrapping around as the direct method does
+                auto line = [&](long long e1, long long e2)
+                {
+                    return pData + (wrap(e2, E2)*E1 + wrap(e1, E1))*RO;
+                };
+
+                window.clear_columns();
+                for (long long ke2 = -halfKz; ke2 <= halfKz; ke2++)
+                {
+                    for (long long ke1 = -halfKs; ke1 <= halfKs; ke1++)
+                    {
+                        const T* pLine = line(e1Start + ke1, e2 + ke2);
+                        for (long long ro = 0; ro < RO; ro++)
+                        {
+                            window.add_to_column(ro, pLine + ro, stride, 1.0);
+                        }
+                    }
+                }
+
+                for (long long e1 = e1Start; e1 < e1End; e1++)
+                {
+                    // Columns move down a line just before they enter the window, while they are still in cache
+                    // when added to it, rather than in a separate pass over all columns
+                    for (long long ke2 = -halfKz; ke2 <= halfKz; ke2++)
+                    {
+                        entering[ke2 + halfKz] = line(e1 + halfKs, e2 + ke2);
+                        leaving[ke2 + halfKz] = line(e1 - halfKs - 1, e2 + ke2);
+                    }
+                    std::fill(moved.begin(), moved.end(), e1 == e1Start);
+
+                    auto move_column = [&](long long ro)
+                    {
+                        if (moved[ro]) return;
+                        moved[ro] = true;
+                        for (size_t k = 0; k < entering.size(); k++)
+                        {
+                            window.add_to_column(ro, entering[k] + ro, stride, 1.0);
+                            window.add_to_column(ro, leaving[k] + ro, stride, -1.0);
+                        }
+                    };
+
+                    for (long long kro = -halfKs; kro <= halfKs; kro++)
+                    {
+                        move_column(wrap(kro, RO));
+                    }
+
+                    T* pSenLine = pSen + (e2*E1 + e1)*RO;
+                    window.start_row(halfKs);
+                    for (long long ro = 0; ro < RO; ro++)
+                    {
+                        if (ro > 0)
+                        {
+                            const long long column = wrap(ro + halfKs, RO);
+                            move_column(column);
+                            window.slide(column, wrap(ro - halfKs - 1, RO));
+                        }
+                        window.coil_map(power, DH_D, V1, V, pSenLine + ro, stride);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<typename T> 
+void coil_map_2d_Inati(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks, size_t power)
+{
+    GADGETRON_TRACE_SPAN("coil_map_2d_Inati");
+    try
+    {
+        long long RO = data.get_size(0);
+        long long E1 = data.get_size(1);
+        long long CHA = data.get_size(2);
+
+        long long N = data.get_number_of_elements() / (RO*E1*CHA);
+        GADGET_CHECK_THROW(N == 1);
+
+        if (!data.dimensions_equal(&coilMap))
+        {
+            coilMap = data;
+        }
+
+        if (ks % 2 != 1)
+        {
+            ks++;
+        }
+
+        coil_map_Inati_sliding(data.begin(), coilMap.begin(), RO, E1, 1, CHA, ks, 1, power);
+    }
+    catch (...)
+    {
+        GERROR_STREAM("Errors in coil_map_2d_Inati(...) ... ");
+        throw;
+    }
+}
+
+template void coil_map_2d_Inati(const hoNDArray< std::complex<float> >& data, hoNDArray< std::complex<float> >& coilMap, size_t ks, size_t power);
+template void coil_map_2d_Inati(const hoNDArray< std::complex<double> >& data, hoNDArray< std::complex<double> >& coilMap, size_t ks, size_t power);
+
+template void coil_map_2d_Inati(const hoNDArray< complext<float> >& data, hoNDArray< complext<float> >& coilMap, size_t ks, size_t power);
+template void coil_map_2d_Inati(const hoNDArray< complext<double> >& data, hoNDArray< complext<double> >& coilMap, size_t ks, size_t power);
+// ------------------------------------------------------------------------
+
+template<typename T> 
+void coil_map_3d_Inati(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks, size_t kz, size_t power)
+{
+    GADGETRON_TRACE_SPAN("coil_map_3d_Inati");
+    try
+    {
+        long long RO = data.get_size(0);
+        long long E1 = data.get_size(1);
+        long long E2 = data.get_size(2);
+        long long CHA = data.get_size(3);
+
+        long long N = data.get_number_of_elements() / (RO*E1*E2*CHA);
+        GADGET_CHECK_THROW(N == 1);
+
+        if (!data.dimensions_equal(&coilMap))
+        {
+            coilMap = data;
+        }
+
+        if (ks % 2 != 1)
+        {
+            ks++;
+        }
+
+        if (kz % 2 != 1)
+        {
+            kz++;
+        }
+
+        coil_map_Inati_sliding(data.begin(), coilMap.begin(), RO, E1, E2, CHA, ks, kz, power);
+    }
+    catch (...)
     {
         GERROR_STREAM("Errors in coil_map_3d_Inati(...) ... ");
         throw;
@@ -408,6 +778,7 @@ template void coil_map_3d_Inati(const hoNDArray< complext<double> >& data, hoNDA
 template<typename T> 
 void coil_map_2d_Inati_Iter(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks, size_t iterNum, typename realType<T>::Type thres)
 {
+    GADGETRON_TRACE_SPAN("coil_map_2d_Inati_Iter");
     using std::conj;
     try
     {
@@ -522,6 +893,7 @@ template void coil_map_2d_Inati_Iter(const hoNDArray< complext<double> >& data,
 template<typename T> 
 void coil_map_3d_Inati_Iter(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks, size_t kz, size_t iterNum, typename realType<T>::Type thres)
 {
+    GADGETRON_TRACE_SPAN("coil_map_3d_Inati_Iter");
     using std::conj;
     typedef typename realType<T>::Type value_type;
 
@@ -751,6 +1123,7 @@ template void coil_map_Inati_Iter(const hoNDArray< std::complex<double> >& data,
 template <typename T>
 void coil_combine(const hoNDArray<T>& data, const hoNDArray<T>& coilMap, size_t cha_dim, hoNDArray<T>& combined)
 {
+    GADGETRON_TRACE_SPAN("coil_combine");
     try
     {
         size_t NDim = data.get_number_of_dimensions();
@@ -38,6 +38,11 @@ namespace Gadgetron
     // data: [RO E1 E2 CHA], this functions uses true 3D data correlation matrix
     template<typename T>  void coil_map_3d_Inati(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks = 7, size_t kz = 5, size_t power = 3);
 
+    // coil_map_2d_Inati and coil_map_3d_Inati update the local correlation matrix as the kernel window slides;
+    // these compute the same maps by forming the ks*ks*kz x CHA data matrix and its correlation matrix for every pixel
+    template<typename T>  void coil_map_2d_Inati_direct(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks = 7, size_t power = 3);
+    template<typename T>  void coil_map_3d_Inati_direct(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks = 7, size_t kz = 5, size_t power = 3);
+
     // data: [RO E1 E2 CHA N S SLC ...], if E2==1, the 2D coil map estimation is assumed
     template<typename T>  void coil_map_Inati(const hoNDArray<T>& data, hoNDArray<T>& coilMap, size_t ks = 7, size_t kz = 5, size_t power = 3);
     template<typename T>  hoNDArray<T> coil_map_Inati(const hoNDArray<T>& data, size_t ks = 7, size_t kz = 5, size_t power = 3);
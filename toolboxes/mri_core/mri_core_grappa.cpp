@@ -30,7 +30,9 @@
 #include "hoNDArray_utils.h"
 #include "hoNDArray_elemwise.h"
 #include "hoNDArray_reductions.h"
+#include "hoNDArray_expressions.h"
 #include "ImageIOAnalyze.h"
+#include "trace.h"
 
 #ifdef USE_OMP
     #include "omp.h"
@@ -246,6 +248,7 @@ template EXPORTMRICORE void grappa2d_perform_calib(const hoNDArray< std::complex
 template <typename T> 
 void grappa2d_calib(const hoNDArray<T>& acsSrc, const hoNDArray<T>& acsDst, double thres, size_t kRO, const std::vector<int>& kE1, const std::vector<int>& oE1, size_t startRO, size_t endRO, size_t startE1, size_t endE1, hoNDArray<T>& ker)
 {
+    GADGETRON_TRACE_SPAN("grappa2d_calib");
     try
     {
         GADGET_CHECK_THROW(acsSrc.get_size(0)==acsDst.get_size(0));
@@ -616,6 +619,7 @@ template EXPORTMRICORE void grappa2d_calib_convolution_kernel(const hoNDArray< s
 template <typename T> 
 void grappa2d_calib_convolution_kernel(const hoNDArray<T>& dataSrc, const hoNDArray<T>& dataDst, hoNDArray<unsigned short>& dataMask, size_t accelFactor, double thres, size_t kRO, size_t kNE1, hoNDArray<T>& convKer)
 {
+    GADGETRON_TRACE_SPAN("grappa2d_calib_convolution_kernel");
     try
     {
         bool fitItself = false;
@@ -668,6 +672,7 @@ template EXPORTMRICORE void grappa2d_calib_convolution_kernel(const hoNDArray< s
 template <typename T> 
 void grappa2d_image_domain_kernel(const hoNDArray<T>& convKer, size_t RO, size_t E1, hoNDArray<T>& kIm)
 {
+    GADGETRON_TRACE_SPAN("grappa2d_image_domain_kernel");
     try
     {
         hoNDArray<T> convKerScaled(convKer);
@@ -691,6 +696,7 @@ template EXPORTMRICORE void grappa2d_image_domain_kernel(const hoNDArray< std::c
 template <typename T>
 void grappa2d_unmixing_coeff(const hoNDArray<T>& kerIm, const hoNDArray<T>& coilMap, size_t acceFactorE1, hoNDArray<T>& unmixCoeff, hoNDArray< typename realType<T>::Type >& gFactor)
 {
+    GADGETRON_TRACE_SPAN("grappa2d_unmixing_coeff");
     try
     {
         typedef typename realType<T>::Type value_type;
@@ -734,7 +740,7 @@ void grappa2d_unmixing_coeff(const hoNDArray<T>& kerIm, const hoNDArray<T>& coil
 
 #pragma omp parallel default(none) private(src) shared(RO, E1, srcCHA, dstCHA, pKerIm, pCoilMap, pCoeff, dim)
         {
-            hoNDArray<T> coeff2D, coeffTmp(dim);
+            hoNDArray<T> coeff2D;
             hoNDArray<T> coilMap2D;
             hoNDArray<T> kerIm2D;
 
@@ -747,8 +753,7 @@ void grappa2d_unmixing_coeff(const hoNDArray<T>& kerIm, const hoNDArray<T>& coil
                 {
                     kerIm2D.create(dim, pKerIm + src*RO*E1 + dst*RO*E1*srcCHA);
                     coilMap2D.create(dim, pCoilMap + dst*RO*E1);
-                    Gadgetron::multiplyConj(kerIm2D, coilMap2D, coeffTmp);
-                    Gadgetron::add(coeff2D, coeffTmp, coeff2D);
+                    coeff2D = coeff2D + kerIm2D * conj(coilMap2D);
                 }
             }
         }
@@ -778,6 +783,7 @@ template EXPORTMRICORE void grappa2d_unmixing_coeff(const hoNDArray< std::comple
 template <typename T> 
 void grappa2d_image_domain_unwrapping(const hoNDArray<T>& kspace, const hoNDArray<T>& kerIm, hoNDArray<T>& complexIm)
 {
+    GADGETRON_TRACE_SPAN("grappa2d_image_domain_unwrapping");
     try
     {
         hoNDArray<T> aliasedIm(kspace);
@@ -799,6 +805,7 @@ template EXPORTMRICORE void grappa2d_image_domain_unwrapping(const hoNDArray< st
 template <typename T> 
 void grappa2d_image_domain_unwrapping_aliased_image(const hoNDArray<T>& aliasedIm, const hoNDArray<T>& kerIm, hoNDArray<T>& complexIm)
 {
+    GADGETRON_TRACE_SPAN("grappa2d_image_domain_unwrapping_aliased_image");
     try
     {
         size_t RO = kerIm.get_size(0);
@@ -864,6 +871,7 @@ template EXPORTMRICORE void grappa2d_image_domain_unwrapping_aliased_image(const
 template <typename T>
 void apply_unmix_coeff_kspace(const hoNDArray<T>& kspace, const hoNDArray<T>& unmixCoeff, hoNDArray<T>& complexIm)
 {
+    GADGETRON_TRACE_SPAN("apply_unmix_coeff_kspace");
     try
     {
         GADGET_CHECK_THROW(kspace.get_size(0) == unmixCoeff.get_size(0));
@@ -899,6 +907,7 @@ template EXPORTMRICORE void apply_unmix_coeff_kspace(const hoNDArray< std::compl
 template <typename T>
 void apply_unmix_coeff_aliased_image(const hoNDArray<T>& aliasedIm, const hoNDArray<T>& unmixCoeff, hoNDArray<T>& complexIm)
 {
+    GADGETRON_TRACE_SPAN("apply_unmix_coeff_aliased_image");
     try
     {
         GADGET_CHECK_THROW(aliasedIm.get_size(0) == unmixCoeff.get_size(0));
@@ -947,6 +956,7 @@ void grappa3d_calib(const hoNDArray<T>& acsSrc, const hoNDArray<T>& acsDst,
                 const std::vector<int>& kE2, const std::vector<int>& oE2,
                 hoNDArray<T>& ker)
 {
+    GADGETRON_TRACE_SPAN("grappa3d_calib");
     try
     {
         GADGET_CHECK_THROW(acsSrc.get_size(0) == acsDst.get_size(0));
@@ -1406,6 +1416,7 @@ template EXPORTMRICORE void grappa3d_calib_convolution_kernel(const hoNDArray< s
 template <typename T> 
 void grappa3d_image_domain_kernel(const hoNDArray<T>& convKer, size_t RO, size_t E1, size_t E2, hoNDArray<T>& kIm, bool preset_kIm_with_zeros)
 {
+    GADGETRON_TRACE_SPAN("grappa3d_image_domain_kernel");
     try
     {
         size_t srcCHA = convKer.get_size(3);
@@ -1459,6 +1470,7 @@ void grappa3d_unmixing_coeff(const hoNDArray<T>& convKer, const hoNDArray<T>& co
                         size_t acceFactorE1, size_t acceFactorE2, hoNDArray<T>& unmixCoeff, 
                         hoNDArray< typename realType<T>::Type >& gFactor)
 {
+    GADGETRON_TRACE_SPAN("grappa3d_unmixing_coeff");
     try
     {
         size_t kRO = convKer.get_size(0);
@@ -1524,8 +1536,7 @@ void grappa3d_unmixing_coeff(const hoNDArray<T>& convKer, const hoNDArray<T>& co
                     hoNDArray<T> coilMapCha;
                     coilMapCha.create(RO, E1, E2, const_cast<T*>(coilMap.begin()) + dcha*RO*E1*E2);
 
-                    Gadgetron::multiplyConj(kImCha, coilMapCha, kImTmp);
-                    Gadgetron::add(unmixCha, kImTmp, unmixCha);
+                    unmixCha = unmixCha + kImCha * conj(coilMapCha);
                 }
             }
         }
@@ -1564,6 +1575,7 @@ void grappa3d_image_domain_unwrapping(const hoNDArray<T>& convKer, const hoNDArr
                                 size_t acceFactorE1, size_t acceFactorE2,
                                 hoNDArray<T>& complexIm)
 {
+    GADGETRON_TRACE_SPAN("grappa3d_image_domain_unwrapping");
     try
     {
         size_t kRO = convKer.get_size(0);
@@ -1657,6 +1669,7 @@ void grappa3d_image_domain_unwrapping_aliasedImage(const hoNDArray<T>& convKer,
                                             size_t acceFactorE1, size_t acceFactorE2,
                                             hoNDArray<T>& complexIm)
 {
+    GADGETRON_TRACE_SPAN("grappa3d_image_domain_unwrapping_aliasedImage");
     try
     {
         size_t kRO = convKer.get_size(0);
@@ -1743,6 +1756,7 @@ template EXPORTMRICORE void grappa3d_image_domain_unwrapping_aliasedImage(const
 template <typename T> 
 void apply_unmix_coeff_kspace_3D(const hoNDArray<T>& kspace, const hoNDArray<T>& unmixCoeff, hoNDArray<T>& complexIm)
 {
+    GADGETRON_TRACE_SPAN("apply_unmix_coeff_kspace_3D");
     try
     {
         size_t RO = kspace.get_size(0);
@@ -1794,6 +1808,7 @@ template EXPORTMRICORE void apply_unmix_coeff_kspace_3D(const hoNDArray< std::co
 template <typename T> 
 void apply_unmix_coeff_aliased_image_3D(const hoNDArray<T>& aliasedIm, const hoNDArray<T>& unmixCoeff, hoNDArray<T>& complexIm)
 {
+    GADGETRON_TRACE_SPAN("apply_unmix_coeff_aliased_image_3D");
     try
     {
         size_t RO = aliasedIm.get_size(0);
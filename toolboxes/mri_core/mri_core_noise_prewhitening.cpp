@@ -0,0 +1,42 @@
+/** \file   mri_core_noise_prewhitening.cpp
+    \brief  Application of a noise prewhitening matrix to acquisitions, batched into one matrix product
+*/
+
+#include "mri_core_noise_prewhitening.h"
+#include "mri_core_utility.h"
+#include "log.h"
+#include "trace.h"
+
+namespace Gadgetron
+{
+
+template <typename T>
+bool is_upper_triangular(const hoNDArray<T>& a)
+{
+    size_t N = a.get_size(0);
+    for (size_t c = 0; c < N; c++)
+    {
+        for (size_t r = c + 1; r < N; r++)
+        {
+            if (a(r, c) != T(0)) return false;
+        }
+    }
+    return true;
+}
+
+template EXPORTMRICORE bool is_upper_triangular(const hoNDArray< std::complex<float> >& a);
+template EXPORTMRICORE bool is_upper_triangular(const hoNDArray< std::complex<double> >& a);
+
+// ------------------------------------------------------------------------
+
+template <typename T>
+void apply_noise_prewhitening(const std::vector<hoNDArray<T>*>& data, const hoNDArray<T>& prewhitener, hoNDArray<T>& buf)
+{
+    GADGETRON_TRACE_SPAN("apply_noise_prewhitening");
+    apply_channel_matrix(data, prewhitener, is_upper_triangular(prewhitener), buf);
+}
+
+template EXPORTMRICORE void apply_noise_prewhitening(const std::vector<hoNDArray< std::complex<float> >*>& data, const hoNDArray< std::complex<float> >& prewhitener, hoNDArray< std::complex<float> >& buf);
+template EXPORTMRICORE void apply_noise_prewhitening(const std::vector<hoNDArray< std::complex<double> >*>& data, const hoNDArray< std::complex<double> >& prewhitener, hoNDArray< std::complex<double> >& buf);
+
+}
@@ -0,0 +1,22 @@
+/** \file   mri_core_noise_prewhitening.h
+    \brief  Application of a noise prewhitening matrix to acquisitions, batched into one matrix product
+*/
+
+#pragma once
+
+#include "mri_core_export.h"
+#include "hoNDArray.h"
+
+#include <vector>
+
+namespace Gadgetron
+{
+    /// true if all entries below the diagonal of the square matrix a are zero
+    template <typename T> EXPORTMRICORE bool is_upper_triangular(const hoNDArray<T>& a);
+
+    /// prewhiten acquisitions in place, data[n] = data[n] * prewhitener, with apply_channel_matrix
+    /// prewhitener: [CHA CHA]; if it is upper triangular, as the inverse of the Cholesky factor of the noise
+    /// covariance is, the triangular product is used
+    /// buf: scratch storage, reused between calls
+    template <typename T> EXPORTMRICORE void apply_noise_prewhitening(const std::vector<hoNDArray<T>*>& data, const hoNDArray<T>& prewhitener, hoNDArray<T>& buf);
+}
@@ -0,0 +1,210 @@
+/** \file   mri_core_readout_oversampling.cpp
+    \brief  Removal of readout oversampling from kspace readouts, by FFT cropping or by half-band FIR decimation
+*/
+
+#include "mri_core_readout_oversampling.h"
+#include "hoNDFFT.h"
+#include "log.h"
+#include "trace.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace Gadgetron
+{
+
+namespace
+{
+    constexpr double pi = 3.14159265358979323846;
+}
+
+template <typename T>
+void remove_readout_oversampling(const hoNDArray<T>& data, size_t start, size_t RO_out, hoNDArray<T>& res)
+{
+    hoNDArray<T> buf;
+    remove_readout_oversampling(data, start, RO_out, res, buf);
+}
+
+template <typename T>
+void remove_readout_oversampling(const hoNDArray<T>& data, size_t start, size_t RO_out, hoNDArray<T>& res, hoNDArray<T>& buf)
+{
+    GADGETRON_TRACE_SPAN("remove_readout_oversampling");
+
+    try
+    {
+        size_t RO = data.get_size(0);
+        GADGET_CHECK_THROW(start + RO_out <= RO);
+
+        std::vector<size_t> dim = data.dimensions();
+        dim[0] = RO_out;
+        if (!res.dimensions_equal(&dim))
+        {
+            res.create(dim);
+        }
+
+        hoNDFFT<typename realType<T>::Type>::instance()->ifft1c(data, buf);
+
+        size_t N = data.get_number_of_elements() / RO;
+        const T* pIm = buf.begin();
+        T* pRes = res.begin();
+        for (size_t n = 0; n < N; n++)
+        {
+            memcpy(pRes + n*RO_out, pIm + n*RO + start, sizeof(T)*RO_out);
+        }
+
+        hoNDFFT<typename realType<T>::Type>::instance()->fft1c(res);
+    }
+    catch (...)
+    {
+        GADGET_THROW("Errors in remove_readout_oversampling(...) ... ");
+    }
+}
+
+template EXPORTMRICORE void remove_readout_oversampling(const hoNDArray< std::complex<float> >& data, size_t start, size_t RO_out, hoNDArray< std::complex<float> >& res);
+template EXPORTMRICORE void remove_readout_oversampling(const hoNDArray< std::complex<double> >& data, size_t start, size_t RO_out, hoNDArray< std::complex<double> >& res);
+template EXPORTMRICORE void remove_readout_oversampling(const hoNDArray< std::complex<float> >& data, size_t start, size_t RO_out, hoNDArray< std::complex<float> >& res, hoNDArray< std::complex<float> >& buf);
+template EXPORTMRICORE void remove_readout_oversampling(const hoNDArray< std::complex<double> >& data, size_t start, size_t RO_out, hoNDArray< std::complex<double> >& res, hoNDArray< std::complex<double> >& buf);
+
+// ------------------------------------------------------------------------
+
+template <typename T>
+void generate_readout_decimation_filter(size_t RO, size_t taps, hoNDArray<T>& filter)
+{
+    try
+    {
+        GADGET_CHECK_THROW(RO % 4 == 0);
+        GADGET_CHECK_THROW(taps > 0 && 2 * taps <= RO / 2);
+
+        filter.create(taps + 1);
+
+        // Cropping the centre half of the readout image is a circular convolution of the kspace readout with
+        //     h(d) = exp(-i*pi*d/RO) * sin(pi*d/2) / (sqrt(2) * RO/2 * sin(pi*d/RO)),   h(0) = 1/sqrt(2)
+        // followed by keeping every second sample. h vanishes for even d, and the phase term accounts for the
+        // cropped image running from -RO/4 to RO/4-1 about the centre.
+        const double beta = 8.0;
+        const double normalization = 1.0 / (std::sqrt(2.0) * (RO / 2));
+
+        filter(0) = T(1.0 / std::sqrt(2.0));
+        for (size_t i = 1; i <= taps; i++)
+        {
+            double d = double(2 * i - 1);
+            double x = d / (2 * taps);
+            double window = std::cyl_bessel_i(0.0, beta * std::sqrt(1 - x * x)) / std::cyl_bessel_i(0.0, beta);
+            double magnitude = window * normalization * std::sin(pi * d / 2) / std::sin(pi * d / RO);
+            filter(i) = T(std::polar(magnitude, -pi * d / RO));
+        }
+    }
+    catch (...)
+    {
+        GADGET_THROW("Errors in generate_readout_decimation_filter(...) ... ");
+    }
+}
+
+template EXPORTMRICORE void generate_readout_decimation_filter(size_t RO, size_t taps, hoNDArray< std::complex<float> >& filter);
+template EXPORTMRICORE void generate_readout_decimation_filter(size_t RO, size_t taps, hoNDArray< std::complex<double> >& filter);
+
+// ------------------------------------------------------------------------
+
+template <typename T>
+void decimate_readout(const hoNDArray<T>& data, const hoNDArray<T>& filter, hoNDArray<T>& res)
+{
+    GADGETRON_TRACE_SPAN("decimate_readout");
+
+    typedef typename realType<T>::Type value_type;
+
+    try
+    {
+        size_t RO = data.get_size(0);
+        GADGET_CHECK_THROW(RO % 4 == 0);
+
+        long long taps = (long long)filter.get_number_of_elements() - 1;
+        long long M = (long long)(RO / 2);
+        GADGET_CHECK_THROW(taps > 0 && 2 * taps <= M);
+
+        std::vector<size_t> dim = data.dimensions();
+        dim[0] = M;
+        if (!res.dimensions_equal(&dim))
+        {
+            res.create(dim);
+        }
+
+        long long N = (long long)(data.get_number_of_elements() / RO);
+
+        // Writing even samples E(p) = x(2p) and odd samples O(p) = x(2p+1), the output is
+        //     y(j) = h(0) E(j) + sum_i [ h(2i-1) O(j+i-1) + conj(h(2i-1)) O(j-i) ],   i = 1..taps
+        // with O indexed circularly. O is split into real and imaginary parts, padded with taps samples of wrap
+        // around on either side, so that every tap is a contiguous multiply-add over j that the compiler vectorizes.
+        std::vector<value_type> hr(taps + 1), hi(taps + 1);
+        for (long long i = 0; i <= taps; i++)
+        {
+            hr[i] = real(filter(i));
+            hi[i] = imag(filter(i));
+        }
+
+#pragma omp parallel if (N > 16) default(shared)
+        {
+            std::vector<value_type> oddRe(M + 2 * taps), oddIm(M + 2 * taps), resRe(M), resIm(M);
+
+#pragma omp for
+            for (long long n = 0; n < N; n++)
+            {
+                const T* pData = data.begin() + n*RO;
+                T* pRes = res.begin() + n*M;
+
+                for (long long p = 0; p < M; p++)
+                {
+                    oddRe[p + taps] = real(pData[2 * p + 1]);
+                    oddIm[p + taps] = imag(pData[2 * p + 1]);
+                }
+
+                for (long long p = 0; p < taps; p++)
+                {
+                    oddRe[p] = oddRe[M + p];
+                    oddIm[p] = oddIm[M + p];
+                    oddRe[M + taps + p] = oddRe[taps + p];
+                    oddIm[M + taps + p] = oddIm[taps + p];
+                }
+
+                for (long long j = 0; j < M; j++)
+                {
+                    resRe[j] = hr[0] * real(pData[2 * j]);
+                    resIm[j] = hr[0] * imag(pData[2 * j]);
+                }
+
+                for (long long i = 1; i <= taps; i++)
+                {
+                    const value_type a = hr[i], b = hi[i];
+                    const value_type* pAheadRe = oddRe.data() + taps + i - 1;
+                    const value_type* pAheadIm = oddIm.data() + taps + i - 1;
+                    const value_type* pBehindRe = oddRe.data() + taps - i;
+                    const value_type* pBehindIm = oddIm.data() + taps - i;
+                    for (long long j = 0; j < M; j++)
+                    {
+                        // h * ahead + conj(h) * behind
+                        value_type sumRe = pAheadRe[j] + pBehindRe[j];
+                        value_type sumIm = pAheadIm[j] + pBehindIm[j];
+                        value_type diffRe = pAheadRe[j] - pBehindRe[j];
+                        value_type diffIm = pAheadIm[j] - pBehindIm[j];
+                        resRe[j] += a * sumRe - b * diffIm;
+                        resIm[j] += a * sumIm + b * diffRe;
+                    }
+                }
+
+                for (long long j = 0; j < M; j++)
+                {
+                    pRes[j] = T(resRe[j], resIm[j]);
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        GADGET_THROW("Errors in decimate_readout(...) ... ");
+    }
+}
+
+template EXPORTMRICORE void decimate_readout(const hoNDArray< std::complex<float> >& data, const hoNDArray< std::complex<float> >& filter, hoNDArray< std::complex<float> >& res);
+template EXPORTMRICORE void decimate_readout(const hoNDArray< std::complex<double> >& data, const hoNDArray< std::complex<double> >& filter, hoNDArray< std::complex<double> >& res);
+
+}
@@ -0,0 +1,35 @@
+/** \file   mri_core_readout_oversampling.h
+    \brief  Removal of readout oversampling from kspace readouts, by FFT cropping or by half-band FIR decimation
+*/
+
+#pragma once
+
+#include "mri_core_export.h"
+#include "hoNDArray.h"
+
+namespace Gadgetron
+{
+    /// remove readout oversampling by cropping the readout image: ifft1c, keep samples [start, start+RO_out), fft1c
+    /// data: [RO ...], every readout along the first dimension is processed, so the readouts of many channels and
+    /// acquisitions can be transformed together in one call
+    /// res: [RO_out ...]
+    template <typename T> EXPORTMRICORE void remove_readout_oversampling(const hoNDArray<T>& data, size_t start, size_t RO_out, hoNDArray<T>& res);
+
+    /// as above, with the readout image kept in buf, so that calls on data of the same size do not allocate
+    template <typename T> EXPORTMRICORE void remove_readout_oversampling(const hoNDArray<T>& data, size_t start, size_t RO_out, hoNDArray<T>& res, hoNDArray<T>& buf);
+
+    /// generate the half-band filter for removing 2x readout oversampling in kspace, without FFTs
+    /// RO: oversampled readout length, must be a multiple of 4, as the half of the readout that is kept starts at RO/4
+    /// taps: number of filter taps on either side of the centre, at most RO/4; the filter is the kernel of the exact crop, truncated
+    /// with a Kaiser window, so more taps keep the image accurate closer to the edges of the field of view
+    /// filter: [taps+1], the centre tap followed by the odd taps h(1), h(3), ... h(2*taps-1); h(-d) = conj(h(d)) and
+    /// all other even taps are zero
+    template <typename T> EXPORTMRICORE void generate_readout_decimation_filter(size_t RO, size_t taps, hoNDArray<T>& filter);
+
+    /// remove 2x readout oversampling by filtering with the half-band filter and keeping every second sample
+    /// data: [RO ...] with RO a multiple of 4, res: [RO/2 ...]
+    /// filter: generated by generate_readout_decimation_filter for the same RO
+    /// this approximates remove_readout_oversampling(data, RO/4, RO/2, res), with errors concentrated at the edges of
+    /// the field of view
+    template <typename T> EXPORTMRICORE void decimate_readout(const hoNDArray<T>& data, const hoNDArray<T>& filter, hoNDArray<T>& res);
+}
@@ -24,6 +24,7 @@
 #include "hoNDArray_utils.h"
 #include "hoNDArray_elemwise.h"
 #include "hoNDArray_reductions.h"
+#include "hoNDArray_expressions.h"
 
 #ifdef USE_OMP
     #include "omp.h"
@@ -901,7 +902,6 @@ void spirit_adjoint_forward_kernel(const hoNDArray<T>& kImS2D, const hoNDArray<T
         long long d;
     #pragma omp parallel default(none) private(d) shared(N, dim, dstCHA, srcCHA, kIm, kImS2D, kImD2S) num_threads( (int)dstCHA ) if (dstCHA > 4)
         {
-            hoNDArray<T> ker(N);
             hoNDArray<T> dKer, kerS2D, kerD2S;
 
     #pragma omp for
@@ -916,8 +916,7 @@ void spirit_adjoint_forward_kernel(const hoNDArray<T>& kImS2D, const hoNDArray<T
                         kerS2D.create(dim, const_cast<T*>(kImS2D.begin()) + s*N + dprime*N*srcCHA);
                         kerD2S.create(dim, const_cast<T*>(kImD2S.begin()) + d*N + s*N*dstCHA);
 
-                        Gadgetron::multiply(kerS2D, kerD2S, ker);
-                        Gadgetron::add(dKer, ker, dKer);
+                        dKer = dKer + kerS2D * kerD2S;
                     }
                 }
             }
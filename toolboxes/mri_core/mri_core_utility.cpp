@@ -9,6 +9,9 @@
 #include "hoNDArray_utils.h"
 #include "hoNDFFT.h"
 #include "mri_core_kspace_filter.h"
+#include "cpp_blas.h"
+#include "trace.h"
+#include <cstring>
 #include <ctime>
 
 namespace Gadgetron
@@ -596,6 +599,83 @@ namespace Gadgetron
 
     // ------------------------------------------------------------------------
 
+    template <typename T>
+    void apply_channel_matrix(const std::vector<hoNDArray<T>*>& data, const hoNDArray<T>& matrix, bool upper_triangular, hoNDArray<T>& buf)
+    {
+        GADGETRON_TRACE_SPAN("apply_channel_matrix");
+
+        try
+        {
+            if (data.empty()) return;
+
+            size_t CHA = matrix.get_size(0);
+            GADGET_CHECK_THROW(matrix.get_size(1) == CHA);
+
+            size_t E = 0;
+            for (auto acq : data)
+            {
+                GADGET_CHECK_THROW(acq->get_size(1) == CHA);
+                E += acq->get_size(0);
+            }
+
+            if (upper_triangular && data.size() == 1)
+            {
+                BLAS::trmm(false, true, false, E, CHA, T(1), matrix.begin(), CHA, data[0]->begin(), E);
+                return;
+            }
+
+            // the full product cannot be done in place, so the result goes into the second half of buf
+            size_t required = E * CHA * (upper_triangular ? 1 : 2);
+            if (buf.get_number_of_elements() < required)
+            {
+                buf.create(required);
+            }
+
+            T* pStacked = buf.begin();
+            size_t offset = 0;
+            for (auto acq : data)
+            {
+                size_t e = acq->get_size(0);
+                for (size_t cha = 0; cha < CHA; cha++)
+                {
+                    memcpy(pStacked + cha*E + offset, acq->begin() + cha*e, sizeof(T)*e);
+                }
+                offset += e;
+            }
+
+            T* pRes = pStacked;
+            if (upper_triangular)
+            {
+                BLAS::trmm(false, true, false, E, CHA, T(1), matrix.begin(), CHA, pStacked, E);
+            }
+            else
+            {
+                pRes = pStacked + E*CHA;
+                BLAS::gemm(false, false, E, CHA, CHA, T(1), pStacked, E, matrix.begin(), CHA, T(0), pRes, E);
+            }
+
+            offset = 0;
+            for (auto acq : data)
+            {
+                size_t e = acq->get_size(0);
+                for (size_t cha = 0; cha < CHA; cha++)
+                {
+                    memcpy(acq->begin() + cha*e, pRes + cha*E + offset, sizeof(T)*e);
+                }
+                offset += e;
+            }
+        }
+        catch (...)
+        {
+            GADGET_THROW("Errors in apply_channel_matrix(...) ... ");
+        }
+    }
+
+    template EXPORTMRICORE void apply_channel_matrix(const std::vector<hoNDArray< std::complex<float> >*>& data, const hoNDArray< std::complex<float> >& matrix, bool upper_triangular, hoNDArray< std::complex<float> >& buf);
+    template EXPORTMRICORE void apply_channel_matrix(const std::vector<hoNDArray< std::complex<double> >*>& data, const hoNDArray< std::complex<double> >& matrix, bool upper_triangular, hoNDArray< std::complex<double> >& buf);
+
+    // ------------------------------------------------------------------------
+
     void get_debug_folder_path(const std::string& debugFolder, std::string& debugFolderPath)
     {
         char* v = std::getenv("GADGETRON_DEBUG_FOLDER");
@@ -52,6 +52,16 @@ namespace Gadgetron
     /// apply KLT coefficients to data for every N, S, and SLC
     template <typename T> EXPORTMRICORE void apply_eigen_channel_coefficients(const std::vector< std::vector< std::vector< hoNDKLT<T> > > >& KLT, hoNDArray<T>& data);
 
+    /// multiply acquisitions in place by a channel matrix, data[n] = data[n] * matrix, e.g. to prewhiten them or to
+    /// transform them to virtual coils
+    /// data: acquisitions [E CHA], the number of samples E may differ between them
+    /// matrix: [CHA CHA]; if upper_triangular is set, only the upper triangle is used, with the triangular product,
+    /// which needs half the flops of the full one
+    /// buf: scratch storage, reused between calls; several acquisitions are stacked into buf, so that all of them are
+    /// multiplied with one matrix product, and copied back. A single acquisition is multiplied without a copy if the
+    /// matrix is upper triangular.
+    template <typename T> EXPORTMRICORE void apply_channel_matrix(const std::vector<hoNDArray<T>*>& data, const hoNDArray<T>& matrix, bool upper_triangular, hoNDArray<T>& buf);
+
     /// get the path of debug folder
     // environmental variable GADGETRON_DEBUG_FOLDER is used 
     EXPORTMRICORE void get_debug_folder_path(const std::string& debugFolder, std::string& debugFolderPath);
@@ -89,15 +89,15 @@ namespace Gadgetron {
             {
                 bp::object pyImageArray((bp::handle<>(bp::borrowed(obj))));
 
-                reconData->data_ = bp::extract<hoNDArray<std::complex<float>>>(pyImageArray.attr("data"));
-                reconData->headers_ = bp::extract<hoNDArray<ISMRMRD::ImageHeader>>(pyImageArray.attr("headers"));
+                reconData->data_ = python_extract<hoNDArray<std::complex<float>>>(pyImageArray.attr("data"));
+                reconData->headers_ = python_extract<hoNDArray<ISMRMRD::ImageHeader>>(pyImageArray.attr("headers"));
                 reconData->meta_ = bp::extract<std::vector<ISMRMRD::MetaContainer>>(pyImageArray.attr("meta"));
 
                 if (PyObject_HasAttrString(pyImageArray.ptr(), "waveform"))
                     reconData->waveform_ = bp::extract<std::vector<ISMRMRD::Waveform>>(pyImageArray.attr("waveform"));
 
                 if (PyObject_HasAttrString(pyImageArray.ptr(), "acq_headers"))
-                    reconData->acq_headers_ = bp::extract<hoNDArray<ISMRMRD::AcquisitionHeader>>(pyImageArray.attr("acq_headers"));
+                    reconData->acq_headers_ = python_extract<hoNDArray<ISMRMRD::AcquisitionHeader>>(pyImageArray.attr("acq_headers"));
             }
             catch (const bp::error_already_set&)
             {
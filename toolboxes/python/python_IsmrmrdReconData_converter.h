@@ -123,11 +123,11 @@ struct IsmrmrdReconData_from_python_object {
   static IsmrmrdDataBuffered extractDataBuffered(bp::object pyDataBuffered){
     IsmrmrdDataBuffered result;
 
-    result.data_ = bp::extract<hoNDArray<std::complex<float>>>(pyDataBuffered.attr("data"));
+    result.data_ = python_extract<hoNDArray<std::complex<float>>>(pyDataBuffered.attr("data"));
     if (PyObject_HasAttrString(pyDataBuffered.ptr(),"trajectory"))
-      result.trajectory_ = bp::extract<hoNDArray<float>>(pyDataBuffered.attr("trajectory"));
+      result.trajectory_ = python_extract<hoNDArray<float>>(pyDataBuffered.attr("trajectory"));
 
-    result.headers_ = bp::extract<hoNDArray<ISMRMRD::AcquisitionHeader>>(pyDataBuffered.attr("headers"));
+    result.headers_ = python_extract<hoNDArray<ISMRMRD::AcquisitionHeader>>(pyDataBuffered.attr("headers"));
 
     auto pySampling = pyDataBuffered.attr("sampling");
     SamplingDescription sampling;
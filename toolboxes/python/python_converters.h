@@ -23,6 +23,27 @@ void register_converter(void) {
     (void) expander {0, (python_converter<TS>::create(), 0)...};
 }
 
+/// Interface for converting results of Python calls. The default goes through
+/// `bp::extract`, which copies out of the converter's storage; specializations
+/// can move instead.
+template <typename T>
+struct python_extractor {
+    static T extract(const bp::object& obj) { return bp::extract<T>(obj); }
+};
+
+/// Convenience wrapper for `python_extractor<T>::extract()`
+template <typename T>
+T python_extract(const bp::object& obj) {
+    return python_extractor<T>::extract(obj);
+}
+
+/// Arguments to Python calls are converted by Boost, unless overloaded
+/// for rvalues of a type that can be handed over to Python instead.
+template <typename T>
+const T& python_argument(const T& arg) {
+    return arg;
+}
+
 }
 
 #include "patchlevel.h"
@@ -16,11 +16,85 @@ namespace bp = boost::python;
 
 namespace Gadgetron {
 
+/// Name of the capsules through which NumPy arrays own hoNDArrays
+constexpr const char* hoNDArray_capsule_name = "gadgetron.hoNDArray";
+
+/// Whether NumPy arrays can share the storage of hoNDArray<T>, rather than holding objects or untyped data
+template <typename T>
+bool numpy_can_view() {
+    int type = get_numpy_type<T>();
+    return type != NPY_VOID && type != NPY_OBJECT;
+}
+
+// -------------------------------------------------------------------------------
+/// Makes a Fortran ordered NumPy array using the storage of arr, which must outlive it.
+template <typename T>
+PyObject* numpy_array_on_storage(const hoNDArray<T>& arr, int flags) {
+    size_t ndim = arr.get_number_of_dimensions();
+    std::vector<npy_intp> dims2(ndim);
+    for (size_t i = 0; i < ndim; i++) {
+        dims2[i] = static_cast<npy_intp>(arr.get_size(i));
+    }
+    PyObject* obj = NumPyArray_New(dims2.size(), dims2.data(), get_numpy_type<T>(),
+            const_cast<T*>(arr.get_data_ptr()), flags);
+    if (!obj) bp::throw_error_already_set();
+    return obj;
+}
+
+/// Hands arr over to NumPy without copying. The returned array owns the storage through a capsule holding
+/// the hoNDArray, so it stays valid for as long as Python uses it or any view of it.
+template <typename T>
+bp::object numpy_view(hoNDArray<T>&& arr) {
+    if (!numpy_can_view<T>() || arr.get_number_of_elements() == 0) {
+        NumPyConversionScope scope(NumPyConversion::copy);
+        return bp::object(arr);
+    }
+    if (!arr.delete_data_on_destruct()) {
+        // The storage is not the array's to hand over
+        return numpy_view(hoNDArray<T>(arr));
+    }
+
+    auto owned = new hoNDArray<T>(std::move(arr));
+    PyObject* capsule = PyCapsule_New(owned, hoNDArray_capsule_name, [](PyObject* capsule) {
+        delete static_cast<hoNDArray<T>*>(PyCapsule_GetPointer(capsule, hoNDArray_capsule_name));
+    });
+    if (!capsule) {
+        delete owned;
+        bp::throw_error_already_set();
+    }
+
+    PyObject* obj = nullptr;
+    try {
+        obj = numpy_array_on_storage(*owned, NPY_ARRAY_FARRAY);
+    } catch (...) {
+        bp::decref(capsule);
+        throw;
+    }
+    if (NumPyArray_SetBaseObject(obj, capsule) != 0) {
+        // the capsule reference is stolen even on failure
+        bp::decref(obj);
+        bp::throw_error_already_set();
+    }
+    return bp::object(bp::handle<>(obj));
+}
+
+/// In view mode, hoNDArrays passed to Python as rvalues are handed over with numpy_view.
+template <typename T>
+bp::object python_argument(hoNDArray<T>&& arg) {
+    if (numpy_conversion() == NumPyConversion::view) return numpy_view(std::move(arg));
+    return bp::object(arg);
+}
+
 // -------------------------------------------------------------------------------
 /// Used for making a NumPy array from and hoNDArray
 template <typename T>
 struct hoNDArray_to_numpy_array {
     static PyObject* convert(const hoNDArray<T>& arr) {
+        if (numpy_conversion() == NumPyConversion::view && numpy_can_view<T>() && arr.get_number_of_elements() > 0) {
+            // Read-only, as arr is const; valid as long as arr is
+            return numpy_array_on_storage(arr, NPY_ARRAY_FARRAY_RO);
+        }
+
         size_t ndim = arr.get_number_of_dimensions();
         std::vector<npy_intp> dims2(ndim);
         for (size_t i = 0; i < ndim; i++) {
@@ -126,6 +200,11 @@ struct hoNDArray_from_numpy_array {
         void* storage = ((bp::converter::rvalue_from_python_storage<hoNDArray<T> >*)data)->storage.bytes;
         data->convertible = storage;
 
+        if (numpy_conversion() == NumPyConversion::view && numpy_can_view<T>()) {
+            adopt(obj_orig, storage);
+            return;
+        }
+
         PyObject* obj =  NumPyArray_FromAny(obj_orig, nullptr, 1, 36,  NPY_ARRAY_IN_FARRAY, nullptr);
         size_t ndim = NumPyArray_NDIM(obj);
         std::vector<size_t> dims(ndim);
@@ -138,6 +217,45 @@ struct hoNDArray_from_numpy_array {
                 sizeof(T) * arr->get_number_of_elements());
         bp::decref(obj);
     }
+
+    /// Construct an hoNDArray in-place on the storage of the NumPy array, which it keeps alive.
+    /// NumPy only copies if the array is not already writeable, aligned, Fortran-contiguous and of type T.
+    static void adopt(PyObject* obj_orig, void* storage) {
+        PyObject* obj = NumPyArray_FromAny(obj_orig, NumPyArray_DescrFromType(get_numpy_type<T>()), 1, 36,
+                NPY_ARRAY_FARRAY, nullptr);
+        if (!obj) bp::throw_error_already_set();
+
+        size_t ndim = NumPyArray_NDIM(obj);
+        std::vector<size_t> dims(ndim);
+        for (size_t i = 0; i < ndim; i++) {
+            dims[i] = NumPyArray_DIM(obj, i);
+        }
+
+        // The hoNDArray may be released on any thread
+        auto owner = std::shared_ptr<void>(obj, [](void* obj) {
+            GILLock lock;
+            bp::decref(static_cast<PyObject*>(obj));
+        });
+        new (storage) hoNDArray<T>(dims, static_cast<T*>(NumPyArray_DATA(obj)), std::move(owner));
+    }
+};
+
+// -------------------------------------------------------------------------------
+/// hoNDArrays are built in the converter's storage, and moved out of it rather than copied.
+template <typename T>
+struct python_extractor<hoNDArray<T> > {
+    static hoNDArray<T> extract(const bp::object& obj) {
+        bp::converter::rvalue_from_python_data<hoNDArray<T> > data(bp::converter::rvalue_from_python_stage1(
+                obj.ptr(), bp::converter::registered<hoNDArray<T> >::converters));
+        if (!data.stage1.convertible) {
+            // let Boost raise its usual error
+            return bp::extract<hoNDArray<T> >(obj);
+        }
+        if (data.stage1.construct) {
+            data.stage1.construct(obj.ptr(), &data.stage1);
+        }
+        return std::move(*static_cast<hoNDArray<T>*>(data.stage1.convertible));
+    }
 };
 
 // --------------------------------------------------------------------------------
@@ -20,6 +20,9 @@ EXPORTPYTHON npy_intp NumPyArray_SIZE(PyObject* obj);
 EXPORTPYTHON PyObject *NumPyArray_SimpleNew(int nd, npy_intp* dims, int typenum);
 EXPORTPYTHON PyObject *NumPyArray_EMPTY(int nd, npy_intp* dims, int typenum, int fortran);
 EXPORTPYTHON PyObject* NumPyArray_FromAny(PyObject* op, PyArray_Descr* dtype, int min_depth, int max_depth, int requirements, PyObject* context);
+EXPORTPYTHON PyObject* NumPyArray_New(int nd, npy_intp* dims, int typenum, void* data, int flags);
+EXPORTPYTHON int NumPyArray_SetBaseObject(PyObject* obj, PyObject* base);
+EXPORTPYTHON PyArray_Descr* NumPyArray_DescrFromType(int typenum);
 /// return the enumerated numpy type for a given C++ type
 template <typename T> int get_numpy_type() { return NPY_VOID; }
 template <> inline int get_numpy_type< bool >() { return NPY_BOOL; }
@@ -6,6 +6,7 @@
 
 #include <boost/thread/mutex.hpp>
 #include <boost/algorithm/string.hpp>
+#include <utility>
 
 // #include "Gadget.h"             // for GADGET_OK/FAIL
 
@@ -17,6 +18,7 @@ static bool python_initialized = false;
 static bool numpy_initialized = false;
 static boost::mutex python_initialize_mtx;
 static boost::mutex numpy_initialize_mtx;
+static thread_local NumPyConversion numpy_conversion_mode = NumPyConversion::copy;
 
 void initialize_python(void)
 {
@@ -84,6 +86,16 @@ void add_python_path(const std::string& path)
 
 }
 
+NumPyConversion numpy_conversion(void)
+{
+    return numpy_conversion_mode;
+}
+
+NumPyConversion set_numpy_conversion(NumPyConversion conversion)
+{
+    return std::exchange(numpy_conversion_mode, conversion);
+}
+
 /// Adapted from http://stackoverflow.com/a/6576177/1689220
 std::string pyerr_to_string(void)
 {
@@ -131,6 +143,23 @@ npy_intp* NumPyArray_STRIDES(PyObject* obj)
 PyObject* NumPyArray_FromAny(PyObject* op, PyArray_Descr* dtype, int min_depth, int max_depth, int requirements, PyObject* context){
   return PyArray_FromAny(op, dtype, min_depth, max_depth, requirements, context);
 }
+/// Wraps PyArray_New for existing data; the array does not own data
+PyObject* NumPyArray_New(int nd, npy_intp* dims, int typenum, void* data, int flags)
+{
+    return PyArray_New(&PyArray_Type, nd, dims, typenum, nullptr, data, 0, flags, nullptr);
+}
+
+/// Wraps PyArray_SetBaseObject, which steals the reference to base
+int NumPyArray_SetBaseObject(PyObject* obj, PyObject* base)
+{
+    return PyArray_SetBaseObject((PyArrayObject*)obj, base);
+}
+
+PyArray_Descr* NumPyArray_DescrFromType(int typenum)
+{
+    return PyArray_DescrFromType(typenum);
+}
+
 /// Wraps PyArray_ITEMSIZE
 int NumPyArray_ITEMSIZE(PyObject* obj)
 {
@@ -2,6 +2,7 @@
 
 #include "python_export.h"
 #include "log.h"
+#include <boost/optional.hpp>
 #include <boost/python.hpp>
 namespace bp = boost::python;
 
@@ -20,6 +21,21 @@ EXPORTPYTHON void add_python_path(const std::string& path);
 /// Extracts the exception/traceback to build and return a std::string
 EXPORTPYTHON std::string pyerr_to_string(void);
 
+/// How hoNDArrays are converted to and from NumPy arrays
+enum class NumPyConversion {
+    /// NumPy arrays get a copy of the data, and returned arrays are copied back (the default)
+    copy,
+    /// NumPy arrays wrap the hoNDArray storage. Arrays passed by const reference are read-only and only valid
+    /// during the call; arrays passed as rvalues are handed over to NumPy, which releases them. Returned arrays
+    /// are adopted without copying if they are Fortran-contiguous, aligned and of the right type.
+    view
+};
+
+/// The conversion used on the calling thread
+EXPORTPYTHON NumPyConversion numpy_conversion(void);
+/// Sets the conversion used on the calling thread, returning the previous one
+EXPORTPYTHON NumPyConversion set_numpy_conversion(NumPyConversion conversion);
+
 }
 
 // Include converters after declaring above functions
@@ -44,6 +60,24 @@ namespace Gadgetron {
 
     };
 
+/// RAII selection of the NumPy conversion on the calling thread. Usage:
+///
+///    NumPyConversionScope scope(NumPyConversion::view);
+///
+    class NumPyConversionScope {
+    public:
+        explicit NumPyConversionScope(NumPyConversion conversion) : previous_(set_numpy_conversion(conversion)) {}
+
+        ~NumPyConversionScope() { set_numpy_conversion(previous_); }
+
+        NumPyConversionScope(const NumPyConversionScope &) = delete;
+
+        NumPyConversionScope &operator=(const NumPyConversionScope &) = delete;
+
+    private:
+        NumPyConversion previous_;
+    };
+
 }
 
 #include "python_converters.h"
@@ -69,7 +103,31 @@ protected:
         }
     }
 
+    /// Calls fn_, converting arguments and results as selected by set_numpy_conversion
+    template <typename... TS>
+    bp::object call(TS&&... args)
+    {
+        if (!conversion_)
+            return fn_(python_argument(std::forward<TS>(args))...);
+        NumPyConversionScope scope(*conversion_);
+        return fn_(python_argument(std::forward<TS>(args))...);
+    }
+
+    template <typename Result>
+    Result extract(const bp::object& res)
+    {
+        if (!conversion_)
+            return python_extract<Result>(res);
+        NumPyConversionScope scope(*conversion_);
+        return python_extract<Result>(res);
+    }
+
     bp::object fn_;
+    boost::optional<NumPyConversion> conversion_;
+
+public:
+    /// Converts hoNDArrays for this function as given, instead of as selected on the calling thread
+    void set_numpy_conversion(NumPyConversion conversion) { conversion_ = conversion; }
 };
 
 /// PythonFunction for multiple return types (std::tuple)
@@ -87,14 +145,14 @@ public:
     }
 
     template <typename... TS>
-    TupleType operator()(const TS&... args)
+    TupleType operator()(TS&&... args)
     {
         // register type converter for each parameter type
-        register_converter<TS...>();
+        register_converter<std::decay_t<TS>...>();
         GILLock lg; // lock GIL and release at function exit
         try {
-            bp::object res = fn_(args...);
-            return bp::extract<TupleType>(res);
+            bp::object res = call(std::forward<TS>(args)...);
+            return extract<TupleType>(res);
         } catch (bp::error_already_set const &) {
             std::string err = pyerr_to_string();
             GERROR(err.c_str());
@@ -116,14 +174,14 @@ public:
     }
 
     template <typename... TS>
-    RetType operator()(const TS&... args)
+    RetType operator()(TS&&... args)
     {
         // register type converter for each parameter type
-        register_converter<TS...>();
+        register_converter<std::decay_t<TS>...>();
         GILLock lg; // lock GIL and release at function exit
         try {
-            bp::object res = fn_(args...);
-            return bp::extract<RetType>(res);
+            bp::object res = call(std::forward<TS>(args)...);
+            return extract<RetType>(res);
         } catch (bp::error_already_set const &) {
             std::string err = pyerr_to_string();
             GERROR(err.c_str());
@@ -143,13 +201,13 @@ public:
     }
 
     template <typename... TS>
-    bp::object operator()(const TS&... args)
+    bp::object operator()(TS&&... args)
     {
         // register type converter for each parameter type
-        register_converter<TS...>();
+        register_converter<std::decay_t<TS>...>();
         GILLock lg; // lock GIL and release at function exit
         try {
-            bp::object res = fn_(args...);
+            bp::object res = call(std::forward<TS>(args)...);
             return res;
         }
         catch (bp::error_already_set const &) {
@@ -170,13 +228,13 @@ public:
       : PythonFunctionBase(module, funcname) {}
 
     template <typename... TS>
-    void operator()(const TS&... args)
+    void operator()(TS&&... args)
     {
         // register type converter for each parameter type
-        register_converter<TS...>();
+        register_converter<std::decay_t<TS>...>();
         GILLock lg; // lock GIL and release at function exit
         try {
-            bp::object res = fn_(args...);
+            bp::object res = call(std::forward<TS>(args)...);
         } catch (bp::error_already_set const &) {
             std::string err = pyerr_to_string();
             GERROR(err.c_str());
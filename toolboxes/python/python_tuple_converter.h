@@ -40,7 +40,7 @@ struct pytuple2cpptuple_wrapper {
 
     template<int ...S>
     std::tuple<Args...> callFunc(seq<S...>) {
-        return std::make_tuple((static_cast<Args>(bp::extract<Args>(params[S])))...);
+        return std::make_tuple(python_extract<Args>(bp::object(params[S]))...);
     }
 };
 
@@ -59,6 +59,18 @@ template<typename ... Args> std::tuple<Args...> pytuple2cpptuple(PyObject* obj)
     return bpt;
 }
 
+/// Converts elements of the tuple with `python_extract`, instead of copying them out of the std::tuple built by Boost.
+template <typename ...Args>
+struct python_extractor<std::tuple<Args...> > {
+    static std::tuple<Args...> extract(const bp::object& obj) {
+        if (!PyTuple_CheckExact(obj.ptr())) {
+            // let Boost raise its usual error
+            return bp::extract<std::tuple<Args...> >(obj);
+        }
+        return pytuple2cpptuple<Args...>(obj.ptr());
+    }
+};
+
 /// To-Python converter used by Boost
 template<typename ... Args>
 struct cpptuple_to_python_tuple {